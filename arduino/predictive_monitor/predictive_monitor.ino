@@ -6,6 +6,12 @@
  * Reads DHT11 (temperature/humidity) and MPU6050 (vibration)
  * every 2 seconds and sends CSV data over serial (USB) to PC.
  *
+ * With WIRE_BINARY 1 the board sends compact binary frames instead
+ * (layout in src/frame.h) and samples vibration at 100 Hz in batches
+ * of 16 - over 10x the readings the CSV rows fit through 9600 baud.
+ * Read it with `sensor_ingestd -B PORT`; the dashboard's --serial mode
+ * needs the CSV format.
+ *
  * Wiring:
  *   DHT11  VCC  -> 5V
  *   DHT11  GND  -> GND
@@ -34,11 +40,17 @@
 #define DHT_TYPE DHT11
 #define READ_INTERVAL_MS 2000
 
+/* 0 = CSV rows (dashboard --serial), 1 = binary frames (sensor_ingestd -B) */
+#define WIRE_BINARY 0
+#define VIB_INTERVAL_MS 10        /* binary mode: 100 Hz vibration */
+#define VIB_BATCH 16              /* vibration samples per frame */
+#define TIMEBASE_INTERVAL_MS 5000 /* absolute time re-sent this often */
+
 #define SENSOR_TEMP 0
 #define SENSOR_HUMIDITY 1
 #define SENSOR_VIBRATION 2
 
-/* Thresholds */
+/* Thresholds - keep in step with config/board.ini */
 #define TEMP_WARN_HIGH 70.0f
 #define TEMP_CRITICAL_HIGH 85.0f
 #define HUMID_WARN_LOW 20.0f
@@ -143,6 +155,77 @@ void send_csv_row(uint32_t timestamp, uint8_t sensor_id,
     Serial.println(alert_level);
 }
 
+/* ============================================================
+ * SEND BINARY FRAME OVER SERIAL
+ * SYNC LEN ID DT PERIOD COUNTS... CRC - see src/frame.h.
+ * ============================================================ */
+
+#define FRAME_SYNC 0xA5
+#define FRAME_ID_TIME 0xFF
+
+static uint32_t last_frame_ms = 0;
+static uint32_t last_timebase_ms = 0;
+
+/* CRC-16/CCITT-FALSE, bitwise: no table in the Uno's 2 KB of RAM */
+uint16_t crc16_update(uint16_t crc, uint8_t byte)
+{
+    crc ^= (uint16_t)byte << 8;
+    for (uint8_t b = 0; b < 8; b++)
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    return crc;
+}
+
+void write_frame(uint8_t id, int16_t dt, uint8_t period,
+                 const int16_t *counts, uint8_t n)
+{
+    uint8_t frame[8 + 2 * VIB_BATCH];
+    uint8_t len = 0;
+
+    frame[len++] = FRAME_SYNC;
+    frame[len++] = 4 + 2 * n;
+    frame[len++] = id;
+    frame[len++] = (uint16_t)dt & 0xFF;
+    frame[len++] = (uint16_t)dt >> 8;
+    frame[len++] = period;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        frame[len++] = (uint16_t)counts[i] & 0xFF;
+        frame[len++] = (uint16_t)counts[i] >> 8;
+    }
+
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 1; i < len; i++)
+        crc = crc16_update(crc, frame[i]);
+    frame[len++] = crc & 0xFF;
+    frame[len++] = crc >> 8;
+
+    Serial.write(frame, len);
+}
+
+void send_timebase(uint32_t now)
+{
+    int16_t words[2] = {(int16_t)(now & 0xFFFF), (int16_t)(now >> 16)};
+    write_frame(FRAME_ID_TIME, 0, 0, words, 2);
+    last_frame_ms = now;
+    last_timebase_ms = now;
+}
+
+/* Timestamps are deltas from the previous frame; re-anchor when the
+ * delta would not fit or the periodic time base is due */
+void send_frame(uint8_t id, uint32_t first_ms, uint8_t period,
+                const int16_t *counts, uint8_t n)
+{
+    int32_t dt = (int32_t)(first_ms - last_frame_ms);
+    if (dt > 32767 || dt < -32768 ||
+        first_ms - last_timebase_ms >= TIMEBASE_INTERVAL_MS)
+    {
+        send_timebase(first_ms);
+        dt = 0;
+    }
+    write_frame(id, (int16_t)dt, period, counts, n);
+    last_frame_ms = first_ms;
+}
+
 /* ============================================================
  * COMPUTE VIBRATION MAGNITUDE
  * ============================================================ */
@@ -161,6 +244,13 @@ float compute_vibration(int16_t ax, int16_t ay, int16_t az)
     return vibration;
 }
 
+/* Same magnitude in raw accelerometer counts (16384 per g) */
+int16_t vibration_counts(int16_t ax, int16_t ay, int16_t az)
+{
+    float counts = compute_vibration(ax, ay, az) * 16384.0f;
+    return (counts > 32767.0f) ? 32767 : (int16_t)counts;
+}
+
 /* ============================================================
  * SETUP
  * ============================================================ */
@@ -173,9 +263,13 @@ void setup()
         delay(10);
     }
 
+#if WIRE_BINARY
+    send_timebase(millis());
+#else
     Serial.println("timestamp,sensor_id,sensor_name,value,alert_level");
     Serial.println("# Predictive Maintenance Monitor ready");
     Serial.println("# Sensors: DHT11 (temp/humidity) + MPU6050 (vibration)");
+#endif
 
     dht.begin();
 
@@ -191,6 +285,55 @@ void setup()
  * LOOP
  * ============================================================ */
 
+#if WIRE_BINARY
+
+/* DHT11 every READ_INTERVAL_MS (its limit), MPU6050 every VIB_INTERVAL_MS.
+ * Readings go out as centi-units / raw counts; the host applies scales. */
+void loop()
+{
+    static uint32_t next_dht = 0;
+    static uint32_t next_vib = 0;
+    static int16_t vib[VIB_BATCH];
+    static uint32_t vib_first = 0;
+    static uint8_t vib_count = 0;
+
+    uint32_t now = millis();
+
+    if ((int32_t)(now - next_dht) >= 0)
+    {
+        next_dht += READ_INTERVAL_MS;
+        float temperature = dht.readTemperature();
+        float humidity = dht.readHumidity();
+
+        if (!isnan(temperature) && !isnan(humidity))
+        {
+            int16_t t = (int16_t)(temperature * 100.0f);
+            int16_t h = (int16_t)(humidity * 100.0f);
+            send_frame(SENSOR_TEMP, now, 0, &t, 1);
+            send_frame(SENSOR_HUMIDITY, now, 0, &h, 1);
+        }
+    }
+
+    if ((int32_t)(now - next_vib) >= 0)
+    {
+        next_vib += VIB_INTERVAL_MS;
+        int16_t ax, ay, az, gx, gy, gz;
+        mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+
+        if (vib_count == 0)
+            vib_first = now;
+        vib[vib_count++] = vibration_counts(ax, ay, az);
+
+        if (vib_count == VIB_BATCH)
+        {
+            send_frame(SENSOR_VIBRATION, vib_first, VIB_INTERVAL_MS, vib, VIB_BATCH);
+            vib_count = 0;
+        }
+    }
+}
+
+#else
+
 void loop()
 {
     uint32_t timestamp = millis();
@@ -230,3 +373,5 @@ void loop()
 
     delay(READ_INTERVAL_MS);
 }
+
+#endif /* WIRE_BINARY */
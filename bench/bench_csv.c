@@ -0,0 +1,149 @@
+/**
+ * @file bench_csv.c
+ * @brief Streaming CSV parser throughput benchmark
+ *
+ * Builds an in-memory corpus by repeating data/serial_log.csv (the real
+ * board output) up to the requested size, then feeds it to
+ * csv_parse_chunk() in read()-sized chunks - lines split at every chunk
+ * boundary, exactly as on a serial port - and reports MB/s. For
+ * comparison the same corpus is parsed line by line with strtoul/strtof,
+ * the approach the ingester used before.
+ *
+ * MB/s depends heavily on the machine, so there is no absolute target.
+ * The speedup over strtoul/strtof on the same corpus is the number to
+ * compare between machines.
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_csv [corpus_mb] [chunk_bytes]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/csv_parser.h"
+#include "../src/clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPS     5
+#define OUT_CAP  4096
+
+static char *build_corpus(size_t target, size_t *len)
+{
+    FILE *f = fopen("data/serial_log.csv", "rb");
+    if (f == NULL)
+    {
+        fprintf(stderr, "bench_csv: data/serial_log.csv not found (run from the repo root)\n");
+        return NULL;
+    }
+    static char seed[1 << 20];
+    size_t n = fread(seed, 1, sizeof(seed), f);
+    fclose(f);
+
+    char *corpus = malloc(target + n);
+    if (corpus == NULL || n == 0)
+    {
+        free(corpus);
+        return NULL;
+    }
+    size_t used = 0;
+    while (used < target)
+    {
+        memcpy(corpus + used, seed, n);
+        used += n;
+    }
+    *len = used;
+    return corpus;
+}
+
+/** Returns rows parsed; sums values into *sink so nothing is optimised out */
+static size_t run_stream(const char *data, size_t len, size_t chunk, double *sink)
+{
+    static sensor_reading_t out[OUT_CAP];
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+
+    for (size_t off = 0; off < len; off += chunk)
+    {
+        size_t n = (len - off < chunk) ? len - off : chunk;
+        size_t used = 0;
+        while (used < n)
+        {
+            size_t consumed;
+            size_t got = csv_parse_chunk(&p, data + off + used, n - used,
+                                         out, OUT_CAP, &consumed);
+            if (got > 0)
+                *sink += out[got - 1].value;
+            used += consumed;
+        }
+    }
+    return (size_t)p.rows;
+}
+
+/** The old ingest path: find each line, then strtoul/strtof */
+static size_t run_libc(const char *data, size_t len, double *sink)
+{
+    size_t rows = 0;
+    const char *pos = data, *end = data + len;
+
+    while (pos < end)
+    {
+        const char *nl = memchr(pos, '\n', (size_t)(end - pos));
+        if (nl == NULL)
+            break;
+        if (*pos >= '0' && *pos <= '9')
+        {
+            char *p;
+            unsigned long ts = strtoul(pos, &p, 10);
+            unsigned long id = strtoul(p + 1, &p, 10);
+            p = memchr(p + 1, ',', (size_t)(nl - p));
+            if (p != NULL)
+            {
+                *sink += strtof(p + 1, NULL);
+                rows  += (ts <= UINT32_MAX && id <= UINT8_MAX);
+            }
+        }
+        pos = nl + 1;
+    }
+    return rows;
+}
+
+int main(int argc, char **argv)
+{
+    size_t mb    = (argc > 1) ? strtoul(argv[1], NULL, 10) : 256;
+    size_t chunk = (argc > 2) ? strtoul(argv[2], NULL, 10) : 65536;
+    size_t len;
+
+    char *corpus = build_corpus(mb << 20, &len);
+    if (corpus == NULL)
+        return 1;
+
+    double best_stream = 1e30, best_libc = 1e30, sink = 0.0;
+    size_t rows = 0, rows_libc = 0;
+
+    for (int rep = 0; rep < REPS; rep++)
+    {
+        uint64_t t0 = clock_ns();
+        rows = run_stream(corpus, len, chunk, &sink);
+        uint64_t t1 = clock_ns();
+        rows_libc = run_libc(corpus, len, &sink);
+        uint64_t t2 = clock_ns();
+
+        if ((double)(t1 - t0) < best_stream) best_stream = (double)(t1 - t0);
+        if ((double)(t2 - t1) < best_libc)   best_libc   = (double)(t2 - t1);
+    }
+
+    double size_mb = (double)len / (1024.0 * 1024.0);
+    printf("corpus: %.1f MB, %zu rows, %zu-byte chunks (best of %d)\n",
+           size_mb, rows, chunk, REPS);
+    printf("%-22s %10s %12s\n", "parser", "MB/s", "Mrows/s");
+    printf("%-22s %10.0f %12.1f\n", "csv_parse_chunk",
+           size_mb / (best_stream / 1e9), (double)rows / (best_stream / 1e3));
+    printf("%-22s %10.0f %12.1f\n", "strtoul/strtof lines",
+           size_mb / (best_libc / 1e9), (double)rows_libc / (best_libc / 1e3));
+    printf("speedup over strtoul/strtof: %.1fx\n", best_libc / best_stream);
+    printf("(checksum %.1f)\n", sink);
+
+    free(corpus);
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file bench_csv_bulk.c
+ * @brief Bulk CSV reader throughput benchmark (GB/s)
+ *
+ * Writes a corpus file by repeating data/serial_log.csv, maps it with
+ * csv_bulk_open() and reads it into 64K-row columns, best of REPS passes
+ * over the (page-cached) file. The streaming parser runs over the same
+ * mapping for comparison.
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_csv_bulk [corpus_mb] [corpus_path]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/csv_bulk.h"
+#include "../src/csv_parser.h"
+#include "../src/clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPS      5
+#define BATCH     65536
+
+static bool write_corpus(const char *path, size_t target)
+{
+    FILE *in = fopen("data/serial_log.csv", "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "bench_csv_bulk: data/serial_log.csv not found (run from the repo root)\n");
+        return false;
+    }
+    static char seed[1 << 20];
+    size_t n = fread(seed, 1, sizeof(seed), in);
+    fclose(in);
+
+    FILE *out = fopen(path, "wb");
+    if (out == NULL || n == 0)
+    {
+        if (out != NULL)
+            fclose(out);
+        fprintf(stderr, "bench_csv_bulk: cannot write %s\n", path);
+        return false;
+    }
+    for (size_t written = 0; written < target; written += n)
+        fwrite(seed, 1, n, out);
+    fclose(out);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t      mb   = (argc > 1) ? strtoul(argv[1], NULL, 10) : 256;
+    const char *path = (argc > 2) ? argv[2] : "/tmp/bench_csv_bulk.csv";
+
+    if (!write_corpus(path, mb << 20))
+        return 1;
+
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    if (r == NULL || !csv_bulk_open(r, path) || !csv_columns_init(&cols, BATCH))
+        return 1;
+
+    double best_bulk = 1e30, best_stream = 1e30, sink = 0.0;
+    uint64_t rows = 0;
+
+    for (int rep = 0; rep < REPS; rep++)
+    {
+        csv_bulk_rewind(r);
+        uint64_t t0 = clock_ns();
+        rows = 0;
+        while (csv_bulk_read(r, &cols) > 0)
+        {
+            rows += cols.count;
+            sink += cols.value[cols.count - 1];
+        }
+        uint64_t t1 = clock_ns();
+
+        /* Streaming parser over the same mapped bytes */
+        static sensor_reading_t out[4096];
+        csv_parser_t p;
+        csv_parser_init(&p, NULL);
+        size_t used = 0;
+        while (used < r->size)
+        {
+            size_t consumed;
+            size_t got = csv_parse_chunk(&p, r->data + used, r->size - used,
+                                         out, 4096, &consumed);
+            if (got > 0)
+                sink += out[got - 1].value;
+            used += consumed;
+        }
+        uint64_t t2 = clock_ns();
+
+        if ((double)(t1 - t0) < best_bulk)   best_bulk   = (double)(t1 - t0);
+        if ((double)(t2 - t1) < best_stream) best_stream = (double)(t2 - t1);
+    }
+
+    double gb = (double)r->size / 1e9;
+    printf("corpus: %s, %.2f GB, %llu rows (best of %d, %s)\n",
+           path, gb, (unsigned long long)rows, REPS, csv_bulk_isa());
+    printf("%-24s %8s %12s\n", "reader", "GB/s", "Mrows/s");
+    printf("%-24s %8.2f %12.1f\n", "csv_bulk_read (columns)",
+           gb / (best_bulk / 1e9), (double)rows / (best_bulk / 1e3));
+    printf("%-24s %8.2f %12.1f\n", "csv_parse_chunk",
+           gb / (best_stream / 1e9), (double)rows / (best_stream / 1e3));
+    printf("(checksum %.1f)\n", sink);
+
+    csv_columns_free(&cols);
+    csv_bulk_close(r);
+    free(r);
+    remove(path);
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file bench_layout.c
+ * @brief manager_log() cost when its per-sensor state is not in cache
+ *
+ * bench_micro logs into one manager whose few sensors stay in L1. This
+ * benchmark spreads the readings over many managers (MANAGER_MAX_SENSORS
+ * sensors each) in a shuffled order, so nearly every reading finds its
+ * sensor's lines cold and the cost is dominated by how many distinct
+ * cache lines one manager_log() has to pull in:
+ *
+ *   first one pass over all managers, first touch of every page
+ *   warm  one manager, sensors in turn          (layout barely matters)
+ *   cold  all managers, sensors in random order (one miss per line touched)
+ *
+ * Each reading is logged and read straight back so the 16-slot rings
+ * never fill. Thresholds are enabled, no filters or anomaly detection,
+ * i.e. the path most sensors take.
+ *
+ * On Linux the process's own hardware counters are read around each
+ * case with perf_event_open() (cache-references, cache-misses and L1D
+ * read misses per reading). Where the kernel or hypervisor exposes no
+ * PMU the columns say "n/a" and the ns/reading column is the signal.
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_layout [managers] [rounds]
+ */
+
+#define _GNU_SOURCE         /* syscall() */
+
+#include "../src/sensor_manager.h"
+#include "../src/clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define RING        16
+#define COUNTERS    3
+
+static const char *const k_counter_names[COUNTERS] = {
+    "cache-refs", "cache-miss", "L1D-miss"
+};
+
+/* ============================================================================
+ * HARDWARE COUNTERS
+ * ========================================================================== */
+
+static int g_fd[COUNTERS] = {-1, -1, -1};
+
+static void counters_open(void)
+{
+#ifdef __linux__
+    const uint64_t config[COUNTERS] = {
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    };
+    for (int i = 0; i < COUNTERS; i++)
+    {
+        struct perf_event_attr a;
+        memset(&a, 0, sizeof(a));
+        a.size           = sizeof(a);
+        a.type           = i == 2 ? PERF_TYPE_HW_CACHE : PERF_TYPE_HARDWARE;
+        a.config         = config[i];
+        a.disabled       = 1;
+        a.exclude_kernel = 1;
+        a.exclude_hv     = 1;
+        g_fd[i] = (int)syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+    }
+#endif
+}
+
+static void counters_start(void)
+{
+#ifdef __linux__
+    for (int i = 0; i < COUNTERS; i++)
+        if (g_fd[i] >= 0)
+        {
+            ioctl(g_fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(g_fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+}
+
+/** Stop and read; -1 for a counter that is not available */
+static void counters_stop(double out[COUNTERS])
+{
+    for (int i = 0; i < COUNTERS; i++)
+    {
+        out[i] = -1.0;
+#ifdef __linux__
+        uint64_t v;
+        if (g_fd[i] >= 0)
+        {
+            ioctl(g_fd[i], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(g_fd[i], &v, sizeof(v)) == (ssize_t)sizeof(v))
+                out[i] = (double)v;
+        }
+#endif
+    }
+}
+
+/* ============================================================================
+ * CASES
+ * ========================================================================== */
+
+typedef struct {
+    uint32_t mgr;
+    uint8_t  id;
+} target_t;
+
+static manager_t **g_mgr;
+static target_t   *g_order;
+
+static void build(uint32_t managers)
+{
+    g_mgr = malloc(managers * sizeof(*g_mgr));
+    for (uint32_t i = 0; i < managers; i++)
+    {
+        g_mgr[i] = manager_create(MANAGER_MAX_SENSORS);
+        for (uint8_t id = 0; id < MANAGER_MAX_SENSORS; id++)
+        {
+            char name[SENSOR_NAME_MAX];
+            snprintf(name, sizeof(name), "Sensor %u.%u", i, id);
+            manager_register(g_mgr[i], id, name, RING);
+            manager_set_thresholds(g_mgr[i], id, (sensor_threshold_t){
+                .warn_low = -50.0f, .warn_high = 80.0f,
+                .critical_low = -100.0f, .critical_high = 120.0f});
+        }
+    }
+
+    /* Every (manager, sensor) once, Fisher-Yates shuffled */
+    size_t n = (size_t)managers * MANAGER_MAX_SENSORS;
+    g_order = malloc(n * sizeof(*g_order));
+    for (size_t k = 0; k < n; k++)
+        g_order[k] = (target_t){(uint32_t)(k / MANAGER_MAX_SENSORS),
+                                (uint8_t)(k % MANAGER_MAX_SENSORS)};
+    uint32_t s = 2463534242u;
+    for (size_t k = n - 1; k > 0; k--)
+    {
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        size_t j = s % (k + 1);
+        target_t t = g_order[k];
+        g_order[k] = g_order[j];
+        g_order[j] = t;
+    }
+}
+
+static void report(const char *name, uint64_t ns, size_t readings,
+                   const double c[COUNTERS])
+{
+    printf("  %-6s %10.1f", name, (double)ns / (double)readings);
+    for (int i = 0; i < COUNTERS; i++)
+    {
+        if (c[i] < 0.0)
+            printf(" %11s", "n/a");
+        else
+            printf(" %11.2f", c[i] / (double)readings);
+    }
+    printf("\n");
+}
+
+static void run_warm(uint32_t rounds)
+{
+    manager_t *m = g_mgr[0];
+    size_t readings = (size_t)rounds * 4096;
+    sensor_reading_t out;
+    double c[COUNTERS];
+
+    counters_start();
+    uint64_t t0 = clock_ns();
+    for (size_t k = 0; k < readings; k++)
+    {
+        uint8_t id = (uint8_t)(k % MANAGER_MAX_SENSORS);
+        manager_log(m, id, 20.0f + (float)(k & 15), (uint32_t)k);
+        manager_read(m, id, &out);
+    }
+    uint64_t t1 = clock_ns();
+    counters_stop(c);
+    report("warm", t1 - t0, readings, c);
+}
+
+static void run_cold(const char *name, uint32_t managers, uint32_t rounds)
+{
+    size_t n = (size_t)managers * MANAGER_MAX_SENSORS;
+    sensor_reading_t out;
+    double c[COUNTERS];
+
+    counters_start();
+    uint64_t t0 = clock_ns();
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        for (size_t k = 0; k < n; k++)
+        {
+            manager_t *m = g_mgr[g_order[k].mgr];
+            uint8_t   id = g_order[k].id;
+            manager_log(m, id, 20.0f + (float)(k & 15), r);
+            manager_read(m, id, &out);
+        }
+    }
+    uint64_t t1 = clock_ns();
+    counters_stop(c);
+    report(name, t1 - t0, n * rounds, c);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(int argc, char **argv)
+{
+    uint32_t managers = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 4096;
+    uint32_t rounds   = argc > 2 ? (uint32_t)strtoul(argv[2], NULL, 10) : 8;
+    if (managers == 0 || rounds == 0)
+    {
+        fprintf(stderr, "usage: %s [managers] [rounds]\n", argv[0]);
+        return 2;
+    }
+
+    build(managers);
+    counters_open();
+
+    printf("=== manager_log layout: %u managers x %d sensors, "
+           "sizeof(manager_t) = %zu ===\n",
+           managers, MANAGER_MAX_SENSORS, sizeof(manager_t));
+    printf("  %-6s %10s", "case", "ns/reading");
+    for (int i = 0; i < COUNTERS; i++)
+        printf(" %11s", k_counter_names[i]);
+    printf("   (counters per reading)\n");
+
+    run_cold("first", managers, 1);     /* includes page faults */
+    run_warm(rounds);
+    run_cold("cold", managers, rounds);
+
+    for (uint32_t i = 0; i < managers; i++)
+        manager_destroy(g_mgr[i]);
+    free(g_mgr);
+    free(g_order);
+    return 0;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file bench_micro.c
+ * @brief Microbenchmarks for the buffer, sensor, manager and logger layers
+ *
+ * Times the per-reading hot path one layer at a time:
+ *
+ *   buffer_write / buffer_read     ring capacity 16 .. 65536
+ *   sensor_log                     ring capacity 16 .. 65536
+ *   manager_log                    1 .. MANAGER_MAX_SENSORS sensors
+ *   manager_check_threshold        evaluate_threshold() behind the API
+ *   logger_write                   to a scratch CSV file
+ *
+ * Each case is warmed up, then timed as BATCHES batches of up to BATCH
+ * operations. The clock's own cost is measured once and subtracted from
+ * every batch, so small batches (a 16-slot ring) are not inflated.
+ * Reported per operation: mean, p50, p90 and p99 over the batches in
+ * ns, and p50 in cycles (TSC on x86, estimated from the clock rate).
+ *
+ * Rings are kept in steady state: before a timed write batch, enough
+ * entries are read back (untimed) to make room, and vice versa, so the
+ * write position walks the whole ring and large capacities show their
+ * cache footprint.
+ *
+ * -o writes the results as CSV (one row per case) for run-to-run
+ * tracking; -c compares against such a file and prints the p50 change,
+ * flagging anything more than 10% slower.
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_micro [-o results.csv] [-c baseline.csv] [batches]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/sensor_manager.h"
+#include "../src/logger.h"
+#include "../src/clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#define BATCH        1024       ///< Operations per timed batch (at most)
+#define WARMUP       32         ///< Untimed batches before measuring
+#define MAX_BATCHES  4096
+#define MAX_RESULTS  64
+#define REGRESSION   1.10       ///< p50 ratio flagged by -c
+#define VALUES       4096       ///< Pre-generated input values (power of 2)
+
+typedef struct {
+    char   name[32];
+    char   param[32];
+    size_t batch;               ///< Operations per batch
+    size_t batches;
+    double mean_ns, p50_ns, p90_ns, p99_ns, p50_cycles;
+} result_t;
+
+static result_t g_results[MAX_RESULTS];
+static size_t   g_result_count;
+static double   g_samples[MAX_BATCHES];     ///< ns/op per batch
+static float    g_values[VALUES];
+static double   g_clock_ns;                 ///< Cost of one clock_ns() pair
+static double   g_cycles_per_ns;            ///< 0 when unknown
+static size_t   g_batches = 512;
+
+/* ============================================================================
+ * HARNESS
+ * ========================================================================== */
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Median cost of back-to-back clock_ns() calls */
+static void calibrate(void)
+{
+    static double d[1001];
+    for (int i = 0; i < 1001; i++)
+    {
+        uint64_t a = clock_ns();
+        uint64_t b = clock_ns();
+        d[i] = (double)(b - a);
+    }
+    qsort(d, 1001, sizeof(double), cmp_double);
+    g_clock_ns = d[500];
+
+#ifdef HAVE_TSC
+    uint64_t t0 = clock_ns(), c0 = __rdtsc();
+    while (clock_ns() - t0 < 50000000u)
+        ;
+    uint64_t t1 = clock_ns(), c1 = __rdtsc();
+    g_cycles_per_ns = (double)(c1 - c0) / (double)(t1 - t0);
+#endif
+
+    /* Values in the normal band of the thresholds used below */
+    uint32_t s = 12345;
+    for (int i = 0; i < VALUES; i++)
+    {
+        s = s * 1103515245u + 12345u;
+        g_values[i] = 40.0f + (float)((s >> 16) % 2000) / 100.0f;
+    }
+}
+
+/** Turn g_samples[0..n) into a result row */
+static void record(const char *name, const char *param, size_t batch, size_t n)
+{
+    result_t *r = &g_results[g_result_count++];
+    memset(r, 0, sizeof(*r));
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    snprintf(r->param, sizeof(r->param), "%s", param);
+    r->batch   = batch;
+    r->batches = n;
+
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++)
+        sum += g_samples[i];
+    qsort(g_samples, n, sizeof(double), cmp_double);
+
+    r->mean_ns    = sum / (double)n;
+    r->p50_ns     = g_samples[n / 2];
+    r->p90_ns     = g_samples[(size_t)(0.90 * (double)(n - 1))];
+    r->p99_ns     = g_samples[(size_t)(0.99 * (double)(n - 1))];
+    r->p50_cycles = r->p50_ns * g_cycles_per_ns;
+}
+
+/** ns per op for a batch timed as [a, b) */
+static double per_op(uint64_t a, uint64_t b, size_t ops)
+{
+    double ns = (double)(b - a) - g_clock_ns;
+    return (ns > 0.0 ? ns : 0.0) / (double)ops;
+}
+
+/* ============================================================================
+ * CASES
+ * ========================================================================== */
+
+static void bench_buffer(size_t cap)
+{
+    ring_buffer_t *buf = buffer_create(cap);
+    if (buf == NULL)
+        return;
+    size_t k = cap < BATCH ? cap : BATCH;
+    sensor_reading_t r = {0}, out;
+    char param[32];
+    snprintf(param, sizeof(param), "cap=%zu", cap);
+
+    /* Writes: make room for k untimed, then time k writes */
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        while (buffer_free_slots(buf) < k)
+            buffer_read(buf, &out);
+
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < k; i++)
+        {
+            r.timestamp = (uint32_t)i;
+            r.value     = g_values[i & (VALUES - 1)];
+            buffer_write(buf, &r);
+        }
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, k);
+    }
+    record("buffer_write", param, k, g_batches);
+
+    /* Reads: top up k untimed, then time k reads */
+    float sink = 0.0f;
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        while (buffer_count(buf) < k)
+            buffer_write(buf, &r);
+
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < k; i++)
+        {
+            buffer_read(buf, &out);
+            sink += out.value;
+        }
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, k);
+    }
+    record("buffer_read", param, k, g_batches);
+
+    if (sink == -1.0f)
+        printf("%f\n", sink);
+    buffer_destroy(buf);
+}
+
+static void bench_sensor(size_t cap)
+{
+    sensor_t s;
+    if (!sensor_init(&s, 0, "Bench", cap))
+        return;
+    size_t k = cap < BATCH ? cap : BATCH;
+    sensor_reading_t out;
+    char param[32];
+    snprintf(param, sizeof(param), "cap=%zu", cap);
+
+    uint32_t ts = 0;
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        while (buffer_free_slots(s.buf) < k)
+            sensor_read(&s, &out);
+
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < k; i++, ts++)
+            sensor_log(&s, g_values[ts & (VALUES - 1)], ts);
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, k);
+    }
+    record("sensor_log", param, k, g_batches);
+    sensor_destroy(&s);
+}
+
+static manager_t *make_manager(uint8_t sensors, size_t cap)
+{
+    manager_t *m = manager_create(sensors);
+    if (m == NULL)
+        return NULL;
+    for (uint8_t id = 0; id < sensors; id++)
+    {
+        char name[SENSOR_NAME_MAX];
+        snprintf(name, sizeof(name), "Bench %u", id);
+        manager_register(m, id, name, cap);
+        manager_set_thresholds(m, id, (sensor_threshold_t){
+            .warn_low = 10.0f, .warn_high = 70.0f,
+            .critical_low = 0.0f, .critical_high = 85.0f, .enabled = true});
+    }
+    return m;
+}
+
+static void bench_manager(uint8_t sensors)
+{
+    const size_t cap = 1024;
+    manager_t *m = make_manager(sensors, cap);
+    if (m == NULL)
+        return;
+    sensor_reading_t out;
+    char param[32];
+    snprintf(param, sizeof(param), "sensors=%u", sensors);
+
+    /* Round-robin over the sensors, as interleaved board output arrives */
+    uint32_t ts = 0;
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        for (uint8_t id = 0; id < sensors; id++)
+            while (buffer_free_slots(m->sensors[id].buf) < BATCH)
+                manager_read(m, id, &out);
+
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < BATCH; i++, ts++)
+            manager_log(m, (uint8_t)(i % sensors), g_values[ts & (VALUES - 1)], ts);
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, BATCH);
+    }
+    record("manager_log", param, BATCH, g_batches);
+    manager_destroy(m);
+}
+
+static void bench_threshold(void)
+{
+    manager_t *m = make_manager(1, 16);
+    if (m == NULL)
+        return;
+
+    unsigned alerts = 0;
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < BATCH; i++)
+            alerts += manager_check_threshold(m, 0, g_values[i & (VALUES - 1)]);
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, BATCH);
+    }
+    record("check_threshold", "sensors=1", BATCH, g_batches);
+
+    if (alerts == 0xFFFFFFFFu)
+        printf("%u\n", alerts);
+    manager_destroy(m);
+}
+
+static void bench_logger(const char *path)
+{
+    remove(path);
+    csv_logger_t logger;
+    if (!logger_open(&logger, path))
+        return;
+
+    sensor_reading_t r = {.sensor_id = 0};
+    for (size_t b = 0; b < WARMUP + g_batches; b++)
+    {
+        uint64_t t0 = clock_ns();
+        for (size_t i = 0; i < BATCH; i++)
+        {
+            r.timestamp = (uint32_t)(b * BATCH + i);
+            r.value     = g_values[i & (VALUES - 1)];
+            logger_write(&logger, &r, "Temperature (C)", ALERT_NONE);
+        }
+        uint64_t t1 = clock_ns();
+        if (b >= WARMUP)
+            g_samples[b - WARMUP] = per_op(t0, t1, BATCH);
+    }
+    record("logger_write", "file", BATCH, g_batches);
+
+    logger_close(&logger);
+    remove(path);
+}
+
+/* ============================================================================
+ * OUTPUT
+ * ========================================================================== */
+
+static bool write_csv(const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (f == NULL)
+    {
+        fprintf(stderr, "bench_micro: cannot write %s\n", path);
+        return false;
+    }
+    fprintf(f, "bench,param,batch,batches,mean_ns,p50_ns,p90_ns,p99_ns,p50_cycles\n");
+    for (size_t i = 0; i < g_result_count; i++)
+    {
+        const result_t *r = &g_results[i];
+        fprintf(f, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.2f\n", r->name, r->param,
+                r->batch, r->batches, r->mean_ns, r->p50_ns, r->p90_ns,
+                r->p99_ns, r->p50_cycles);
+    }
+    fclose(f);
+    return true;
+}
+
+/** p50 of the same case in a CSV written by -o, or a negative value */
+static double baseline_p50(FILE *f, const result_t *r)
+{
+    char line[256];
+    rewind(f);
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        char name[32], param[32];
+        double mean, p50;
+        if (sscanf(line, "%31[^,],%31[^,],%*u,%*u,%lf,%lf", name, param,
+                   &mean, &p50) == 4 &&
+            strcmp(name, r->name) == 0 && strcmp(param, r->param) == 0)
+            return p50;
+    }
+    return -1.0;
+}
+
+static void print_table(FILE *base)
+{
+    printf("\n%-16s %-12s %9s %9s %9s %9s %9s", "bench", "param",
+           "mean ns", "p50 ns", "p90 ns", "p99 ns", "p50 cyc");
+    printf(base ? " %9s\n" : "\n", "vs base");
+
+    for (size_t i = 0; i < g_result_count; i++)
+    {
+        const result_t *r = &g_results[i];
+        printf("%-16s %-12s %9.2f %9.2f %9.2f %9.2f %9.1f", r->name, r->param,
+               r->mean_ns, r->p50_ns, r->p90_ns, r->p99_ns, r->p50_cycles);
+        if (base != NULL)
+        {
+            double b = baseline_p50(base, r);
+            if (b > 0.0)
+            {
+                double ratio = r->p50_ns / b;
+                printf(" %+8.1f%%%s", (ratio - 1.0) * 100.0,
+                       ratio > REGRESSION ? "  SLOWER" : "");
+            }
+            else
+                printf(" %9s", "new");
+        }
+        printf("\n");
+    }
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(int argc, char **argv)
+{
+    const char *out  = NULL;
+    const char *base = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            base = argv[++i];
+        else
+            g_batches = strtoul(argv[i], NULL, 10);
+    }
+    if (g_batches < 16 || g_batches > MAX_BATCHES)
+    {
+        fprintf(stderr, "usage: %s [-o results.csv] [-c baseline.csv] [batches 16..%d]\n",
+                argv[0], MAX_BATCHES);
+        return 2;
+    }
+
+    calibrate();
+
+    static const size_t caps[] = {16, 256, 4096, 65536};
+    for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); i++)
+        bench_buffer(caps[i]);
+    for (size_t i = 0; i < sizeof(caps) / sizeof(caps[0]); i++)
+        bench_sensor(caps[i]);
+    for (uint8_t n = 1; n <= MANAGER_MAX_SENSORS; n *= 2)
+        bench_manager(n);
+    bench_threshold();
+    bench_logger("/tmp/bench_micro_log.csv");
+
+    printf("\n=== Layer microbenchmarks (%zu batches, clock %.0f ns",
+           g_batches, g_clock_ns);
+    if (g_cycles_per_ns > 0.0)
+        printf(", TSC %.2f GHz", g_cycles_per_ns);
+    printf(") ===");
+
+    FILE *bf = NULL;
+    if (base != NULL && (bf = fopen(base, "r")) == NULL)
+        printf("\n(no baseline at %s yet)", base);
+    print_table(bf);
+    if (bf != NULL)
+        fclose(bf);
+
+    if (out != NULL && !write_csv(out))
+        return 1;
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * @file bench_pool.c
+ * @brief Worker pool scaling benchmark with heavy per-sensor work
+ *
+ * Each reading runs the normal manager pipeline plus a hook that keeps a
+ * 64-sample window per sensor and computes its magnitude spectrum (naive
+ * DFT) every 16 readings - a stand-in for the FFT a vibration channel
+ * would need. One ingestion thread feeds 8 sensors; the pool is run with
+ * 1..N workers and the aggregate throughput is compared to one worker.
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_pool [max_workers] [readings]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/worker_pool.h"
+#include "../src/clock.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SENSORS   8
+#define WINDOW    64
+#define HOP       16
+#define REPS      3
+
+/** Per-sensor spectrum state, one cache line apart per sensor */
+typedef struct {
+    _Alignas(CACHE_LINE) float window[WINDOW];
+    float    spectrum[WINDOW / 2];
+    uint32_t pos;
+} spectrum_state_t;
+
+static void spectrum_hook(const sensor_t *s, const sensor_reading_t *r, void *ctx)
+{
+    spectrum_state_t *st = &((spectrum_state_t *)ctx)[r->sensor_id];
+
+    st->window[st->pos % WINDOW] = s->last_value;
+    if (++st->pos % HOP != 0)
+        return;
+
+    for (int k = 0; k < WINDOW / 2; k++)
+    {
+        float re = 0.0f, im = 0.0f;
+        for (int n = 0; n < WINDOW; n++)
+        {
+            float a = 6.2831853f * (float)(k * n) / WINDOW;
+            re += st->window[n] * cosf(a);
+            im -= st->window[n] * sinf(a);
+        }
+        st->spectrum[k] = re * re + im * im;
+    }
+}
+
+static double run(unsigned workers, uint32_t readings)
+{
+    double best = 1e30;
+
+    for (int rep = 0; rep < REPS; rep++)
+    {
+        worker_pool_t *pool = pool_create((uint8_t)workers, SENSORS, 4096);
+        for (uint8_t id = 0; id < SENSORS; id++)
+            pool_register(pool, id, "bench", 64);
+
+        spectrum_state_t *state = cache_alloc(sizeof(spectrum_state_t) * SENSORS);
+        for (int i = 0; i < SENSORS; i++)
+            state[i] = (spectrum_state_t){ .pos = 0 };
+        pool_set_hook(pool, spectrum_hook, state);
+        pool_start(pool);
+
+        uint64_t t0 = clock_ns();
+        for (uint32_t i = 0; i < readings; i++)
+        {
+            uint8_t id = (uint8_t)(i % SENSORS);
+            while (!pool_submit(pool, id, sinf((float)i * 0.01f), i))
+                ;                   /* back-pressure: retry */
+        }
+        pool_drain(pool);
+        double secs = (double)(clock_ns() - t0) / 1e9;
+        if (secs < best)
+            best = secs;
+
+        /*
+         * The ring buffers fill up after 64 readings per sensor; that is
+         * fine here - the hook and stats run regardless of storage.
+         */
+        pool_destroy(pool);
+        cache_free(state);
+    }
+
+    return readings / best;
+}
+
+int main(int argc, char **argv)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned max_workers = (argc > 1) ? (unsigned)atoi(argv[1])
+                                      : (unsigned)(cores > 0 ? cores : 1);
+    uint32_t readings    = (argc > 2) ? (uint32_t)atol(argv[2]) : 400000u;
+
+    if (max_workers < 1) max_workers = 1;
+    if (max_workers > POOL_MAX_WORKERS) max_workers = POOL_MAX_WORKERS;
+
+    if (freopen("/dev/null", "w", stdout) == NULL)
+        return 1;
+
+    double rate[POOL_MAX_WORKERS + 1];
+    for (unsigned w = 1; w <= max_workers; w++)
+        rate[w] = run(w, readings);
+
+    fprintf(stderr, "worker pool scaling: %u readings, %d sensors, "
+            "%d-point DFT every %d readings, best of %d\n",
+            readings, SENSORS, WINDOW, HOP, REPS);
+    fprintf(stderr, "%-8s %16s %8s\n", "workers", "readings/s", "speedup");
+    for (unsigned w = 1; w <= max_workers; w++)
+        fprintf(stderr, "%-8u %16.0f %7.2fx\n", w, rate[w], rate[w] / rate[1]);
+    return 0;
+}
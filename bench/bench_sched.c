@@ -0,0 +1,165 @@
+/**
+ * @file bench_sched.c
+ * @brief Static partitioning vs work stealing on a skewed sensor mix
+ *
+ * Models the predictive monitor: one 1 kHz vibration channel that needs a
+ * spectrum for every 64-sample window, next to slow channels (a DHT11
+ * every 2 s) that produce a window only now and then. Each window costs
+ * one 64-point DFT.
+ *
+ *   static - sensor i is processed entirely by thread i % N (what the
+ *            worker pool does); the vibration thread does nearly all work
+ *   ws     - each sensor's windows are one range task on the work-stealing
+ *            scheduler, split down to 8 windows and stolen by idle workers
+ *
+ * Build:  make bench
+ * Run:    ./build/bench_sched [workers]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/scheduler.h"
+#include "../src/clock.h"
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SENSORS      8
+#define WINDOW       64
+#define VIB_WINDOWS  4096   /* ~4 min of 1 kHz vibration */
+#define SLOW_WINDOWS 2      /* DHT11 / pressure channels */
+#define GRAIN        8
+
+typedef struct {
+    float  *samples;        ///< windows * WINDOW samples
+    float  *spectrum;       ///< windows * WINDOW/2 bins
+    size_t  windows;
+} channel_t;
+
+static channel_t g_ch[SENSORS];
+
+static void spectrum_windows(void *ctx, size_t begin, size_t end, unsigned worker)
+{
+    channel_t *ch = ctx;
+    (void)worker;
+
+    for (size_t w = begin; w < end; w++)
+    {
+        const float *x = &ch->samples[w * WINDOW];
+        float *out = &ch->spectrum[w * (WINDOW / 2)];
+        for (int k = 0; k < WINDOW / 2; k++)
+        {
+            float re = 0.0f, im = 0.0f;
+            for (int n = 0; n < WINDOW; n++)
+            {
+                float a = 6.2831853f * (float)(k * n) / WINDOW;
+                re += x[n] * cosf(a);
+                im -= x[n] * sinf(a);
+            }
+            out[k] = re * re + im * im;
+        }
+    }
+}
+
+/* ---- Static partitioning baseline ---- */
+
+typedef struct {
+    unsigned index, workers;
+    uint64_t busy_ns;
+} static_arg_t;
+
+static void *static_worker(void *p)
+{
+    static_arg_t *a = p;
+    uint64_t t0 = clock_ns();
+    for (unsigned s = a->index; s < SENSORS; s += a->workers)
+        spectrum_windows(&g_ch[s], 0, g_ch[s].windows, a->index);
+    a->busy_ns = clock_ns() - t0;
+    return NULL;
+}
+
+static double run_static(unsigned workers, double *util)
+{
+    pthread_t    th[WS_MAX_WORKERS];
+    static_arg_t args[WS_MAX_WORKERS];
+
+    uint64_t t0 = clock_ns();
+    for (unsigned i = 0; i < workers; i++)
+    {
+        args[i] = (static_arg_t){ i, workers, 0 };
+        pthread_create(&th[i], NULL, static_worker, &args[i]);
+    }
+    for (unsigned i = 0; i < workers; i++)
+        pthread_join(th[i], NULL);
+    double secs = (double)(clock_ns() - t0) / 1e9;
+
+    for (unsigned i = 0; i < workers; i++)
+        util[i] = (double)args[i].busy_ns / 1e9 / secs;
+    return secs;
+}
+
+static double run_ws(ws_scheduler_t *ws, double *util, uint64_t *steals)
+{
+    ws_reset_stats(ws);
+    uint64_t t0 = clock_ns();
+    for (unsigned s = 0; s < SENSORS; s++)
+        ws_submit(ws, spectrum_windows, &g_ch[s], 0, g_ch[s].windows, GRAIN);
+    ws_wait(ws);
+    double secs = (double)(clock_ns() - t0) / 1e9;
+
+    for (unsigned i = 0; i < ws->worker_count; i++)
+    {
+        ws_worker_stats_t st;
+        ws_get_stats(ws, i, &st);
+        util[i]   = (double)st.busy_ns / 1e9 / secs;
+        steals[i] = st.steals;
+    }
+    return secs;
+}
+
+int main(int argc, char **argv)
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned workers = (argc > 1) ? (unsigned)atoi(argv[1])
+                                  : (unsigned)(cores > 1 ? cores : 4);
+    if (workers < 1) workers = 1;
+    if (workers > WS_MAX_WORKERS) workers = WS_MAX_WORKERS;
+
+    for (unsigned s = 0; s < SENSORS; s++)
+    {
+        channel_t *ch = &g_ch[s];
+        ch->windows  = (s == 0) ? VIB_WINDOWS : SLOW_WINDOWS;
+        ch->samples  = malloc(ch->windows * WINDOW * sizeof(float));
+        ch->spectrum = malloc(ch->windows * (WINDOW / 2) * sizeof(float));
+        for (size_t i = 0; i < ch->windows * WINDOW; i++)
+            ch->samples[i] = sinf((float)i * 0.05f * (float)(s + 1));
+    }
+
+    double u_static[WS_MAX_WORKERS], u_ws[WS_MAX_WORKERS];
+    uint64_t steals[WS_MAX_WORKERS];
+
+    double t_static = run_static(workers, u_static);
+    ws_scheduler_t *ws = ws_create(workers);
+    run_ws(ws, u_ws, steals);                       /* warm-up */
+    double t_ws = run_ws(ws, u_ws, steals);
+    ws_destroy(ws);
+
+    printf("skewed workload: %d sensors, %d + %d x %d windows of %d-point DFT, %u workers\n",
+           SENSORS, VIB_WINDOWS, SENSORS - 1, SLOW_WINDOWS, WINDOW, workers);
+    printf("  static partition : %8.3f s\n", t_static);
+    printf("  work stealing    : %8.3f s  (%.2fx)\n", t_ws, t_static / t_ws);
+    printf("  %-6s %12s %12s %8s\n", "worker", "static util", "ws util", "steals");
+    for (unsigned i = 0; i < workers; i++)
+        printf("  %-6u %11.1f%% %11.1f%% %8" PRIu64 "\n", i,
+               u_static[i] * 100.0, u_ws[i] * 100.0, steals[i]);
+
+    for (unsigned s = 0; s < SENSORS; s++)
+    {
+        free(g_ch[s].samples);
+        free(g_ch[s].spectrum);
+    }
+    return 0;
+}
@@ -9,7 +9,12 @@ param(
 )
 
 $CFLAGS = "-Wall -Wextra -Werror -std=c11 -g"
-$CORE = "src/buffer.c src/sensors.c src/sensor_manager.c src/logger.c"
+$DIAG = "src/diag.c"
+$TIMING = "src/histogram.c src/stage_timing.c"
+$WATCHDOG = "src/timer_wheel.c src/watchdog.c"
+$CORE = "$DIAG $TIMING $WATCHDOG src/arena.c src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c src/rollup.c src/sensor_manager.c src/sharded_manager.c src/spsc.c src/worker_pool.c src/logger.c"
+$REPLAY = "src/csv_parser.c src/csv_bulk.c src/frame.c src/replay.c"
+$SAMPLER = "src/sampler.c"
 
 Write-Host "=== Sensor Data Logger Build Script ===" -ForegroundColor Cyan
 Write-Host "Project: $PSScriptRoot" -ForegroundColor Gray
@@ -63,17 +68,67 @@ function RunCompile {
 }
 
 if (-not $TestOnly) {
-    $exitCode = RunCompile "Main app       -> build/sensor_logger.exe" "gcc $CORE src/main.c -o build/sensor_logger.exe $CFLAGS"
+    $exitCode = RunCompile "Main app       -> build/sensor_logger.exe" "gcc $CORE $REPLAY $SAMPLER src/config.c src/main.c -o build/sensor_logger.exe $CFLAGS -lm -pthread"
     if ($exitCode -ne 0) { $allOk = $false }
 }
 
-$exitCode = RunCompile "Tests (buffer) -> build/test_buffer.exe" "gcc src/buffer.c tests/test_buffer.c -o build/test_buffer.exe $CFLAGS"
+$exitCode = RunCompile "Tests (buffer) -> build/test_buffer.exe" "gcc $DIAG src/arena.c src/buffer.c tests/test_buffer.c -o build/test_buffer.exe $CFLAGS"
 if ($exitCode -ne 0) { $allOk = $false }
 
-$exitCode = RunCompile "Tests (sensor) -> build/test_sensor.exe" "gcc src/buffer.c src/sensors.c tests/test_sensor.c -o build/test_sensor.exe $CFLAGS -lm"
+$exitCode = RunCompile "Tests (sensor) -> build/test_sensor.exe" "gcc $DIAG $TIMING src/arena.c src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c tests/test_sensor.c -o build/test_sensor.exe $CFLAGS -lm"
 if ($exitCode -ne 0) { $allOk = $false }
 
-$exitCode = RunCompile "Tests (manager)-> build/test_manager.exe" "gcc src/buffer.c src/sensors.c src/sensor_manager.c tests/test_manager.c -o build/test_manager.exe $CFLAGS -lm"
+$exitCode = RunCompile "Tests (manager)-> build/test_manager.exe" "gcc $DIAG $TIMING src/arena.c src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c src/rollup.c src/sensor_manager.c $WATCHDOG tests/test_manager.c -o build/test_manager.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (rollup) -> build/test_rollup.exe" "gcc $DIAG src/rollup.c tests/test_rollup.c -o build/test_rollup.exe $CFLAGS -lm"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (query)  -> build/test_query.exe" "gcc src/lttb.c src/query.c tests/test_query.c -o build/test_query.exe $CFLAGS -lm"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (bcast)  -> build/test_broadcast.exe" "gcc src/broadcast.c tests/test_broadcast.c -o build/test_broadcast.exe $CFLAGS -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (shards) -> build/test_sharded.exe" "gcc $CORE tests/test_sharded.c -o build/test_sharded.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (pool)   -> build/test_pool.exe" "gcc $CORE tests/test_pool.c -o build/test_pool.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (sched)  -> build/test_scheduler.exe" "gcc $DIAG src/scheduler.c tests/test_scheduler.c -o build/test_scheduler.exe $CFLAGS -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (csv)    -> build/test_csv_parser.exe" "gcc src/csv_parser.c tests/test_csv_parser.c -o build/test_csv_parser.exe $CFLAGS -lm"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (frame)  -> build/test_frame.exe" "gcc src/frame.c tests/test_frame.c -o build/test_frame.exe $CFLAGS -lm"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (bulk)   -> build/test_csv_bulk.exe" "gcc $DIAG src/csv_parser.c src/csv_bulk.c tests/test_csv_bulk.c -o build/test_csv_bulk.exe $CFLAGS -lm"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (replay) -> build/test_replay.exe" "gcc $CORE $REPLAY tests/test_replay.c -o build/test_replay.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (hist)   -> build/test_histogram.exe" "gcc $DIAG $TIMING tests/test_histogram.c -o build/test_histogram.exe $CFLAGS -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (diag)   -> build/test_diag.exe" "gcc $DIAG src/arena.c src/buffer.c tests/test_diag.c -o build/test_diag.exe $CFLAGS"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (config) -> build/test_config.exe" "gcc $CORE src/config.c tests/test_config.c -o build/test_config.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (sampler)-> build/test_sampler.exe" "gcc $CORE $SAMPLER tests/test_sampler.c -o build/test_sampler.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+$exitCode = RunCompile "Tests (wdog)   -> build/test_watchdog.exe" "gcc $CORE tests/test_watchdog.c -o build/test_watchdog.exe $CFLAGS -lm -pthread"
+if ($exitCode -ne 0) { $allOk = $false }
+
+# sensor_ingestd / test_ingest use epoll and ptys, test_metrics POSIX sockets: Linux only (see Makefile)
+
+$exitCode = RunCompile "Query library  -> build/libsensorquery.dll" "gcc src/lttb.c src/query.c -shared -O2 -o build/libsensorquery.dll $CFLAGS"
 if ($exitCode -ne 0) { $allOk = $false }
 
 if (-not $allOk) {
@@ -119,6 +174,51 @@ if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
 RunExe "Sensor Manager Test Suite" ".\build\test_manager.exe"
 if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
 
+RunExe "Rollup Test Suite"         ".\build\test_rollup.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Query / LTTB Test Suite"   ".\build\test_query.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Broadcast Ring Test Suite" ".\build\test_broadcast.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Sharded Manager Test Suite" ".\build\test_sharded.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Worker Pool Test Suite"    ".\build\test_pool.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Scheduler Test Suite"      ".\build\test_scheduler.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "CSV Parser Test Suite"     ".\build\test_csv_parser.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Frame Protocol Test Suite" ".\build\test_frame.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Bulk CSV Reader Test Suite" ".\build\test_csv_bulk.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Replay Test Suite"         ".\build\test_replay.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Histogram Test Suite"      ".\build\test_histogram.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Diagnostics Test Suite"    ".\build\test_diag.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Config Loader Test Suite"  ".\build\test_config.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Sampler Test Suite"        ".\build\test_sampler.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
+RunExe "Watchdog Test Suite"       ".\build\test_watchdog.exe"
+if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
+
 if (-not $TestOnly) {
     RunExe "Predictive Maintenance Monitor" ".\build\sensor_logger.exe"
     if ($LASTEXITCODE -ne 0) { $anyFailed = $true }
@@ -10,18 +10,29 @@ Works in two modes:
     python dashboard/dashboard.py --serial COM3
     (replace COM3 with your actual Arduino port)
 
+Threshold lines come from the same configuration file the C side loads
+(config/monitor.ini in CSV mode, config/board.ini in serial mode, or
+--config FILE). Without one the built-in THRESHOLDS below are used.
+
 To find your Arduino port:
   Windows: Device Manager -> Ports (COM & LPT) -> Arduino Uno (COMx)
   Or: Arduino IDE -> Tools -> Port
 
 Requirements:
     pip install matplotlib pandas pyserial
+
+Optional (much faster on long logs):
+    make lib      builds build/libsensorquery.so (.dll on Windows), which
+                  downsamples each sensor in C with LTTB so every chart
+                  draws at most MAX_POINTS points.
 """
 
 import os
 import sys
+import ctypes
 import argparse
 import threading
+import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
 import matplotlib.animation as animation
@@ -35,9 +46,17 @@ CSV_PATH    = "data/sensor_log.csv"   # Phase 2 CSV from C program
 SERIAL_CSV  = "data/serial_log.csv"   # Phase 3 CSV written from serial
 BAUD_RATE   = 9600                     # Must match Serial.begin() in Arduino
 REFRESH_MS  = 5000                     # Dashboard refresh interval
+MAX_POINTS  = 800                      # Points per chart (~plot width in px)
+
+QUERY_LIBS  = ["build/libsensorquery.so", "build/libsensorquery.dll"]
+ALERT_NAMES = ["NONE", "WARNING", "CRITICAL"]   # alert_level_t order
 
+MONITOR_CONFIG = "config/monitor.ini"
+BOARD_CONFIG   = "config/board.ini"
+
+# Fallback when no configuration file is found
 THRESHOLDS = {
-    "Temperature C": {
+    "Temperature (C)": {
         "Warn High (70C)":      70.0,
         "Critical High (85C)":  85.0,
     },
@@ -55,6 +74,48 @@ THRESHOLDS = {
     },
 }
 
+LIMIT_LABELS = [("warn_low",      "Warn Low"),
+                ("warn_high",     "Warn High"),
+                ("critical_low",  "Critical Low"),
+                ("critical_high", "Critical High")]
+
+def load_thresholds(path):
+    """
+    Read the threshold lines for each sensor name from a configuration
+    file (src/config.h describes the format). Only [sensor.N] sections
+    and their name / limit keys matter here; the C loader validates the
+    rest. Returns None if the file does not exist.
+    """
+    if not os.path.exists(path):
+        return None
+
+    sensors, current = [], None
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line[0] in "#;":
+                continue
+            if line.startswith("["):
+                current = {} if line.startswith("[sensor.") else None
+                if current is not None:
+                    sensors.append(current)
+                continue
+            if current is None or "=" not in line:
+                continue
+            key, value = (part.strip() for part in line.split("=", 1))
+            current[key] = value.strip('"')
+
+    thresholds = {}
+    for sensor in sensors:
+        limits = {}
+        for key, label in LIMIT_LABELS:
+            if key in sensor:
+                value = float(sensor[key])
+                limits[f"{label} ({value:g})"] = value
+        if limits and "name" in sensor:
+            thresholds[sensor["name"]] = limits
+    return thresholds
+
 COLOURS = {
     "NONE":     "#2196F3",
     "WARNING":  "#FF9800",
@@ -143,6 +204,51 @@ def load_csv(path):
     except Exception:
         return pd.DataFrame()
 
+# =============================================================================
+# C QUERY LIBRARY (LTTB downsampling)
+# =============================================================================
+
+def load_query_lib():
+    """Load libsensorquery if it has been built, else return None."""
+    for path in QUERY_LIBS:
+        if not os.path.exists(path):
+            continue
+        try:
+            lib = ctypes.CDLL(os.path.abspath(path))
+        except OSError:
+            continue
+        lib.query_lttb.restype  = ctypes.c_uint32
+        lib.query_lttb.argtypes = [
+            ctypes.c_char_p, ctypes.c_uint8,
+            ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32,
+            ctypes.POINTER(ctypes.c_uint32),
+            ctypes.POINTER(ctypes.c_float),
+            ctypes.POINTER(ctypes.c_uint8),
+        ]
+        return lib
+    return None
+
+query_lib = load_query_lib()
+
+def downsample(csv_path, sensor_id, sensor_df):
+    """
+    Return (timestamps, values, alert_names) with at most MAX_POINTS rows.
+    Uses the C library when available; otherwise plots every row.
+    """
+    if query_lib is None or len(sensor_df) <= MAX_POINTS:
+        return (sensor_df["timestamp"].values,
+                sensor_df["value"].values,
+                sensor_df["alert_level"].astype(str).values)
+
+    ts     = (ctypes.c_uint32 * MAX_POINTS)()
+    vals   = (ctypes.c_float  * MAX_POINTS)()
+    alerts = (ctypes.c_uint8  * MAX_POINTS)()
+    n = query_lib.query_lttb(csv_path.encode(), sensor_id,
+                             0, 0xFFFFFFFF, MAX_POINTS, ts, vals, alerts)
+    names = [ALERT_NAMES[a] if a < len(ALERT_NAMES) else "NONE"
+             for a in alerts[:n]]
+    return np.array(ts[:n]), np.array(vals[:n]), np.array(names)
+
 # =============================================================================
 # LEGEND
 # =============================================================================
@@ -188,34 +294,39 @@ def make_updater(fig, axes, csv_path):
                 ax.set_title(f"{name} - No readings yet", color="gray")
                 continue
 
-            timestamps = sensor_df["timestamp"].values
-            values     = sensor_df["value"].values
-            alerts     = sensor_df["alert_level"].values
-
-            for i in range(len(timestamps)):
-                colour = COLOURS.get(str(alerts[i]), COLOURS["NONE"])
-                ax.plot(timestamps[i], values[i], "o",
-                        color=colour, markersize=5, zorder=3)
-                if i > 0:
-                    ax.plot([timestamps[i-1], timestamps[i]],
-                            [values[i-1],     values[i]],
-                            color=colour, linewidth=1.5, zorder=2)
-                if str(alerts[i]) != "NONE":
-                    last_alert = f"{name}: {alerts[i]} ({values[i]:.2f})"
+            sensor_id = int(sensor_df["sensor_id"].iloc[0])
+            timestamps, values, alerts = downsample(csv_path, sensor_id,
+                                                    sensor_df)
+
+            # One line + one scatter per alert level: O(1) matplotlib
+            # calls per chart instead of O(n)
+            ax.plot(timestamps, values, color=COLOURS["NONE"],
+                    linewidth=1.5, zorder=2)
+            for level, colour in COLOURS.items():
+                mask = (alerts == level)
+                if mask.any():
+                    ax.scatter(timestamps[mask], values[mask], s=20,
+                               color=colour, zorder=3)
+
+            flagged = sensor_df[sensor_df["alert_level"] != "NONE"]
+            if not flagged.empty:
+                row = flagged.iloc[-1]
+                last_alert = (f"{name}: {row['alert_level']} "
+                              f"({row['value']:.2f})")
 
             if name in THRESHOLDS:
                 styles  = ["--", ":",  "-.", "-"]
-                colours = [COLOURS["WARNING"], COLOURS["CRITICAL"],
-                           COLOURS["WARNING"], COLOURS["CRITICAL"]]
                 for j, (label, threshold) in enumerate(
                         THRESHOLDS[name].items()):
+                    level = "CRITICAL" if label.startswith("Critical") \
+                            else "WARNING"
                     ax.axhline(y=threshold,
-                               color=colours[j % len(colours)],
+                               color=COLOURS[level],
                                linestyle=styles[j % len(styles)],
                                linewidth=1.2, alpha=0.7, label=label)
 
-            latest_val   = values[-1]
-            latest_alert = str(alerts[-1])
+            latest_val   = sensor_df["value"].values[-1]
+            latest_alert = str(sensor_df["alert_level"].values[-1])
             alert_colour = COLOURS.get(latest_alert, COLOURS["NONE"])
 
             ax.set_title(
@@ -251,8 +362,16 @@ if __name__ == "__main__":
     parser = argparse.ArgumentParser(description="Sensor Data Dashboard")
     parser.add_argument("--serial", metavar="PORT",
                         help="Arduino port e.g. --serial COM3")
+    parser.add_argument("--config", metavar="INI",
+                        help="sensor configuration for the threshold lines")
     args = parser.parse_args()
 
+    config = args.config or (BOARD_CONFIG if args.serial else MONITOR_CONFIG)
+    loaded = load_thresholds(config)
+    if loaded is not None:
+        THRESHOLDS = loaded
+        print(f"[DASHBOARD] Thresholds from {config}")
+
     try:
         import matplotlib
         import pandas
@@ -276,6 +395,11 @@ if __name__ == "__main__":
         print(f"[DASHBOARD] CSV mode  ({csv_path})")
         print("[DASHBOARD] For Arduino: python dashboard/dashboard.py --serial COM3")
 
+    if query_lib is not None:
+        print(f"[DASHBOARD] LTTB downsampling on (max {MAX_POINTS} points/chart)")
+    else:
+        print("[DASHBOARD] Plotting every row - run 'make lib' to downsample")
+
     print(f"[DASHBOARD] Refreshing every {REFRESH_MS // 1000}s - close window to stop")
 
     fig, axes = plt.subplots(3, 1, figsize=(12, 9))
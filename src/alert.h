@@ -0,0 +1,64 @@
+/**
+ * @file alert.h
+ * @brief Alert types shared by the sensor and manager layers
+ *
+ * Lives below both layers so that the sensor layer can raise alerts
+ * (e.g. from the anomaly detector) without knowing about the manager.
+ */
+
+#ifndef ALERT_H
+#define ALERT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Alert severity levels
+ *
+ * NONE    - everything normal
+ * WARNING - value approaching a threshold (early warning)
+ * CRITICAL- threshold crossed, action required
+ */
+typedef enum
+{
+    ALERT_NONE = 0,
+    ALERT_WARNING = 1,
+    ALERT_CRITICAL = 2
+} alert_level_t;
+
+/**
+ * @brief One alert event — what happened and when
+ */
+typedef struct
+{
+    uint8_t sensor_id;   ///< Which sensor triggered this
+    alert_level_t level; ///< WARNING or CRITICAL
+    float value;         ///< The value that triggered it
+    uint32_t timestamp;  ///< When it happened
+} alert_event_t;
+
+/**
+ * @brief Threshold configuration for one sensor
+ *
+ * Set warn_high / warn_low to 0 to disable warning thresholds.
+ * Set critical_high / critical_low to 0 to disable critical thresholds.
+ *
+ * Example for a temperature sensor (Celsius):
+ *   warn_low     = 0.0f    (below 0 is unusual)
+ *   warn_high    = 60.0f   (above 60 is getting hot)
+ *   critical_low = -10.0f  (below -10 is a fault)
+ *   critical_high= 85.0f   (above 85 is dangerous)
+ *
+ * Defined here rather than in sensor_manager.h because each sensor_t
+ * keeps its limits next to the rest of its per-reading state.
+ */
+typedef struct
+{
+    float warn_low;      ///< Warning if value drops below this
+    float warn_high;     ///< Warning if value exceeds this
+    float critical_low;  ///< Critical if value drops below this
+    float critical_high; ///< Critical if value exceeds this
+    bool enabled;        ///< false = ignore thresholds for this sensor
+} sensor_threshold_t;
+
+#endif /* ALERT_H */
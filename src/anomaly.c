@@ -0,0 +1,96 @@
+/**
+ * @file anomaly.c
+ * @brief EWMA z-score and CUSUM anomaly detector
+ *
+ * The z-score test compares squared quantities so no sqrt is needed:
+ *
+ *   |x - mean| / sigma > z   <=>   (x - mean)^2 > z^2 * var
+ *
+ * Each reading is scored against the baseline learned from the readings
+ * BEFORE it, then folded into that baseline. The variance used for the
+ * score is floored at min_sigma^2; the learned one is left as it is.
+ */
+
+#include "anomaly.h"
+#include <string.h>
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void anomaly_init(anomaly_detector_t *det, const anomaly_config_t *cfg)
+{
+    if (det == NULL)
+        return;
+
+    memset(det, 0, sizeof(*det));
+    if (cfg == NULL)
+        return;             /* zeroed config = disabled */
+
+    det->cfg       = *cfg;
+    det->z_warn_sq = cfg->z_warn * cfg->z_warn;
+    det->z_crit_sq = cfg->z_critical * cfg->z_critical;
+    det->min_var   = cfg->min_sigma * cfg->min_sigma;
+}
+
+void anomaly_reset(anomaly_detector_t *det)
+{
+    if (det == NULL)
+        return;
+
+    det->mean         = 0.0f;
+    det->var          = 0.0f;
+    det->cusum_pos    = 0.0f;
+    det->cusum_neg    = 0.0f;
+    det->sample_count = 0;
+}
+
+alert_level_t anomaly_update(anomaly_detector_t *det, float value)
+{
+    if (det == NULL || !det->cfg.enabled)
+        return ALERT_NONE;
+
+    /* First sample seeds the baseline */
+    if (det->sample_count == 0) {
+        det->mean         = value;
+        det->sample_count = 1;
+        return ALERT_NONE;
+    }
+
+    float dev    = value - det->mean;
+    float dev_sq = dev * dev;
+    alert_level_t level = ALERT_NONE;
+
+    if (det->sample_count >= det->cfg.warmup) {
+        float var = (det->var > det->min_var) ? det->var : det->min_var;
+        if (det->z_crit_sq > 0.0f && dev_sq > det->z_crit_sq * var)
+            level = ALERT_CRITICAL;
+        else if (det->z_warn_sq > 0.0f && dev_sq > det->z_warn_sq * var)
+            level = ALERT_WARNING;
+
+        if (det->cfg.cusum_h > 0.0f) {
+            float pos = det->cusum_pos + dev - det->cfg.cusum_k;
+            float neg = det->cusum_neg - dev - det->cfg.cusum_k;
+            det->cusum_pos = (pos > 0.0f) ? pos : 0.0f;
+            det->cusum_neg = (neg > 0.0f) ? neg : 0.0f;
+
+            if (det->cusum_pos > det->cfg.cusum_h ||
+                det->cusum_neg > det->cfg.cusum_h) {
+                if (level == ALERT_NONE)
+                    level = ALERT_WARNING;
+                /* Restart accumulation so one drift = one alert */
+                det->cusum_pos = 0.0f;
+                det->cusum_neg = 0.0f;
+            }
+        }
+    }
+
+    /* Fold the reading into the baseline (West's EWMA variance) */
+    det->mean += det->cfg.alpha * dev;
+    det->var   = (1.0f - det->cfg.alpha) * (det->var + det->cfg.alpha * dev_sq);
+
+    if (det->sample_count < UINT32_MAX)
+        det->sample_count++;
+
+    return level;
+}
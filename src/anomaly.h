@@ -0,0 +1,79 @@
+/**
+ * @file anomaly.h
+ * @brief Statistical anomaly detection for a single sensor stream
+ *
+ * Static thresholds only catch values that leave a fixed band. This
+ * detector learns a baseline instead:
+ *
+ *   - EWMA mean / variance  -> flags sudden jumps via a z-score
+ *   - Two-sided CUSUM       -> flags slow drifts that never trip the z-score
+ *
+ * Every update is O(1) with no divisions or square roots, so it is cheap
+ * enough to run on every reading of every sensor.
+ */
+
+#ifndef ANOMALY_H
+#define ANOMALY_H
+
+#include "alert.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Detector tuning
+ *
+ * Set z_warn / z_critical / cusum_h to 0 to disable that check.
+ *
+ * Example for a temperature sensor (Celsius):
+ *   alpha      = 0.05f   (baseline follows ~20 samples)
+ *   z_warn     = 3.0f    (3 sigma jump = warning)
+ *   z_critical = 5.0f    (5 sigma jump = critical)
+ *   cusum_k    = 0.5f    (ignore drift below 0.5 C per sample)
+ *   cusum_h    = 5.0f    (5 C of accumulated drift = warning)
+ *   min_sigma  = 1.0f    (DHT11 resolution: never score against less)
+ *   warmup     = 20      (learn for 20 samples before flagging)
+ *
+ * min_sigma floors the learned spread. A quantised sensor that sat on
+ * one value through warm-up has a variance of exactly 0, and without a
+ * floor its first one-step change would be an infinite z-score. Set it
+ * to about the sensor's resolution; 0 means no floor.
+ */
+typedef struct {
+    float    alpha;         ///< EWMA smoothing factor, 0 < alpha < 1
+    float    z_warn;        ///< |z| above this raises WARNING
+    float    z_critical;    ///< |z| above this raises CRITICAL
+    float    cusum_k;       ///< CUSUM slack per sample (sensor units)
+    float    cusum_h;       ///< CUSUM decision limit (sensor units)
+    float    min_sigma;     ///< Smallest sigma the z-score uses (sensor units)
+    uint32_t warmup;        ///< Samples to learn before flagging anything
+    bool     enabled;       ///< false = detector is a no-op
+} anomaly_config_t;
+
+/**
+ * @brief Detector state — embed one per sensor, no heap needed
+ */
+typedef struct {
+    anomaly_config_t cfg;   ///< Active tuning
+    float    z_warn_sq;     ///< z_warn^2, precomputed
+    float    z_crit_sq;     ///< z_critical^2, precomputed
+    float    min_var;       ///< min_sigma^2, precomputed
+    float    mean;          ///< EWMA mean
+    float    var;           ///< EWMA variance
+    float    cusum_pos;     ///< Upward cumulative deviation
+    float    cusum_neg;     ///< Downward cumulative deviation
+    uint32_t sample_count;  ///< Samples seen since last reset
+} anomaly_detector_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void          anomaly_init(anomaly_detector_t *det, const anomaly_config_t *cfg);
+void          anomaly_reset(anomaly_detector_t *det);
+alert_level_t anomaly_update(anomaly_detector_t *det, float value);
+
+#endif /* ANOMALY_H */
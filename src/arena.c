@@ -0,0 +1,150 @@
+/**
+ * @file arena.c
+ * @brief Bump allocator implementation
+ *
+ * The arena_t header sits in the first cache line of its own
+ * reservation, so an arena is exactly one system allocation and
+ * arena_destroy() exactly one release.
+ */
+
+#define _DEFAULT_SOURCE     /* MAP_ANONYMOUS, MAP_HUGETLB, madvise */
+
+#include "arena.h"
+#include "diag.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+/** Bytes the header occupies at the front of the reservation */
+#define ARENA_HEADER    ((sizeof(arena_t) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1))
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static size_t round_up(size_t n, size_t to)
+{
+    return (n + to - 1) & ~(to - 1);
+}
+
+/** Map `*total` bytes; on success *backing says how and *total may grow */
+static void *map_region(size_t *total, unsigned flags, arena_backing_t *backing)
+{
+#ifdef __linux__
+    if (flags & ARENA_HUGEPAGES)
+    {
+#ifdef MAP_HUGETLB
+        size_t huge = round_up(*total, ARENA_HUGEPAGE_SIZE);
+        void *p = mmap(NULL, huge, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+        {
+            *total   = huge;
+            *backing = ARENA_BACKING_HUGETLB;
+            return p;
+        }
+#endif
+        /* No reserved huge pages: ordinary mapping, ask for THP */
+        void *q = mmap(NULL, *total, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (q != MAP_FAILED)
+        {
+#ifdef MADV_HUGEPAGE
+            madvise(q, *total, MADV_HUGEPAGE);
+#endif
+            *backing = ARENA_BACKING_MMAP;
+            return q;
+        }
+    }
+#else
+    (void)flags;
+#endif
+
+    void *h = cache_alloc(*total);
+    if (h != NULL)
+        memset(h, 0, *total);
+    *backing = ARENA_BACKING_HEAP;
+    return h;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+arena_t *arena_create(size_t size, unsigned flags)
+{
+    if (size == 0 || size > SIZE_MAX / 2)
+        return NULL;
+
+    size_t total = ARENA_HEADER + round_up(size, CACHE_LINE);
+    arena_backing_t backing;
+    unsigned char *region = map_region(&total, flags, &backing);
+    if (region == NULL)
+    {
+        DIAG_ERROR("ARENA", "Cannot reserve %zu bytes", total);
+        return NULL;
+    }
+
+    arena_t *a  = (arena_t *)region;
+    a->base     = region + ARENA_HEADER;
+    a->size     = total - ARENA_HEADER;
+    a->used     = 0;
+    a->backing  = backing;
+
+    DIAG_DEBUG("ARENA", "Reserved %zu bytes (%s)", a->size, arena_backing_name(a));
+    return a;
+}
+
+void arena_destroy(arena_t *arena)
+{
+    if (arena == NULL)
+        return;
+
+#ifdef __linux__
+    if (arena->backing != ARENA_BACKING_HEAP)
+    {
+        munmap(arena, ARENA_HEADER + arena->size);
+        return;
+    }
+#endif
+    cache_free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+    if (arena == NULL)
+        return NULL;
+
+    /* size and used are CACHE_LINE multiples, so rounding cannot overrun */
+    if (size == 0)
+        size = 1;
+    if (size > arena->size - arena->used)
+        return NULL;
+
+    void *p = arena->base + arena->used;
+    arena->used += round_up(size, CACHE_LINE);
+    return p;
+}
+
+size_t arena_remaining(const arena_t *arena)
+{
+    return arena != NULL ? arena->size - arena->used : 0;
+}
+
+bool arena_contains(const arena_t *arena, const void *p)
+{
+    if (arena == NULL || p == NULL)
+        return false;
+
+    uintptr_t u = (uintptr_t)p, b = (uintptr_t)arena->base;
+    return u >= b && u < b + arena->size;
+}
+
+const char *arena_backing_name(const arena_t *arena)
+{
+    static const char *const k_names[] = {"heap", "mmap", "hugetlb"};
+    return arena != NULL ? k_names[arena->backing] : "none";
+}
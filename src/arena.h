@@ -0,0 +1,90 @@
+/**
+ * @file arena.h
+ * @brief Fixed-size bump allocator with cache-line aligned blocks
+ *
+ * One reservation up front, then every allocation is a pointer bump
+ * rounded to CACHE_LINE. Nothing is freed on its own: the whole arena is
+ * released at once by arena_destroy(). The manager uses one to keep
+ * itself and every sensor's ring header and storage side by side in
+ * memory instead of scattered over the heap:
+ *
+ *   arena_t *a = arena_create(64 * 1024, ARENA_HUGEPAGES);
+ *   ring_buffer_t *rb = buffer_create_in(a, 256);
+ *   ...
+ *   arena_destroy(a);                        everything in it is gone
+ *
+ * ARENA_HUGEPAGES asks for huge-page backing on Linux: an explicit
+ * MAP_HUGETLB mapping if the system has huge pages reserved, otherwise
+ * an ordinary mapping with a transparent huge page hint. Elsewhere (and
+ * if mmap fails) the arena is plain cache-line aligned heap memory.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "cacheline.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief arena_create() flag: back the arena with huge pages if possible */
+#define ARENA_HUGEPAGES     0x1u
+
+/** @brief Huge page size assumed when rounding a MAP_HUGETLB request */
+#define ARENA_HUGEPAGE_SIZE (2u * 1024u * 1024u)
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief How the arena's memory was obtained
+ */
+typedef enum {
+    ARENA_BACKING_HEAP = 0,     ///< cache_alloc()
+    ARENA_BACKING_MMAP,         ///< Anonymous mapping (THP hint given)
+    ARENA_BACKING_HUGETLB       ///< Explicit huge pages (MAP_HUGETLB)
+} arena_backing_t;
+
+typedef struct {
+    unsigned char  *base;       ///< Start of the reservation
+    size_t          size;       ///< Bytes reserved (>= requested)
+    size_t          used;       ///< Bytes handed out, CACHE_LINE multiple
+    arena_backing_t backing;    ///< What arena_destroy() must release
+} arena_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Reserve `size` bytes (rounded up to CACHE_LINE), zero-filled.
+ * @param flags  0 or ARENA_HUGEPAGES
+ * @return NULL if size is 0 or memory is unavailable
+ */
+arena_t *arena_create(size_t size, unsigned flags);
+
+/** @brief Release the arena and every block in it (NULL is safe) */
+void     arena_destroy(arena_t *arena);
+
+/**
+ * @brief Bump-allocate `size` bytes on a cache-line boundary.
+ *
+ * Blocks are zeroed and consecutive calls return adjacent blocks.
+ * @return NULL if the arena is NULL or has not enough room left
+ */
+void    *arena_alloc(arena_t *arena, size_t size);
+
+/** @brief Bytes still available, counting whole cache lines */
+size_t   arena_remaining(const arena_t *arena);
+
+/** @brief Whether `p` points into the arena's reservation */
+bool     arena_contains(const arena_t *arena, const void *p);
+
+/** @brief "heap", "mmap" or "hugetlb" */
+const char *arena_backing_name(const arena_t *arena);
+
+#endif /* ARENA_H */
@@ -0,0 +1,295 @@
+/**
+ * @file broadcast.c
+ * @brief Single-producer, multi-consumer broadcast ring implementation
+ *
+ * Memory ordering in one paragraph:
+ *   The producer marks a slot odd (writing), fills it, marks it even with
+ *   release, then bumps `published` with release. A consumer loads
+ *   `published` and the slot's seq with acquire, copies the payload, and
+ *   re-checks seq after an acquire fence — if seq moved, the copy may be
+ *   torn and the consumer has been lapped. A consumer publishes its cursor
+ *   with release after copying, so a gated producer that reads it with
+ *   acquire never overwrites a slot that is still being read.
+ *
+ * Gating is cheap: the producer caches the slowest gating cursor and only
+ * rescans the consumer table when that cache says the ring is full, or
+ * when someone has subscribed since its last look.
+ *
+ * Subscribing does not set the cursor: a cursor read from `published` by
+ * the subscriber could already be stale when it goes live, and the cached
+ * minimum would not know about it. Instead subscribe marks the slot active
+ * and bumps `subscribes`; the producer notices before its next publish,
+ * places every new cursor at that publish's sequence, marks it live and
+ * rescans. Nothing a live GATE consumer needs is ever behind the cache.
+ */
+
+#include "broadcast.h"
+#include "cacheline.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static uint64_t pack_meta(const sensor_reading_t *r)
+{
+    return (uint64_t)r->timestamp | ((uint64_t)r->sensor_id << 32);
+}
+
+static uint32_t float_bits(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float bits_float(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief Slowest live GATE consumer, or `limit` if there is none.
+ */
+static uint64_t min_gating_cursor(broadcast_ring_t *ring, uint64_t limit)
+{
+    uint64_t min = limit;
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        broadcast_consumer_t *c = &ring->consumers[i];
+        if (!atomic_load_explicit(&c->active, memory_order_acquire) ||
+            !atomic_load_explicit(&c->live, memory_order_relaxed) ||
+            atomic_load_explicit(&c->policy, memory_order_relaxed) !=
+                BROADCAST_GATE)
+            continue;
+        uint64_t cur = atomic_load_explicit(&c->cursor, memory_order_acquire);
+        if (cur < min)
+            min = cur;
+    }
+    return min;
+}
+
+/**
+ * @brief Start every newly subscribed consumer at sequence `n`.
+ */
+static void admit_subscribers(broadcast_ring_t *ring, uint64_t n)
+{
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        broadcast_consumer_t *c = &ring->consumers[i];
+        if (!atomic_load_explicit(&c->active, memory_order_acquire) ||
+            atomic_load_explicit(&c->live, memory_order_relaxed))
+            continue;
+        atomic_store_explicit(&c->cursor, n, memory_order_relaxed);
+        atomic_store_explicit(&c->live, true, memory_order_release);
+    }
+}
+
+static bool consumer_valid(const broadcast_ring_t *ring, int consumer)
+{
+    return ring != NULL && consumer >= 0 &&
+           consumer < BROADCAST_MAX_CONSUMERS &&
+           atomic_load_explicit(&ring->consumers[consumer].active,
+                                memory_order_relaxed);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+broadcast_ring_t *broadcast_create(size_t capacity)
+{
+    /* Power of two so sequence -> slot is a mask, not a division */
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return NULL;
+
+    broadcast_ring_t *ring = cache_alloc(sizeof(broadcast_ring_t));
+    if (ring == NULL)
+        return NULL;
+    memset(ring, 0, sizeof(*ring));
+
+    ring->slots = cache_alloc(capacity * sizeof(broadcast_slot_t));
+    if (ring->slots == NULL) {
+        cache_free(ring);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&ring->slots[i].seq, 0);
+        atomic_init(&ring->slots[i].meta, 0);
+        atomic_init(&ring->slots[i].value, 0);
+    }
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        atomic_init(&ring->consumers[i].cursor, 0);
+        atomic_init(&ring->consumers[i].active, false);
+        atomic_init(&ring->consumers[i].live, false);
+    }
+    atomic_init(&ring->published, 0);
+    atomic_init(&ring->subscribes, 0);
+
+    ring->capacity = capacity;
+    ring->mask     = capacity - 1;
+    return ring;
+}
+
+void broadcast_destroy(broadcast_ring_t *ring)
+{
+    if (ring == NULL)
+        return;
+
+    cache_free(ring->slots);
+    ring->slots = NULL;
+    cache_free(ring);
+}
+
+bool broadcast_publish(broadcast_ring_t *ring, const sensor_reading_t *reading)
+{
+    if (ring == NULL || reading == NULL)
+        return false;
+
+    uint64_t n = atomic_load_explicit(&ring->published, memory_order_relaxed);
+
+    /* Place new subscribers here, then gate on them too */
+    uint32_t subs = atomic_load_explicit(&ring->subscribes, memory_order_acquire);
+    if (subs != ring->admitted) {
+        ring->admitted = subs;
+        admit_subscribers(ring, n);
+        ring->gate_cache = min_gating_cursor(ring, n);
+    }
+
+    /* Would this overwrite an entry a gating consumer has not read? */
+    if (n - ring->gate_cache >= ring->capacity) {
+        ring->gate_cache = min_gating_cursor(ring, n);
+        if (n - ring->gate_cache >= ring->capacity) {
+            ring->overflow_count++;
+            return false;
+        }
+    }
+
+    broadcast_slot_t *slot = &ring->slots[n & ring->mask];
+    atomic_store_explicit(&slot->seq, 2 * n + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->meta, pack_meta(reading), memory_order_relaxed);
+    atomic_store_explicit(&slot->value, float_bits(reading->value),
+                          memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, 2 * n + 2, memory_order_release);
+
+    atomic_store_explicit(&ring->published, n + 1, memory_order_release);
+    return true;
+}
+
+uint64_t broadcast_published(const broadcast_ring_t *ring)
+{
+    return (ring == NULL) ? 0
+         : atomic_load_explicit(&ring->published, memory_order_acquire);
+}
+
+uint32_t broadcast_overflow_count(const broadcast_ring_t *ring)
+{
+    return (ring == NULL) ? 0 : ring->overflow_count;
+}
+
+int broadcast_subscribe(broadcast_ring_t *ring, broadcast_policy_t policy)
+{
+    if (ring == NULL)
+        return -1;
+
+    for (int i = 0; i < BROADCAST_MAX_CONSUMERS; i++) {
+        broadcast_consumer_t *c = &ring->consumers[i];
+        bool free_slot = false;
+        if (!atomic_compare_exchange_strong_explicit(&c->active, &free_slot, true,
+                                                     memory_order_acq_rel,
+                                                     memory_order_relaxed))
+            continue;                           /* taken, possibly just now */
+
+        /* Ours. Not readable until the producer places its cursor; if it
+         * admitted the slot between the claim and here, clearing `live`
+         * makes it admit again once it sees the new count. */
+        atomic_store_explicit(&c->policy, policy, memory_order_relaxed);
+        c->lapped = 0;
+        atomic_store_explicit(&c->live, false, memory_order_relaxed);
+        atomic_fetch_add_explicit(&ring->subscribes, 1, memory_order_release);
+        return i;
+    }
+    return -1;
+}
+
+void broadcast_unsubscribe(broadcast_ring_t *ring, int consumer)
+{
+    if (!consumer_valid(ring, consumer))
+        return;
+
+    atomic_store_explicit(&ring->consumers[consumer].active, false,
+                          memory_order_release);
+    atomic_store_explicit(&ring->consumers[consumer].live, false,
+                          memory_order_relaxed);
+}
+
+bool broadcast_consume(broadcast_ring_t *ring, int consumer,
+                       sensor_reading_t *output)
+{
+    if (!consumer_valid(ring, consumer) || output == NULL)
+        return false;
+
+    broadcast_consumer_t *c = &ring->consumers[consumer];
+    if (!atomic_load_explicit(&c->live, memory_order_acquire))
+        return false;                           /* not placed yet */
+    uint64_t n = atomic_load_explicit(&c->cursor, memory_order_relaxed);
+
+    for (;;) {
+        uint64_t pub = atomic_load_explicit(&ring->published,
+                                            memory_order_acquire);
+        if (n >= pub)
+            return false;                       /* caught up */
+
+        /* A full ring behind: skip to the oldest entry still present */
+        if (pub - n > ring->capacity) {
+            uint64_t oldest = pub - ring->capacity;
+            c->lapped += oldest - n;
+            n = oldest;
+        }
+
+        broadcast_slot_t *slot = &ring->slots[n & ring->mask];
+        uint64_t s1 = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (s1 != 2 * n + 2) {
+            if (s1 < 2 * n + 2)
+                return false;                   /* not visible yet */
+            continue;                           /* overwritten: re-lap */
+        }
+
+        uint64_t meta  = atomic_load_explicit(&slot->meta, memory_order_relaxed);
+        uint32_t value = atomic_load_explicit(&slot->value, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != s1)
+            continue;                           /* torn copy: re-lap */
+
+        output->timestamp = (uint32_t)meta;
+        output->sensor_id = (uint8_t)(meta >> 32);
+        output->value     = bits_float(value);
+
+        atomic_store_explicit(&c->cursor, n + 1, memory_order_release);
+        return true;
+    }
+}
+
+uint64_t broadcast_lag(const broadcast_ring_t *ring, int consumer)
+{
+    if (!consumer_valid(ring, consumer) ||
+        !atomic_load_explicit(&ring->consumers[consumer].live,
+                              memory_order_acquire))
+        return 0;
+
+    uint64_t pub = broadcast_published(ring);
+    uint64_t cur = atomic_load_explicit(&ring->consumers[consumer].cursor,
+                                        memory_order_acquire);
+    return (pub > cur) ? pub - cur : 0;
+}
+
+uint64_t broadcast_lapped(const broadcast_ring_t *ring, int consumer)
+{
+    if (!consumer_valid(ring, consumer))
+        return 0;
+
+    return ring->consumers[consumer].lapped;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file broadcast.h
+ * @brief Single-producer, multi-consumer broadcast ring
+ *
+ * buffer_read() is destructive: whoever reads a reading takes it away
+ * from everyone else. The broadcast ring lets one producer publish a
+ * stream that ANY number of consumers (logger, alert engine, live
+ * exporter, ...) each read at their own pace, disruptor-style:
+ *
+ *   - every published entry gets a 64-bit sequence number
+ *   - every consumer owns a cursor (the next sequence it wants)
+ *   - nothing is ever removed; the producer just overwrites old slots
+ *
+ * What happens when a consumer falls a whole ring behind is chosen per
+ * consumer when it subscribes:
+ *
+ *   BROADCAST_GATE - the producer refuses to overwrite entries this
+ *                    consumer has not read yet (publish returns false and
+ *                    the overflow counter grows, like buffer_write)
+ *   BROADCAST_LAP  - the producer overwrites regardless; the consumer
+ *                    notices on its next read, skips to the oldest entry
+ *                    still available and counts what it lost
+ *
+ * Consumers never wait on each other. Publish and consume are lock-free
+ * and safe to call from different threads (one producer thread, one
+ * thread per consumer).
+ *
+ * A consumer may subscribe while the producer is running. Its cursor is
+ * placed by the producer at its next publish, so it starts at the first
+ * entry published after it subscribed and, with GATE, is held from that
+ * entry on; until then broadcast_consume() simply returns false.
+ */
+
+#ifndef BROADCAST_H
+#define BROADCAST_H
+
+#include "buffer.h"     /* sensor_reading_t */
+#include "cacheline.h"  /* CACHE_LINE */
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum number of simultaneous consumers per ring */
+#define BROADCAST_MAX_CONSUMERS  8
+
+/** @brief Cache line size used to keep cursors from false sharing */
+#define BROADCAST_CACHE_LINE     CACHE_LINE
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief What to do when a consumer falls a full ring behind
+ */
+typedef enum {
+    BROADCAST_GATE = 0,     ///< Hold the producer back
+    BROADCAST_LAP           ///< Let the producer overwrite; consumer skips
+} broadcast_policy_t;
+
+/**
+ * @brief One ring slot
+ *
+ * `seq` is a per-slot seqlock: 2n+1 while entry n is being written,
+ * 2n+2 once it is complete. The payload is stored as atomics so a reader
+ * racing with an overwrite gets a torn-but-detected copy, never UB.
+ */
+typedef struct {
+    _Atomic uint64_t seq;       ///< Seqlock word (see above)
+    _Atomic uint64_t meta;      ///< timestamp | sensor_id << 32
+    _Atomic uint32_t value;     ///< float bits
+} broadcast_slot_t;
+
+/**
+ * @brief Per-consumer state, one cache line each
+ */
+typedef struct {
+    _Alignas(BROADCAST_CACHE_LINE)
+    _Atomic uint64_t   cursor;  ///< Next sequence this consumer will read
+    _Atomic bool       active;  ///< Slot in use
+    _Atomic bool       live;    ///< Cursor placed by the producer; readable
+    _Atomic int        policy;  ///< broadcast_policy_t (read by the producer)
+    uint64_t           lapped;  ///< Entries lost to overwrites (LAP only)
+} broadcast_consumer_t;
+
+/**
+ * @brief Broadcast ring control structure
+ */
+typedef struct {
+    broadcast_slot_t    *slots;         ///< capacity slots
+    size_t               capacity;      ///< Power of two
+    size_t               mask;          ///< capacity - 1
+
+    /* Producer-owned line */
+    _Alignas(BROADCAST_CACHE_LINE)
+    _Atomic uint64_t     published;     ///< Entries published so far
+    uint64_t             gate_cache;    ///< Last known min gating cursor
+    uint32_t             overflow_count;///< Publishes refused by a gate
+    uint32_t             admitted;      ///< `subscribes` value last acted on
+    _Atomic uint32_t     subscribes;    ///< Bumped by every subscribe
+
+    broadcast_consumer_t consumers[BROADCAST_MAX_CONSUMERS];
+} broadcast_ring_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+broadcast_ring_t *broadcast_create(size_t capacity);
+void              broadcast_destroy(broadcast_ring_t *ring);
+
+/* Producer side — one thread only */
+bool              broadcast_publish(broadcast_ring_t *ring,
+                                    const sensor_reading_t *reading);
+uint64_t          broadcast_published(const broadcast_ring_t *ring);
+uint32_t          broadcast_overflow_count(const broadcast_ring_t *ring);
+
+/* Consumer side — each consumer id used by one thread */
+int               broadcast_subscribe(broadcast_ring_t *ring,
+                                      broadcast_policy_t policy);
+void              broadcast_unsubscribe(broadcast_ring_t *ring, int consumer);
+bool              broadcast_consume(broadcast_ring_t *ring, int consumer,
+                                    sensor_reading_t *output);
+uint64_t          broadcast_lag(const broadcast_ring_t *ring, int consumer);
+uint64_t          broadcast_lapped(const broadcast_ring_t *ring, int consumer);
+
+#endif /* BROADCAST_H */
@@ -12,9 +12,16 @@
  *  5. sensor_id printed with PRIu8 to match its uint8_t type.
  *  6. buffer_free() renamed buffer_free_slots() — avoids shadowing free().
  *  7. Debug printfs removed from hot paths (write/read).
+ *
+ * Time-range index:
+ *   Live entries occupy at most two contiguous runs of the backing array —
+ *   [tail, end of array) and [start of array, head). Each run is sorted by
+ *   timestamp, and every timestamp in the first run is <= every one in the
+ *   second, so a lower-bound search only has to pick the right run first.
  */
 
 #include "buffer.h"
+#include "diag.h"
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -44,6 +51,44 @@ static size_t pointer_distance(const sensor_reading_t *start,
          + (size_t)(end - buf->buffer);
 }
 
+/** Reset a freshly allocated buffer around `storage` */
+static void buffer_setup(ring_buffer_t *buf, sensor_reading_t *storage,
+                         size_t capacity)
+{
+    buf->buffer         = storage;
+    buf->head           = buf->buffer;
+    buf->tail           = buf->buffer;
+    buf->capacity       = capacity;
+    buf->count          = 0;
+    buf->overflow_count = 0;
+
+    buf->status.is_full           = 0;
+    buf->status.is_empty          = 1;
+    buf->status.overflow_occurred = 0;
+    buf->status.in_arena          = 0;
+    buf->status.reserved          = 0;
+
+    memset(buf->buffer, 0, capacity * sizeof(sensor_reading_t));
+}
+
+/** Header size rounded so the storage after it starts a cache line */
+#define BUFFER_HEADER_SPAN \
+    ((sizeof(ring_buffer_t) + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1))
+
+/** Index of the first entry in data[0..n) with timestamp >= ts */
+static size_t lower_bound(const sensor_reading_t *data, size_t n, uint32_t ts)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (data[mid].timestamp < ts)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
 /* ============================================================================
  * PUBLIC API
  * ========================================================================== */
@@ -57,26 +102,38 @@ ring_buffer_t *buffer_create(size_t capacity)
     if (buf == NULL)
         return NULL;
 
-    buf->buffer = malloc(capacity * sizeof(sensor_reading_t));
-    if (buf->buffer == NULL) {
+    sensor_reading_t *storage = malloc(capacity * sizeof(sensor_reading_t));
+    if (storage == NULL) {
         free(buf);
         return NULL;
     }
 
-    buf->head           = buf->buffer;
-    buf->tail           = buf->buffer;
-    buf->capacity       = capacity;
-    buf->count          = 0;
-    buf->overflow_count = 0;
+    buffer_setup(buf, storage, capacity);
 
-    buf->status.is_full           = 0;
-    buf->status.is_empty          = 1;
-    buf->status.overflow_occurred = 0;
-    buf->status.reserved          = 0;
+    DIAG_DEBUG("BUFFER", "buffer_create(%zu) — OK", capacity);
+    return buf;
+}
 
-    memset(buf->buffer, 0, capacity * sizeof(sensor_reading_t));
+size_t buffer_footprint(size_t capacity)
+{
+    return BUFFER_HEADER_SPAN + capacity * sizeof(sensor_reading_t);
+}
+
+ring_buffer_t *buffer_create_in(arena_t *arena, size_t capacity)
+{
+    if (arena == NULL || capacity == 0 ||
+        capacity > (SIZE_MAX - BUFFER_HEADER_SPAN) / sizeof(sensor_reading_t))
+        return NULL;
+
+    unsigned char *block = arena_alloc(arena, buffer_footprint(capacity));
+    if (block == NULL)
+        return NULL;
+
+    ring_buffer_t *buf = (ring_buffer_t *)block;
+    buffer_setup(buf, (sensor_reading_t *)(block + BUFFER_HEADER_SPAN), capacity);
+    buf->status.in_arena = 1;
 
-    printf("[DEBUG] buffer_create(%zu) — OK\n", capacity);
+    DIAG_DEBUG("BUFFER", "buffer_create_in(%zu) — OK", capacity);
     return buf;
 }
 
@@ -85,7 +142,11 @@ void buffer_destroy(ring_buffer_t *buf)
     if (buf == NULL)
         return;
 
-    printf("[DEBUG] buffer_destroy() called\n");
+    DIAG_DEBUG("BUFFER", "buffer_destroy() called");
+
+    /* Arena memory goes back all at once with arena_destroy() */
+    if (buf->status.in_arena)
+        return;
 
     free(buf->buffer);
     buf->buffer = NULL;
@@ -228,3 +289,55 @@ void buffer_print_debug(const ring_buffer_t *buf)
     printf("=========================\n");
 }
 
+
+size_t buffer_find_from(const ring_buffer_t *buf, uint32_t ts)
+{
+    if (buffer_is_empty(buf))
+        return 0;
+
+    size_t tail_off = (size_t)(buf->tail - buf->buffer);
+    size_t first    = buf->capacity - tail_off;     /* run 1: up to array end */
+    if (first > buf->count)
+        first = buf->count;
+
+    if (buf->tail[first - 1].timestamp >= ts)
+        return lower_bound(buf->tail, first, ts);
+
+    /* Everything in run 1 is older; search run 2 from the array start */
+    return first + lower_bound(buf->buffer, buf->count - first, ts);
+}
+
+size_t buffer_range_begin(const ring_buffer_t *buf, uint32_t t0,
+                          uint32_t t1, buffer_range_iter_t *it)
+{
+    if (it == NULL)
+        return 0;
+
+    it->buf = buf;
+    it->pos = 0;
+    it->end = 0;
+
+    if (buffer_is_empty(buf) || t1 <= t0)
+        return 0;
+
+    it->pos = buffer_find_from(buf, t0);
+    it->end = buffer_find_from(buf, t1);
+    return it->end - it->pos;
+}
+
+bool buffer_range_next(buffer_range_iter_t *it, buffer_span_t *span)
+{
+    if (it == NULL || span == NULL || it->pos >= it->end)
+        return false;
+
+    const ring_buffer_t *buf = it->buf;
+    size_t phys = ((size_t)(buf->tail - buf->buffer) + it->pos) % buf->capacity;
+    size_t run  = buf->capacity - phys;             /* until the wrap point */
+    if (run > it->end - it->pos)
+        run = it->end - it->pos;
+
+    span->data  = buf->buffer + phys;
+    span->count = run;
+    it->pos    += run;
+    return true;
+}
@@ -9,6 +9,7 @@
 #ifndef BUFFER_H
 #define BUFFER_H
 
+#include "arena.h"      /* arena_t              */
 #include <stdint.h>     /* fixed-width types    */
 #include <stdbool.h>    /* bool type            */
 #include <stddef.h>     /* size_t               */
@@ -46,7 +47,8 @@ typedef struct {
     unsigned int is_full          : 1;  ///< Buffer is completely full
     unsigned int is_empty         : 1;  ///< Buffer is completely empty
     unsigned int overflow_occurred: 1;  ///< At least one write was rejected
-    unsigned int reserved         : 5;  ///< Padding — reserved for future use
+    unsigned int in_arena         : 1;  ///< Lives in an arena; destroy frees nothing
+    unsigned int reserved         : 4;  ///< Padding — reserved for future use
 } buffer_status_t;
 
 /**
@@ -62,12 +64,44 @@ typedef struct {
     buffer_status_t   status;       ///< Convenience status flags
 } ring_buffer_t;
 
+/**
+ * @brief Zero-copy view of readings that are contiguous in memory
+ *
+ * Points straight into the ring's storage. Valid until the next
+ * buffer_write / buffer_read / buffer_clear on the same buffer.
+ */
+typedef struct {
+    const sensor_reading_t *data;   ///< First reading in the run
+    size_t                  count;  ///< Number of readings in the run
+} buffer_span_t;
+
+/**
+ * @brief Iterator over the readings in a time range
+ *
+ * A range can straddle the wrap point, so it is handed out as at most
+ * two spans. Positions are logical (0 = oldest entry).
+ */
+typedef struct {
+    const ring_buffer_t *buf;       ///< Buffer being iterated
+    size_t               pos;       ///< Next logical index to yield
+    size_t               end;       ///< One past the last logical index
+} buffer_range_iter_t;
+
 /* ============================================================================
  * PUBLIC API
  * ========================================================================== */
 
 ring_buffer_t* buffer_create(size_t capacity);
 void           buffer_destroy(ring_buffer_t *buf);
+
+/*
+ * Arena placement — header and storage in one cache-line aligned block,
+ * storage starting on the line after the header. buffer_destroy() on
+ * such a buffer only detaches it; the arena owns the memory.
+ */
+ring_buffer_t* buffer_create_in(arena_t *arena, size_t capacity);
+size_t         buffer_footprint(size_t capacity);
+
 bool           buffer_write(ring_buffer_t *buf, const sensor_reading_t *reading);
 bool           buffer_read(ring_buffer_t *buf, sensor_reading_t *output);
 bool           buffer_peek(const ring_buffer_t *buf, sensor_reading_t *output);
@@ -80,4 +114,13 @@ buffer_status_t buffer_get_status(const ring_buffer_t *buf);
 uint32_t       buffer_overflow_count(const ring_buffer_t *buf);
 void           buffer_print_debug(const ring_buffer_t *buf);
 
+/*
+ * Time-range queries — require timestamps to be non-decreasing in write
+ * order (true for every per-sensor buffer). Both are O(log n).
+ */
+size_t         buffer_find_from(const ring_buffer_t *buf, uint32_t ts);
+size_t         buffer_range_begin(const ring_buffer_t *buf, uint32_t t0,
+                                  uint32_t t1, buffer_range_iter_t *it);
+bool           buffer_range_next(buffer_range_iter_t *it, buffer_span_t *span);
+
 #endif /* BUFFER_H */
@@ -0,0 +1,48 @@
+/**
+ * @file cacheline.h
+ * @brief Cache-line size and cache-line aligned allocation
+ *
+ * Structures shared between threads put each thread's hot fields on
+ * their own cache line (_Alignas(CACHE_LINE)) so that one core writing
+ * its cursor never invalidates the line another core is reading. Such
+ * structures must be heap-allocated with cache_alloc(), because plain
+ * malloc() only guarantees max_align_t alignment.
+ */
+
+#ifndef CACHELINE_H
+#define CACHELINE_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>     /* _aligned_malloc */
+#endif
+
+/** @brief Cache line size assumed for padding (x86-64 and most ARM cores) */
+#define CACHE_LINE  64
+
+/**
+ * @brief Allocate `size` bytes aligned to a cache line.
+ * @return Pointer to release with cache_free(), NULL on failure
+ */
+static inline void *cache_alloc(size_t size)
+{
+    size_t rounded = (size + CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+#ifdef _WIN32
+    return _aligned_malloc(rounded, CACHE_LINE);
+#else
+    return aligned_alloc(CACHE_LINE, rounded);
+#endif
+}
+
+/** @brief Free memory from cache_alloc() (NULL is safe) */
+static inline void cache_free(void *ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+#endif /* CACHELINE_H */
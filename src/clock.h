@@ -0,0 +1,40 @@
+/**
+ * @file clock.h
+ * @brief Monotonic nanosecond clock for benchmarks and timing
+ *
+ * Header-only so every translation unit can inline it. On POSIX the
+ * including file must define _POSIX_C_SOURCE (>= 199309L) before any
+ * system header so that clock_gettime() is declared under -std=c11.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+static inline uint64_t clock_ns(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+}
+
+#else
+#include <time.h>
+
+static inline uint64_t clock_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+#endif
+
+#endif /* CLOCK_H */
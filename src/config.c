@@ -0,0 +1,513 @@
+/**
+ * @file config.c
+ * @brief INI configuration parser, validator and manager builder
+ *
+ * The parser works one line at a time on a stack buffer, so the same
+ * code serves config_parse() (lines split out of a string) and
+ * config_load() (lines read with fgets()).
+ */
+
+#include "config.h"
+#include "diag.h"
+#include <ctype.h>
+#include <float.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Which kind of section the following keys belong to */
+typedef enum {
+    SECTION_NONE = 0,
+    SECTION_LOGGER,
+    SECTION_MANAGER,
+    SECTION_WATCHDOG,
+    SECTION_SENSOR
+} section_t;
+
+typedef struct {
+    config_t       *cfg;
+    config_error_t *err;
+    unsigned        line;
+    section_t       section;
+    uint8_t         id;         ///< Current sensor for SECTION_SENSOR
+} parser_t;
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static bool fail(config_error_t *err, unsigned line, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static bool fail(config_error_t *err, unsigned line, const char *fmt, ...)
+{
+    if (err == NULL)
+        return false;
+
+    err->line = line;
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(err->msg, sizeof(err->msg), fmt, ap);
+    va_end(ap);
+    return false;
+}
+
+/** Strip leading and trailing whitespace in place */
+static char *trim(char *s)
+{
+    while (isspace((unsigned char)*s))
+        s++;
+    char *end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1]))
+        *--end = '\0';
+    return s;
+}
+
+static bool parse_float(const char *s, float *out)
+{
+    char *end;
+    float v = strtof(s, &end);
+    if (end == s || *trim(end) != '\0')
+        return false;
+    *out = v;
+    return true;
+}
+
+static bool parse_uint(const char *s, uint32_t *out)
+{
+    char *end;
+    if (*s == '-')
+        return false;
+    unsigned long v = strtoul(s, &end, 10);
+    if (end == s || *trim(end) != '\0' || v > UINT32_MAX)
+        return false;
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool parse_bool(const char *s, bool *out)
+{
+    if (strcmp(s, "true") == 0)
+        *out = true;
+    else if (strcmp(s, "false") == 0)
+        *out = false;
+    else
+        return false;
+    return true;
+}
+
+/** "median 5", "moving_avg 4" or "biquad b0 b1 b2 a1 a2" */
+static bool parse_filter(char *s, filter_stage_config_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    char *arg = s;
+    while (*arg != '\0' && !isspace((unsigned char)*arg))
+        arg++;
+    if (*arg != '\0')
+        *arg++ = '\0';
+
+    if (strcmp(s, "median") == 0 || strcmp(s, "moving_avg") == 0)
+    {
+        uint32_t w;
+        if (!parse_uint(trim(arg), &w) || w == 0 || w > FILTER_MAX_WINDOW)
+            return false;
+        out->type   = (s[0] == 'm' && s[1] == 'e') ? FILTER_MEDIAN
+                                                   : FILTER_MOVING_AVG;
+        out->window = (uint8_t)w;
+        return true;
+    }
+
+    if (strcmp(s, "biquad") == 0)
+    {
+        float c[5];
+        for (int i = 0; i < 5; i++)
+        {
+            char *end;
+            c[i] = strtof(arg, &end);
+            if (end == arg)
+                return false;
+            arg = end;
+        }
+        if (*trim(arg) != '\0')
+            return false;
+        out->type   = FILTER_BIQUAD;
+        out->biquad = (biquad_coeffs_t){c[0], c[1], c[2], c[3], c[4]};
+        return true;
+    }
+
+    return false;
+}
+
+/** "[logger]", "[manager]", "[watchdog]" or "[sensor.N]" (already trimmed) */
+static bool parse_section(parser_t *p, char *s)
+{
+    size_t len = strlen(s);
+    if (len < 2 || s[len - 1] != ']')
+        return fail(p->err, p->line, "unterminated section header");
+    s[len - 1] = '\0';
+    s = trim(s + 1);
+
+    if (strcmp(s, "logger") == 0)
+    {
+        p->section = SECTION_LOGGER;
+        return true;
+    }
+    if (strcmp(s, "manager") == 0)
+    {
+        p->section = SECTION_MANAGER;
+        return true;
+    }
+    if (strcmp(s, "watchdog") == 0)
+    {
+        p->section = SECTION_WATCHDOG;
+        return true;
+    }
+    if (strncmp(s, "sensor.", 7) == 0)
+    {
+        uint32_t id;
+        if (!parse_uint(s + 7, &id) || id >= MANAGER_MAX_SENSORS)
+            return fail(p->err, p->line, "sensor id must be 0..%d",
+                        MANAGER_MAX_SENSORS - 1);
+
+        config_sensor_t *cs = &p->cfg->sensors[id];
+        if (cs->present)
+            return fail(p->err, p->line, "sensor %u declared twice", id);
+
+        cs->present = true;
+        snprintf(cs->name, sizeof(cs->name), "Sensor %u", id);
+        if (id + 1 > p->cfg->capacity)
+            p->cfg->capacity = (uint8_t)(id + 1);
+
+        p->section = SECTION_SENSOR;
+        p->id      = (uint8_t)id;
+        return true;
+    }
+
+    return fail(p->err, p->line, "unknown section [%s]", s);
+}
+
+static bool parse_sensor_key(parser_t *p, const char *key, char *val)
+{
+    config_sensor_t    *cs = &p->cfg->sensors[p->id];
+    sensor_threshold_t *t  = &cs->thresholds;
+    float              *limit = NULL;
+
+    if (strcmp(key, "name") == 0)
+    {
+        if (*val == '\0' || strlen(val) >= SENSOR_NAME_MAX)
+            return fail(p->err, p->line, "name must be 1..%d characters",
+                        SENSOR_NAME_MAX - 1);
+        strcpy(cs->name, val);
+        return true;
+    }
+    if (strcmp(key, "buffer") == 0)
+    {
+        if (!parse_uint(val, &cs->buffer))
+            return fail(p->err, p->line, "buffer: not a count: '%s'", val);
+        return true;
+    }
+    if (strcmp(key, "period") == 0)
+    {
+        if (!parse_uint(val, &cs->period_ms))
+            return fail(p->err, p->line, "period: not a count of ms: '%s'", val);
+        return true;
+    }
+    if (strcmp(key, "phase") == 0)
+    {
+        if (!parse_uint(val, &cs->phase_ms))
+            return fail(p->err, p->line, "phase: not a count of ms: '%s'", val);
+        return true;
+    }
+    if (strcmp(key, "log_raw") == 0)
+    {
+        if (!parse_bool(val, &cs->log_raw))
+            return fail(p->err, p->line, "log_raw: expected true or false");
+        return true;
+    }
+    if (strcmp(key, "filter") == 0)
+    {
+        if (cs->n_filters >= FILTER_MAX_STAGES)
+            return fail(p->err, p->line, "more than %d filter stages",
+                        FILTER_MAX_STAGES);
+        if (!parse_filter(val, &cs->filters[cs->n_filters]))
+            return fail(p->err, p->line, "filter: expected 'median N', "
+                        "'moving_avg N' (N <= %d) or 'biquad b0 b1 b2 a1 a2'",
+                        FILTER_MAX_WINDOW);
+        cs->n_filters++;
+        return true;
+    }
+
+    if (strcmp(key, "warn_low") == 0)           limit = &t->warn_low;
+    else if (strcmp(key, "warn_high") == 0)     limit = &t->warn_high;
+    else if (strcmp(key, "critical_low") == 0)  limit = &t->critical_low;
+    else if (strcmp(key, "critical_high") == 0) limit = &t->critical_high;
+    else
+        return fail(p->err, p->line, "unknown key '%s' in [sensor.%u]",
+                    key, p->id);
+
+    if (!parse_float(val, limit))
+        return fail(p->err, p->line, "%s: not a number: '%s'", key, val);
+    t->enabled = true;
+    return true;
+}
+
+static bool parse_line(parser_t *p, char *line)
+{
+    char *s = trim(line);
+    if (*s == '\0' || *s == '#' || *s == ';')
+        return true;
+
+    if (*s == '[')
+        return parse_section(p, s);
+
+    char *eq = strchr(s, '=');
+    if (eq == NULL)
+        return fail(p->err, p->line, "expected 'key = value'");
+    *eq = '\0';
+    char *key = trim(s);
+    char *val = trim(eq + 1);
+
+    /* Optional quotes keep leading/trailing spaces or a '#' in a value */
+    size_t len = strlen(val);
+    if (len >= 2 && val[0] == '"' && val[len - 1] == '"')
+    {
+        val[len - 1] = '\0';
+        val++;
+    }
+
+    switch (p->section)
+    {
+    case SECTION_LOGGER:
+        if (strcmp(key, "path") == 0)
+        {
+            if (*val == '\0' || strlen(val) >= LOGGER_PATH_MAX)
+                return fail(p->err, p->line, "path must be 1..%d characters",
+                            LOGGER_PATH_MAX - 1);
+            strcpy(p->cfg->log_path, val);
+            return true;
+        }
+        if (strcmp(key, "flush_every") == 0)
+        {
+            if (!parse_uint(val, &p->cfg->flush_every) ||
+                p->cfg->flush_every == 0)
+                return fail(p->err, p->line, "flush_every: expected a count >= 1");
+            return true;
+        }
+        return fail(p->err, p->line, "unknown key '%s' in [logger]", key);
+
+    case SECTION_MANAGER:
+        if (strcmp(key, "hugepages") == 0)
+        {
+            if (!parse_bool(val, &p->cfg->hugepages))
+                return fail(p->err, p->line, "hugepages: expected true or false");
+            return true;
+        }
+        return fail(p->err, p->line, "unknown key '%s' in [manager]", key);
+
+    case SECTION_WATCHDOG:
+        if (strcmp(key, "misses") == 0)
+        {
+            if (!parse_uint(val, &p->cfg->watchdog_misses))
+                return fail(p->err, p->line, "misses: not a count: '%s'", val);
+            return true;
+        }
+        return fail(p->err, p->line, "unknown key '%s' in [watchdog]", key);
+
+    case SECTION_SENSOR:
+        return parse_sensor_key(p, key, val);
+
+    default:
+        return fail(p->err, p->line, "'%s' outside of a section", key);
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void config_init(config_t *cfg)
+{
+    if (cfg == NULL)
+        return;
+
+    memset(cfg, 0, sizeof(*cfg));
+    for (int i = 0; i < MANAGER_MAX_SENSORS; i++)
+    {
+        config_sensor_t *cs = &cfg->sensors[i];
+        cs->buffer     = SENSOR_BUFFER_CAPACITY;
+        cs->period_ms  = CONFIG_DEFAULT_PERIOD_MS;
+        cs->thresholds = (sensor_threshold_t){
+            .warn_low     = -FLT_MAX, .warn_high     = FLT_MAX,
+            .critical_low = -FLT_MAX, .critical_high = FLT_MAX,
+            .enabled      = false};
+    }
+    strcpy(cfg->log_path, "data/sensor_log.csv");
+    cfg->flush_every = 1;
+}
+
+bool config_parse(config_t *cfg, const char *text, config_error_t *err)
+{
+    if (cfg == NULL || text == NULL)
+        return fail(err, 0, "no configuration");
+
+    config_init(cfg);
+    parser_t p = {.cfg = cfg, .err = err};
+
+    while (*text != '\0')
+    {
+        const char *nl  = strchr(text, '\n');
+        size_t      len = nl != NULL ? (size_t)(nl - text) : strlen(text);
+        p.line++;
+        if (len >= CONFIG_LINE_MAX)
+            return fail(err, p.line, "line longer than %d characters",
+                        CONFIG_LINE_MAX - 1);
+
+        char line[CONFIG_LINE_MAX];
+        memcpy(line, text, len);
+        line[len] = '\0';
+        if (!parse_line(&p, line))
+            return false;
+
+        text += len + (nl != NULL);
+    }
+
+    return config_validate(cfg, err);
+}
+
+bool config_load(config_t *cfg, const char *path, config_error_t *err)
+{
+    if (cfg == NULL || path == NULL)
+        return fail(err, 0, "no configuration");
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return fail(err, 0, "cannot open '%s'", path);
+
+    config_init(cfg);
+    parser_t p = {.cfg = cfg, .err = err};
+    char line[CONFIG_LINE_MAX];
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), f) != NULL)
+    {
+        p.line++;
+        if (strchr(line, '\n') == NULL && !feof(f))
+            ok = fail(err, p.line, "line longer than %d characters",
+                      CONFIG_LINE_MAX - 1);
+        else
+            ok = parse_line(&p, line);
+    }
+    fclose(f);
+
+    if (ok)
+        DIAG_INFO("CONFIG", "Loaded '%s' (%u lines)", path, p.line);
+    return ok && config_validate(cfg, err);
+}
+
+bool config_validate(const config_t *cfg, config_error_t *err)
+{
+    if (cfg == NULL)
+        return fail(err, 0, "no configuration");
+
+    if (cfg->capacity == 0)
+        return fail(err, 0, "no [sensor.N] sections");
+
+    for (uint8_t id = 0; id < cfg->capacity; id++)
+    {
+        const config_sensor_t *cs = &cfg->sensors[id];
+        if (!cs->present)
+            continue;
+
+        if (cs->buffer == 0 || cs->buffer > CONFIG_MAX_BUFFER)
+            return fail(err, 0, "sensor %u: buffer must be 1..%u",
+                        id, CONFIG_MAX_BUFFER);
+        if (cs->period_ms == 0)
+            return fail(err, 0, "sensor %u: period must be at least 1 ms", id);
+
+        const sensor_threshold_t *t = &cs->thresholds;
+        if (t->enabled &&
+            !(t->critical_low <= t->warn_low && t->warn_low <= t->warn_high &&
+              t->warn_high <= t->critical_high))
+            return fail(err, 0, "sensor %u: limits must satisfy critical_low "
+                        "<= warn_low <= warn_high <= critical_high", id);
+    }
+    return true;
+}
+
+manager_t *config_build(const config_t *cfg, config_error_t *err)
+{
+    if (!config_validate(cfg, err))
+        return NULL;
+
+    /* Exactly the declared rings, each rounded as arena_alloc() will */
+    size_t arena_bytes = 0;
+    for (uint8_t id = 0; id < cfg->capacity; id++)
+        if (cfg->sensors[id].present)
+            arena_bytes += (buffer_footprint(cfg->sensors[id].buffer) +
+                            CACHE_LINE - 1) & ~(size_t)(CACHE_LINE - 1);
+
+    manager_t *m = manager_create_arena(cfg->capacity, arena_bytes,
+                                        cfg->hugepages ? ARENA_HUGEPAGES : 0);
+    if (m == NULL)
+    {
+        fail(err, 0, "cannot create a manager for %u sensors", cfg->capacity);
+        return NULL;
+    }
+
+    for (uint8_t id = 0; id < cfg->capacity; id++)
+    {
+        const config_sensor_t *cs = &cfg->sensors[id];
+        if (!cs->present)
+            continue;
+
+        bool ok = manager_register(m, id, cs->name, cs->buffer);
+        if (ok && cs->thresholds.enabled)
+            ok = manager_set_thresholds(m, id, cs->thresholds);
+        for (uint8_t f = 0; ok && f < cs->n_filters; f++)
+            ok = manager_add_filter(m, id, cs->filters[f]);
+        ok = ok && manager_set_log_raw(m, id, cs->log_raw);
+
+        if (!ok)
+        {
+            fail(err, 0, "sensor %u: could not be set up", id);
+            manager_destroy(m);
+            return NULL;
+        }
+    }
+
+    DIAG_INFO("CONFIG", "Built manager: %u sensors, %zu bytes of rings",
+              m->count, arena_bytes);
+    return m;
+}
+
+bool config_watchdog(const config_t *cfg, watchdog_t *wd)
+{
+    if (cfg->watchdog_misses == 0)
+        return true;
+
+    for (uint8_t id = 0; id < cfg->capacity; id++)
+    {
+        const config_sensor_t *cs = &cfg->sensors[id];
+        if (cs->present &&
+            !watchdog_watch(wd, id, cs->period_ms, cfg->watchdog_misses))
+            return false;
+    }
+    return true;
+}
+
+void config_thresholds(const config_t *cfg, threshold_table_t *table)
+{
+    for (uint8_t id = 0; id < MANAGER_MAX_SENSORS; id++)
+        table->limits[id] = cfg->sensors[id].thresholds;
+}
+
+bool config_open_logger(const config_t *cfg, csv_logger_t *logger)
+{
+    if (cfg == NULL || !logger_open(logger, cfg->log_path))
+        return false;
+
+    logger_set_flush_every(logger, cfg->flush_every);
+    return true;
+}
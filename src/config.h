@@ -0,0 +1,182 @@
+/**
+ * @file config.h
+ * @brief Declarative sensor configuration (INI file)
+ *
+ * Describes a whole monitor - sensors, ring sizes, filter chains,
+ * thresholds and logger policy - in one text file instead of a series
+ * of manager_register() / manager_set_thresholds() calls:
+ *
+ *   # Lines starting with '#' or ';' are comments
+ *   [logger]
+ *   path        = data/sensor_log.csv
+ *   flush_every = 1              rows per flush
+ *
+ *   [manager]
+ *   hugepages   = false          ARENA_HUGEPAGES for the manager's arena
+ *
+ *   [watchdog]
+ *   misses      = 3              fault a sensor silent for 3 periods
+ *                                (watchdog.h); 0 or left out = off
+ *
+ *   [sensor.0]                   section number = sensor ID
+ *   name          = Temperature (C)
+ *   buffer        = 16           ring capacity (readings)
+ *   warn_low      = 0            any limit left out never fires
+ *   warn_high     = 70
+ *   critical_low  = -10
+ *   critical_high = 85
+ *   filter        = median 5     repeat for more stages, in order:
+ *   filter        = moving_avg 4   median N | moving_avg N |
+ *                                  biquad b0 b1 b2 a1 a2
+ *   log_raw       = false
+ *   period        = 1000         sampling period and phase, ms (sampler.h)
+ *   phase         = 0
+ *
+ * Loading is three steps, each of which can fail with a message and the
+ * offending line in a config_error_t:
+ *
+ *   config_t cfg;
+ *   config_error_t err;
+ *   if (!config_load(&cfg, "config/monitor.ini", &err))    parse + validate
+ *       printf("line %u: %s\n", err.line, err.msg);
+ *   manager_t *m = config_build(&cfg, &err);               one pass
+ *   config_open_logger(&cfg, &logger);
+ *
+ * config_t is a plain fixed-size struct, so parsing allocates nothing.
+ * config_build() sizes the manager's arena for exactly the rings the
+ * file declares and then registers and configures every sensor; after
+ * it returns, logging allocates nothing either.
+ */
+
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "sensor_manager.h"
+#include "logger.h"
+#include "watchdog.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Longest line accepted, including the newline */
+#define CONFIG_LINE_MAX     256
+
+/** @brief Sampling period of a sensor that does not give one (ms) */
+#define CONFIG_DEFAULT_PERIOD_MS 1000
+
+/** @brief Largest ring a config file may ask for (readings) */
+#define CONFIG_MAX_BUFFER   (1u << 20)
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Where and why loading failed
+ *
+ * line is 1-based; 0 means the problem is with the file as a whole
+ * (cannot open it, no sensors, ...).
+ */
+typedef struct {
+    unsigned line;
+    char     msg[96];
+} config_error_t;
+
+/**
+ * @brief One [sensor.N] section
+ */
+typedef struct {
+    bool                  present;                     ///< Section seen
+    char                  name[SENSOR_NAME_MAX];       ///< Default "Sensor N"
+    uint32_t              buffer;                      ///< Ring capacity
+    sensor_threshold_t    thresholds;                  ///< enabled if any limit set
+    filter_stage_config_t filters[FILTER_MAX_STAGES];  ///< In file order
+    uint8_t               n_filters;
+    bool                  log_raw;
+    uint32_t              period_ms;                   ///< Expected sample period
+    uint32_t              phase_ms;                    ///< Offset within the period
+} config_sensor_t;
+
+/**
+ * @brief A parsed configuration file
+ */
+typedef struct {
+    config_sensor_t sensors[MANAGER_MAX_SENSORS];  ///< Indexed by sensor ID
+    uint8_t         capacity;                      ///< Highest ID + 1
+    bool            hugepages;                     ///< [manager] hugepages
+    char            log_path[LOGGER_PATH_MAX];     ///< [logger] path
+    uint32_t        flush_every;                   ///< [logger] flush_every
+    uint32_t        watchdog_misses;               ///< [watchdog] misses, 0 = off
+} config_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Reset to an empty configuration with every default filled in.
+ */
+void config_init(config_t *cfg);
+
+/**
+ * @brief Parse and validate a configuration held in memory.
+ * @param text  NUL-terminated file contents
+ * @param err   Filled on failure (may be NULL)
+ * @return true if the text is a complete, valid configuration
+ */
+bool config_parse(config_t *cfg, const char *text, config_error_t *err);
+
+/**
+ * @brief Parse and validate a configuration file.
+ * @return true on success; on failure `err` names the line and problem
+ */
+bool config_load(config_t *cfg, const char *path, config_error_t *err);
+
+/**
+ * @brief Check a configuration for consistency.
+ *
+ * Run by config_parse() / config_load(); exposed for configurations
+ * built or edited in code. Rejects: no sensors, an empty ring, a zero
+ * period, limits out of order (critical_low <= warn_low <= warn_high <=
+ * critical_high).
+ */
+bool config_validate(const config_t *cfg, config_error_t *err);
+
+/**
+ * @brief Create a manager and register every declared sensor.
+ *
+ * The manager's arena is sized for exactly the declared rings, so all
+ * of them land in it and nothing is left to allocate while logging.
+ * @return The manager, NULL on failure (with `err` filled)
+ */
+manager_t *config_build(const config_t *cfg, config_error_t *err);
+
+/**
+ * @brief Watch every declared sensor at its period, if [watchdog] asks.
+ *
+ * Each sensor may miss watchdog_misses of its periods before it is
+ * faulted. Does nothing when the watchdog is off.
+ * @param wd  Watchdog initialised on the manager config_build() made
+ * @return false if a sensor could not be watched
+ */
+bool config_watchdog(const config_t *cfg, watchdog_t *wd);
+
+/**
+ * @brief Every sensor's limits as one table, for a running manager.
+ *
+ * For reloading thresholds without a restart: load the file again and
+ * hand the table to manager_publish_thresholds(). Only the limits are
+ * taken; sensors, rings and filters stay as config_build() made them.
+ */
+void config_thresholds(const config_t *cfg, threshold_table_t *table);
+
+/**
+ * @brief Open cfg->log_path with the configured flush policy.
+ * @return logger_open()'s result
+ */
+bool config_open_logger(const config_t *cfg, csv_logger_t *logger);
+
+#endif /* CONFIG_H */
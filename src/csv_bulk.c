@@ -0,0 +1,561 @@
+/**
+ * @file csv_bulk.c
+ * @brief Bulk CSV reader implementation
+ *
+ * Stage 1 (block_masks) is the only code that looks at every byte, so it
+ * is the SIMD part: per 64-byte block it builds two uint64_t masks, one
+ * bit per ',' and per '\n'. Stage 2 walks the set bits with
+ * count-trailing-zeros, so it visits only the ~5 structural offsets of
+ * each row, and parses the fields between them with SWAR. Rows the fast
+ * path does not recognise go through parse_row(), which uses the
+ * streaming parser's scanners and does the skip/bad bookkeeping.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "csv_bulk.h"
+#include "csv_parser.h"     /* csv_scan_uint / csv_scan_decimal */
+#include "cacheline.h"
+#include "diag.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <stdlib.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BULK_ISA "avx2"
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BULK_ISA "sse2"
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define BULK_ISA "neon"
+#else
+#define BULK_ISA "scalar"
+#endif
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+
+/** Bit i of *commas / *newlines set if p[i] is ',' / '\n' (64 bytes at p) */
+static inline void block_masks(const char *p, uint64_t *commas, uint64_t *newlines)
+{
+#if defined(__AVX2__)
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i nl    = _mm256_set1_epi8('\n');
+    __m256i a = _mm256_loadu_si256((const __m256i *)p);
+    __m256i b = _mm256_loadu_si256((const __m256i *)(p + 32));
+    *commas   = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, comma)) |
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, comma)) << 32;
+    *newlines = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, nl)) |
+                (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b, nl)) << 32;
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i nl    = _mm_set1_epi8('\n');
+    uint64_t c = 0, n = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + 16 * i));
+        c |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, comma)) << (16 * i);
+        n |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nl)) << (16 * i);
+    }
+    *commas   = c;
+    *newlines = n;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    /* No movemask on NEON: weight each lane by its bit, then add pairwise */
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                         1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t w     = vld1q_u8(weights);
+    const uint8x16_t comma = vdupq_n_u8(',');
+    const uint8x16_t nl    = vdupq_n_u8('\n');
+    uint8x16_t mc[4], mn[4];
+    for (int i = 0; i < 4; i++)
+    {
+        uint8x16_t v = vld1q_u8((const uint8_t *)p + 16 * i);
+        mc[i] = vandq_u8(vceqq_u8(v, comma), w);
+        mn[i] = vandq_u8(vceqq_u8(v, nl), w);
+    }
+    uint8x16_t sc = vpaddq_u8(vpaddq_u8(mc[0], mc[1]), vpaddq_u8(mc[2], mc[3]));
+    uint8x16_t sn = vpaddq_u8(vpaddq_u8(mn[0], mn[1]), vpaddq_u8(mn[2], mn[3]));
+    sc = vpaddq_u8(sc, sc);
+    sn = vpaddq_u8(sn, sn);
+    *commas   = vgetq_lane_u64(vreinterpretq_u64_u8(sc), 0);
+    *newlines = vgetq_lane_u64(vreinterpretq_u64_u8(sn), 0);
+#else
+    uint64_t c = 0, n = 0;
+    for (int i = 0; i < 64; i++)
+    {
+        c |= (uint64_t)(p[i] == ',') << i;
+        n |= (uint64_t)(p[i] == '\n') << i;
+    }
+    *commas   = c;
+    *newlines = n;
+#endif
+}
+
+static inline unsigned ctz64(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    unsigned n = 0;
+    while ((x & 1) == 0) { x >>= 1; n++; }
+    return n;
+#endif
+}
+
+/**
+ * Cursor over the structural characters of data[0 .. size): the masks of
+ * the current block with the bits already visited cleared.
+ */
+typedef struct {
+    const char *data;
+    size_t      size;
+    size_t      base;               ///< Offset of the current block
+    uint64_t    pending;            ///< ',' and '\n' bits not yet visited
+    uint64_t    newlines;           ///< '\n' bits of the block
+    bool        eof_newline;        ///< Last line has no '\n' of its own
+} scan_t;
+
+static void scan_block(scan_t *s, size_t base)
+{
+    uint64_t commas;
+
+    s->base = base;
+    if (base + 64 <= s->size)
+    {
+        block_masks(s->data + base, &commas, &s->newlines);
+    }
+    else
+    {
+        /* Last partial block: pad with zeros, which match nothing */
+        char tail[64];
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, s->data + base, s->size - base);
+        block_masks(tail, &commas, &s->newlines);
+    }
+    s->pending = commas | s->newlines;
+}
+
+/** Position the cursor at `pos` (any offset, not just a block start) */
+static void scan_init(scan_t *s, const char *data, size_t size, size_t pos)
+{
+    s->data        = data;
+    s->size        = size;
+    s->eof_newline = size > 0 && data[size - 1] != '\n';
+    scan_block(s, pos & ~(size_t)63);
+
+    s->pending &= ~(uint64_t)0 << (pos & 63);
+}
+
+/**
+ * Next ',' or '\n' at or after the cursor. The end of data counts as a
+ * newline when the last line is unterminated.
+ * @return false when there is none
+ */
+static inline bool scan_next(scan_t *s, size_t *pos, bool *newline)
+{
+    while (s->pending == 0)
+    {
+        if (s->base + 64 >= s->size)
+        {
+            if (!s->eof_newline)
+                return false;
+            s->eof_newline = false;
+            *pos     = s->size;
+            *newline = true;
+            return true;
+        }
+        scan_block(s, s->base + 64);
+    }
+
+    unsigned bit = ctz64(s->pending);
+    *newline     = (s->newlines >> bit) & 1;
+    *pos         = s->base + bit;
+    s->pending  &= s->pending - 1;
+    return true;
+}
+
+/**
+ * SWAR: eight ASCII digits at p, first digit most significant.
+ * Only the first `len` (1..8) bytes are used; p[0..8) must be readable.
+ * @return false if one of them is not a digit
+ */
+static inline bool swar_digits8(const char *p, size_t len, uint32_t *out)
+{
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    w -= 0x3030303030303030ull;
+    w <<= 8 * (8 - len);                    /* drop the tail, zero-fill the front */
+    if (((w + 0x7676767676767676ull) | w) & 0x8080808080808080ull)
+        return false;
+
+    w = (w * 10 + (w >> 8)) & 0x00FF00FF00FF00FFull;               /* pairs */
+    w = (w * (1 + ((uint64_t)100 << 16)) >> 16) & 0x0000FFFF0000FFFFull;  /* quads */
+    *out = (uint32_t)((w * (1 + ((uint64_t)10000 << 32))) >> 32);
+    return true;
+}
+
+/** SWAR: exactly four ASCII digits at p (the logger's fixed fraction) */
+static inline bool swar_digits4(const char *p, uint32_t *out)
+{
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    w -= 0x30303030u;
+    if (((w + 0x76767676u) | w) & 0x80808080u)
+        return false;
+
+    w = (w * 10 + (w >> 8)) & 0x00FF00FFu;
+    *out = (w * (1 + (100u << 16))) >> 16;
+    return true;
+}
+
+static inline bool is_digit(char c)
+{
+    return (unsigned)(c - '0') < 10u;
+}
+
+/**
+ * Parse the line [s, end) into row `i` of `cols`.
+ * Handles the skip/bad bookkeeping; returns true for a data row.
+ */
+static bool parse_row(csv_bulk_t *r, const char *s, const char *end,
+                      csv_columns_t *cols, size_t i)
+{
+    if (end > s && end[-1] == '\r')
+        end--;
+
+    if (s == end || *s == '#')
+    {
+        r->skipped++;
+        return false;
+    }
+    if (!is_digit(*s))
+    {
+        /* The header is re-sent every time the board resets */
+        if ((size_t)(end - s) >= 9 && memcmp(s, "timestamp", 9) == 0)
+            r->skipped++;
+        else
+            r->bad++;
+        return false;
+    }
+
+    const char *q = s;
+    uint32_t ts, id;
+    float value;
+
+    if (!csv_scan_uint(&q, end, &ts) || q == end || *q++ != ',')
+        goto bad;
+    if (!csv_scan_uint(&q, end, &id) || id > UINT8_MAX || q == end || *q++ != ',')
+        goto bad;
+    q = memchr(q, ',', (size_t)(end - q));          /* skip sensor_name */
+    if (q == NULL)
+        goto bad;
+    q++;
+    if (!csv_scan_decimal(&q, end, &value) || q == end || *q++ != ',' || q == end)
+        goto bad;
+
+    alert_level_t alert;
+    switch (*q)
+    {
+        case 'N': alert = ALERT_NONE;     break;
+        case 'W': alert = ALERT_WARNING;  break;
+        case 'C': alert = ALERT_CRITICAL; break;
+        default:  goto bad;
+    }
+
+    cols->timestamp[i] = ts;
+    cols->sensor_id[i] = (uint8_t)id;
+    cols->value[i]     = value;
+    cols->alert[i]     = (uint8_t)alert;
+    r->rows++;
+    return true;
+
+bad:
+    r->bad++;
+    return false;
+}
+
+/**
+ * Fast path for the logger's own rows, with the first four commas of the
+ * line [s, end) already known (c[0..3], absolute offsets into data):
+ * digits-only timestamp and id, [-]int[.frac] value, N/W/C alert.
+ * Returns false without touching any counter for anything else, so
+ * parse_row() can take the line.
+ */
+static inline bool fast_row(csv_bulk_t *r, size_t s, const size_t c[4], size_t end,
+                            csv_columns_t *cols, size_t i)
+{
+    const char *d = r->data;
+    uint32_t ts, frac;
+
+    /* timestamp: 1..8 digits, read as one 8-byte word */
+    size_t len = c[0] - s;
+    if (len - 1 >= 8 || s + 8 > r->size || !swar_digits8(d + s, len, &ts))
+        return false;
+
+    /* sensor_id: 1..3 digits */
+    const char *p = d + c[0] + 1, *e = d + c[1];
+    if (p == e || e - p > 3)
+        return false;
+    uint32_t id = 0;
+    for (; p < e; p++)
+    {
+        if (!is_digit(*p))
+            return false;
+        id = id * 10 + (uint32_t)(*p - '0');
+    }
+    if (id > UINT8_MAX)
+        return false;
+
+    /* value: [-]digits[.digits], fixed four-digit fraction in one word */
+    p = d + c[2] + 1;
+    e = d + c[3];
+    bool neg = (p < e && *p == '-');
+    p += neg;
+    const char *digits = p;
+    uint64_t mant = 0;
+    while (p < e && is_digit(*p))
+        mant = mant * 10 + (uint64_t)(*p++ - '0');
+    if (p == digits || p - digits > 9)
+        return false;
+
+    int scale = 0;
+    if (p < e)
+    {
+        if (*p++ != '.')
+            return false;
+        scale = (int)(e - p);
+        if (scale == 4)
+        {
+            if (!swar_digits4(p, &frac))
+                return false;
+            mant = mant * 10000 + frac;
+        }
+        else
+        {
+            if (scale > 8)
+                return false;
+            for (; p < e; p++)
+            {
+                if (!is_digit(*p))
+                    return false;
+                mant = mant * 10 + (uint64_t)(*p - '0');
+            }
+        }
+    }
+
+    /* alert_level: first letter */
+    if (c[3] + 1 >= end)
+        return false;
+    alert_level_t alert;
+    switch (d[c[3] + 1])
+    {
+        case 'N': alert = ALERT_NONE;     break;
+        case 'W': alert = ALERT_WARNING;  break;
+        case 'C': alert = ALERT_CRITICAL; break;
+        default:  return false;
+    }
+
+    /* Same arithmetic as csv_scan_decimal(), so the floats are identical */
+    double v = (double)mant / csv_pow10[scale];
+    cols->timestamp[i] = ts;
+    cols->sensor_id[i] = (uint8_t)id;
+    cols->value[i]     = (float)(neg ? -v : v);
+    cols->alert[i]     = (uint8_t)alert;
+    r->rows++;
+    return true;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+bool csv_columns_init(csv_columns_t *cols, size_t capacity)
+{
+    if (cols == NULL || capacity == 0)
+        return false;
+
+    memset(cols, 0, sizeof(*cols));
+    cols->timestamp = cache_alloc(capacity * sizeof(uint32_t));
+    cols->sensor_id = cache_alloc(capacity * sizeof(uint8_t));
+    cols->value     = cache_alloc(capacity * sizeof(float));
+    cols->alert     = cache_alloc(capacity * sizeof(uint8_t));
+
+    if (!cols->timestamp || !cols->sensor_id || !cols->value || !cols->alert)
+    {
+        DIAG_ERROR("BULK", "Cannot allocate columns for %zu rows", capacity);
+        csv_columns_free(cols);
+        return false;
+    }
+    cols->capacity = capacity;
+    return true;
+}
+
+void csv_columns_free(csv_columns_t *cols)
+{
+    if (cols == NULL)
+        return;
+
+    cache_free(cols->timestamp);
+    cache_free(cols->sensor_id);
+    cache_free(cols->value);
+    cache_free(cols->alert);
+    memset(cols, 0, sizeof(*cols));
+}
+
+void csv_bulk_open_mem(csv_bulk_t *r, const char *data, size_t size)
+{
+    if (r == NULL)
+        return;
+
+    memset(r, 0, sizeof(*r));
+    r->data = data;
+    r->size = (data != NULL) ? size : 0;
+}
+
+bool csv_bulk_open(csv_bulk_t *r, const char *path)
+{
+    if (r == NULL || path == NULL)
+        return false;
+
+    csv_bulk_open_mem(r, NULL, 0);
+
+#ifdef _WIN32
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        DIAG_ERROR("BULK", "Cannot open %s", path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size > 0)
+    {
+        r->map = malloc((size_t)size);
+        if (r->map == NULL || fread(r->map, 1, (size_t)size, f) != (size_t)size)
+        {
+            DIAG_ERROR("BULK", "Cannot read %s", path);
+            free(r->map);
+            r->map = NULL;
+            fclose(f);
+            return false;
+        }
+        r->map_size = (size_t)size;
+    }
+    fclose(f);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        DIAG_ERROR("BULK", "Cannot open %s", path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    if (st.st_size > 0)
+    {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED)
+        {
+            DIAG_ERROR("BULK", "Cannot map %s", path);
+            close(fd);
+            return false;
+        }
+        posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+        r->map      = map;
+        r->map_size = (size_t)st.st_size;
+    }
+    close(fd);                              /* the mapping stays valid */
+#endif
+
+    r->data = r->map;
+    r->size = r->map_size;
+    return true;
+}
+
+void csv_bulk_close(csv_bulk_t *r)
+{
+    if (r == NULL)
+        return;
+
+    if (r->map != NULL)
+    {
+#ifdef _WIN32
+        free(r->map);
+#else
+        munmap(r->map, r->map_size);
+#endif
+    }
+    r->map  = NULL;
+    r->data = NULL;
+    r->size = r->pos = 0;
+}
+
+void csv_bulk_rewind(csv_bulk_t *r)
+{
+    if (r != NULL)
+        r->pos = 0;
+}
+
+size_t csv_bulk_read(csv_bulk_t *r, csv_columns_t *cols)
+{
+    if (r == NULL || cols == NULL || cols->capacity == 0)
+        return 0;
+
+    cols->count = 0;
+    if (r->pos >= r->size)
+        return 0;
+
+    scan_t sc;
+    scan_init(&sc, r->data, r->size, r->pos);
+
+    size_t line = r->pos;
+    while (cols->count < cols->capacity && line < r->size)
+    {
+        /* Cut one line from the masks, noting its first four commas */
+        size_t c[4], at;
+        unsigned commas = 0;
+        bool newline;
+        for (;;)
+        {
+            if (!scan_next(&sc, &at, &newline))
+            {
+                at = r->size;
+                break;
+            }
+            if (newline)
+                break;
+            if (commas < 4)
+                c[commas] = at;
+            commas++;
+        }
+
+        if ((commas >= 4 && fast_row(r, line, c, at, cols, cols->count)) ||
+            parse_row(r, r->data + line, r->data + at, cols, cols->count))
+            cols->count++;
+        line = at + 1;
+    }
+    r->pos = (line < r->size) ? line : r->size;
+    return cols->count;
+}
+
+const char *csv_bulk_isa(void)
+{
+    return BULK_ISA;
+}
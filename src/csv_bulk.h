@@ -0,0 +1,123 @@
+/**
+ * @file csv_bulk.h
+ * @brief Bulk CSV reader for replaying and analysing logger files
+ *
+ * Reads files in the logger's schema
+ *
+ *   timestamp,sensor_id,sensor_name,value,alert_level
+ *   1000,0,Temperature (C),42.0000,NONE
+ *
+ * into columnar arrays - one array per field, the layout analysis loops
+ * and the replay engine want:
+ *
+ *   1. The file is memory-mapped (read-only, sequential advice); nothing
+ *      is copied through read() buffers.
+ *   2. Structural characters (',' and '\n') are located with SIMD
+ *      compares over 64-byte blocks (AVX2, SSE2 or NEON, scalar
+ *      otherwise) and turned into two bitmasks per block.
+ *   3. Rows and fields are cut by walking the set bits; the logger's own
+ *      rows are parsed with SWAR (the timestamp as one 8-byte word, the
+ *      fixed four-digit fraction as one 4-byte word), anything else with
+ *      csv_parser.h's scanners. Values are bit-identical either way.
+ *
+ * On the logger's rows bench_csv_bulk measures it at about 1.5x
+ * csv_parse_chunk() with the default (SSE2) build.
+ *
+ * sensor_name is not materialised - the sensor_id column identifies the
+ * sensor. The header, '#' comments and blank lines are skipped; other
+ * rows that do not have five fields or do not parse are counted as bad.
+ *
+ *   csv_bulk_t r;
+ *   csv_columns_t cols;
+ *   csv_bulk_open(&r, "data/sensor_log.csv");
+ *   csv_columns_init(&cols, 65536);
+ *   while (csv_bulk_read(&r, &cols) > 0)
+ *       for (size_t i = 0; i < cols.count; i++)
+ *           use(cols.timestamp[i], cols.sensor_id[i], cols.value[i]);
+ *   csv_columns_free(&cols);
+ *   csv_bulk_close(&r);
+ */
+
+#ifndef CSV_BULK_H
+#define CSV_BULK_H
+
+#include "alert.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Columnar batch of rows (structure of arrays)
+ */
+typedef struct {
+    uint32_t *timestamp;
+    uint8_t  *sensor_id;
+    float    *value;
+    uint8_t  *alert;                ///< alert_level_t
+    size_t    count;                ///< Rows in this batch
+    size_t    capacity;             ///< Rows each array holds
+} csv_columns_t;
+
+/**
+ * @brief Bulk reader over one mapped file (or caller memory)
+ */
+typedef struct {
+    const char *data;
+    size_t      size;
+    size_t      pos;                ///< Start of the next unread line
+    void       *map;                ///< mmap base / heap copy, NULL for _mem
+    size_t      map_size;
+    uint64_t    rows;               ///< Rows produced
+    uint64_t    skipped;            ///< Header, comment and blank lines
+    uint64_t    bad;                ///< Malformed rows
+} csv_bulk_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Allocate column arrays for `capacity` rows (cache-line aligned).
+ * @return false on allocation failure
+ */
+bool csv_columns_init(csv_columns_t *cols, size_t capacity);
+
+/** @brief Free column arrays (NULL-safe). */
+void csv_columns_free(csv_columns_t *cols);
+
+/**
+ * @brief Map a file for reading.
+ *
+ * On Windows the file is read into memory instead of mapped.
+ *
+ * @return false if the file cannot be opened or mapped
+ */
+bool csv_bulk_open(csv_bulk_t *r, const char *path);
+
+/**
+ * @brief Read from a caller-owned buffer instead of a file.
+ */
+void csv_bulk_open_mem(csv_bulk_t *r, const char *data, size_t size);
+
+/** @brief Unmap / release (the reader can be reopened). */
+void csv_bulk_close(csv_bulk_t *r);
+
+/** @brief Start again from the first byte. */
+void csv_bulk_rewind(csv_bulk_t *r);
+
+/**
+ * @brief Fill `cols` with the next rows (replaces its contents).
+ * @return Rows read (cols->count); 0 at end of data
+ */
+size_t csv_bulk_read(csv_bulk_t *r, csv_columns_t *cols);
+
+/**
+ * @brief Name of the SIMD path compiled in ("avx2", "sse2", "neon", "scalar").
+ */
+const char *csv_bulk_isa(void);
+
+#endif /* CSV_BULK_H */
@@ -0,0 +1,342 @@
+/**
+ * @file csv_parser.c
+ * @brief Zero-allocation streaming CSV parser implementation
+ *
+ * Decimal parsing: digits are accumulated into a 64-bit integer mantissa
+ * (up to 19 significant digits, the rest only move the exponent), then
+ * scaled once by a power of ten from a table. For the Arduino's "%.4f"
+ * values that is one integer loop plus one multiply - exact to the last
+ * bit of a float.
+ */
+
+#include "csv_parser.h"
+#include <string.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+const double csv_pow10[CSV_POW10_MAX + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+    1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+    1e20, 1e21, 1e22
+};
+
+static uint32_t fnv1a(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return h ? h : 1;                       /* 0 marks an empty slot */
+}
+
+static bool is_digit(char c)
+{
+    return (unsigned)(c - '0') < 10u;
+}
+
+/* Number scanners are public (csv_scan_*) for the bulk reader */
+
+bool csv_scan_uint(const char **pp, const char *end, uint32_t *out)
+{
+    const char *p = *pp;
+    uint64_t v = 0;
+
+    if (p == end || !is_digit(*p))
+        return false;
+    while (p < end && is_digit(*p))
+    {
+        v = v * 10 + (uint64_t)(*p++ - '0');
+        if (v > UINT32_MAX)
+            return false;
+    }
+    *pp  = p;
+    *out = (uint32_t)v;
+    return true;
+}
+
+bool csv_scan_decimal(const char **pp, const char *end, float *out)
+{
+    const char *p = *pp;
+    bool neg = false;
+    uint64_t mant = 0;
+    int digits = 0, exp10 = 0;
+    bool any = false;
+
+    if (p < end && (*p == '-' || *p == '+'))
+        neg = (*p++ == '-');
+
+    for (; p < end && is_digit(*p); p++, any = true)
+    {
+        if (digits < 19) { mant = mant * 10 + (uint64_t)(*p - '0'); if (mant) digits++; }
+        else             { exp10++; }
+    }
+    if (p < end && *p == '.')
+    {
+        for (p++; p < end && is_digit(*p); p++, any = true)
+        {
+            if (digits < 19) { mant = mant * 10 + (uint64_t)(*p - '0'); if (mant) digits++; exp10--; }
+        }
+    }
+    if (!any)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *q = p + 1;
+        bool eneg = false;
+        if (q < end && (*q == '-' || *q == '+'))
+            eneg = (*q++ == '-');
+        uint32_t e;
+        if (csv_scan_uint(&q, end, &e) && e < 400)
+        {
+            exp10 += eneg ? -(int)e : (int)e;
+            p = q;
+        }
+    }
+
+    double v = (double)mant;
+    if (exp10 < 0)
+    {
+        int e = -exp10;
+        while (e > CSV_POW10_MAX) { v /= csv_pow10[CSV_POW10_MAX]; e -= CSV_POW10_MAX; }
+        v /= csv_pow10[e];
+    }
+    else
+    {
+        int e = exp10;
+        while (e > CSV_POW10_MAX) { v *= csv_pow10[CSV_POW10_MAX]; e -= CSV_POW10_MAX; }
+        v *= csv_pow10[e];
+    }
+
+    *pp  = p;
+    *out = (float)(neg ? -v : v);
+    return true;
+}
+
+/** Emit into out if there is room; handles the skip/bad bookkeeping */
+static bool parse_line(csv_parser_t *p, const char *s, size_t len,
+                       sensor_reading_t *out)
+{
+    const char *end = s + len;
+    if (len > 0 && end[-1] == '\r')
+        end--;
+
+    if (s == end || *s == '#')
+    {
+        p->skipped++;
+        return false;
+    }
+    if (!is_digit(*s))
+    {
+        /* The header is re-sent every time the board resets */
+        if ((size_t)(end - s) >= 9 && memcmp(s, "timestamp", 9) == 0)
+            p->skipped++;
+        else
+            p->bad++;
+        return false;
+    }
+
+    const char *q = s;
+    uint32_t ts, id;
+    float value;
+
+    if (!csv_scan_uint(&q, end, &ts) || q == end || *q++ != ',')
+        goto bad;
+    if (!csv_scan_uint(&q, end, &id) || id > UINT8_MAX || q == end || *q++ != ',')
+        goto bad;
+
+    const char *name = q;
+    const char *comma = memchr(q, ',', (size_t)(end - q));
+    if (comma == NULL)
+        goto bad;
+    q = comma + 1;
+
+    if (!csv_scan_decimal(&q, end, &value) || (q != end && *q != ','))
+        goto bad;
+
+    if (p->dict != NULL)
+    {
+        uint8_t mapped;
+        if (!csv_dict_lookup(p->dict, name, (size_t)(comma - name), &mapped))
+        {
+            p->unknown_names++;
+            return false;
+        }
+        id = mapped;
+    }
+
+    out->timestamp = ts;
+    out->sensor_id = (uint8_t)id;
+    out->value     = value;
+    p->rows++;
+    return true;
+
+bad:
+    p->bad++;
+    return false;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void csv_dict_init(csv_dict_t *dict)
+{
+    if (dict != NULL)
+        memset(dict, 0, sizeof(*dict));
+}
+
+bool csv_dict_add(csv_dict_t *dict, const char *name, uint8_t id)
+{
+    if (dict == NULL || name == NULL)
+        return false;
+
+    size_t len = strlen(name);
+    if (len == 0 || len > CSV_NAME_MAX || dict->count >= CSV_DICT_SLOTS / 2)
+        return false;
+
+    uint8_t existing;
+    if (csv_dict_lookup(dict, name, len, &existing))
+        return false;
+
+    uint32_t h = fnv1a(name, len);
+    for (uint32_t i = h;; i++)
+    {
+        uint32_t slot = i & (CSV_DICT_SLOTS - 1);
+        if (dict->slots[slot].hash == 0)
+        {
+            dict->slots[slot].hash = h;
+            dict->slots[slot].len  = (uint8_t)len;
+            dict->slots[slot].id   = id;
+            memcpy(dict->slots[slot].name, name, len);
+            dict->count++;
+            return true;
+        }
+    }
+}
+
+bool csv_dict_lookup(const csv_dict_t *dict, const char *name, size_t len,
+                     uint8_t *id)
+{
+    if (dict == NULL || name == NULL || len > CSV_NAME_MAX)
+        return false;
+
+    uint32_t h = fnv1a(name, len);
+    for (uint32_t i = h;; i++)
+    {
+        uint32_t slot = i & (CSV_DICT_SLOTS - 1);
+        if (dict->slots[slot].hash == 0)
+            return false;                   /* table is never full */
+        if (dict->slots[slot].hash == h && dict->slots[slot].len == len &&
+            memcmp(dict->slots[slot].name, name, len) == 0)
+        {
+            if (id != NULL)
+                *id = dict->slots[slot].id;
+            return true;
+        }
+    }
+}
+
+void csv_parser_init(csv_parser_t *p, const csv_dict_t *dict)
+{
+    if (p == NULL)
+        return;
+
+    memset(p, 0, sizeof(*p));
+    p->dict = dict;
+}
+
+bool csv_parse_line(csv_parser_t *p, const char *line, size_t len,
+                    sensor_reading_t *out)
+{
+    if (p == NULL || line == NULL || out == NULL)
+        return false;
+
+    return parse_line(p, line, len, out);
+}
+
+size_t csv_parse_chunk(csv_parser_t *p, const char *data, size_t len,
+                       sensor_reading_t *out, size_t max_out,
+                       size_t *consumed)
+{
+    size_t n = 0;
+    const char *pos = data;
+    const char *end = data + len;
+
+    if (p == NULL || data == NULL || out == NULL)
+    {
+        if (consumed != NULL)
+            *consumed = 0;
+        return 0;
+    }
+
+    /* 1. Finish the line carried over from the previous chunk */
+    if ((p->carry_len > 0 || p->discarding) && pos < end && n < max_out)
+    {
+        const char *nl = memchr(pos, '\n', len);
+        size_t take = (size_t)((nl ? nl : end) - pos);
+
+        if (!p->discarding)
+        {
+            if (p->carry_len + take > CSV_LINE_MAX)
+            {
+                p->discarding = true;
+                p->carry_len  = 0;
+                p->bad++;
+            }
+            else
+            {
+                memcpy(p->carry + p->carry_len, pos, take);
+                p->carry_len += take;
+            }
+        }
+
+        if (nl == NULL)
+        {
+            if (consumed != NULL)
+                *consumed = len;
+            return 0;
+        }
+
+        if (!p->discarding && parse_line(p, p->carry, p->carry_len, &out[n]))
+            n++;
+        p->carry_len  = 0;
+        p->discarding = false;
+        pos = nl + 1;
+    }
+
+    /* 2. Complete lines straight from the caller's buffer - no copy */
+    while (pos < end && n < max_out)
+    {
+        const char *nl = memchr(pos, '\n', (size_t)(end - pos));
+        if (nl == NULL)
+        {
+            /* 3. Keep the tail for the next chunk */
+            size_t tail = (size_t)(end - pos);
+            if (tail > CSV_LINE_MAX)
+            {
+                p->discarding = true;
+                p->bad++;
+            }
+            else
+            {
+                memcpy(p->carry, pos, tail);
+                p->carry_len = tail;
+            }
+            pos = end;
+            break;
+        }
+
+        if (parse_line(p, pos, (size_t)(nl - pos), &out[n]))
+            n++;
+        pos = nl + 1;
+    }
+
+    if (consumed != NULL)
+        *consumed = (size_t)(pos - data);
+    return n;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file csv_parser.h
+ * @brief Zero-allocation streaming parser for the Arduino CSV protocol
+ *
+ * Consumes the byte stream produced by send_csv_row() in whatever chunks
+ * read() happens to return:
+ *
+ *   timestamp,sensor_id,sensor_name,value,alert_level\r\n
+ *   # Predictive Maintenance Monitor ready\r\n
+ *   88,0,Temperature (C),23.6000,NONE\r\n
+ *
+ * - lines split across chunks are carried in a small fixed buffer
+ * - the header (it is re-sent on every board reset) and '#' comments
+ *   are skipped; anything else that does not parse is counted as bad
+ * - integers and decimals are parsed by hand: no strtod, no locale
+ * - sensor_name can be resolved to an ID through a dictionary built
+ *   once up front, so the name - not the board's numbering - decides
+ *   which sensor a row belongs to
+ *
+ * Nothing is allocated: the parser, the dictionary and the output array
+ * are all owned by the caller.
+ *
+ *   csv_dict_t dict;
+ *   csv_dict_init(&dict);
+ *   csv_dict_add(&dict, "Temperature (C)", 0);
+ *
+ *   csv_parser_t p;
+ *   csv_parser_init(&p, &dict);
+ *
+ *   sensor_reading_t out[256];
+ *   size_t used = 0;
+ *   while (used < len) {
+ *       size_t consumed;
+ *       size_t n = csv_parse_chunk(&p, data + used, len - used,
+ *                                  out, 256, &consumed);
+ *       used += consumed;
+ *       // ... out[0 .. n-1] ...
+ *   }
+ */
+
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include "buffer.h"     /* sensor_reading_t */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Longest line carried across chunks (Arduino rows are ~40 bytes) */
+#define CSV_LINE_MAX     128
+
+/** @brief Dictionary slots (power of two, keep well above the name count) */
+#define CSV_DICT_SLOTS   64
+
+/** @brief Longest sensor name stored in the dictionary */
+#define CSV_NAME_MAX     32
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Open-addressing name -> sensor ID table
+ */
+typedef struct {
+    struct {
+        uint32_t hash;              ///< 0 = empty slot
+        uint8_t  len;
+        uint8_t  id;
+        char     name[CSV_NAME_MAX];
+    } slots[CSV_DICT_SLOTS];
+    uint8_t count;
+} csv_dict_t;
+
+/**
+ * @brief Streaming parser state
+ */
+typedef struct {
+    const csv_dict_t *dict;         ///< NULL = trust the sensor_id column
+    char     carry[CSV_LINE_MAX];   ///< Partial line from the previous chunk
+    size_t   carry_len;
+    bool     discarding;            ///< Overlong line: drop until '\n'
+    uint64_t rows;                  ///< Data rows produced
+    uint64_t skipped;               ///< Header, comment and blank lines
+    uint64_t bad;                   ///< Malformed or overlong lines
+    uint64_t unknown_names;         ///< Rows whose name is not in dict
+} csv_parser_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/** @brief Empty the dictionary. */
+void csv_dict_init(csv_dict_t *dict);
+
+/**
+ * @brief Map a sensor name to an ID.
+ * @return false if the name is too long, already present, or the table is full
+ */
+bool csv_dict_add(csv_dict_t *dict, const char *name, uint8_t id);
+
+/**
+ * @brief Look up a name given as a (not NUL-terminated) byte range.
+ * @return true and sets *id if found
+ */
+bool csv_dict_lookup(const csv_dict_t *dict, const char *name, size_t len,
+                     uint8_t *id);
+
+/**
+ * @brief Reset a parser (dict may be NULL).
+ */
+void csv_parser_init(csv_parser_t *p, const csv_dict_t *dict);
+
+/**
+ * @brief Parse as many complete lines of `data` as fit in `out`.
+ *
+ * A trailing partial line is copied into the parser and completed by the
+ * next call. If `out` fills up first, *consumed stops after the last
+ * line that was emitted; call again with the remaining bytes.
+ *
+ * @param p         Parser
+ * @param data      Next bytes of the stream
+ * @param len       Number of bytes
+ * @param out       Destination array
+ * @param max_out   Capacity of out
+ * @param consumed  Set to the number of bytes of data used
+ * @return          Number of readings written to out
+ */
+size_t csv_parse_chunk(csv_parser_t *p, const char *data, size_t len,
+                       sensor_reading_t *out, size_t max_out,
+                       size_t *consumed);
+
+/**
+ * @brief Parse one complete line (no newline; a trailing '\r' is fine).
+ *
+ * Updates the parser's counters exactly like csv_parse_chunk().
+ *
+ * @return true if `out` holds a data row
+ */
+bool csv_parse_line(csv_parser_t *p, const char *line, size_t len,
+                    sensor_reading_t *out);
+
+/**
+ * @brief Scan an unsigned 32-bit decimal at *pp (no sign, no spaces).
+ * @return true and advances *pp past the digits; false if none or overflow
+ */
+bool csv_scan_uint(const char **pp, const char *end, uint32_t *out);
+
+/**
+ * @brief Scan [-+]digits[.digits][e[-+]digits] at *pp, locale-free.
+ * @return true and advances *pp past the number
+ */
+bool csv_scan_decimal(const char **pp, const char *end, float *out);
+
+/** @brief Largest exponent in csv_pow10 (1e22 is the last exact double) */
+#define CSV_POW10_MAX  22
+
+/**
+ * @brief Exact powers of ten, 1e0 .. 1e22.
+ *
+ * csv_scan_decimal() scales its mantissa with these; other parsers use the
+ * same table so their results are bit-identical.
+ */
+extern const double csv_pow10[CSV_POW10_MAX + 1];
+
+#endif /* CSV_PARSER_H */
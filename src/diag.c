@@ -0,0 +1,74 @@
+/**
+ * @file diag.c
+ * @brief Leveled diagnostics: runtime level, sink and formatting
+ *
+ * Only diag_emit() is out of line, and it is reached only for messages
+ * that pass both filters, so the formatting cost is paid by what is
+ * actually printed.
+ */
+
+#include "diag.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+atomic_int diag_runtime_level = DIAG_LEVEL_WARN;
+
+static void stderr_sink(void *ctx, int level, const char *module, const char *msg);
+
+static diag_sink_fn g_sink     = stderr_sink;
+static void        *g_sink_ctx = NULL;
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static void stderr_sink(void *ctx, int level, const char *module, const char *msg)
+{
+    (void)ctx;
+    if (level >= DIAG_LEVEL_WARN)
+        fprintf(stderr, "[%s] %s: %s\n", module, diag_level_name(level), msg);
+    else
+        fprintf(stderr, "[%s] %s\n", module, msg);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void diag_set_level(int level)
+{
+    if (level < DIAG_LEVEL_DEBUG)
+        level = DIAG_LEVEL_DEBUG;
+    if (level > DIAG_LEVEL_OFF)
+        level = DIAG_LEVEL_OFF;
+    atomic_store_explicit(&diag_runtime_level, level, memory_order_relaxed);
+}
+
+int diag_get_level(void)
+{
+    return atomic_load_explicit(&diag_runtime_level, memory_order_relaxed);
+}
+
+void diag_set_sink(diag_sink_fn fn, void *ctx)
+{
+    g_sink     = fn != NULL ? fn : stderr_sink;
+    g_sink_ctx = fn != NULL ? ctx : NULL;
+}
+
+const char *diag_level_name(int level)
+{
+    static const char *const k_names[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+    return level >= DIAG_LEVEL_DEBUG && level < DIAG_LEVEL_OFF ? k_names[level]
+                                                               : "?";
+}
+
+void diag_emit(int level, const char *module, const char *fmt, ...)
+{
+    char line[DIAG_LINE_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(line, sizeof(line), fmt, ap);
+    va_end(ap);
+
+    g_sink(g_sink_ctx, level, module != NULL ? module : "?", line);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file diag.h
+ * @brief Leveled diagnostics for the library ("[MANAGER] Registered ...")
+ *
+ * Library code never writes to stdout itself: status and error messages
+ * go through DIAG_DEBUG / DIAG_INFO / DIAG_WARN / DIAG_ERROR, which are
+ * filtered twice:
+ *
+ *   DIAG_MIN_LEVEL   compile time (-DDIAG_MIN_LEVEL=DIAG_LEVEL_WARN);
+ *                    calls below it are dead code the compiler removes
+ *   diag_set_level() run time, default DIAG_LEVEL_WARN; a filtered call
+ *                    costs one relaxed load and a compare, and its
+ *                    arguments are never evaluated
+ *
+ * Messages that pass are formatted into a line and handed to the sink,
+ * by default stderr as "[MODULE] text" or "[MODULE] ERROR: text":
+ *
+ *   DIAG_INFO("MANAGER", "Registered sensor id=%u", id);
+ *   ...
+ *   diag_set_level(DIAG_LEVEL_INFO);          e.g. for a -v flag
+ *   diag_set_sink(my_sink, my_ctx);           syslog, a test buffer, ...
+ *
+ * Report functions the caller asks for (manager_print_stats,
+ * hist_print, ...) and alert lines still print to stdout directly.
+ */
+
+#ifndef DIAG_H
+#define DIAG_H
+
+#include <stdatomic.h>
+
+/* ============================================================================
+ * LEVELS
+ * ========================================================================== */
+
+#define DIAG_LEVEL_DEBUG    0   ///< Allocation and teardown chatter
+#define DIAG_LEVEL_INFO     1   ///< Configuration and lifecycle events
+#define DIAG_LEVEL_WARN     2   ///< Recoverable problems
+#define DIAG_LEVEL_ERROR    3   ///< A call failed
+#define DIAG_LEVEL_OFF      4   ///< Nothing (as a level only)
+
+/** @brief Lowest level compiled in; calls below it vanish */
+#ifndef DIAG_MIN_LEVEL
+#define DIAG_MIN_LEVEL      DIAG_LEVEL_DEBUG
+#endif
+
+/** @brief Longest message passed to a sink (longer ones are truncated) */
+#define DIAG_LINE_MAX       256
+
+/**
+ * @brief Receives every message that passes both filters.
+ *
+ * Called on the thread that logged, possibly from several at once.
+ * `msg` has no trailing newline and is only valid during the call.
+ */
+typedef void (*diag_sink_fn)(void *ctx, int level, const char *module,
+                             const char *msg);
+
+/* ============================================================================
+ * API
+ * ========================================================================== */
+
+/** @brief Runtime threshold; read inline by the DIAG_* macros */
+extern atomic_int diag_runtime_level;
+
+/** @brief Emit messages at `level` and above (DIAG_LEVEL_OFF for none) */
+void diag_set_level(int level);
+
+/** @brief Current runtime level */
+int diag_get_level(void);
+
+/**
+ * @brief Send messages to `fn` instead of stderr; NULL restores stderr.
+ *
+ * Install it before starting threads that may log.
+ */
+void diag_set_sink(diag_sink_fn fn, void *ctx);
+
+/** @brief "DEBUG", "INFO", "WARN", "ERROR" */
+const char *diag_level_name(int level);
+
+/** @brief Format and hand to the sink; use the macros instead */
+void diag_emit(int level, const char *module, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/* ============================================================================
+ * MACROS
+ * ========================================================================== */
+
+#define DIAG_ENABLED(level)                                                 \
+    ((level) >= DIAG_MIN_LEVEL &&                                           \
+     (level) >= atomic_load_explicit(&diag_runtime_level,                   \
+                                     memory_order_relaxed))
+
+#define DIAG_LOG(level, module, ...)                                        \
+    do {                                                                    \
+        if (DIAG_ENABLED(level))                                            \
+            diag_emit((level), (module), __VA_ARGS__);                      \
+    } while (0)
+
+#define DIAG_DEBUG(module, ...)  DIAG_LOG(DIAG_LEVEL_DEBUG, module, __VA_ARGS__)
+#define DIAG_INFO(module, ...)   DIAG_LOG(DIAG_LEVEL_INFO,  module, __VA_ARGS__)
+#define DIAG_WARN(module, ...)   DIAG_LOG(DIAG_LEVEL_WARN,  module, __VA_ARGS__)
+#define DIAG_ERROR(module, ...)  DIAG_LOG(DIAG_LEVEL_ERROR, module, __VA_ARGS__)
+
+#endif /* DIAG_H */
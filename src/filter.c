@@ -0,0 +1,261 @@
+/**
+ * @file filter.c
+ * @brief Per-sensor digital filter pipeline implementation
+ *
+ * Sliding median, in brief:
+ *   While the window is filling, samples are pushed onto whichever heap
+ *   keeps the halves balanced (lo holds the extra one for odd counts).
+ *   Once full, the oldest slot is overwritten IN PLACE and re-sifted inside
+ *   its own heap. That can only break the "max(lo) <= min(hi)" rule at the
+ *   two tops, and a single swap of the tops restores it — so heap sizes
+ *   never change and every update is O(log w).
+ */
+
+#include "filter.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS — median heaps
+ * ========================================================================== */
+
+/** True if slot a belongs above slot b in the heap on `side` */
+static bool heap_above(const median_state_t *m, uint8_t side,
+                       uint8_t a, uint8_t b)
+{
+    return (side == 0) ? (m->val[a] > m->val[b])    /* lo: max-heap */
+                       : (m->val[a] < m->val[b]);   /* hi: min-heap */
+}
+
+static uint8_t *heap_of(median_state_t *m, uint8_t side)
+{
+    return (side == 0) ? m->lo : m->hi;
+}
+
+static uint8_t heap_count(const median_state_t *m, uint8_t side)
+{
+    return (side == 0) ? m->lo_count : m->hi_count;
+}
+
+static void heap_swap(median_state_t *m, uint8_t side, uint8_t i, uint8_t j)
+{
+    uint8_t *h = heap_of(m, side);
+    uint8_t tmp = h[i];
+    h[i] = h[j];
+    h[j] = tmp;
+    m->hpos[h[i]] = i;
+    m->hpos[h[j]] = j;
+}
+
+static void heap_sift_up(median_state_t *m, uint8_t side, uint8_t i)
+{
+    uint8_t *h = heap_of(m, side);
+    while (i > 0) {
+        uint8_t parent = (uint8_t)((i - 1) / 2);
+        if (!heap_above(m, side, h[i], h[parent]))
+            break;
+        heap_swap(m, side, i, parent);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(median_state_t *m, uint8_t side, uint8_t i)
+{
+    uint8_t *h = heap_of(m, side);
+    uint8_t n  = heap_count(m, side);
+    for (;;) {
+        uint8_t best  = i;
+        uint8_t left  = (uint8_t)(2 * i + 1);
+        uint8_t right = (uint8_t)(2 * i + 2);
+        if (left < n && heap_above(m, side, h[left], h[best]))
+            best = left;
+        if (right < n && heap_above(m, side, h[right], h[best]))
+            best = right;
+        if (best == i)
+            break;
+        heap_swap(m, side, i, best);
+        i = best;
+    }
+}
+
+static void heap_push(median_state_t *m, uint8_t side, uint8_t slot)
+{
+    uint8_t *h = heap_of(m, side);
+    uint8_t  n = (side == 0) ? m->lo_count++ : m->hi_count++;
+    h[n]          = slot;
+    m->side[slot] = side;
+    m->hpos[slot] = n;
+    heap_sift_up(m, side, n);
+}
+
+static uint8_t heap_pop(median_state_t *m, uint8_t side)
+{
+    uint8_t *h   = heap_of(m, side);
+    uint8_t  top = h[0];
+    uint8_t  n   = (side == 0) ? --m->lo_count : --m->hi_count;
+    if (n > 0) {
+        h[0]          = h[n];
+        m->hpos[h[0]] = 0;
+        heap_sift_down(m, side, 0);
+    }
+    return top;
+}
+
+static float median_process(median_state_t *m, uint8_t window, float value)
+{
+    uint8_t slot = m->next;
+    m->next = (uint8_t)((m->next + 1) % window);
+    m->val[slot] = value;
+
+    if (m->lo_count + m->hi_count < window) {
+        /* Filling: push to the correct half, then rebalance */
+        if (m->lo_count == 0 || value <= m->val[m->lo[0]])
+            heap_push(m, 0, slot);
+        else
+            heap_push(m, 1, slot);
+
+        if (m->lo_count > m->hi_count + 1)
+            heap_push(m, 1, heap_pop(m, 0));
+        else if (m->hi_count > m->lo_count)
+            heap_push(m, 0, heap_pop(m, 1));
+    } else {
+        /* Full: overwrite the oldest slot in place */
+        uint8_t side = m->side[slot];
+        heap_sift_up(m, side, m->hpos[slot]);
+        heap_sift_down(m, side, m->hpos[slot]);
+
+        if (m->hi_count > 0 && m->val[m->lo[0]] > m->val[m->hi[0]]) {
+            uint8_t a = m->lo[0];
+            uint8_t b = m->hi[0];
+            m->lo[0] = b;  m->side[b] = 0;  m->hpos[b] = 0;
+            m->hi[0] = a;  m->side[a] = 1;  m->hpos[a] = 0;
+            heap_sift_down(m, 0, 0);
+            heap_sift_down(m, 1, 0);
+        }
+    }
+
+    if (m->lo_count > m->hi_count)
+        return m->val[m->lo[0]];
+    return 0.5f * (m->val[m->lo[0]] + m->val[m->hi[0]]);
+}
+
+/* ============================================================================
+ * PRIVATE HELPERS — moving average and biquad
+ * ========================================================================== */
+
+static float moving_avg_process(moving_avg_state_t *a, uint8_t window,
+                                float value)
+{
+    if (a->count == window)
+        a->sum -= a->val[a->next];
+    else
+        a->count++;
+
+    a->val[a->next] = value;
+    a->sum += value;
+    a->next = (uint8_t)((a->next + 1) % window);
+
+    return (float)(a->sum / a->count);
+}
+
+static float biquad_process(biquad_state_t *s, const biquad_coeffs_t *c,
+                            float x)
+{
+    float y = c->b0 * x + s->z1;
+    s->z1   = c->b1 * x - c->a1 * y + s->z2;
+    s->z2   = c->b2 * x - c->a2 * y;
+    return y;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void filter_chain_init(filter_chain_t *chain)
+{
+    if (chain == NULL)
+        return;
+
+    memset(chain, 0, sizeof(*chain));
+}
+
+bool filter_chain_add(filter_chain_t *chain, const filter_stage_config_t *cfg)
+{
+    if (chain == NULL || cfg == NULL || chain->count >= FILTER_MAX_STAGES)
+        return false;
+
+    switch (cfg->type) {
+    case FILTER_MEDIAN:
+    case FILTER_MOVING_AVG:
+        if (cfg->window == 0 || cfg->window > FILTER_MAX_WINDOW)
+            return false;
+        break;
+    case FILTER_BIQUAD:
+        break;
+    default:
+        return false;
+    }
+
+    filter_stage_t *stage = &chain->stages[chain->count++];
+    memset(stage, 0, sizeof(*stage));
+    stage->cfg = *cfg;
+    return true;
+}
+
+float filter_chain_process(filter_chain_t *chain, float value)
+{
+    if (chain == NULL)
+        return value;
+
+    for (uint8_t i = 0; i < chain->count; i++) {
+        filter_stage_t *stage = &chain->stages[i];
+        switch (stage->cfg.type) {
+        case FILTER_MEDIAN:
+            value = median_process(&stage->state.median,
+                                   stage->cfg.window, value);
+            break;
+        case FILTER_MOVING_AVG:
+            value = moving_avg_process(&stage->state.avg,
+                                       stage->cfg.window, value);
+            break;
+        case FILTER_BIQUAD:
+            value = biquad_process(&stage->state.biquad,
+                                   &stage->cfg.biquad, value);
+            break;
+        default:
+            break;
+        }
+    }
+    return value;
+}
+
+void filter_chain_reset(filter_chain_t *chain)
+{
+    if (chain == NULL)
+        return;
+
+    /* Keep each stage's configuration, forget its history */
+    for (uint8_t i = 0; i < chain->count; i++)
+        memset(&chain->stages[i].state, 0, sizeof(chain->stages[i].state));
+}
+
+biquad_coeffs_t filter_biquad_lowpass(float sample_rate, float cutoff, float q)
+{
+    /* RBJ Audio EQ Cookbook low-pass, normalised by a0 */
+    biquad_coeffs_t c = { .b0 = 1.0f };
+    if (sample_rate <= 0.0f || cutoff <= 0.0f || q <= 0.0f ||
+        cutoff >= 0.5f * sample_rate)
+        return c;                           /* pass-through */
+
+    float w0    = 2.0f * 3.14159265f * cutoff / sample_rate;
+    float cosw  = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0    = 1.0f + alpha;
+
+    c.b0 = ((1.0f - cosw) * 0.5f) / a0;
+    c.b1 = (1.0f - cosw) / a0;
+    c.b2 = c.b0;
+    c.a1 = (-2.0f * cosw) / a0;
+    c.a2 = (1.0f - alpha) / a0;
+    return c;
+}
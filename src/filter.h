@@ -0,0 +1,133 @@
+/**
+ * @file filter.h
+ * @brief Per-sensor digital filter pipeline
+ *
+ * A filter chain is a short, fixed list of stages applied to every raw
+ * reading before it reaches stats, thresholds and anomaly detection:
+ *
+ *   raw -> [median] -> [moving average] -> [biquad IIR] -> conditioned
+ *
+ * All state lives inside the chain itself (no malloc), so embedding one in
+ * each sensor_t preallocates everything and a reading costs zero heap work.
+ *
+ *   FILTER_MEDIAN      - removes single-sample spikes, O(log w) per sample
+ *   FILTER_MOVING_AVG  - smooths white noise, O(1) per sample
+ *   FILTER_BIQUAD      - second-order IIR (low-pass, notch, ...), O(1)
+ */
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum number of stages in one chain */
+#define FILTER_MAX_STAGES  4
+
+/** @brief Maximum median / moving-average window length */
+#define FILTER_MAX_WINDOW  31
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Stage kinds
+ */
+typedef enum {
+    FILTER_NONE = 0,        ///< Unused stage slot
+    FILTER_MEDIAN,          ///< Sliding-window median
+    FILTER_MOVING_AVG,      ///< Sliding-window mean
+    FILTER_BIQUAD           ///< Second-order IIR section
+} filter_type_t;
+
+/**
+ * @brief Biquad coefficients, normalised so a0 == 1
+ *
+ *   y[n] = b0*x[n] + b1*x[n-1] + b2*x[n-2] - a1*y[n-1] - a2*y[n-2]
+ */
+typedef struct {
+    float b0, b1, b2;
+    float a1, a2;
+} biquad_coeffs_t;
+
+/**
+ * @brief Configuration for one stage
+ */
+typedef struct {
+    filter_type_t   type;       ///< Stage kind
+    uint8_t         window;     ///< Window length (MEDIAN / MOVING_AVG)
+    biquad_coeffs_t biquad;     ///< Coefficients (BIQUAD)
+} filter_stage_config_t;
+
+/**
+ * @brief Sliding median as two heaps over a ring of samples
+ *
+ * `lo` is a max-heap of the smaller half, `hi` a min-heap of the larger
+ * half. Each ring slot remembers which heap it is in and where, so the
+ * oldest sample can be overwritten in place and re-sifted in O(log w).
+ */
+typedef struct {
+    float   val[FILTER_MAX_WINDOW];     ///< Samples, ring order
+    uint8_t lo[FILTER_MAX_WINDOW];      ///< Max-heap of slot indices
+    uint8_t hi[FILTER_MAX_WINDOW];      ///< Min-heap of slot indices
+    uint8_t side[FILTER_MAX_WINDOW];    ///< 0 = slot in lo, 1 = slot in hi
+    uint8_t hpos[FILTER_MAX_WINDOW];    ///< Slot's index within its heap
+    uint8_t lo_count;
+    uint8_t hi_count;
+    uint8_t next;                       ///< Ring slot to overwrite next
+} median_state_t;
+
+/**
+ * @brief Sliding mean over a ring of samples
+ */
+typedef struct {
+    float   val[FILTER_MAX_WINDOW];
+    double  sum;                        ///< double keeps long runs drift-free
+    uint8_t count;
+    uint8_t next;
+} moving_avg_state_t;
+
+/**
+ * @brief Biquad delay line (transposed direct form II)
+ */
+typedef struct {
+    float z1, z2;
+} biquad_state_t;
+
+/**
+ * @brief One configured stage plus its history
+ */
+typedef struct {
+    filter_stage_config_t cfg;
+    union {
+        median_state_t     median;
+        moving_avg_state_t avg;
+        biquad_state_t     biquad;
+    } state;
+} filter_stage_t;
+
+/**
+ * @brief An ordered list of stages — an empty chain is a pass-through
+ */
+typedef struct {
+    filter_stage_t stages[FILTER_MAX_STAGES];
+    uint8_t        count;
+} filter_chain_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void  filter_chain_init(filter_chain_t *chain);
+bool  filter_chain_add(filter_chain_t *chain, const filter_stage_config_t *cfg);
+float filter_chain_process(filter_chain_t *chain, float value);
+void  filter_chain_reset(filter_chain_t *chain);
+
+biquad_coeffs_t filter_biquad_lowpass(float sample_rate, float cutoff, float q);
+
+#endif /* FILTER_H */
@@ -0,0 +1,243 @@
+/**
+ * @file frame.c
+ * @brief Binary serial framing implementation
+ *
+ * The decoder keeps at most one frame's worth of bytes. Input is copied
+ * into it only up to the end of the current frame, so on a bad CRC the
+ * buffered bytes are exactly the ones that must be re-scanned for the
+ * next SYNC.
+ */
+
+#include "frame.h"
+#include <string.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+/* CRC-16/CCITT, 4 bits at a time: a 32-byte table instead of 512 */
+static const uint16_t k_crc_nibble[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static bool valid_len(uint8_t len)
+{
+    return len >= 6 && len <= 4 + 2 * FRAME_MAX_SAMPLES && (len & 1) == 0;
+}
+
+/** Drop buf[0] (a false SYNC) and keep the rest for re-scanning */
+static void drop_first(frame_decoder_t *d)
+{
+    d->len--;
+    memmove(d->buf, d->buf + 1, d->len);
+    d->skipped++;
+}
+
+/** Emit a CRC-checked frame from buf; returns readings written */
+static size_t emit(frame_decoder_t *d, sensor_reading_t *out)
+{
+    uint8_t  id     = d->buf[2];
+    int16_t  dt     = (int16_t)get16(&d->buf[3]);
+    uint8_t  period = d->buf[5];
+    size_t   n      = (size_t)(d->buf[1] - 4) / 2;
+    const uint8_t *c = &d->buf[FRAME_HEADER];
+
+    if (id == FRAME_ID_TIME)
+    {
+        d->time_ms = (uint32_t)get16(c) | ((uint32_t)get16(c + 2) << 16);
+        d->time_frames++;
+        return 0;
+    }
+
+    d->time_ms += (uint32_t)(int32_t)dt;
+    float scale = (id < FRAME_MAX_SENSORS) ? d->scale[id] : 0.0f;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        int16_t raw = (int16_t)get16(c + 2 * i);
+        out[i].sensor_id = id;
+        out[i].timestamp = d->time_ms + (uint32_t)(i * period);
+        out[i].value     = (scale != 0.0f) ? (float)raw * scale : (float)raw;
+    }
+    d->frames++;
+    d->samples += n;
+    return n;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+uint16_t frame_crc16(const uint8_t *data, size_t len)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ k_crc_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ k_crc_nibble[(crc >> 12) ^ (data[i] & 0x0F)]);
+    }
+    return crc;
+}
+
+size_t frame_encode(uint8_t *dst, size_t cap, uint8_t id, int16_t dt_ms,
+                    uint8_t period, const int16_t *counts, uint8_t n)
+{
+    size_t total = FRAME_OVERHEAD + 2u * n;
+    if (dst == NULL || counts == NULL || n == 0 || n > FRAME_MAX_SAMPLES ||
+        id == FRAME_ID_TIME || cap < total)
+        return 0;
+
+    dst[0] = FRAME_SYNC;
+    dst[1] = (uint8_t)(4 + 2 * n);
+    dst[2] = id;
+    put16(&dst[3], (uint16_t)dt_ms);
+    dst[5] = period;
+    for (uint8_t i = 0; i < n; i++)
+        put16(&dst[FRAME_HEADER + 2 * i], (uint16_t)counts[i]);
+    put16(&dst[total - 2], frame_crc16(&dst[1], total - 3));
+    return total;
+}
+
+size_t frame_encode_time(uint8_t *dst, size_t cap, uint32_t time_ms)
+{
+    size_t total = FRAME_OVERHEAD + 4;
+    if (dst == NULL || cap < total)
+        return 0;
+
+    dst[0] = FRAME_SYNC;
+    dst[1] = 8;
+    dst[2] = FRAME_ID_TIME;
+    put16(&dst[3], 0);
+    dst[5] = 0;
+    put16(&dst[6], (uint16_t)(time_ms & 0xFFFF));
+    put16(&dst[8], (uint16_t)(time_ms >> 16));
+    put16(&dst[10], frame_crc16(&dst[1], 9));
+    return total;
+}
+
+void frame_decoder_init(frame_decoder_t *d)
+{
+    if (d != NULL)
+        memset(d, 0, sizeof(*d));
+}
+
+bool frame_set_scale(frame_decoder_t *d, uint8_t id, float scale)
+{
+    if (d == NULL || id >= FRAME_MAX_SENSORS)
+        return false;
+
+    d->scale[id] = scale;
+    return true;
+}
+
+size_t frame_decode(frame_decoder_t *d, const uint8_t *data, size_t len,
+                    sensor_reading_t *out, size_t max_out, size_t *consumed)
+{
+    size_t n = 0;
+    const uint8_t *pos = data;
+    const uint8_t *end = data + len;
+
+    if (d == NULL || (data == NULL && len > 0) || out == NULL)
+    {
+        if (consumed != NULL)
+            *consumed = 0;
+        return 0;
+    }
+
+    for (;;)
+    {
+        /* 1. Hunt for SYNC - in the buffer after a resync, else in data */
+        if (d->len > 0 && d->buf[0] != FRAME_SYNC)
+        {
+            drop_first(d);
+            continue;
+        }
+        if (d->len == 0)
+        {
+            if (pos == end)
+                break;
+            const uint8_t *s = memchr(pos, FRAME_SYNC, (size_t)(end - pos));
+            if (s == NULL)
+            {
+                d->skipped += (uint64_t)(end - pos);
+                pos = end;
+                break;
+            }
+            d->skipped += (uint64_t)(s - pos);
+            d->buf[0] = FRAME_SYNC;
+            d->len = 1;
+            pos = s + 1;
+            continue;
+        }
+
+        /* 2. Work out how long this frame is */
+        size_t need = 2;
+        if (d->len >= 2)
+        {
+            if (!valid_len(d->buf[1]))
+            {
+                d->length_errors++;
+                drop_first(d);
+                continue;
+            }
+            need = 2u + d->buf[1] + 2u;
+        }
+
+        /* 3. Copy up to the end of the frame, never past it */
+        if (d->len < need)
+        {
+            size_t take = need - d->len;
+            if (take > (size_t)(end - pos))
+                take = (size_t)(end - pos);
+            if (take == 0)
+                break;
+
+            /* Do not take a frame's last bytes unless its readings fit */
+            if (d->len >= 2 && d->len + take == need)
+            {
+                uint8_t id = (d->len > 2) ? d->buf[2] : pos[0];
+                size_t samples = (size_t)(d->buf[1] - 4) / 2;
+                if (id != FRAME_ID_TIME && n + samples > max_out)
+                    break;
+            }
+
+            memcpy(d->buf + d->len, pos, take);
+            d->len += take;
+            pos    += take;
+            continue;
+        }
+
+        /* 4. Complete frame: check and emit */
+        if (get16(&d->buf[need - 2]) != frame_crc16(&d->buf[1], need - 3))
+        {
+            d->crc_errors++;
+            drop_first(d);
+            continue;
+        }
+
+        size_t samples = (d->buf[2] == FRAME_ID_TIME) ? 0 : (size_t)(d->buf[1] - 4) / 2;
+        if (n + samples > max_out)
+            break;                          /* only after a resync: next call */
+        n += emit(d, out + n);
+
+        /* After a resync the buffer can already hold the next frame's start */
+        d->len -= need;
+        memmove(d->buf, d->buf + need, d->len);
+    }
+
+    if (consumed != NULL)
+        *consumed = (size_t)(pos - data);
+    return n;
+}
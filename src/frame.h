@@ -0,0 +1,130 @@
+/**
+ * @file frame.h
+ * @brief Compact binary framing for the Arduino -> host serial link
+ *
+ * The CSV rows cost ~40 bytes per reading, which caps a 9600-baud link at
+ * about 24 readings/s. A frame carries a batch of raw counts from one
+ * sensor in 2 bytes per sample plus 8 bytes of overhead:
+ *
+ *   offset  size  field
+ *   0       1     SYNC     0xA5
+ *   1       1     LEN      bytes from ID to the last count (4 + 2n)
+ *   2       1     ID       sensor ID (FRAME_ID_TIME = time-base frame)
+ *   3       2     DT       int16 LE, ms since the previous frame's first sample
+ *   5       1     PERIOD   ms between the samples in this frame
+ *   6       2n    COUNTS   n x int16 LE raw counts (n = 1..FRAME_MAX_SAMPLES)
+ *   6+2n    2     CRC      CRC-16/CCITT-FALSE LE over LEN..COUNTS
+ *
+ * A 16-sample frame is 40 bytes - 2.5 bytes per reading, 16x the CSV rate.
+ *
+ * Timestamps are delta-coded: a frame's first sample is at the previous
+ * frame's first sample + DT, and sample i at that + i * PERIOD. The board
+ * sends a time-base frame (ID FRAME_ID_TIME, two counts = uint32 ms, low
+ * word first) at start-up, periodically, and whenever DT would not fit.
+ * After corruption the host's clock is off by at most the DTs it lost,
+ * until the next time-base frame.
+ *
+ * Counts become engineering units through a per-sensor scale set on the
+ * decoder (e.g. 0.01 for centi-degrees); unscaled sensors pass counts
+ * through as-is.
+ *
+ * Resynchronisation: the decoder hunts for SYNC, checks LEN, and verifies
+ * the CRC. On a bad length or CRC it drops only the SYNC byte it locked
+ * onto and re-scans the bytes it had buffered, so a frame that begins
+ * inside a corrupted one is still found.
+ */
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "buffer.h"     /* sensor_reading_t */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+#define FRAME_SYNC          0xA5
+#define FRAME_ID_TIME       0xFF    ///< Time-base frame (not a sensor)
+#define FRAME_MAX_SAMPLES   32      ///< Counts per frame
+#define FRAME_HEADER        6       ///< SYNC..PERIOD
+#define FRAME_OVERHEAD      8       ///< Header + CRC
+#define FRAME_MAX_BYTES     (FRAME_OVERHEAD + 2 * FRAME_MAX_SAMPLES)
+#define FRAME_MAX_SENSORS   32      ///< Sensor IDs that can carry a scale
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Streaming frame decoder state (caller-allocated)
+ */
+typedef struct {
+    uint8_t  buf[FRAME_MAX_BYTES];          ///< Bytes of the frame in progress
+    size_t   len;                           ///< Bytes in buf[]
+    uint32_t time_ms;                       ///< First-sample time of the last frame
+    float    scale[FRAME_MAX_SENSORS];      ///< counts -> units; 0 = pass through
+    uint64_t frames;                        ///< Good sensor frames
+    uint64_t time_frames;                   ///< Good time-base frames
+    uint64_t samples;                       ///< Readings produced
+    uint64_t crc_errors;                    ///< Frames dropped on CRC
+    uint64_t length_errors;                 ///< Impossible LEN after SYNC
+    uint64_t skipped;                       ///< Bytes discarded while hunting
+} frame_decoder_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ */
+uint16_t frame_crc16(const uint8_t *data, size_t len);
+
+/**
+ * @brief Encode one sensor frame.
+ *
+ * @param dst     Output (at least FRAME_OVERHEAD + 2n bytes)
+ * @param cap     Capacity of dst
+ * @param id      Sensor ID (not FRAME_ID_TIME)
+ * @param dt_ms   ms since the previous frame's first sample
+ * @param period  ms between samples
+ * @param counts  Raw counts
+ * @param n       Number of counts, 1..FRAME_MAX_SAMPLES
+ * @return        Bytes written, 0 on bad arguments
+ */
+size_t frame_encode(uint8_t *dst, size_t cap, uint8_t id, int16_t dt_ms,
+                    uint8_t period, const int16_t *counts, uint8_t n);
+
+/**
+ * @brief Encode a time-base frame carrying an absolute ms timestamp.
+ * @return Bytes written, 0 if cap is too small
+ */
+size_t frame_encode_time(uint8_t *dst, size_t cap, uint32_t time_ms);
+
+/**
+ * @brief Reset a decoder (scales cleared, clock at 0).
+ */
+void frame_decoder_init(frame_decoder_t *d);
+
+/**
+ * @brief Readings of sensor `id` become counts * scale.
+ * @return false if id >= FRAME_MAX_SENSORS
+ */
+bool frame_set_scale(frame_decoder_t *d, uint8_t id, float scale);
+
+/**
+ * @brief Decode as many complete frames of `data` as fit in `out`.
+ *
+ * Works like csv_parse_chunk(): partial frames are kept in the decoder,
+ * and if a frame does not fit in the remaining space of `out`,
+ * *consumed stops before it so the caller can call again.
+ *
+ * @return Number of readings written to out
+ */
+size_t frame_decode(frame_decoder_t *d, const uint8_t *data, size_t len,
+                    sensor_reading_t *out, size_t max_out, size_t *consumed);
+
+#endif /* FRAME_H */
@@ -0,0 +1,238 @@
+/**
+ * @file histogram.c
+ * @brief Log-linear latency histogram implementation
+ *
+ * Bucket layout: values below 2^HIST_SUB_BITS index their own counter.
+ * A larger value whose top bit is bit m is shifted right until it fits
+ * in HIST_SUB_BITS bits (shift = m - HIST_SUB_BITS + 1); the shifted
+ * value lies in [HIST_HALF, 2 * HIST_HALF), so
+ *
+ *   index = shift * HIST_HALF + (value >> shift)
+ *
+ * continues exactly where the previous power of two ended, and every
+ * bucket is 2^shift wide - 1/HIST_HALF of the values it holds.
+ *
+ * The single writer updates each counter with a relaxed load and a
+ * relaxed store rather than an atomic add: on x86 and ARM both are plain
+ * moves, while readers on other threads still get a well-defined value.
+ */
+
+#include "histogram.h"
+#include "cacheline.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static size_t bucket_of(uint64_t v)
+{
+    if (v < (1u << HIST_SUB_BITS))
+        return (size_t)v;
+
+    unsigned msb   = 63u - (unsigned)__builtin_clzll(v);
+    unsigned shift = msb - HIST_SUB_BITS + 1u;
+    return (size_t)shift * HIST_HALF + (size_t)(v >> shift);
+}
+
+/** Largest value that lands in bucket `i` */
+static uint64_t bucket_upper(size_t i)
+{
+    if (i < (1u << HIST_SUB_BITS))
+        return (uint64_t)i;
+
+    unsigned shift = (unsigned)(i / HIST_HALF) - 1u;
+    uint64_t sub   = (uint64_t)(i - (size_t)shift * HIST_HALF);
+    return ((sub + 1u) << shift) - 1u;
+}
+
+static inline uint64_t load(const _Atomic uint64_t *c)
+{
+    return atomic_load_explicit(c, memory_order_relaxed);
+}
+
+static inline void store(_Atomic uint64_t *c, uint64_t v)
+{
+    atomic_store_explicit(c, v, memory_order_relaxed);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+hist_t *hist_create(void)
+{
+    hist_t *h = cache_alloc(sizeof(hist_t));
+    if (h == NULL)
+    {
+        DIAG_ERROR("HIST", "Out of memory");
+        return NULL;
+    }
+    hist_reset(h);
+    return h;
+}
+
+void hist_destroy(hist_t *h)
+{
+    cache_free(h);
+}
+
+void hist_reset(hist_t *h)
+{
+    if (h == NULL)
+        return;
+
+    store(&h->count, 0);
+    store(&h->sum, 0);
+    store(&h->min, UINT64_MAX);
+    store(&h->max, 0);
+    for (size_t i = 0; i < HIST_BUCKETS; i++)
+        store(&h->counts[i], 0);
+}
+
+void hist_record(hist_t *h, uint64_t value)
+{
+    _Atomic uint64_t *c = &h->counts[bucket_of(value)];
+    store(c, load(c) + 1u);
+    store(&h->count, load(&h->count) + 1u);
+    store(&h->sum, load(&h->sum) + value);
+    if (value < load(&h->min))
+        store(&h->min, value);
+    if (value > load(&h->max))
+        store(&h->max, value);
+}
+
+void hist_merge(hist_t *dst, const hist_t *src)
+{
+    if (dst == NULL || src == NULL)
+        return;
+
+    /* Sum the bucket counts themselves so that percentiles of the merged
+     * histogram are consistent even if `src` recorded meanwhile */
+    uint64_t n = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; i++)
+    {
+        uint64_t c = load(&src->counts[i]);
+        if (c != 0)
+        {
+            store(&dst->counts[i], load(&dst->counts[i]) + c);
+            n += c;
+        }
+    }
+    store(&dst->count, load(&dst->count) + n);
+    store(&dst->sum, load(&dst->sum) + load(&src->sum));
+
+    uint64_t lo = load(&src->min), hi = load(&src->max);
+    if (lo < load(&dst->min))
+        store(&dst->min, lo);
+    if (hi > load(&dst->max))
+        store(&dst->max, hi);
+}
+
+uint64_t hist_count(const hist_t *h)
+{
+    return h != NULL ? load(&h->count) : 0;
+}
+
+uint64_t hist_min(const hist_t *h)
+{
+    return hist_count(h) != 0 ? load(&h->min) : 0;
+}
+
+uint64_t hist_max(const hist_t *h)
+{
+    return hist_count(h) != 0 ? load(&h->max) : 0;
+}
+
+double hist_mean(const hist_t *h)
+{
+    uint64_t n = hist_count(h);
+    return n != 0 ? (double)load(&h->sum) / (double)n : 0.0;
+}
+
+uint64_t hist_percentile(const hist_t *h, double p)
+{
+    if (h == NULL)
+        return 0;
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; i++)
+        total += load(&h->counts[i]);
+    if (total == 0)
+        return 0;
+
+    if (p < 0.0)   p = 0.0;
+    if (p > 100.0) p = 100.0;
+
+    /* Rank of the p-th value, 1-based: the smallest value with at least
+     * p% of the recorded values at or below it */
+    double   want = p / 100.0 * (double)total;
+    uint64_t rank = (uint64_t)want;
+    if ((double)rank < want)
+        rank++;
+    if (rank < 1)
+        rank = 1;
+    if (rank > total)
+        rank = total;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HIST_BUCKETS; i++)
+    {
+        seen += load(&h->counts[i]);
+        if (seen >= rank)
+        {
+            uint64_t v  = bucket_upper(i);
+            uint64_t hi = load(&h->max);
+            return v < hi ? v : hi;
+        }
+    }
+    return load(&h->max);
+}
+
+uint64_t hist_count_le(const hist_t *h, uint64_t value)
+{
+    if (h == NULL)
+        return 0;
+
+    size_t last = bucket_of(value);
+    if (bucket_upper(last) > value)
+    {
+        if (last == 0)
+            return 0;
+        last--;
+    }
+
+    uint64_t n = 0;
+    for (size_t i = 0; i <= last; i++)
+        n += load(&h->counts[i]);
+    return n;
+}
+
+uint64_t hist_sum(const hist_t *h)
+{
+    return h != NULL ? load(&h->sum) : 0;
+}
+
+void hist_print_header(const char *title)
+{
+    printf("  %-16s %10s %9s %9s %9s %9s %9s %9s\n", title, "count", "mean",
+           "p50", "p90", "p99", "p99.9", "max");
+}
+
+void hist_print(const hist_t *h, const char *label, const char *unit)
+{
+    if (hist_count(h) == 0)
+    {
+        printf("  %-16s %10s\n", label, "(no samples)");
+        return;
+    }
+
+    printf("  %-16s %10" PRIu64 " %9.0f", label, hist_count(h), hist_mean(h));
+    static const double q[] = {50.0, 90.0, 99.0, 99.9};
+    for (size_t i = 0; i < sizeof(q) / sizeof(q[0]); i++)
+        printf(" %9" PRIu64, hist_percentile(h, q[i]));
+    printf(" %9" PRIu64 "  %s\n", hist_max(h), unit);
+}
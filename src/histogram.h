@@ -0,0 +1,145 @@
+/**
+ * @file histogram.h
+ * @brief Fixed-size log-linear latency histogram (HDR style)
+ *
+ * Records any uint64 value (normally nanoseconds) into a fixed array of
+ * counters, so recording never allocates and percentiles carry a bounded
+ * relative error instead of depending on a sample:
+ *
+ *   values 0 .. 127        one counter per value (exact)
+ *   each power of two up   split into HIST_HALF linear sub-buckets,
+ *                          i.e. 1/64 (~1.6%) relative resolution
+ *
+ * A histogram has a single writer. hist_record() is a handful of relaxed
+ * loads and stores - no locks, no read-modify-write instructions - so the
+ * usual layout is one histogram per thread, merged with hist_merge() by
+ * whoever reports. Merging and percentile queries may run while the
+ * owner keeps recording; they see a recent, slightly torn snapshot
+ * (counts and totals may be a few samples apart), never a corrupt one.
+ *
+ *   hist_t *h = hist_create();
+ *   hist_record(h, clock_ns() - t0);
+ *   ...
+ *   hist_merge(total, h);
+ *   hist_print(total, "manager_log", "ns");
+ *
+ * hist_t is about 30 KB; allocate it with hist_create() rather than on
+ * the stack.
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief log2 of the values recorded exactly (0 .. 2^HIST_SUB_BITS - 1) */
+#define HIST_SUB_BITS   7
+
+/** @brief Linear sub-buckets per power of two above the exact range */
+#define HIST_HALF       (1u << (HIST_SUB_BITS - 1))
+
+/** @brief Counters needed to cover the full uint64 range */
+#define HIST_BUCKETS    ((64 - HIST_SUB_BITS + 2) * HIST_HALF)
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Histogram (heap-allocated, see hist_create)
+ */
+typedef struct {
+    _Atomic uint64_t count;                 ///< Values recorded
+    _Atomic uint64_t sum;                   ///< Sum of values (for the mean)
+    _Atomic uint64_t min;                   ///< UINT64_MAX while empty
+    _Atomic uint64_t max;
+    _Atomic uint64_t counts[HIST_BUCKETS];
+} hist_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Allocate an empty, cache-line aligned histogram.
+ * @return NULL on allocation failure
+ */
+hist_t *hist_create(void);
+
+/** @brief Free a histogram from hist_create() (NULL is safe) */
+void hist_destroy(hist_t *h);
+
+/**
+ * @brief Empty a histogram.
+ *
+ * Only while its writer is not recording.
+ */
+void hist_reset(hist_t *h);
+
+/**
+ * @brief Record one value. Only the histogram's owner may call this.
+ */
+void hist_record(hist_t *h, uint64_t value);
+
+/**
+ * @brief Add every value of `src` into `dst`.
+ *
+ * `src` may be recording concurrently; `dst` must not be.
+ */
+void hist_merge(hist_t *dst, const hist_t *src);
+
+/** @brief Values recorded */
+uint64_t hist_count(const hist_t *h);
+
+/** @brief Smallest value recorded, 0 when empty */
+uint64_t hist_min(const hist_t *h);
+
+/** @brief Largest value recorded, 0 when empty */
+uint64_t hist_max(const hist_t *h);
+
+/** @brief Mean of the values recorded, 0 when empty */
+double hist_mean(const hist_t *h);
+
+/**
+ * @brief Value at percentile `p` (0..100).
+ *
+ * Returns the upper edge of the bucket holding the p-th value, capped at
+ * the recorded max, so the answer is never below the true percentile and
+ * at most one bucket width (~1.6%) above it.
+ *
+ * @return 0 when empty
+ */
+uint64_t hist_percentile(const hist_t *h, double p);
+
+/**
+ * @brief Number of values recorded at or below `value`.
+ *
+ * Counted in whole buckets: the bucket holding `value` only counts if
+ * `value` is its top, so values up to ~1.6% below `value` may be left
+ * out.
+ */
+uint64_t hist_count_le(const hist_t *h, uint64_t value);
+
+/**
+ * @brief Sum of the values recorded
+ */
+uint64_t hist_sum(const hist_t *h);
+
+/**
+ * @brief Print one row: label, count, mean, p50, p90, p99, p99.9, max.
+ *
+ * Use hist_print_header() once above a group of rows.
+ */
+void hist_print(const hist_t *h, const char *label, const char *unit);
+
+/** @brief Column header matching hist_print() */
+void hist_print_header(const char *title);
+
+#endif /* HISTOGRAM_H */
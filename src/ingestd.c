@@ -0,0 +1,305 @@
+/**
+ * @file ingestd.c
+ * @brief Serial ingestion daemon - many Arduinos, one thread
+ *
+ * Opens every device given on the command line, multiplexes them with
+ * epoll (serial_ingest.c), runs each reading through the manager
+ * (filters, thresholds, anomaly detection) and appends it to the same
+ * CSV file the dashboard reads.
+ *
+ * Usage:
+ *   sensor_ingestd [-B] [-b baud] [-c config/board.ini] [-o out.csv] [-m ADDR] DEVICE...
+ *
+ *   sensor_ingestd /dev/ttyACM0 /dev/ttyACM1
+ *   sensor_ingestd -B /dev/ttyACM0        (sketch built with WIRE_BINARY 1)
+ *   sensor_ingestd -m 9464 /dev/ttyACM0   (Prometheus metrics on :9464)
+ *
+ * Runs until every device has hung up or it receives SIGINT / SIGTERM.
+ * Sensors, thresholds and the output file come from the configuration
+ * (config/board.ini by default, matching predictive_monitor.ino); -o
+ * overrides its [logger] path.
+ *
+ * SIGHUP re-reads the configuration and swaps in its thresholds while
+ * ingestion keeps running (manager_publish_thresholds()). Sensors, rings,
+ * filters and the output file stay as they were at start-up; changing
+ * those needs a restart.
+ *
+ * With [watchdog] misses = K in the configuration, a sensor that sends
+ * nothing for K of its periods (a DHT11 that stopped answering) is put
+ * in SENSOR_STATE_ERROR with a STALE alert until it reports again.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "serial_ingest.h"
+#include "clock.h"
+#include "config.h"
+#include "logger.h"
+#include "pipeline_metrics.h"
+#include "metrics_server.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SENSOR_TEMP      0
+#define SENSOR_HUMIDITY  1
+#define SENSOR_VIBRATION 2
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+/** State of the SIGHUP reload thread */
+typedef struct {
+    manager_t  *m;
+    const char *path;
+    atomic_bool stop;
+} reload_t;
+
+/**
+ * Waits for SIGHUP (blocked in every other thread) and publishes the
+ * file's thresholds. Runs beside the ingest loop, never inside it, so a
+ * slow or broken file cannot stall a reading.
+ */
+static void *reload_thread(void *arg)
+{
+    reload_t *rl = arg;
+    sigset_t  hup;
+    sigemptyset(&hup);
+    sigaddset(&hup, SIGHUP);
+
+    for (;;)
+    {
+        int sig;
+        if (sigwait(&hup, &sig) != 0 || atomic_load(&rl->stop))
+            break;
+
+        config_t          cfg;
+        config_error_t    err;
+        threshold_table_t table;
+        if (!config_load(&cfg, rl->path, &err))
+        {
+            DIAG_ERROR("INGEST", "Reload %s:%u: %s - keeping current thresholds",
+                       rl->path, err.line, err.msg);
+            continue;
+        }
+        for (uint8_t id = 0; id < MANAGER_MAX_SENSORS; id++)
+        {
+            bool running = id < rl->m->capacity && rl->m->registered[id];
+            if (cfg.sensors[id].present != running)
+                DIAG_WARN("INGEST", "Reload: sensor %u %s - restart to apply", id,
+                          running ? "no longer declared" : "added");
+        }
+        config_thresholds(&cfg, &table);
+        manager_publish_thresholds(rl->m, &table);
+        DIAG_INFO("INGEST", "Reloaded thresholds from %s", rl->path);
+    }
+    return NULL;
+}
+
+/** Write every accepted reading to CSV with the manager's alert verdict */
+static void csv_sink(manager_t *m, const sensor_reading_t *batch,
+                     const alert_level_t *alerts, size_t n, void *ctx)
+{
+    csv_logger_t *logger = ctx;
+
+    for (size_t i = 0; i < n; i++)
+        logger_write(logger, &batch[i], m->sensors[batch[i].sensor_id].name,
+                     alerts[i]);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "usage: %s [-Bv] [-b baud] [-c INI] [-o out.csv] [-m ADDR] DEVICE...\n"
+                    "  -B  boards send binary frames (WIRE_BINARY sketch)\n"
+                    "  -c  sensors, thresholds and logger policy (default config/board.ini)\n"
+                    "  -m  serve Prometheus metrics on [host:]port or a unix socket path\n"
+                    "  -v  print library status messages (repeat for debug)\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t    baud = 9600;
+    const char *config = "config/board.ini";
+    const char *out  = NULL;
+    const char *metrics_addr = NULL;
+    bool        binary = false;
+    int         level  = DIAG_LEVEL_WARN;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "Bb:c:o:m:vh")) != -1)
+    {
+        switch (opt)
+        {
+        case 'b': baud = (uint32_t)strtoul(optarg, NULL, 10); break;
+        case 'c': config = optarg;                            break;
+        case 'o': out  = optarg;                              break;
+        case 'm': metrics_addr = optarg;                      break;
+        case 'B': binary = true;                              break;
+        case 'v': level -= level > DIAG_LEVEL_DEBUG;          break;
+        default:  usage(argv[0]);                             return 2;
+        }
+    }
+    if (optind >= argc)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    diag_set_level(level);
+
+    /* Only the reload thread takes SIGHUP; threads started later inherit this */
+    sigset_t hup;
+    sigemptyset(&hup);
+    sigaddset(&hup, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &hup, NULL);
+
+    config_t       cfg;
+    config_error_t err;
+    manager_t     *m = NULL;
+    if (config_load(&cfg, config, &err))
+        m = config_build(&cfg, &err);
+    if (m == NULL)
+    {
+        DIAG_ERROR("INGEST", "%s:%u: %s", config, err.line, err.msg);
+        return 1;
+    }
+    if (out != NULL)
+        snprintf(cfg.log_path, sizeof(cfg.log_path), "%s", out);
+
+    csv_logger_t logger;
+    if (!config_open_logger(&cfg, &logger))
+    {
+        manager_destroy(m);
+        return 1;
+    }
+
+    serial_ingest_t in;
+    if (!ingest_init(&in, m))
+    {
+        logger_close(&logger);
+        manager_destroy(m);
+        return 1;
+    }
+    ingest_set_sink(&in, csv_sink, &logger);
+
+    /* Route rows by name, so a board that numbers its sensors differently
+     * still lands on the right one */
+    csv_dict_t names;
+    csv_dict_init(&names);
+    for (uint8_t id = 0; id < m->capacity; id++)
+    {
+        if (m->registered[id])
+            csv_dict_add(&names, m->sensors[id].name, id);
+    }
+    ingest_set_dict(&in, &names);
+
+    /* Timed on the host clock: a silent board sends no timestamps */
+    watchdog_t wd;
+    bool       watching = cfg.watchdog_misses > 0;
+    if (watching)
+    {
+        watchdog_init(&wd, m, clock_ns() / 1000000u);
+        if (!config_watchdog(&cfg, &wd))
+            DIAG_WARN("INGEST", "Watchdog not watching every sensor");
+    }
+
+    reload_t  rl = {.m = m, .path = config};
+    pthread_t reloader;
+    atomic_init(&rl.stop, false);
+    bool reloading = pthread_create(&reloader, NULL, reload_thread, &rl) == 0;
+    if (!reloading)
+        DIAG_WARN("INGEST", "No reload thread - SIGHUP ignored");
+
+    for (int i = optind; i < argc; i++)
+    {
+        int idx = ingest_add_device(&in, argv[i], baud);
+        if (idx < 0 || !binary)
+            continue;
+
+        /* The sketch sends centi-units for the DHT11 and raw MPU6050
+         * counts (16384 per g at +-2 g) for vibration */
+        frame_decoder_t *dec = ingest_set_binary(&in, idx);
+        frame_set_scale(dec, SENSOR_TEMP,      0.01f);
+        frame_set_scale(dec, SENSOR_HUMIDITY,  0.01f);
+        frame_set_scale(dec, SENSOR_VIBRATION, 1.0f / 16384.0f);
+    }
+
+    /* Scrapes read relaxed atomics published below, never the manager */
+    metrics_t         *reg = NULL;
+    metrics_server_t  *srv = NULL;
+    pipeline_metrics_t pm;
+    if (metrics_addr != NULL)
+    {
+        reg = metrics_create();
+        if (reg == NULL || !pipeline_metrics_init(&pm, reg, m, &logger) ||
+            (srv = metrics_server_start(reg, metrics_addr)) == NULL)
+        {
+            DIAG_ERROR("INGEST", "Metrics endpoint unavailable");
+            if (reg != NULL)
+                pipeline_metrics_free(&pm, &logger);
+            metrics_destroy(reg);
+            reg = NULL;
+        }
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    while (!g_stop && in.open_count > 0)
+    {
+        /* Readings are stamped with the latest watchdog_poll(), so poll
+         * each round and wake no later than the next deadline */
+        int timeout_ms = 500;
+        if (watching)
+        {
+            uint64_t now = clock_ns() / 1000000u;
+            watchdog_poll(&wd, now);
+            uint64_t due = watchdog_next_due(&wd);
+            if (due > now && due - now < (uint64_t)timeout_ms)
+                timeout_ms = (int)(due - now);
+        }
+
+        if (ingest_poll(&in, timeout_ms) < 0)
+            break;
+        if (reg != NULL)
+            pipeline_metrics_publish(&pm, m, &logger);
+    }
+
+    if (reloading)
+    {
+        atomic_store(&rl.stop, true);
+        pthread_kill(reloader, SIGHUP);
+        pthread_join(reloader, NULL);
+    }
+
+    ingest_close(&in);
+    printf("[INGEST] %" PRIu64 " readings logged, %" PRIu64 " rejected\n",
+           in.accepted, in.rejected);
+    if (watching)
+        printf("[INGEST] %" PRIu64 " sensors went stale, %" PRIu64
+               " recovered\n", wd.stale_events, wd.recoveries);
+    manager_print_stats(m);
+
+    if (reg != NULL)
+    {
+        metrics_server_stop(srv);
+        pipeline_metrics_free(&pm, &logger);
+        metrics_destroy(reg);
+    }
+    logger_close(&logger);
+    manager_destroy(m);
+    return 0;
+}
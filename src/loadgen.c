@@ -0,0 +1,511 @@
+/**
+ * @file loadgen.c
+ * @brief Synthetic load generator for the full logging pipeline
+ *
+ * Drives manager_log() -> sensor_log() -> buffer_write() from several
+ * producer threads and drains the rings into logger_write() from a
+ * consumer thread, the way sensor_ingestd and the dashboard share the
+ * pipeline in production, and reports what it sustained:
+ *
+ *   - readings generated and logged per second
+ *   - drops: readings refused because a ring was full
+ *     (buffer_overflow_count), i.e. the consumer fell behind
+ *   - latency percentiles of the manager call on the producer side, and
+ *     end to end (due time -> written by the consumer)
+ *
+ * Each producer thread owns one shard of a sharded_manager_t and feeds
+ * its own `-s` sensors, so threads x sensors independent streams are
+ * simulated. Every sensor follows a signal profile:
+ *
+ *   noise  steady value plus Gaussian noise
+ *   drift  slow linear drift over the run
+ *   spike  occasional large single-sample outliers (anomaly detector)
+ *   step   level shift half way through the run
+ *   stuck  frozen sensor, the same value every time
+ *   mix    profiles assigned round-robin across sensors (default)
+ *
+ * On top of the profile, a fraction `-a` of readings is pushed past the
+ * warning line (one in six of those past critical) to set the alert
+ * density. Alerts are printed by the manager as usual, so at high
+ * densities pipe the output through tail.
+ *
+ * Timestamps are microseconds since the start of the run (not the usual
+ * milliseconds) so the consumer can measure end-to-end latency from
+ * them; runs are limited to an hour to stay clear of uint32 wrap.
+ *
+ * Usage:
+ *   sensor_loadgen [-t threads] [-s sensors] [-r hz] [-d seconds]
+ *                  [-p profile] [-a density] [-b ring] [-i drain_ms]
+ *                  [-o out.csv | -n]
+ *
+ *   sensor_loadgen -t 4 -s 8 -r 1000 -d 10      (32 sensors at 1 kHz)
+ *   sensor_loadgen -t 2 -r 0 -n                 (flat out, no CSV)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sharded_manager.h"
+#include "logger.h"
+#include "histogram.h"
+#include "stage_timing.h"
+#include "clock.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Readings popped per sensor per shard lock by the consumer */
+#define LOADGEN_DRAIN       256
+
+/** Longest run: timestamps are uint32 microseconds */
+#define LOADGEN_MAX_SECONDS 3600
+
+/* Thresholds every simulated sensor gets; profiles stay near BASE */
+#define BASE            50.0f
+#define SIGMA           1.0f
+#define WARN_LOW        20.0f
+#define WARN_HIGH       70.0f
+#define CRIT_LOW        10.0f
+#define CRIT_HIGH       85.0f
+
+typedef enum {
+    PROFILE_NOISE = 0,
+    PROFILE_DRIFT,
+    PROFILE_SPIKE,
+    PROFILE_STEP,
+    PROFILE_STUCK,
+    PROFILE_COUNT,
+    PROFILE_MIX = PROFILE_COUNT
+} profile_t;
+
+static const char *const k_profiles[] = {"noise", "drift", "spike", "step",
+                                         "stuck", "mix"};
+
+typedef struct {
+    unsigned  threads;
+    unsigned  sensors;          ///< Per thread
+    double    rate_hz;          ///< Per sensor, 0 = unthrottled
+    double    seconds;
+    profile_t profile;
+    double    alert_density;    ///< Fraction of readings past warn_high
+    size_t    ring;             ///< Ring buffer slots per sensor
+    unsigned  drain_ms;         ///< Consumer poll interval
+    const char *out;            ///< NULL = consumer does not write CSV
+} loadgen_config_t;
+
+typedef struct {
+    const loadgen_config_t *cfg;
+    sharded_manager_t      *sm;
+    pthread_barrier_t      *start;
+    const uint64_t         *t0;
+    uint8_t                 shard;
+    uint64_t                rng;
+    uint64_t                generated;
+    uint64_t                accepted;
+    hist_t                 *lat;        ///< sharded_log() call, ns
+} producer_t;
+
+typedef struct {
+    const loadgen_config_t *cfg;
+    sharded_manager_t      *sm;
+    csv_logger_t           *logger;
+    pthread_barrier_t      *start;
+    const uint64_t         *t0;
+    atomic_bool            *done;
+    uint64_t                consumed;
+    hist_t                 *lat;        ///< due -> written, us
+} consumer_t;
+
+/* ============================================================================
+ * HELPERS
+ * ========================================================================== */
+
+static uint64_t rng_next(uint64_t *s)
+{
+    /* xorshift64* */
+    uint64_t x = *s;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *s = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+/** Uniform in [0, 1) */
+static float rng_unit(uint64_t *s)
+{
+    return (float)(rng_next(s) >> 40) * (1.0f / 16777216.0f);
+}
+
+/** Approximately standard normal (Irwin-Hall, four uniforms) */
+static float rng_gauss(uint64_t *s)
+{
+    float sum = rng_unit(s) + rng_unit(s) + rng_unit(s) + rng_unit(s);
+    return (sum - 2.0f) * 1.7320508f;
+}
+
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {.tv_sec  = (time_t)(ns / 1000000000u),
+                          .tv_nsec = (long)(ns % 1000000000u)};
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Next value of a sensor on profile `p`, `t` seconds into the run.
+ */
+static float generate(const loadgen_config_t *cfg, profile_t p, float t,
+                      uint64_t *rng)
+{
+    if (cfg->alert_density > 0.0 && rng_unit(rng) < cfg->alert_density)
+    {
+        /* Past the warning line; the top sixth lands past critical */
+        float span = (CRIT_HIGH - WARN_HIGH) * 1.2f;
+        return WARN_HIGH + 0.01f + rng_unit(rng) * span;
+    }
+
+    float v = BASE + SIGMA * rng_gauss(rng);
+    switch (p)
+    {
+    case PROFILE_DRIFT:
+        v += 10.0f * t / (float)cfg->seconds;
+        break;
+    case PROFILE_SPIKE:
+        if (rng_unit(rng) < 0.001f)
+            v += SIGMA * (8.0f + 8.0f * rng_unit(rng));
+        break;
+    case PROFILE_STEP:
+        if (t >= (float)cfg->seconds / 2.0f)
+            v += 10.0f;
+        break;
+    case PROFILE_STUCK:
+        v = BASE;
+        break;
+    default:
+        break;
+    }
+    return v;
+}
+
+/* ============================================================================
+ * THREADS
+ * ========================================================================== */
+
+static void *producer(void *arg)
+{
+    producer_t *p = arg;
+    const loadgen_config_t *cfg = p->cfg;
+    profile_t prof[MANAGER_MAX_SENSORS];
+
+    for (unsigned k = 0; k < cfg->sensors; k++)
+        prof[k] = (cfg->profile == PROFILE_MIX)
+                ? (profile_t)((p->shard * cfg->sensors + k) % PROFILE_COUNT)
+                : cfg->profile;
+
+    pthread_barrier_wait(p->start);
+
+    uint64_t t0     = *p->t0;
+    uint64_t end    = t0 + (uint64_t)(cfg->seconds * 1e9);
+    double   period = cfg->rate_hz > 0.0 ? 1e9 / cfg->rate_hz : 0.0;
+    uint64_t now    = clock_ns();
+
+    for (uint64_t round = 0; now < end; round++)
+    {
+        uint64_t due = now;
+        if (period > 0.0)
+        {
+            /* Absolute schedule: a late round is not made up by sleeping less
+             * later, it just shows up as latency */
+            due = t0 + (uint64_t)((double)round * period);
+            if (due >= end)
+                break;
+            if (due > now)
+                sleep_ns(due - now);
+        }
+
+        uint32_t ts = (uint32_t)((due - t0) / 1000u);
+        float    t  = (float)((double)(due - t0) / 1e9);
+
+        for (unsigned k = 0; k < cfg->sensors; k++)
+        {
+            float    v = generate(cfg, prof[k], t, &p->rng);
+            uint64_t a = clock_ns();
+            bool    ok = sharded_log(p->sm, p->shard, (uint8_t)k, v, ts);
+            now = clock_ns();
+
+            hist_record(p->lat, now - a);
+            p->generated++;
+            p->accepted += ok;
+        }
+    }
+    return NULL;
+}
+
+static void *consumer(void *arg)
+{
+    consumer_t *c = arg;
+    const loadgen_config_t *cfg = c->cfg;
+    sharded_manager_t *sm = c->sm;
+    sensor_reading_t batch[LOADGEN_DRAIN];
+    uint8_t alerts[LOADGEN_DRAIN];
+
+    pthread_barrier_wait(c->start);
+    uint64_t t0 = *c->t0;
+
+    for (;;)
+    {
+        /* Read the flag before draining: once it is set, an empty pass
+         * means every reading has been consumed */
+        bool finished = atomic_load(c->done);
+        uint64_t got = 0;
+
+        for (uint8_t s = 0; s < sm->shard_count; s++)
+        {
+            manager_shard_t *sh = &sm->shards[s];
+            for (uint8_t id = 0; id < cfg->sensors; id++)
+            {
+                size_t n = 0;
+                pthread_mutex_lock(&sh->lock);
+                while (n < LOADGEN_DRAIN && manager_read(sh->m, id, &batch[n]))
+                {
+                    alerts[n] = (uint8_t)manager_check_threshold(sh->m, id,
+                                                                 batch[n].value);
+                    n++;
+                }
+                pthread_mutex_unlock(&sh->lock);
+
+                if (n == 0)
+                    continue;
+                uint64_t now_us = (clock_ns() - t0) / 1000u;
+                for (size_t i = 0; i < n; i++)
+                {
+                    hist_record(c->lat, now_us - batch[i].timestamp);
+                    if (c->logger != NULL)
+                        logger_write(c->logger, &batch[i], sh->m->sensors[id].name,
+                                     (alert_level_t)alerts[i]);
+                }
+                got += n;
+            }
+        }
+        c->consumed += got;
+
+        if (got == 0)
+        {
+            if (finished)
+                break;
+            sleep_ns(cfg->drain_ms ? cfg->drain_ms * 1000000ull : 50000u);
+        }
+        else if (cfg->drain_ms)
+        {
+            sleep_ns(cfg->drain_ms * 1000000ull);
+        }
+    }
+    if (c->logger != NULL)
+        logger_flush(c->logger);
+    return NULL;
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-t threads] [-s sensors] [-r hz] [-d seconds] [-p profile]\n"
+            "          [-a density] [-b ring] [-i drain_ms] [-o out.csv | -n]\n"
+            "  -t  producer threads, one manager shard each (default 2)\n"
+            "  -s  sensors per thread, 1..%d (default 4)\n"
+            "  -r  samples per second per sensor, 0 = flat out (default 1000)\n"
+            "  -d  run time in seconds (default 5)\n"
+            "  -p  noise | drift | spike | step | stuck | mix (default mix)\n"
+            "  -a  fraction of readings past the warning line (default 0)\n"
+            "  -b  ring buffer slots per sensor (default 1024)\n"
+            "  -i  consumer poll interval in ms, 0 = busy (default 10)\n"
+            "  -o  CSV written by the consumer, replaced each run\n"
+            "      (default data/loadgen_log.csv)\n"
+            "  -n  consumer drains without writing CSV\n",
+            prog, MANAGER_MAX_SENSORS);
+}
+
+static bool parse_profile(const char *s, profile_t *out)
+{
+    for (int i = 0; i <= PROFILE_MIX; i++)
+    {
+        if (strcmp(s, k_profiles[i]) == 0)
+        {
+            *out = (profile_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    loadgen_config_t cfg = {
+        .threads = 2, .sensors = 4, .rate_hz = 1000.0, .seconds = 5.0,
+        .profile = PROFILE_MIX, .alert_density = 0.0, .ring = 1024,
+        .drain_ms = 10, .out = "data/loadgen_log.csv",
+    };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:s:r:d:p:a:b:i:o:nh")) != -1)
+    {
+        switch (opt)
+        {
+        case 't': cfg.threads = (unsigned)strtoul(optarg, NULL, 10);  break;
+        case 's': cfg.sensors = (unsigned)strtoul(optarg, NULL, 10);  break;
+        case 'r': cfg.rate_hz = strtod(optarg, NULL);                 break;
+        case 'd': cfg.seconds = strtod(optarg, NULL);                 break;
+        case 'a': cfg.alert_density = strtod(optarg, NULL);           break;
+        case 'b': cfg.ring = strtoul(optarg, NULL, 10);               break;
+        case 'i': cfg.drain_ms = (unsigned)strtoul(optarg, NULL, 10); break;
+        case 'o': cfg.out = optarg;                                   break;
+        case 'n': cfg.out = NULL;                                     break;
+        case 'p':
+            if (parse_profile(optarg, &cfg.profile))
+                break;
+            /* fall through */
+        default:
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.threads < 1 || cfg.threads > SHARDED_MAX_SHARDS ||
+        cfg.sensors < 1 || cfg.sensors > MANAGER_MAX_SENSORS ||
+        !(cfg.rate_hz >= 0.0) || !(cfg.seconds > 0.0) ||
+        cfg.seconds > LOADGEN_MAX_SECONDS || cfg.ring < 1 ||
+        !(cfg.alert_density >= 0.0 && cfg.alert_density <= 1.0))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    printf("=== Load generator: %u threads x %u sensors, ", cfg.threads, cfg.sensors);
+    if (cfg.rate_hz > 0.0)
+        printf("%g Hz each", cfg.rate_hz);
+    else
+        printf("unthrottled");
+    printf(", profile %s, alerts %g%%, %g s ===\n",
+           k_profiles[cfg.profile], cfg.alert_density * 100.0, cfg.seconds);
+
+    sharded_manager_t *sm = sharded_create((uint8_t)cfg.threads, (uint8_t)cfg.sensors);
+    if (sm == NULL)
+        return 1;
+    for (uint8_t id = 0; id < cfg.sensors; id++)
+    {
+        char name[SENSOR_NAME_MAX];
+        snprintf(name, sizeof(name), "Synthetic %u", id);
+        sharded_register(sm, id, name, cfg.ring);
+        sharded_set_thresholds(sm, id, (sensor_threshold_t){
+            .warn_low = WARN_LOW, .warn_high = WARN_HIGH,
+            .critical_low = CRIT_LOW, .critical_high = CRIT_HIGH,
+            .enabled = true});
+    }
+
+    csv_logger_t logger;
+    if (cfg.out != NULL)
+    {
+        remove(cfg.out);
+        if (!logger_open(&logger, cfg.out))
+        {
+            sharded_destroy(sm);
+            return 1;
+        }
+    }
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, cfg.threads + 2);
+    uint64_t   t0   = 0;
+    atomic_bool done = false;
+
+    producer_t *prods = calloc(cfg.threads, sizeof(producer_t));
+    pthread_t  *tids  = calloc(cfg.threads, sizeof(pthread_t));
+    consumer_t  cons  = {.cfg = &cfg, .sm = sm, .start = &start, .t0 = &t0,
+                         .done = &done, .lat = hist_create(),
+                         .logger = cfg.out != NULL ? &logger : NULL};
+    bool ok = prods != NULL && tids != NULL && cons.lat != NULL;
+    for (unsigned i = 0; ok && i < cfg.threads; i++)
+    {
+        prods[i] = (producer_t){.cfg = &cfg, .sm = sm, .start = &start,
+                                .t0 = &t0, .shard = (uint8_t)i,
+                                .rng = 0x2545F4914F6CDD1Dull * (i + 1),
+                                .lat = hist_create()};
+        ok = prods[i].lat != NULL;
+    }
+    if (!ok)
+    {
+        DIAG_ERROR("LOADGEN", "Out of memory");
+        return 1;
+    }
+
+    pthread_t ctid;
+    for (unsigned i = 0; i < cfg.threads; i++)
+        pthread_create(&tids[i], NULL, producer, &prods[i]);
+    pthread_create(&ctid, NULL, consumer, &cons);
+
+    t0 = clock_ns();
+    pthread_barrier_wait(&start);
+
+    for (unsigned i = 0; i < cfg.threads; i++)
+        pthread_join(tids[i], NULL);
+    uint64_t produced_ns = clock_ns() - t0;
+    atomic_store(&done, true);
+    pthread_join(ctid, NULL);
+    uint64_t total_ns = clock_ns() - t0;
+
+    /* ----------------------------------------------------------------
+     * Report
+     * ---------------------------------------------------------------- */
+    uint64_t generated = 0, accepted = 0;
+    hist_t *lat = hist_create();
+    for (unsigned i = 0; i < cfg.threads; i++)
+    {
+        generated += prods[i].generated;
+        accepted  += prods[i].accepted;
+        hist_merge(lat, prods[i].lat);
+    }
+    sharded_totals_t tot;
+    sharded_get_totals(sm, &tot);
+
+    double ps = (double)produced_ns / 1e9;
+    printf("\n--- Load generator results ---\n");
+    printf("  Generated          : %" PRIu64 " readings in %.2f s (%.0f /s)\n",
+           generated, ps, (double)generated / ps);
+    printf("  Logged (sustained) : %" PRIu64 " (%.0f /s)\n",
+           accepted, (double)accepted / ps);
+    printf("  Dropped (overflow) : %" PRIu64 " (%.3f%%)\n", tot.overflows,
+           generated ? 100.0 * (double)tot.overflows / (double)generated : 0.0);
+    printf("  Consumed           : %" PRIu64 " in %.2f s%s\n", cons.consumed,
+           (double)total_ns / 1e9, cfg.out ? " (written to CSV)" : "");
+    printf("  Alerts / anomalies : %" PRIu64 " / %" PRIu64 "\n",
+           tot.alerts, tot.anomalies);
+    hist_print_header("Latency");
+    hist_print(lat, "manager_log", "ns");
+    hist_print(cons.lat, "end-to-end", "us");
+    if (cfg.out != NULL)
+        printf("  CSV file: %s\n", cfg.out);
+    if (stage_timing_enabled())
+        stage_timing_print();
+
+    /* ----------------------------------------------------------------
+     * Cleanup
+     * ---------------------------------------------------------------- */
+    hist_destroy(lat);
+    for (unsigned i = 0; i < cfg.threads; i++)
+        hist_destroy(prods[i].lat);
+    hist_destroy(cons.lat);
+    free(prods);
+    free(tids);
+    pthread_barrier_destroy(&start);
+    if (cfg.out != NULL)
+        logger_close(&logger);
+    sharded_destroy(sm);
+    return 0;
+}
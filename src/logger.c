@@ -22,7 +22,12 @@
  *   previous readings.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "logger.h"
+#include "stage_timing.h"
+#include "clock.h"
+#include "diag.h"
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
@@ -62,6 +67,20 @@ static bool file_is_empty(const char *filepath)
     return (ch == EOF);
 }
 
+/** fflush(), timed into the logger's flush histogram if it has one */
+static void flush_file(csv_logger_t *logger)
+{
+    if (logger->flush_ns == NULL)
+    {
+        fflush((FILE *)logger->file);
+        return;
+    }
+
+    uint64_t t0 = clock_ns();
+    fflush((FILE *)logger->file);
+    hist_record(logger->flush_ns, clock_ns() - t0);
+}
+
 /* ============================================================================
  * PUBLIC API
  * ========================================================================== */
@@ -87,12 +106,16 @@ bool logger_open(csv_logger_t *logger, const char *filepath)
     FILE *f = fopen(filepath, "a");
     if (f == NULL)
     {
-        printf("[LOGGER] ERROR: Could not open file '%s'\n", filepath);
+        DIAG_ERROR("LOGGER", "Could not open file '%s'", filepath);
         return false;
     }
 
     logger->file = (void *)f;
     logger->rows_written = 0;
+    logger->bytes_written = 0;
+    logger->flush_ns = NULL;
+    logger->flush_every = 1;
+    logger->unflushed = 0;
     logger->is_open = true;
 
     /* Write CSV header if this is a new/empty file */
@@ -100,11 +123,11 @@ bool logger_open(csv_logger_t *logger, const char *filepath)
     {
         fprintf(f, "timestamp,sensor_id,sensor_name,value,alert_level\n");
         fflush(f);
-        printf("[LOGGER] Created '%s' with header\n", filepath);
+        DIAG_INFO("LOGGER", "Created '%s' with header", filepath);
     }
     else
     {
-        printf("[LOGGER] Appending to existing '%s'\n", filepath);
+        DIAG_INFO("LOGGER", "Appending to existing '%s'", filepath);
     }
 
     return true;
@@ -119,8 +142,8 @@ void logger_close(csv_logger_t *logger)
     logger->file = NULL;
     logger->is_open = false;
 
-    printf("[LOGGER] Closed '%s' (%" PRIu32 " rows written)\n",
-           logger->filepath, logger->rows_written);
+    DIAG_INFO("LOGGER", "Closed '%s' (%" PRIu32 " rows written)",
+              logger->filepath, logger->rows_written);
 }
 
 bool logger_write(csv_logger_t *logger,
@@ -132,26 +155,34 @@ bool logger_write(csv_logger_t *logger,
         return false;
 
     FILE *f = (FILE *)logger->file;
+    uint64_t t = STAGE_BEGIN(STAGE_LOGGER);
 
     /*
      * Write one CSV row:
      *   timestamp, sensor_id, sensor_name, value, alert_level
      */
-    fprintf(f, "%" PRIu32 ",%" PRIu8 ",%s,%.4f,%s\n",
-            reading->timestamp,
-            reading->sensor_id,
-            sensor_name,
-            reading->value,
-            alert_to_str(alert));
+    int n = fprintf(f, "%" PRIu32 ",%" PRIu8 ",%s,%.4f,%s\n",
+                    reading->timestamp,
+                    reading->sensor_id,
+                    sensor_name,
+                    reading->value,
+                    alert_to_str(alert));
 
     logger->rows_written++;
+    if (n > 0)
+        logger->bytes_written += (uint64_t)n;
 
     /*
-     * Flush immediately so Python sees the row right away.
-     * On a real embedded system you might flush every N rows
+     * By default flush immediately so Python sees the row right away.
+     * logger_set_flush_every() batches N rows per flush instead, e.g.
      * to reduce SD card wear.
      */
-    fflush(f);
+    if (++logger->unflushed >= logger->flush_every)
+    {
+        flush_file(logger);
+        logger->unflushed = 0;
+    }
+    STAGE_END(STAGE_LOGGER, t);
 
     return true;
 }
@@ -161,10 +192,23 @@ void logger_flush(csv_logger_t *logger)
     if (logger == NULL || !logger->is_open)
         return;
 
-    fflush((FILE *)logger->file);
+    flush_file(logger);
+    logger->unflushed = 0;
+}
+
+void logger_set_flush_every(csv_logger_t *logger, uint32_t rows)
+{
+    if (logger != NULL)
+        logger->flush_every = rows > 0 ? rows : 1;
 }
 
 uint32_t logger_rows_written(const csv_logger_t *logger)
 {
     return (logger == NULL) ? 0 : logger->rows_written;
 }
+
+void logger_time_flushes(csv_logger_t *logger, hist_t *h)
+{
+    if (logger != NULL)
+        logger->flush_ns = h;
+}
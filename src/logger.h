@@ -16,6 +16,7 @@
 #define LOGGER_H
 
 #include "sensor_manager.h"
+#include "histogram.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -33,7 +34,7 @@
 /**
  * @brief Logger control structure
  *
- * Holds the open file handle and running write count.
+ * Holds the open file handle and running write counts.
  * One logger instance can serve the whole manager.
  */
 typedef struct
@@ -41,6 +42,10 @@ typedef struct
     char filepath[LOGGER_PATH_MAX]; ///< Path to the CSV file
     void *file;                     ///< FILE* handle (void* avoids stdio in header)
     uint32_t rows_written;          ///< Total rows written this session
+    uint64_t bytes_written;         ///< CSV bytes written this session
+    hist_t *flush_ns;               ///< Flush latency, NULL = not timed
+    uint32_t flush_every;           ///< Rows per flush (1 = every row)
+    uint32_t unflushed;             ///< Rows written since the last flush
     bool is_open;                   ///< True if file is open and ready
 } csv_logger_t;
 
@@ -93,9 +98,27 @@ bool logger_write(csv_logger_t *logger,
  */
 void logger_flush(csv_logger_t *logger);
 
+/**
+ * @brief Flush after every `rows` rows instead of after each one.
+ *
+ * The default (1) lets the dashboard see each row at once; a larger
+ * value trades that latency for fewer writes (SD card wear, throughput).
+ * logger_close() always flushes what is left. 0 is treated as 1.
+ */
+void logger_set_flush_every(csv_logger_t *logger, uint32_t rows);
+
 /**
  * @brief Return total rows written this session.
  */
 uint32_t logger_rows_written(const csv_logger_t *logger);
 
+/**
+ * @brief Time every flush into `h` (ns), or stop timing with NULL.
+ *
+ * The histogram is recorded by the thread that writes through the
+ * logger and may be read from another one (see histogram.h). Call
+ * after logger_open().
+ */
+void logger_time_flushes(csv_logger_t *logger, hist_t *h);
+
 #endif /* LOGGER_H */
@@ -0,0 +1,86 @@
+/**
+ * @file lttb.c
+ * @brief Largest-Triangle-Three-Buckets implementation
+ *
+ * The interior points are split into (threshold - 2) equal buckets. For
+ * each bucket we keep the point that forms the largest triangle with the
+ * previously kept point and the average of the NEXT bucket. One pass,
+ * O(n) time, no allocation.
+ */
+
+#include "lttb.h"
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+size_t lttb_select(const uint32_t *x, const float *y, size_t n,
+                   size_t threshold, size_t *out_idx)
+{
+    if (x == NULL || y == NULL || out_idx == NULL || n == 0 || threshold == 0)
+        return 0;
+
+    /* Nothing to reduce */
+    if (threshold >= n) {
+        for (size_t i = 0; i < n; i++)
+            out_idx[i] = i;
+        return n;
+    }
+
+    /* Too few points for a middle bucket: keep the ends */
+    if (threshold < 3) {
+        out_idx[0] = 0;
+        if (threshold == 2)
+            out_idx[1] = n - 1;
+        return threshold;
+    }
+
+    double every = (double)(n - 2) / (double)(threshold - 2);
+    size_t kept  = 0;
+    size_t a     = 0;                   /* previously kept point */
+    out_idx[kept++] = 0;
+
+    for (size_t i = 0; i < threshold - 2; i++) {
+        /* Average of the next bucket (or the last point for the final one) */
+        size_t avg_start = (size_t)((double)(i + 1) * every) + 1;
+        size_t avg_end   = (size_t)((double)(i + 2) * every) + 1;
+        if (avg_end > n)
+            avg_end = n;
+        if (avg_start >= avg_end)
+            avg_start = avg_end - 1;
+
+        double avg_x = 0.0, avg_y = 0.0;
+        for (size_t j = avg_start; j < avg_end; j++) {
+            avg_x += (double)x[j];
+            avg_y += (double)y[j];
+        }
+        avg_x /= (double)(avg_end - avg_start);
+        avg_y /= (double)(avg_end - avg_start);
+
+        /* Current bucket */
+        size_t from = (size_t)((double)i * every) + 1;
+        size_t to   = (size_t)((double)(i + 1) * every) + 1;
+
+        double ax = (double)x[a];
+        double ay = (double)y[a];
+        double best_area = -1.0;
+        size_t best = from;
+
+        for (size_t j = from; j < to; j++) {
+            double area = (ax - avg_x) * ((double)y[j] - ay)
+                        - (ax - (double)x[j]) * (avg_y - ay);
+            if (area < 0.0)
+                area = -area;
+            if (area > best_area) {
+                best_area = area;
+                best      = j;
+            }
+        }
+
+        out_idx[kept++] = best;
+        a = best;
+    }
+
+    out_idx[kept++] = n - 1;
+    return kept;
+}
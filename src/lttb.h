@@ -0,0 +1,36 @@
+/**
+ * @file lttb.h
+ * @brief Largest-Triangle-Three-Buckets visual downsampling
+ *
+ * Reduces a time series to at most `threshold` points while keeping its
+ * visual shape: peaks, dips and spikes survive, flat stretches collapse.
+ * The first and last points are always kept.
+ *
+ * Works on indices so callers can carry any per-point metadata (alert
+ * level, sensor id, ...) along with the selected points.
+ */
+
+#ifndef LTTB_H
+#define LTTB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Pick up to `threshold` representative points.
+ *
+ * @param x          Timestamps, ascending
+ * @param y          Values
+ * @param n          Number of input points
+ * @param threshold  Maximum number of points to keep
+ * @param out_idx    Receives selected indices, ascending (>= threshold slots)
+ * @return           Number of indices written (min(n, threshold))
+ */
+size_t lttb_select(const uint32_t *x, const float *y, size_t n,
+                   size_t threshold, size_t *out_idx);
+
+#endif /* LTTB_H */
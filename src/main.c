@@ -7,18 +7,53 @@
  * can visualise it in real time.
  *
  * Run this first, then run dashboard.py in a second terminal.
+ *
+ * With --replay it instead streams a recorded log (CSV from the logger
+ * or sensor_ingestd, or a raw capture of the binary protocol) back
+ * through the manager and the logger, and reports throughput and
+ * per-stage latency:
+ *
+ *   sensor_logger --replay data/serial_log.csv --speed 60
+ *   sensor_logger --replay capture.bin --binary --fast -o out.csv
+ *
+ * With --sample it instead samples simulated sources in real time, each
+ * sensor at the period and phase its configuration gives, all driven by
+ * one timer wheel on one thread (sampler.h):
+ *
+ *   sensor_logger --sample 30
+ *
+ * Sensors, thresholds and the log file come from a configuration file
+ * (config.h): config/monitor.ini for the simulation, config/board.ini
+ * for replays, or whatever --config names.
  */
 
 #include "sensor_manager.h"
+#include "config.h"
 #include "logger.h"
+#include "replay.h"
+#include "sampler.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <math.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 
+/* IDs declared in config/monitor.ini */
 #define SENSOR_TEMP 0
 #define SENSOR_VIBRATION 1
 #define SENSOR_CURRENT 2
 
+/* Recorded logs come from the board (predictive_monitor.ino) */
+#define BOARD_TEMP      0
+#define BOARD_HUMIDITY  1
+#define BOARD_VIBRATION 2
+
+#define MONITOR_CONFIG  "config/monitor.ini"
+#define BOARD_CONFIG    "config/board.ini"
+
 /* Simulated millisecond tick */
 static uint32_t tick = 0;
 static uint32_t now(void) { return tick += 1000; }
@@ -27,68 +62,334 @@ static uint32_t now(void) { return tick += 1000; }
  * @brief Log a reading through the manager AND write it to CSV.
  *
  * This wrapper keeps main.c clean - one call does both jobs.
- * It checks thresholds via the manager, then writes the result
- * (including alert level) to the CSV file.
+ * The manager filters the value and checks thresholds, then the
+ * result (including alert level) is written to the CSV file.
  */
 static void log_and_record(manager_t *m, csv_logger_t *logger,
                            uint8_t id, float value, uint32_t timestamp)
 {
-    /* Check threshold before logging so we capture the alert level */
-    alert_level_t alert = manager_check_threshold(m, id, value);
+    const sensor_t *s = &m->sensors[id];
+
+    /* Log through manager (filters, updates buffer + stats); a sensor
+     * the configuration does not declare is skipped */
+    if (!manager_log(m, id, value, timestamp))
+        return;
 
-    /* Log through manager (updates buffer + stats) */
-    manager_log(m, id, value, timestamp);
+    /* Alert level reflects the filtered value the manager checked */
+    alert_level_t alert = manager_check_threshold(m, id, s->last_value);
 
     /* Write to CSV with sensor name and alert level */
     sensor_reading_t r = {.timestamp = timestamp,
                           .sensor_id = id,
-                          .value = value};
-    logger_write(logger, &r, m->sensors[id].name, alert);
+                          .value = s->log_raw ? value : s->last_value};
+    logger_write(logger, &r, s->name, alert);
 }
 
-int main(void)
+static void usage(const char *prog)
 {
-    printf("=== Predictive Maintenance Monitor ===\n\n");
+    printf("usage: %s [-v] [--config INI]   run the simulation\n"
+           "       %s [-v] [--config INI] --sample SECONDS\n"
+           "       %s [-v] [--config INI] --replay FILE [--binary] [--speed X | --fast] [-o out.csv]\n"
+           "  --config  sensors and thresholds (default " MONITOR_CONFIG ",\n"
+           "            " BOARD_CONFIG " with --replay)\n"
+           "  --sample  sample simulated sensors at their configured periods\n"
+           "  --binary  FILE is a raw capture of the binary protocol\n"
+           "  --speed   multiplier on the recorded timing (default 1)\n"
+           "  --fast    no pacing, as fast as possible\n"
+           "  -o        output CSV (default data/replay_log.csv)\n"
+           "  -v        print library status messages (repeat for debug)\n",
+           prog, prog, prog);
+}
 
-    /* ----------------------------------------------------------------
-     * 1. Create data/ directory and open CSV logger
-     * ---------------------------------------------------------------- */
+/**
+ * @brief Create data/ for the CSV log if it is not there yet.
+ */
+static void make_data_dir(void)
+{
 #ifdef _WIN32
     system("if not exist data mkdir data");
 #else
     system("mkdir -p data");
 #endif
+}
+
+/**
+ * @brief Load a configuration file and build its manager, or say why not.
+ */
+static manager_t *load_config(const char *path, config_t *cfg)
+{
+    config_error_t err;
+    manager_t *m = NULL;
+
+    if (config_load(cfg, path, &err))
+        m = config_build(cfg, &err);
+    if (m == NULL)
+    {
+        if (err.line > 0)
+            printf("ERROR: %s:%u: %s\n", path, err.line, err.msg);
+        else
+            printf("ERROR: %s: %s\n", path, err.msg);
+    }
+    return m;
+}
+
+/**
+ * @brief Replay a recorded log into a manager set up like the board's.
+ *
+ * The board configuration's flush policy applies; the output file is
+ * `out`, not its [logger] path, so a replay never appends to live data.
+ */
+static int run_replay(const char *path, bool binary, double speed,
+                      const char *out, const char *config)
+{
+    printf("=== Replay: %s ===\n", path);
+
+    config_t cfg;
+    manager_t *m = load_config(config, &cfg);
+    if (m == NULL)
+        return 1;
 
+    snprintf(cfg.log_path, sizeof(cfg.log_path), "%s", out);
     csv_logger_t logger;
-    if (!logger_open(&logger, "data/sensor_log.csv"))
+    if (!config_open_logger(&cfg, &logger))
     {
-        printf("ERROR: Could not open log file\n");
+        printf("ERROR: Could not open log file %s\n", out);
+        manager_destroy(m);
         return 1;
     }
 
-    /* ----------------------------------------------------------------
-     * 2. Create manager and register sensors
-     * ---------------------------------------------------------------- */
-    manager_t *m = manager_create(3);
+    replay_t *rp = malloc(sizeof(*rp));
+    if (rp == NULL)
+    {
+        logger_close(&logger);
+        manager_destroy(m);
+        return 1;
+    }
+    replay_init(rp, m, &logger);
+    replay_set_speed(rp, speed);
+
+    bool ok;
+    if (binary)
+    {
+        /* Same scales as sensor_ingestd -B */
+        frame_decoder_t dec;
+        frame_decoder_init(&dec);
+        frame_set_scale(&dec, BOARD_TEMP,      0.01f);
+        frame_set_scale(&dec, BOARD_HUMIDITY,  0.01f);
+        frame_set_scale(&dec, BOARD_VIBRATION, 1.0f / 16384.0f);
+        ok = replay_binary_file(rp, &dec, path);
+        if (ok)
+            printf("  %" PRIu64 " frames, %" PRIu64 " CRC errors, %" PRIu64
+                   " bytes skipped\n", dec.frames, dec.crc_errors, dec.skipped);
+    }
+    else
+    {
+        ok = replay_csv_file(rp, path);
+    }
+
+    if (ok)
+    {
+        manager_print_stats(m);
+        replay_print_stats(rp);
+        printf("\nCSV file: %s\n", out);
+    }
+
+    free(rp);
+    logger_close(&logger);
+    manager_destroy(m);
+    return ok ? 0 : 1;
+}
+
+/* ----------------------------------------------------------------------------
+ * --sample: simulated sources on the acquisition scheduler
+ * -------------------------------------------------------------------------- */
+
+static volatile sig_atomic_t g_stop = 0;
+
+static void on_sigint(int sig)
+{
+    (void)sig;
+    g_stop = 1;
+}
+
+typedef struct {
+    manager_t    *m;
+    csv_logger_t *logger;
+    uint64_t      duration_ms;
+} sample_ctx_t;
+
+/**
+ * @brief A machine slowly wearing out: each sensor wanders around the
+ *        middle of its warning band and drifts towards the top of it.
+ */
+static bool read_simulated(void *ctx, uint8_t id, uint64_t due_ms, float *value)
+{
+    const sample_ctx_t       *sc = ctx;
+    const sensor_threshold_t *t  = &sc->m->sensors[id].limits;
+
+    float low  = t->warn_low  > -1e6f ? t->warn_low  : 0.0f;
+    float high = t->warn_high <  1e6f ? t->warn_high : low + 1.0f;
+    float mid  = 0.5f * (low + high);
+    float half = 0.5f * (high - low);
+    float wear = (float)due_ms / (float)sc->duration_ms;
+
+    *value = mid + half * (0.3f * sinf((float)due_ms * 0.0005f + (float)id) +
+                           1.2f * wear);
+    return true;
+}
+
+/** Log and record each reading, then take it back off its ring - the CSV
+ *  file is the record, and a long run must not fill the rings */
+static void sample_sink(void *ctx, const sensor_reading_t *batch, size_t n)
+{
+    const sample_ctx_t *sc = ctx;
+    sensor_reading_t    out;
+    for (size_t i = 0; i < n; i++)
+    {
+        log_and_record(sc->m, sc->logger, batch[i].sensor_id, batch[i].value,
+                       batch[i].timestamp);
+        manager_read(sc->m, batch[i].sensor_id, &out);
+    }
+}
+
+/**
+ * @brief Sample every configured sensor in real time for `seconds`.
+ */
+static int run_sample(const char *config, unsigned seconds)
+{
+    printf("=== Sampling for %u s (Ctrl-C stops) ===\n", seconds);
+
+    config_t cfg;
+    manager_t *m = load_config(config, &cfg);
     if (m == NULL)
+        return 1;
+
+    make_data_dir();
+    csv_logger_t logger;
+    if (!config_open_logger(&cfg, &logger))
+    {
+        printf("ERROR: Could not open log file %s\n", cfg.log_path);
+        manager_destroy(m);
+        return 1;
+    }
+
+    sample_ctx_t sc = {m, &logger, (uint64_t)seconds * 1000u};
+    sampler_t *s = sampler_create(MANAGER_MAX_SENSORS, 0);
+    if (s == NULL)
     {
         logger_close(&logger);
+        manager_destroy(m);
         return 1;
     }
+    sampler_set_sink(s, sample_sink, &sc);
+
+    for (uint8_t id = 0; id < cfg.capacity; id++)
+    {
+        const config_sensor_t *cs = &cfg.sensors[id];
+        if (!cs->present)
+            continue;
+        sampler_add(s, id, cs->period_ms, cs->phase_ms, read_simulated, &sc);
+        printf("  %-20s every %u ms, phase %u ms\n", cs->name,
+               cs->period_ms, cs->phase_ms);
+    }
+
+    signal(SIGINT, on_sigint);
+    sampler_run(s, sc.duration_ms, &g_stop);
+
+    sampler_print_stats(s);
+    manager_print_stats(m);
+    printf("\nCSV file: %s\n", cfg.log_path);
+
+    sampler_destroy(s);
+    logger_close(&logger);
+    manager_destroy(m);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    const char *replay = NULL;
+    const char *config = NULL;
+    long        sample = 0;
+    const char *out    = "data/replay_log.csv";
+    bool        binary = false;
+    double      speed  = 1.0;
+    int         level  = DIAG_LEVEL_WARN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replay = argv[++i];
+        else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc)
+            sample = strtol(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+            config = argv[++i];
+        else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+            speed = strtod(argv[++i], NULL);
+        else if (strcmp(argv[i], "--fast") == 0)
+            speed = REPLAY_FAST;
+        else if (strcmp(argv[i], "--binary") == 0)
+            binary = true;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            out = argv[++i];
+        else if (strcmp(argv[i], "-v") == 0)
+            level = level > DIAG_LEVEL_DEBUG ? level - 1 : level;
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    diag_set_level(level);
 
-    manager_register(m, SENSOR_TEMP, "Temperature (C)", 16);
-    manager_register(m, SENSOR_VIBRATION, "Vibration (g)", 16);
-    manager_register(m, SENSOR_CURRENT, "Current Draw (A)", 16);
+    if (replay != NULL)
+    {
+        if (speed < 0.0)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        return run_replay(replay, binary, speed, out,
+                          config != NULL ? config : BOARD_CONFIG);
+    }
+
+    if (sample != 0)
+    {
+        if (sample < 0)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        return run_sample(config != NULL ? config : MONITOR_CONFIG,
+                          (unsigned)sample);
+    }
+
+    printf("=== Predictive Maintenance Monitor ===\n\n");
+
+    /* ----------------------------------------------------------------
+     * 1. Load the configuration: one pass builds the manager, its
+     *    sensors, thresholds and filters
+     * ---------------------------------------------------------------- */
+    config_t cfg;
+    manager_t *m = load_config(config != NULL ? config : MONITOR_CONFIG, &cfg);
+    if (m == NULL)
+        return 1;
 
     /* ----------------------------------------------------------------
-     * 3. Set thresholds
+     * 2. Create data/ directory and open CSV logger
      * ---------------------------------------------------------------- */
-    manager_set_thresholds(m, SENSOR_TEMP, (sensor_threshold_t){.warn_low = 0.0f, .warn_high = 70.0f, .critical_low = -10.0f, .critical_high = 85.0f, .enabled = true});
-    manager_set_thresholds(m, SENSOR_VIBRATION, (sensor_threshold_t){.warn_low = 0.0f, .warn_high = 0.5f, .critical_low = 0.0f, .critical_high = 1.0f, .enabled = true});
-    manager_set_thresholds(m, SENSOR_CURRENT, (sensor_threshold_t){.warn_low = 0.0f, .warn_high = 8.0f, .critical_low = 0.0f, .critical_high = 10.0f, .enabled = true});
+    make_data_dir();
+
+    csv_logger_t logger;
+    if (!config_open_logger(&cfg, &logger))
+    {
+        printf("ERROR: Could not open log file\n");
+        manager_destroy(m);
+        return 1;
+    }
 
     /* ----------------------------------------------------------------
-     * 4. Phase 1: Normal operation
+     * 3. Phase 1: Normal operation
      * ---------------------------------------------------------------- */
     printf("\n--- Phase 1: Normal operation ---\n");
     float normal_temps[] = {42.0f, 43.5f, 44.0f, 43.0f, 44.5f};
@@ -104,7 +405,7 @@ int main(void)
     printf("  Written %u rows to CSV\n", logger_rows_written(&logger));
 
     /* ----------------------------------------------------------------
-     * 5. Phase 2: Early warning signs
+     * 4. Phase 2: Early warning signs
      * ---------------------------------------------------------------- */
     printf("\n--- Phase 2: Early warning signs ---\n");
     float warn_temps[] = {65.0f, 68.0f, 71.0f};
@@ -120,7 +421,7 @@ int main(void)
     printf("  Written %u rows to CSV\n", logger_rows_written(&logger));
 
     /* ----------------------------------------------------------------
-     * 6. Phase 3: Critical failure
+     * 5. Phase 3: Critical failure
      * ---------------------------------------------------------------- */
     printf("\n--- Phase 3: Critical failure ---\n");
     log_and_record(m, &logger, SENSOR_TEMP, 91.0f, now());
@@ -129,17 +430,17 @@ int main(void)
     printf("  Written %u rows to CSV\n", logger_rows_written(&logger));
 
     /* ----------------------------------------------------------------
-     * 7. Final report
+     * 6. Final report
      * ---------------------------------------------------------------- */
     manager_print_all(m);
     manager_print_stats(m);
     printf("\nTotal CSV rows written: %u\n",
            logger_rows_written(&logger));
-    printf("CSV file: data/sensor_log.csv\n");
+    printf("CSV file: %s\n", cfg.log_path);
     printf("Run dashboard: python dashboard/dashboard.py\n");
 
     /* ----------------------------------------------------------------
-     * 8. Cleanup
+     * 7. Cleanup
      * ---------------------------------------------------------------- */
     logger_close(&logger);
     manager_destroy(m);
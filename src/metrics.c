@@ -0,0 +1,478 @@
+/**
+ * @file metrics.c
+ * @brief Metrics registry and Prometheus text rendering
+ *
+ * Each thread finds its slot through a small thread-local cache keyed by
+ * the registry's serial number (not its address, which a later registry
+ * may reuse). A miss claims the next free slot with one atomic add.
+ *
+ * Slot counters and histograms have a single writer - the owning thread -
+ * and use relaxed loads and stores like hist_t. metrics_render() reads
+ * them the same way, so a scrape and the ingestion path never wait on
+ * each other.
+ */
+
+#include "metrics.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Registries a thread keeps cached slots for */
+#define SLOT_CACHE  4
+
+typedef struct {
+    uint64_t        serial;
+    metrics_slot_t *slot;
+} slot_cache_t;
+
+static _Thread_local slot_cache_t t_cache[SLOT_CACHE];
+static _Thread_local unsigned     t_cache_next;
+static _Atomic uint64_t           g_serial = 1;
+
+/** Histogram bucket bounds in ns, exported as seconds */
+static const uint64_t k_bounds_ns[] = {
+    1000, 5000, 10000, 50000, 100000, 500000,
+    1000000, 5000000, 10000000, 50000000, 100000000, 500000000,
+    1000000000, 5000000000, 10000000000
+};
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static bool valid_name(const char *name)
+{
+    if (name == NULL || name[0] == '\0' || strlen(name) >= METRICS_NAME_MAX)
+        return false;
+    for (const char *p = name; *p; p++)
+    {
+        char c = *p;
+        bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                  c == '_' || c == ':' || (p != name && c >= '0' && c <= '9');
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+static int add_metric(metrics_t *reg, metric_type_t type, const char *name,
+                      const char *help, const char *labels, const hist_t *ext)
+{
+    if (reg == NULL || !valid_name(name))
+    {
+        DIAG_ERROR("METRICS", "Invalid metric name '%s'", name ? name : "(null)");
+        return -1;
+    }
+    if (labels != NULL && strlen(labels) >= METRICS_LABELS_MAX)
+    {
+        DIAG_ERROR("METRICS", "Labels of '%s' too long", name);
+        return -1;
+    }
+
+    pthread_mutex_lock(&reg->register_lock);
+    unsigned n = atomic_load_explicit(&reg->count, memory_order_relaxed);
+    if (n >= METRICS_MAX)
+    {
+        pthread_mutex_unlock(&reg->register_lock);
+        DIAG_ERROR("METRICS", "Registry full (%d metrics)", METRICS_MAX);
+        return -1;
+    }
+
+    metric_t *m = &reg->metric[n];
+    snprintf(m->name, sizeof(m->name), "%s", name);
+    snprintf(m->help, sizeof(m->help), "%s", help ? help : "");
+    snprintf(m->labels, sizeof(m->labels), "%s", labels ? labels : "");
+    m->type     = type;
+    m->external = ext;
+    atomic_store_explicit(&m->value, 0, memory_order_relaxed);
+
+    /* Publish the filled-in entry to scrapes */
+    atomic_store_explicit(&reg->count, n + 1, memory_order_release);
+    pthread_mutex_unlock(&reg->register_lock);
+    return (int)n;
+}
+
+/** The calling thread's slot in `reg`, claimed on first use */
+static metrics_slot_t *local_slot(metrics_t *reg)
+{
+    for (unsigned i = 0; i < SLOT_CACHE; i++)
+    {
+        if (t_cache[i].serial == reg->serial)
+            return t_cache[i].slot;
+    }
+
+    unsigned idx = atomic_fetch_add(&reg->slots_used, 1);
+    if (idx >= METRICS_MAX_THREADS)
+        return NULL;
+
+    metrics_slot_t *s = cache_alloc(sizeof(metrics_slot_t));
+    if (s == NULL)
+        return NULL;
+    memset(s, 0, sizeof(*s));
+    atomic_store_explicit(&reg->slot[idx], s, memory_order_release);
+
+    slot_cache_t *c = &t_cache[t_cache_next++ % SLOT_CACHE];
+    c->serial = reg->serial;
+    c->slot   = s;
+    return s;
+}
+
+static bool is_type(metrics_t *reg, int id, metric_type_t type)
+{
+    return reg != NULL && id >= 0 &&
+           (unsigned)id < atomic_load_explicit(&reg->count, memory_order_acquire) &&
+           reg->metric[id].type == type;
+}
+
+/** Sum of a counter across every slot plus its absolute part */
+static uint64_t counter_total(metrics_t *reg, int id)
+{
+    uint64_t v = atomic_load_explicit(&reg->metric[id].value, memory_order_relaxed);
+    unsigned n = atomic_load_explicit(&reg->slots_used, memory_order_acquire);
+    if (n > METRICS_MAX_THREADS)
+        n = METRICS_MAX_THREADS;
+    for (unsigned i = 0; i < n; i++)
+    {
+        metrics_slot_t *s = atomic_load_explicit(&reg->slot[i], memory_order_acquire);
+        if (s != NULL)
+            v += atomic_load_explicit(&s->counter[id], memory_order_relaxed);
+    }
+    return v;
+}
+
+static double gauge_value(metrics_t *reg, int id)
+{
+    uint64_t bits = atomic_load_explicit(&reg->metric[id].value, memory_order_relaxed);
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+/** Merge every slot's samples of histogram `id` (and its external) into `out` */
+static void histogram_collect(metrics_t *reg, int id, hist_t *out)
+{
+    hist_reset(out);
+    hist_merge(out, reg->metric[id].external);
+
+    unsigned n = atomic_load_explicit(&reg->slots_used, memory_order_acquire);
+    if (n > METRICS_MAX_THREADS)
+        n = METRICS_MAX_THREADS;
+    for (unsigned i = 0; i < n; i++)
+    {
+        metrics_slot_t *s = atomic_load_explicit(&reg->slot[i], memory_order_acquire);
+        if (s != NULL)
+            hist_merge(out, atomic_load_explicit(&s->hist[id], memory_order_acquire));
+    }
+}
+
+/* ---- growable text buffer ---- */
+
+typedef struct {
+    char  *p;
+    size_t len, cap;
+    bool   oom;
+} text_t;
+
+static void emit(text_t *t, const char *fmt, ...)
+{
+    if (t->oom)
+        return;
+
+    for (;;)
+    {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(t->p + t->len, t->cap - t->len, fmt, ap);
+        va_end(ap);
+        if (n < 0)
+        {
+            t->oom = true;
+            return;
+        }
+        if ((size_t)n < t->cap - t->len)
+        {
+            t->len += (size_t)n;
+            return;
+        }
+
+        size_t cap = t->cap * 2 + (size_t)n;
+        char *p = realloc(t->p, cap);
+        if (p == NULL)
+        {
+            t->oom = true;
+            return;
+        }
+        t->p   = p;
+        t->cap = cap;
+    }
+}
+
+static void emit_double(text_t *t, double v)
+{
+    if (isnan(v))
+        emit(t, "NaN");
+    else if (isinf(v))
+        emit(t, v > 0 ? "+Inf" : "-Inf");
+    else
+        emit(t, "%.9g", v);
+}
+
+/** `name{labels,extra}` with the braces left out when both are empty */
+static void emit_series(text_t *t, const metric_t *m, const char *suffix,
+                        const char *extra)
+{
+    const char *sep = (m->labels[0] && extra[0]) ? "," : "";
+    if (m->labels[0] || extra[0])
+        emit(t, "%s%s{%s%s%s} ", m->name, suffix, m->labels, sep, extra);
+    else
+        emit(t, "%s%s ", m->name, suffix);
+}
+
+static void render_one(metrics_t *reg, int id, text_t *t, hist_t *tmp)
+{
+    const metric_t *m = &reg->metric[id];
+
+    switch (m->type)
+    {
+    case METRIC_COUNTER:
+        emit_series(t, m, "", "");
+        emit(t, "%" PRIu64 "\n", counter_total(reg, id));
+        break;
+
+    case METRIC_GAUGE:
+        emit_series(t, m, "", "");
+        emit_double(t, gauge_value(reg, id));
+        emit(t, "\n");
+        break;
+
+    case METRIC_HISTOGRAM:
+    {
+        histogram_collect(reg, id, tmp);
+        uint64_t total = 0;
+        for (size_t i = 0; i < HIST_BUCKETS; i++)
+            total += atomic_load_explicit(&tmp->counts[i], memory_order_relaxed);
+
+        char le[32];
+        for (size_t b = 0; b < sizeof(k_bounds_ns) / sizeof(k_bounds_ns[0]); b++)
+        {
+            snprintf(le, sizeof(le), "le=\"%g\"", (double)k_bounds_ns[b] / 1e9);
+            emit_series(t, m, "_bucket", le);
+            emit(t, "%" PRIu64 "\n", hist_count_le(tmp, k_bounds_ns[b]));
+        }
+        emit_series(t, m, "_bucket", "le=\"+Inf\"");
+        emit(t, "%" PRIu64 "\n", total);
+        emit_series(t, m, "_sum", "");
+        emit_double(t, (double)hist_sum(tmp) / 1e9);
+        emit(t, "\n");
+        emit_series(t, m, "_count", "");
+        emit(t, "%" PRIu64 "\n", total);
+        break;
+    }
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+metrics_t *metrics_create(void)
+{
+    metrics_t *reg = calloc(1, sizeof(metrics_t));
+    if (reg == NULL)
+    {
+        DIAG_ERROR("METRICS", "Out of memory");
+        return NULL;
+    }
+    pthread_mutex_init(&reg->register_lock, NULL);
+    reg->serial = atomic_fetch_add(&g_serial, 1);
+    return reg;
+}
+
+void metrics_destroy(metrics_t *reg)
+{
+    if (reg == NULL)
+        return;
+
+    unsigned n = atomic_load(&reg->slots_used);
+    if (n > METRICS_MAX_THREADS)
+        n = METRICS_MAX_THREADS;
+    for (unsigned i = 0; i < n; i++)
+    {
+        metrics_slot_t *s = atomic_load(&reg->slot[i]);
+        if (s == NULL)
+            continue;
+        for (unsigned k = 0; k < METRICS_MAX; k++)
+            hist_destroy(atomic_load(&s->hist[k]));
+        cache_free(s);
+    }
+    pthread_mutex_destroy(&reg->register_lock);
+    free(reg);
+}
+
+int metrics_counter(metrics_t *reg, const char *name, const char *help,
+                    const char *labels)
+{
+    return add_metric(reg, METRIC_COUNTER, name, help, labels, NULL);
+}
+
+int metrics_gauge(metrics_t *reg, const char *name, const char *help,
+                  const char *labels)
+{
+    int id = add_metric(reg, METRIC_GAUGE, name, help, labels, NULL);
+    if (id >= 0)
+        metrics_set(reg, id, 0.0);
+    return id;
+}
+
+int metrics_histogram(metrics_t *reg, const char *name, const char *help,
+                      const char *labels)
+{
+    return add_metric(reg, METRIC_HISTOGRAM, name, help, labels, NULL);
+}
+
+int metrics_histogram_external(metrics_t *reg, const char *name,
+                               const char *help, const char *labels,
+                               const hist_t *h)
+{
+    return add_metric(reg, METRIC_HISTOGRAM, name, help, labels, h);
+}
+
+void metrics_add(metrics_t *reg, int id, uint64_t n)
+{
+    if (!is_type(reg, id, METRIC_COUNTER))
+        return;
+
+    metrics_slot_t *s = local_slot(reg);
+    if (s == NULL)
+    {
+        atomic_fetch_add_explicit(&reg->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    _Atomic uint64_t *c = &s->counter[id];
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + n,
+                          memory_order_relaxed);
+}
+
+void metrics_set_total(metrics_t *reg, int id, uint64_t total)
+{
+    if (is_type(reg, id, METRIC_COUNTER))
+        atomic_store_explicit(&reg->metric[id].value, total, memory_order_relaxed);
+}
+
+void metrics_set(metrics_t *reg, int id, double value)
+{
+    if (!is_type(reg, id, METRIC_GAUGE))
+        return;
+
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    atomic_store_explicit(&reg->metric[id].value, bits, memory_order_relaxed);
+}
+
+void metrics_observe(metrics_t *reg, int id, uint64_t ns)
+{
+    if (!is_type(reg, id, METRIC_HISTOGRAM) || reg->metric[id].external != NULL)
+        return;
+
+    metrics_slot_t *s = local_slot(reg);
+    hist_t *h = s ? atomic_load_explicit(&s->hist[id], memory_order_relaxed) : NULL;
+    if (h == NULL && s != NULL)
+    {
+        h = hist_create();
+        atomic_store_explicit(&s->hist[id], h, memory_order_release);
+    }
+    if (h == NULL)
+    {
+        atomic_fetch_add_explicit(&reg->dropped, 1, memory_order_relaxed);
+        return;
+    }
+    hist_record(h, ns);
+}
+
+double metrics_value(metrics_t *reg, int id)
+{
+    if (is_type(reg, id, METRIC_COUNTER))
+        return (double)counter_total(reg, id);
+    if (is_type(reg, id, METRIC_GAUGE))
+        return gauge_value(reg, id);
+    return 0.0;
+}
+
+char *metrics_render(metrics_t *reg, size_t *len)
+{
+    if (reg == NULL)
+        return NULL;
+
+    text_t t = {.p = malloc(4096), .cap = 4096};
+    hist_t *tmp = hist_create();
+    if (t.p == NULL || tmp == NULL)
+    {
+        free(t.p);
+        hist_destroy(tmp);
+        return NULL;
+    }
+    t.p[0] = '\0';
+
+    static const char *const k_type[] = {"counter", "gauge", "histogram"};
+    unsigned count = atomic_load_explicit(&reg->count, memory_order_acquire);
+
+    /* A metric family's series must be contiguous: emit each name once,
+     * at its first registration, followed by all of its label sets */
+    for (unsigned i = 0; i < count; i++)
+    {
+        const metric_t *m = &reg->metric[i];
+        bool seen = false;
+        for (unsigned j = 0; j < i && !seen; j++)
+            seen = strcmp(reg->metric[j].name, m->name) == 0;
+        if (seen)
+            continue;
+
+        if (m->help[0])
+            emit(&t, "# HELP %s %s\n", m->name, m->help);
+        emit(&t, "# TYPE %s %s\n", m->name, k_type[m->type]);
+        for (unsigned j = i; j < count; j++)
+        {
+            if (strcmp(reg->metric[j].name, m->name) == 0)
+                render_one(reg, (int)j, &t, tmp);
+        }
+    }
+
+    hist_destroy(tmp);
+    if (t.oom)
+    {
+        free(t.p);
+        return NULL;
+    }
+    if (len != NULL)
+        *len = t.len;
+    return t.p;
+}
+
+size_t metrics_escape(char *out, size_t cap, const char *value)
+{
+    if (out == NULL || cap == 0)
+        return 0;
+
+    size_t n = 0;
+    for (const char *p = value ? value : ""; *p; p++)
+    {
+        const char *rep = NULL;
+        char one[2] = {*p, '\0'};
+        if (*p == '\\')      rep = "\\\\";
+        else if (*p == '"')  rep = "\\\"";
+        else if (*p == '\n') rep = "\\n";
+        else                 rep = one;
+
+        size_t k = strlen(rep);
+        if (n + k >= cap)
+            break;
+        memcpy(out + n, rep, k);
+        n += k;
+    }
+    out[n] = '\0';
+    return n;
+}
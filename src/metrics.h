@@ -0,0 +1,180 @@
+/**
+ * @file metrics.h
+ * @brief Runtime metrics registry exported in Prometheus text format
+ *
+ * Counters, gauges and histograms registered once at startup and updated
+ * from the ingestion path without locks:
+ *
+ *   counter    metrics_add()          per-thread slot, summed at scrape
+ *              metrics_set_total()    absolute total kept elsewhere
+ *                                     (manager or logger counters)
+ *   gauge      metrics_set()          last value written wins
+ *   histogram  metrics_observe()      per-thread hist_t, merged at scrape
+ *              metrics_histogram_external()  a hist_t recorded elsewhere
+ *
+ * Every thread that calls metrics_add() or metrics_observe() claims its
+ * own cache-line aligned slot on first use, so two producers never write
+ * the same cache line and an update is a relaxed load and store. A
+ * scrape (metrics_render) only reads: it sums slots and merges
+ * histograms with relaxed loads and never takes a lock the hot path
+ * uses. Registration takes a mutex and belongs at startup.
+ *
+ * Histograms record nanoseconds and are exported in seconds with fixed
+ * buckets from 1 us to 10 s.
+ *
+ *   metrics_t *reg = metrics_create();
+ *   int rows = metrics_counter(reg, "logger_rows_total", "Rows written", NULL);
+ *   metrics_add(reg, rows, 1);
+ *   char *text = metrics_render(reg, &len);
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "histogram.h"
+#include "cacheline.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Metrics per registry (each label set counts as one) */
+#define METRICS_MAX             128
+
+/** @brief Threads that may update one registry */
+#define METRICS_MAX_THREADS     64
+
+#define METRICS_NAME_MAX        64
+#define METRICS_HELP_MAX        96
+#define METRICS_LABELS_MAX      96
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+typedef enum {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} metric_type_t;
+
+/**
+ * @brief One registered time series
+ */
+typedef struct {
+    char          name[METRICS_NAME_MAX];
+    char          help[METRICS_HELP_MAX];
+    char          labels[METRICS_LABELS_MAX];   ///< `key="value",...` or ""
+    metric_type_t type;
+    const hist_t *external;         ///< Histogram recorded elsewhere, or NULL
+    _Atomic uint64_t value;         ///< Counter total / gauge double bits
+} metric_t;
+
+/**
+ * @brief Per-thread storage, one cache-line aligned block per thread
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) _Atomic uint64_t counter[METRICS_MAX];
+    _Atomic(hist_t *) hist[METRICS_MAX];    ///< Created on first observe
+} metrics_slot_t;
+
+/**
+ * @brief Registry (heap-allocated, see metrics_create)
+ */
+typedef struct {
+    uint64_t          serial;               ///< Unique per registry (thread cache key)
+    metric_t          metric[METRICS_MAX];
+    _Atomic unsigned  count;                ///< Metrics registered
+    pthread_mutex_t   register_lock;        ///< Registration only
+
+    _Atomic(metrics_slot_t *) slot[METRICS_MAX_THREADS];
+    _Atomic unsigned  slots_used;
+    _Atomic uint64_t  dropped;              ///< Updates from threads past the limit
+} metrics_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Create an empty registry.
+ * @return NULL on allocation failure
+ */
+metrics_t *metrics_create(void);
+
+/**
+ * @brief Free the registry, its slots and their histograms.
+ *
+ * No thread may update or render it any more.
+ */
+void metrics_destroy(metrics_t *reg);
+
+/**
+ * @brief Register a metric.
+ *
+ * `name` must be a valid Prometheus metric name. `labels` is the inside
+ * of the braces, already escaped (see metrics_escape), or NULL. Several
+ * label sets may share a name and help text; they are exported together.
+ *
+ * @return Metric id for the update calls, -1 if the registry is full or
+ *         the arguments are invalid
+ */
+int metrics_counter(metrics_t *reg, const char *name, const char *help,
+                    const char *labels);
+int metrics_gauge(metrics_t *reg, const char *name, const char *help,
+                  const char *labels);
+int metrics_histogram(metrics_t *reg, const char *name, const char *help,
+                      const char *labels);
+
+/**
+ * @brief Register a histogram whose samples are recorded in `h` by
+ *        someone else (e.g. the logger's flush timer).
+ *
+ * `h` must outlive the registry's last scrape.
+ */
+int metrics_histogram_external(metrics_t *reg, const char *name,
+                               const char *help, const char *labels,
+                               const hist_t *h);
+
+/** @brief Add `n` to a counter from the calling thread's slot */
+void metrics_add(metrics_t *reg, int id, uint64_t n);
+
+/**
+ * @brief Set the absolute part of a counter.
+ *
+ * For totals that already live elsewhere; the exported value is this
+ * plus anything added with metrics_add().
+ */
+void metrics_set_total(metrics_t *reg, int id, uint64_t total);
+
+/** @brief Set a gauge */
+void metrics_set(metrics_t *reg, int id, double value);
+
+/** @brief Record one ns value into a histogram from the calling thread */
+void metrics_observe(metrics_t *reg, int id, uint64_t ns);
+
+/**
+ * @brief Current value of a counter or gauge (what a scrape would see).
+ */
+double metrics_value(metrics_t *reg, int id);
+
+/**
+ * @brief Render every metric in Prometheus text format (version 0.0.4).
+ *
+ * @param len  Set to the text length (excluding the terminating NUL)
+ * @return malloc'd NUL-terminated text to free(), NULL if out of memory
+ */
+char *metrics_render(metrics_t *reg, size_t *len);
+
+/**
+ * @brief Escape a label value (backslash, quote, newline) into `out`.
+ * @return Length written, truncated to fit `cap`
+ */
+size_t metrics_escape(char *out, size_t cap, const char *value);
+
+#endif /* METRICS_H */
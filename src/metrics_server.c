@@ -0,0 +1,274 @@
+/**
+ * @file metrics_server.c
+ * @brief Minimal HTTP/1.0 scrape endpoint over TCP or a Unix socket
+ *
+ * The accept loop polls with a short timeout so metrics_server_stop()
+ * can end it without signals. Each client is read until the end of its
+ * request headers (or METRICS_CLIENT_TIMEOUT_MS), answered and closed;
+ * keep-alive is not offered.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "metrics_server.h"
+#include "diag.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/** Accept-loop poll interval: how long stop may take (ms) */
+#define ACCEPT_POLL_MS  100
+
+/** Request bytes read before giving up on finding the header end */
+#define REQUEST_MAX     4096
+
+struct metrics_server {
+    metrics_t       *reg;
+    int              fd;
+    uint16_t         port;
+    char             path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    pthread_t        thread;
+    atomic_bool      stop;
+    _Atomic uint64_t scrapes;
+};
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static bool write_all(int fd, const char *p, size_t n)
+{
+    while (n > 0)
+    {
+        /* MSG_NOSIGNAL: a scraper hanging up must not SIGPIPE the daemon */
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR)
+            continue;
+        if (w <= 0)
+            return false;
+        p += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+/** Read until a blank line; false on timeout, error or oversize request */
+static bool read_request(int fd, char *buf, size_t cap)
+{
+    size_t len = 0;
+    while (len + 1 < cap)
+    {
+        struct pollfd p = {.fd = fd, .events = POLLIN};
+        if (poll(&p, 1, METRICS_CLIENT_TIMEOUT_MS) <= 0)
+            return false;
+
+        ssize_t r = read(fd, buf + len, cap - 1 - len);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        len += (size_t)r;
+        buf[len] = '\0';
+        if (strstr(buf, "\r\n\r\n") != NULL || strstr(buf, "\n\n") != NULL)
+            return true;
+    }
+    return false;
+}
+
+static void serve_client(metrics_server_t *srv, int fd)
+{
+    char req[REQUEST_MAX];
+    if (!read_request(fd, req, sizeof(req)))
+        return;
+
+    char method[8], target[256];
+    if (sscanf(req, "%7s %255s", method, target) != 2)
+        return;
+
+    bool found = strcmp(target, "/metrics") == 0 || strcmp(target, "/") == 0 ||
+                 strncmp(target, "/metrics?", 9) == 0;
+    if (strcmp(method, "GET") != 0 || !found)
+    {
+        static const char k_404[] =
+            "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\n"
+            "Content-Length: 10\r\n\r\nnot found\n";
+        write_all(fd, k_404, sizeof(k_404) - 1);
+        return;
+    }
+
+    size_t len = 0;
+    char *body = metrics_render(srv->reg, &len);
+    if (body == NULL)
+    {
+        static const char k_500[] =
+            "HTTP/1.0 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+        write_all(fd, k_500, sizeof(k_500) - 1);
+        return;
+    }
+
+    char head[160];
+    int n = snprintf(head, sizeof(head),
+                     "HTTP/1.0 200 OK\r\n"
+                     "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                     "Content-Length: %zu\r\n\r\n", len);
+    if (write_all(fd, head, (size_t)n))
+        write_all(fd, body, len);
+    free(body);
+    atomic_fetch_add(&srv->scrapes, 1);
+}
+
+static void *serve_loop(void *arg)
+{
+    metrics_server_t *srv = arg;
+
+    while (!atomic_load(&srv->stop))
+    {
+        struct pollfd p = {.fd = srv->fd, .events = POLLIN};
+        if (poll(&p, 1, ACCEPT_POLL_MS) <= 0)
+            continue;
+
+        int c = accept(srv->fd, NULL, NULL);
+        if (c < 0)
+            continue;
+        serve_client(srv, c);
+        close(c);
+    }
+    return NULL;
+}
+
+static int bind_unix(metrics_server_t *srv, const char *path)
+{
+    struct sockaddr_un sa = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(sa.sun_path))
+    {
+        DIAG_ERROR("METRICS", "Socket path too long '%s'", path);
+        return -1;
+    }
+    strcpy(sa.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    strcpy(srv->path, path);
+    return fd;
+}
+
+static int bind_tcp(metrics_server_t *srv, const char *addr)
+{
+    char host[64] = "127.0.0.1";
+    const char *colon = strrchr(addr, ':');
+    const char *port_s = addr;
+    if (colon != NULL)
+    {
+        size_t hl = (size_t)(colon - addr);
+        if (hl == 0 || hl >= sizeof(host))
+            return -1;
+        memcpy(host, addr, hl);
+        host[hl] = '\0';
+        port_s = colon + 1;
+    }
+
+    char *end;
+    unsigned long port = strtoul(port_s, &end, 10);
+    if (*port_s == '\0' || *end != '\0' || port > 65535)
+        return -1;
+
+    struct sockaddr_in sa = {.sin_family = AF_INET, .sin_port = htons((uint16_t)port)};
+    if (inet_pton(AF_INET, host, &sa.sin_addr) != 1)
+        return -1;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    socklen_t sl = sizeof(sa);
+    getsockname(fd, (struct sockaddr *)&sa, &sl);
+    srv->port = ntohs(sa.sin_port);
+    return fd;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+metrics_server_t *metrics_server_start(metrics_t *reg, const char *addr)
+{
+    if (reg == NULL || addr == NULL)
+        return NULL;
+
+    metrics_server_t *srv = calloc(1, sizeof(*srv));
+    if (srv == NULL)
+        return NULL;
+    srv->reg = reg;
+
+    srv->fd = strchr(addr, '/') != NULL ? bind_unix(srv, addr)
+                                        : bind_tcp(srv, addr);
+    if (srv->fd < 0 || listen(srv->fd, 8) < 0)
+    {
+        DIAG_ERROR("METRICS", "Cannot listen on '%s'", addr);
+        if (srv->fd >= 0)
+            close(srv->fd);
+        free(srv);
+        return NULL;
+    }
+
+    if (pthread_create(&srv->thread, NULL, serve_loop, srv) != 0)
+    {
+        close(srv->fd);
+        if (srv->path[0])
+            unlink(srv->path);
+        free(srv);
+        return NULL;
+    }
+
+    if (srv->path[0])
+        DIAG_INFO("METRICS", "Serving on unix:%s", srv->path);
+    else
+        DIAG_INFO("METRICS", "Serving on port %u", srv->port);
+    return srv;
+}
+
+uint16_t metrics_server_port(const metrics_server_t *srv)
+{
+    return srv != NULL ? srv->port : 0;
+}
+
+uint64_t metrics_server_scrapes(const metrics_server_t *srv)
+{
+    return srv != NULL ? atomic_load(&((metrics_server_t *)srv)->scrapes) : 0;
+}
+
+void metrics_server_stop(metrics_server_t *srv)
+{
+    if (srv == NULL)
+        return;
+
+    atomic_store(&srv->stop, true);
+    pthread_join(srv->thread, NULL);
+    close(srv->fd);
+    if (srv->path[0])
+        unlink(srv->path);
+    free(srv);
+}
@@ -0,0 +1,54 @@
+/**
+ * @file metrics_server.h
+ * @brief Local scrape endpoint for a metrics registry (POSIX)
+ *
+ * Serves metrics_render() output to Prometheus (or curl) from a
+ * background thread:
+ *
+ *   "9464"              TCP on 127.0.0.1:9464
+ *   "0.0.0.0:9464"      TCP on an explicit address
+ *   "/run/sensor.sock"  Unix stream socket at that path (any address
+ *                       containing '/'); replaced if it already exists
+ *
+ * Any GET for /metrics (or /) gets the text exposition format; other
+ * paths get 404. One connection is served at a time: a scrape is a
+ * render and a single write, and nothing on the ingestion path waits
+ * for it.
+ *
+ *   metrics_server_t *srv = metrics_server_start(reg, "9464");
+ *   ...
+ *   metrics_server_stop(srv);
+ */
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "metrics.h"
+#include <stdint.h>
+
+/** @brief Longest wait for a client's request before it is dropped (ms) */
+#define METRICS_CLIENT_TIMEOUT_MS   1000
+
+typedef struct metrics_server metrics_server_t;
+
+/**
+ * @brief Bind `addr` and start serving `reg`.
+ * @return NULL if the address is invalid or cannot be bound
+ */
+metrics_server_t *metrics_server_start(metrics_t *reg, const char *addr);
+
+/**
+ * @brief TCP port actually bound (useful with port 0), 0 for Unix sockets.
+ */
+uint16_t metrics_server_port(const metrics_server_t *srv);
+
+/** @brief Scrapes answered so far */
+uint64_t metrics_server_scrapes(const metrics_server_t *srv);
+
+/**
+ * @brief Stop the thread, close the socket (unlinking a Unix socket path)
+ *        and free the server. NULL is safe.
+ */
+void metrics_server_stop(metrics_server_t *srv);
+
+#endif /* METRICS_SERVER_H */
@@ -0,0 +1,106 @@
+/**
+ * @file pipeline_metrics.c
+ * @brief Standard manager + logger metrics
+ */
+
+#include "pipeline_metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+bool pipeline_metrics_init(pipeline_metrics_t *pm, metrics_t *reg,
+                           const manager_t *m, csv_logger_t *logger)
+{
+    if (pm == NULL || reg == NULL || m == NULL)
+        return false;
+
+    memset(pm, 0, sizeof(*pm));
+    pm->reg = reg;
+    bool ok = true;
+
+    for (uint8_t id = 0; id < MANAGER_MAX_SENSORS; id++)
+    {
+        pm->fill[id] = pm->overflows[id] = pm->samples[id] = -1;
+        if (id >= m->capacity || !m->registered[id])
+            continue;
+
+        char name[SENSOR_NAME_MAX * 2], labels[METRICS_LABELS_MAX];
+        metrics_escape(name, sizeof(name), m->sensors[id].name);
+        snprintf(labels, sizeof(labels), "id=\"%u\",sensor=\"%s\"", id, name);
+
+        pm->fill[id] = metrics_gauge(reg, "sensor_buffer_fill_ratio",
+                                     "Ring buffer occupancy (0..1)", labels);
+        pm->overflows[id] = metrics_counter(reg, "sensor_buffer_overflows_total",
+                                            "Readings refused because the ring was full",
+                                            labels);
+        pm->samples[id] = metrics_counter(reg, "sensor_samples_total",
+                                          "Readings stored per sensor", labels);
+        ok = ok && pm->fill[id] >= 0 && pm->overflows[id] >= 0 &&
+             pm->samples[id] >= 0;
+    }
+
+    pm->readings  = metrics_counter(reg, "manager_readings_total",
+                                    "Readings accepted by manager_log", NULL);
+    pm->alerts    = metrics_counter(reg, "manager_alerts_total",
+                                    "Threshold and anomaly alerts raised", NULL);
+    pm->anomalies = metrics_counter(reg, "manager_anomalies_total",
+                                    "Alerts raised by anomaly detection", NULL);
+    ok = ok && pm->readings >= 0 && pm->alerts >= 0 && pm->anomalies >= 0;
+
+    pm->rows = pm->bytes = pm->flush = -1;
+    if (logger != NULL)
+    {
+        pm->flush_ns = hist_create();
+        pm->rows  = metrics_counter(reg, "logger_rows_total",
+                                    "CSV rows written", NULL);
+        pm->bytes = metrics_counter(reg, "logger_bytes_total",
+                                    "CSV bytes written", NULL);
+        pm->flush = metrics_histogram_external(reg, "logger_flush_seconds",
+                                               "Time spent in fflush of the CSV log",
+                                               NULL, pm->flush_ns);
+        ok = ok && pm->flush_ns != NULL && pm->rows >= 0 && pm->bytes >= 0 &&
+             pm->flush >= 0;
+        logger_time_flushes(logger, pm->flush_ns);
+    }
+    return ok;
+}
+
+void pipeline_metrics_publish(pipeline_metrics_t *pm, const manager_t *m,
+                              const csv_logger_t *logger)
+{
+    if (pm == NULL || m == NULL)
+        return;
+
+    for (uint8_t id = 0; id < m->capacity; id++)
+    {
+        if (pm->fill[id] < 0 || !m->registered[id])
+            continue;
+
+        const sensor_t *s = &m->sensors[id];
+        size_t cap = s->buf ? s->buf->capacity : 0;
+        metrics_set(pm->reg, pm->fill[id],
+                    cap ? (double)buffer_count(s->buf) / (double)cap : 0.0);
+        metrics_set_total(pm->reg, pm->overflows[id], buffer_overflow_count(s->buf));
+        metrics_set_total(pm->reg, pm->samples[id], s->stats.sample_count);
+    }
+
+    metrics_set_total(pm->reg, pm->readings, m->total_logs);
+    metrics_set_total(pm->reg, pm->alerts, m->total_alerts);
+    metrics_set_total(pm->reg, pm->anomalies, m->total_anomalies);
+
+    if (logger != NULL)
+    {
+        metrics_set_total(pm->reg, pm->rows, logger->rows_written);
+        metrics_set_total(pm->reg, pm->bytes, logger->bytes_written);
+    }
+}
+
+void pipeline_metrics_free(pipeline_metrics_t *pm, csv_logger_t *logger)
+{
+    if (pm == NULL)
+        return;
+
+    if (logger != NULL && logger->flush_ns == pm->flush_ns)
+        logger_time_flushes(logger, NULL);
+    hist_destroy(pm->flush_ns);
+    pm->flush_ns = NULL;
+}
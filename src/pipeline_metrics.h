@@ -0,0 +1,72 @@
+/**
+ * @file pipeline_metrics.h
+ * @brief Standard metrics for one manager + logger pipeline
+ *
+ * Registers the series operators scrape and publishes them from the
+ * thread that owns the manager and the logger, so nothing in the
+ * ingestion path is shared with the scraper except relaxed atomics:
+ *
+ *   sensor_buffer_fill_ratio{id,sensor}      gauge, ring occupancy 0..1
+ *   sensor_buffer_overflows_total{id,sensor} readings refused, ring full
+ *   sensor_samples_total{id,sensor}          readings stored per sensor
+ *   manager_readings_total                   manager_log() calls accepted
+ *   manager_alerts_total                     threshold + anomaly alerts
+ *   manager_anomalies_total                  anomaly alerts alone
+ *   logger_rows_total / logger_bytes_total   CSV output
+ *   logger_flush_seconds                     histogram of every fflush
+ *
+ * Rates (alerts/s, bytes/s) come from rate() over the counters on the
+ * Prometheus side.
+ *
+ *   pipeline_metrics_t pm;
+ *   pipeline_metrics_init(&pm, reg, m, &logger);    after registration
+ *   ...
+ *   pipeline_metrics_publish(&pm, m, &logger);      e.g. every poll
+ *   ...
+ *   pipeline_metrics_free(&pm, &logger);
+ */
+
+#ifndef PIPELINE_METRICS_H
+#define PIPELINE_METRICS_H
+
+#include "metrics.h"
+#include "logger.h"
+
+typedef struct {
+    metrics_t *reg;
+    int fill[MANAGER_MAX_SENSORS];          ///< -1 = sensor not exported
+    int overflows[MANAGER_MAX_SENSORS];
+    int samples[MANAGER_MAX_SENSORS];
+    int readings, alerts, anomalies;
+    int rows, bytes, flush;                 ///< -1 without a logger
+    hist_t *flush_ns;                       ///< Owned, attached to the logger
+} pipeline_metrics_t;
+
+/**
+ * @brief Register the pipeline's metrics in `reg`.
+ *
+ * Exports every sensor registered in `m` at this point. With a logger,
+ * its flushes start being timed. `logger` may be NULL.
+ *
+ * @return false if the registry is full or out of memory
+ */
+bool pipeline_metrics_init(pipeline_metrics_t *pm, metrics_t *reg,
+                           const manager_t *m, csv_logger_t *logger);
+
+/**
+ * @brief Copy the manager's and logger's current counts into the registry.
+ *
+ * Call from the thread that logs into `m` (or with its lock held); it is
+ * a few dozen relaxed stores.
+ */
+void pipeline_metrics_publish(pipeline_metrics_t *pm, const manager_t *m,
+                              const csv_logger_t *logger);
+
+/**
+ * @brief Stop timing the logger's flushes and free the histogram.
+ *
+ * Only once nothing scrapes the registry any more.
+ */
+void pipeline_metrics_free(pipeline_metrics_t *pm, csv_logger_t *logger);
+
+#endif /* PIPELINE_METRICS_H */
@@ -0,0 +1,204 @@
+/**
+ * @file query.c
+ * @brief Dashboard query API implementation
+ *
+ * Query-side code, not the ingestion hot path: rows for the requested
+ * sensor are gathered into temporary heap arrays, reduced with LTTB, and
+ * the arrays freed before returning.
+ */
+
+#include "query.h"
+#include "lttb.h"
+#include "alert.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Longest CSV line we expect from the logger / Arduino */
+#define QUERY_LINE_MAX 256
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+/** Growable column store for the rows of one sensor */
+typedef struct {
+    uint32_t *ts;
+    float    *values;
+    uint8_t  *alerts;
+    size_t    count;
+    size_t    capacity;
+} series_t;
+
+static bool series_push(series_t *s, uint32_t ts, float value, uint8_t alert)
+{
+    if (s->count == s->capacity) {
+        size_t cap = s->capacity ? s->capacity * 2 : 1024;
+        uint32_t *nt = realloc(s->ts,     cap * sizeof(*nt));
+        if (nt == NULL) return false;
+        s->ts = nt;
+        float    *nv = realloc(s->values, cap * sizeof(*nv));
+        if (nv == NULL) return false;
+        s->values = nv;
+        uint8_t  *na = realloc(s->alerts, cap * sizeof(*na));
+        if (na == NULL) return false;
+        s->alerts   = na;
+        s->capacity = cap;
+    }
+
+    s->ts[s->count]     = ts;
+    s->values[s->count] = value;
+    s->alerts[s->count] = alert;
+    s->count++;
+    return true;
+}
+
+static void series_free(series_t *s)
+{
+    free(s->ts);
+    free(s->values);
+    free(s->alerts);
+    memset(s, 0, sizeof(*s));
+}
+
+static uint8_t alert_from_str(const char *str)
+{
+    if (strncmp(str, "CRITICAL", 8) == 0)
+        return ALERT_CRITICAL;
+    if (strncmp(str, "WARNING", 7) == 0)
+        return ALERT_WARNING;
+    return ALERT_NONE;
+}
+
+/**
+ * @brief Unsigned decimal field at p, no larger than max, ending in ','.
+ * @return true and sets *out and *next (just past the comma)
+ */
+static bool parse_field(char *p, unsigned long max, unsigned long *out,
+                        char **next)
+{
+    char *end;
+
+    if (*p < '0' || *p > '9')
+        return false;                   /* strtoul would take '-' or spaces */
+
+    unsigned long v = strtoul(p, &end, 10);
+    if (end == p || *end != ',' || v > max)
+        return false;
+
+    *out  = v;
+    *next = end + 1;
+    return true;
+}
+
+/**
+ * @brief Parse one data row. Header / comment / malformed rows -> false.
+ *
+ * Out-of-range timestamps and sensor IDs are rejected, not wrapped into
+ * another sensor's series.
+ */
+static bool parse_row(char *line, uint32_t *ts, uint8_t *id,
+                      float *value, uint8_t *alert)
+{
+    if (line[0] < '0' || line[0] > '9')
+        return false;                   /* header or '#' comment */
+
+    char *p = line;
+    char *end;
+    unsigned long v;
+
+    if (!parse_field(p, UINT32_MAX, &v, &p)) return false;
+    *ts = (uint32_t)v;
+
+    if (!parse_field(p, UINT8_MAX, &v, &p)) return false;
+    *id = (uint8_t)v;
+
+    p = strchr(p, ',');                 /* skip sensor_name */
+    if (p == NULL) return false;
+    p++;
+
+    *value = strtof(p, &end);
+    if (*end != ',') return false;
+
+    *alert = alert_from_str(end + 1);
+    return true;
+}
+
+/**
+ * @brief Collect matching rows; s == NULL just counts them.
+ */
+static uint32_t scan_csv(const char *csv_path, uint8_t sensor_id,
+                         uint32_t t0, uint32_t t1, series_t *s)
+{
+    FILE *f = fopen(csv_path, "r");
+    if (f == NULL)
+        return 0;
+
+    char     line[QUERY_LINE_MAX];
+    uint32_t matched = 0;
+
+    while (fgets(line, sizeof(line), f) != NULL) {
+        uint32_t ts;
+        uint8_t  id, alert;
+        float    value;
+
+        if (!parse_row(line, &ts, &id, &value, &alert))
+            continue;
+        if (id != sensor_id || ts < t0 || ts >= t1)
+            continue;
+        if (s != NULL && !series_push(s, ts, value, alert))
+            break;                      /* out of memory: use what we have */
+        matched++;
+    }
+
+    fclose(f);
+    return matched;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+uint32_t query_lttb(const char *csv_path, uint8_t sensor_id,
+                    uint32_t t0, uint32_t t1, uint32_t max_points,
+                    uint32_t *out_ts, float *out_values, uint8_t *out_alerts)
+{
+    if (csv_path == NULL || out_ts == NULL || out_values == NULL ||
+        max_points == 0)
+        return 0;
+
+    series_t s = {0};
+    scan_csv(csv_path, sensor_id, t0, t1, &s);
+    if (s.count == 0) {
+        series_free(&s);
+        return 0;
+    }
+
+    size_t *idx = malloc(max_points * sizeof(*idx));
+    if (idx == NULL) {
+        series_free(&s);
+        return 0;
+    }
+
+    size_t kept = lttb_select(s.ts, s.values, s.count, max_points, idx);
+    for (size_t i = 0; i < kept; i++) {
+        out_ts[i]     = s.ts[idx[i]];
+        out_values[i] = s.values[idx[i]];
+        if (out_alerts != NULL)
+            out_alerts[i] = s.alerts[idx[i]];
+    }
+
+    free(idx);
+    series_free(&s);
+    return (uint32_t)kept;
+}
+
+uint32_t query_count(const char *csv_path, uint8_t sensor_id,
+                     uint32_t t0, uint32_t t1)
+{
+    if (csv_path == NULL)
+        return 0;
+
+    return scan_csv(csv_path, sensor_id, t0, t1, NULL);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file query.h
+ * @brief Dashboard query API — plot-ready, downsampled sensor series
+ *
+ * Built into a shared library (make lib -> build/libsensorquery.so, or
+ * .dll on Windows) so the Python dashboard can ask for exactly as many
+ * points as it can draw instead of plotting every row:
+ *
+ *   lib = ctypes.CDLL("build/libsensorquery.so")
+ *   n = lib.query_lttb(b"data/sensor_log.csv", sensor_id, t0, t1, k,
+ *                      ts_array, value_array, alert_array)
+ *
+ * Every argument is a plain C scalar or a caller-allocated array, so no
+ * ctypes structures or callbacks are needed.
+ */
+
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Downsample one sensor's CSV history with LTTB.
+ *
+ * Reads rows in the logger's format
+ * (timestamp,sensor_id,sensor_name,value,alert_level), keeps those for
+ * `sensor_id` with t0 <= timestamp < t1, and reduces them to at most
+ * `max_points` representative points.
+ *
+ * @param csv_path    CSV file written by logger.c or the serial reader
+ * @param sensor_id   Sensor to extract
+ * @param t0          Range start (inclusive)
+ * @param t1          Range end (exclusive); UINT32_MAX = open-ended
+ * @param max_points  Resolution the caller can draw (size of out arrays)
+ * @param out_ts      Receives timestamps
+ * @param out_values  Receives values
+ * @param out_alerts  Receives alert levels (alert_level_t as uint8_t), may be NULL
+ * @return            Number of points written (0 if no data or on error)
+ */
+uint32_t query_lttb(const char *csv_path, uint8_t sensor_id,
+                    uint32_t t0, uint32_t t1, uint32_t max_points,
+                    uint32_t *out_ts, float *out_values, uint8_t *out_alerts);
+
+/**
+ * @brief Count one sensor's rows in a time range (no downsampling).
+ *
+ * Lets the dashboard report "showing K of N readings".
+ */
+uint32_t query_count(const char *csv_path, uint8_t sensor_id,
+                     uint32_t t0, uint32_t t1);
+
+#endif /* QUERY_H */
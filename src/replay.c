@@ -0,0 +1,316 @@
+/**
+ * @file replay.c
+ * @brief Log replay implementation
+ *
+ * Pacing sleeps until the first reading of a run is due and then takes
+ * every following reading that is already due, so at high multipliers
+ * runs grow and the per-reading clock cost stays small.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "replay.h"
+#include "clock.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static void sleep_ns(uint64_t ns)
+{
+#ifdef _WIN32
+    Sleep((DWORD)(ns / 1000000u));
+#else
+    struct timespec ts = {.tv_sec  = (time_t)(ns / 1000000000u),
+                          .tv_nsec = (long)(ns % 1000000000u)};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void stage_add(replay_stage_t *s, uint64_t ns)
+{
+    s->total_ns += ns;
+    if (ns > s->max_ns)
+        s->max_ns = ns;
+}
+
+/** Wall time at which recorded `ms` is due (re-anchors on a restart) */
+static uint64_t due_ns(replay_t *rp, uint32_t ms, uint64_t now)
+{
+    if (!rp->anchored || (uint64_t)ms + REPLAY_RESTART_MS < rp->last_ms)
+    {
+        rp->anchored  = true;
+        rp->anchor_ms = ms;
+        rp->anchor_ns = now;
+    }
+    rp->last_ms = ms;
+
+    if (ms <= rp->anchor_ms)
+        return rp->anchor_ns;
+    double offset = (double)(ms - rp->anchor_ms) * 1e6 / rp->speed;
+    return rp->anchor_ns + (uint64_t)offset;
+}
+
+/**
+ * Wait for run[i] to fall due, then return the end of the span of
+ * readings from i that are due by now.
+ */
+static size_t pace(replay_t *rp, size_t i, size_t n)
+{
+    uint64_t now = clock_ns();
+    uint64_t due = due_ns(rp, rp->run[i].timestamp, now);
+
+    if (due > now)
+    {
+        sleep_ns(due - now);
+        uint64_t woke = clock_ns();
+        rp->wait_ns += woke - now;
+        now = woke;
+    }
+    if (now > due && now - due > rp->max_late_ns)
+        rp->max_late_ns = now - due;
+
+    size_t j = i + 1;
+    while (j < n && due_ns(rp, rp->run[j].timestamp, now) <= now)
+        j++;
+    return j;
+}
+
+/** Manager stage, then logger stage, for run[i..j) */
+static void deliver(replay_t *rp, size_t i, size_t j)
+{
+    manager_t *m = rp->m;
+    uint64_t t0 = clock_ns();
+
+    for (size_t k = i; k < j; k++)
+    {
+        sensor_reading_t *r = &rp->run[k];
+        rp->accepted[k] = manager_log(m, r->sensor_id, r->value, r->timestamp);
+        if (!rp->accepted[k])
+            continue;
+
+        /* Alert on the conditioned value, as main.c does. The replay is
+         * the buffer's consumer: popping the stored reading keeps the
+         * ring from filling up and yields exactly what was buffered
+         * (conditioned, or raw for log_raw sensors) for the logger */
+        rp->alerts[k] = (uint8_t)manager_check_threshold(
+            m, r->sensor_id, m->sensors[r->sensor_id].last_value);
+        manager_read(m, r->sensor_id, r);
+    }
+
+    uint64_t t1 = clock_ns();
+    size_t logged = 0;
+
+    for (size_t k = i; k < j; k++)
+    {
+        if (!rp->accepted[k])
+            continue;
+        logged++;
+        if (rp->logger != NULL)
+        {
+            const sensor_reading_t *r = &rp->run[k];
+            logger_write(rp->logger, r, m->sensors[r->sensor_id].name,
+                         (alert_level_t)rp->alerts[k]);
+        }
+    }
+    /* Paced replays feed a live dashboard - make each span visible */
+    if (rp->logger != NULL && rp->speed > 0.0)
+        logger_flush(rp->logger);
+
+    uint64_t t2 = clock_ns();
+    stage_add(&rp->manage, t1 - t0);
+    stage_add(&rp->write, t2 - t1);
+    rp->runs++;
+    rp->readings += logged;
+    rp->rejected += (j - i) - logged;
+}
+
+/** Hand run[0..n) on, in due spans when paced */
+static void flush_run(replay_t *rp, size_t n)
+{
+    size_t i = 0;
+    while (i < n)
+    {
+        size_t j = rp->speed > 0.0 ? pace(rp, i, n) : n;
+        deliver(rp, i, j);
+        i = j;
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void replay_init(replay_t *rp, manager_t *m, csv_logger_t *logger)
+{
+    memset(rp, 0, sizeof(*rp));
+    rp->m      = m;
+    rp->logger = logger;
+    rp->speed  = 1.0;
+}
+
+bool replay_set_speed(replay_t *rp, double speed)
+{
+    if (!(speed >= 0.0))
+        return false;
+    rp->speed    = speed;
+    rp->anchored = false;
+    return true;
+}
+
+bool replay_csv(replay_t *rp, csv_bulk_t *r)
+{
+    csv_columns_t cols;
+    if (!csv_columns_init(&cols, REPLAY_BATCH))
+        return false;
+
+    uint64_t start = clock_ns();
+    for (;;)
+    {
+        uint64_t t0  = clock_ns();
+        size_t   pos = r->pos;
+        size_t   n   = csv_bulk_read(r, &cols);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            rp->run[i].timestamp = cols.timestamp[i];
+            rp->run[i].sensor_id = cols.sensor_id[i];
+            rp->run[i].value     = cols.value[i];
+        }
+        stage_add(&rp->parse, clock_ns() - t0);
+        rp->bytes += r->pos - pos;
+
+        if (n == 0)
+            break;
+        flush_run(rp, n);
+    }
+    if (rp->logger != NULL)
+        logger_flush(rp->logger);
+    rp->elapsed_ns += clock_ns() - start;
+
+    csv_columns_free(&cols);
+    return true;
+}
+
+void replay_frames(replay_t *rp, frame_decoder_t *dec,
+                   const uint8_t *data, size_t len)
+{
+    uint64_t start = clock_ns();
+
+    while (len > 0)
+    {
+        size_t   consumed;
+        uint64_t t0 = clock_ns();
+        size_t   n  = frame_decode(dec, data, len, rp->run, REPLAY_BATCH,
+                                   &consumed);
+        stage_add(&rp->parse, clock_ns() - t0);
+
+        data += consumed;
+        len  -= consumed;
+        rp->bytes += consumed;
+
+        if (n > 0)
+            flush_run(rp, n);
+        else if (consumed == 0)
+            break;
+    }
+    if (rp->logger != NULL)
+        logger_flush(rp->logger);
+    rp->elapsed_ns += clock_ns() - start;
+}
+
+bool replay_csv_file(replay_t *rp, const char *path)
+{
+    csv_bulk_t r;
+    if (!csv_bulk_open(&r, path))
+        return false;
+
+    bool ok = replay_csv(rp, &r);
+    csv_bulk_close(&r);
+    return ok;
+}
+
+bool replay_binary_file(replay_t *rp, frame_decoder_t *dec, const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        DIAG_ERROR("REPLAY", "Cannot open %s", path);
+        return false;
+    }
+
+    uint8_t *chunk = malloc(REPLAY_READ_SIZE);
+    if (chunk == NULL)
+    {
+        fclose(f);
+        return false;
+    }
+
+    for (;;)
+    {
+        uint64_t t0 = clock_ns();
+        size_t   n  = fread(chunk, 1, REPLAY_READ_SIZE, f);
+        uint64_t dt = clock_ns() - t0;
+
+        stage_add(&rp->parse, dt);
+        rp->elapsed_ns += dt;
+        if (n == 0)
+            break;
+        replay_frames(rp, dec, chunk, n);
+    }
+
+    free(chunk);
+    fclose(f);
+    return true;
+}
+
+void replay_print_stats(const replay_t *rp)
+{
+    double secs = (double)rp->elapsed_ns / 1e9;
+    double busy = (double)(rp->parse.total_ns + rp->manage.total_ns +
+                           rp->write.total_ns);
+    uint64_t total = rp->readings + rp->rejected;
+
+    printf("\n--- Replay ---\n");
+    printf("  %" PRIu64 " readings logged, %" PRIu64 " rejected, %.2f MB in %.3f s",
+           rp->readings, rp->rejected,
+           (double)rp->bytes / 1e6, secs);
+    if (rp->speed > 0.0)
+        printf(" (speed %gx)\n", rp->speed);
+    else
+        printf(" (as fast as possible)\n");
+
+    if (secs > 0.0)
+        printf("  Throughput: %.0f readings/s, %.1f MB/s\n",
+               (double)total / secs, (double)rp->bytes / 1e6 / secs);
+    if (rp->speed > 0.0)
+        printf("  Paced: %.3f s asleep, worst lag %.3f ms\n",
+               (double)rp->wait_ns / 1e9, (double)rp->max_late_ns / 1e6);
+
+    printf("  %-8s %12s %16s %8s\n", "Stage", "ns/reading", "worst run (us)", "share");
+    const struct {
+        const char *name;
+        const replay_stage_t *s;
+    } rows[] = {
+        {"parse",   &rp->parse},
+        {"manager", &rp->manage},
+        {"logger",  &rp->write},
+    };
+    for (size_t i = 0; i < sizeof(rows) / sizeof(rows[0]); i++)
+    {
+        const replay_stage_t *s = rows[i].s;
+        printf("  %-8s %12.1f %16.1f %7.1f%%\n", rows[i].name,
+               total ? (double)s->total_ns / (double)total : 0.0,
+               (double)s->max_ns / 1e3,
+               busy > 0.0 ? 100.0 * (double)s->total_ns / busy : 0.0);
+    }
+}
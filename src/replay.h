@@ -0,0 +1,162 @@
+/**
+ * @file replay.h
+ * @brief Replay recorded logs through the manager and the CSV logger
+ *
+ * Streams a recorded log back through the same path live readings take -
+ * manager_log() (filters, thresholds, anomaly detection) and then
+ * logger_write() - so an incident can be reproduced offline and the
+ * whole pipeline benchmarked on real data.
+ *
+ * Two inputs are understood:
+ *
+ *   - CSV in the logger's schema (data/serial_log.csv, sensor_log.csv),
+ *     read in column batches with csv_bulk.h
+ *   - a raw capture of the binary serial protocol (frame.h), decoded
+ *     with a caller-configured frame_decoder_t so per-sensor scales apply
+ *
+ * Pacing follows the recorded timestamps:
+ *
+ *   speed 1.0   original timing
+ *   speed 10.0  ten times faster (any positive multiplier)
+ *   speed 0     as fast as possible (REPLAY_FAST)
+ *
+ * When a timestamp goes back by more than REPLAY_RESTART_MS (the board
+ * restarted and the log was appended to) the clock is re-anchored at
+ * that reading. Smaller steps back - frames of different sensors
+ * interleave - are delivered straight away.
+ *
+ * Readings are handed on in runs of up to REPLAY_BATCH: the run is
+ * parsed, then logged by the manager, then written by the logger, and
+ * each of the three stages is timed separately. The replay consumes
+ * each reading from its sensor's ring buffer once logged, so logs far
+ * longer than the ring replay in full:
+ *
+ *   replay_t rp;
+ *   replay_init(&rp, m, &logger);
+ *   replay_set_speed(&rp, 10.0);
+ *   replay_csv_file(&rp, "data/serial_log.csv");
+ *   replay_print_stats(&rp);
+ */
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "sensor_manager.h"
+#include "logger.h"
+#include "csv_bulk.h"
+#include "frame.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Readings per run (parse -> manager -> logger) */
+#define REPLAY_BATCH        1024
+
+/** @brief Bytes read per fread() when replaying a binary capture */
+#define REPLAY_READ_SIZE    65536
+
+/** @brief Step back in time treated as a board restart */
+#define REPLAY_RESTART_MS   1000u
+
+/** @brief Speed value for "as fast as possible" */
+#define REPLAY_FAST         0.0
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Time spent in one stage of the pipeline
+ */
+typedef struct {
+    uint64_t total_ns;              ///< Sum over all runs
+    uint64_t max_ns;                ///< Slowest single run
+} replay_stage_t;
+
+/**
+ * @brief Replay engine (caller-allocated, see replay_init)
+ */
+typedef struct {
+    manager_t    *m;                ///< Destination manager
+    csv_logger_t *logger;           ///< Output log (NULL = manager only)
+    double        speed;            ///< Multiplier, REPLAY_FAST = unpaced
+
+    /* Pacing anchor: recorded ms `anchor_ms` is due at wall `anchor_ns` */
+    bool          anchored;
+    uint32_t      anchor_ms;
+    uint64_t      anchor_ns;
+    uint32_t      last_ms;          ///< Timestamp of the previous reading
+
+    /* One run in flight */
+    sensor_reading_t run[REPLAY_BATCH];
+    uint8_t          alerts[REPLAY_BATCH];     ///< alert_level_t per reading
+    bool             accepted[REPLAY_BATCH];
+
+    /* Results */
+    uint64_t      readings;         ///< Logged by the manager
+    uint64_t      rejected;         ///< Unknown sensor or refused by manager
+    uint64_t      bytes;            ///< Input bytes consumed
+    uint64_t      runs;             ///< Runs handed to the manager
+    uint64_t      elapsed_ns;       ///< Wall time of the replay calls
+    uint64_t      wait_ns;          ///< Time slept to honour pacing
+    uint64_t      max_late_ns;      ///< Worst lag behind a reading's due time
+    replay_stage_t parse;           ///< Reading / decoding the input
+    replay_stage_t manage;          ///< manager_log(), threshold, buffer read
+    replay_stage_t write;           ///< logger_write()
+} replay_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Initialise a replay into manager `m` (and `logger`, may be NULL).
+ */
+void replay_init(replay_t *rp, manager_t *m, csv_logger_t *logger);
+
+/**
+ * @brief Set the pacing multiplier.
+ * @return false (speed unchanged) if speed is negative
+ */
+bool replay_set_speed(replay_t *rp, double speed);
+
+/**
+ * @brief Replay every row of an open bulk reader.
+ *
+ * Works on files (csv_bulk_open) and memory (csv_bulk_open_mem) alike.
+ *
+ * @return false if the column batch could not be allocated
+ */
+bool replay_csv(replay_t *rp, csv_bulk_t *r);
+
+/**
+ * @brief Replay a chunk of a binary capture.
+ *
+ * Can be called repeatedly with consecutive chunks; a frame split across
+ * chunks is completed from `dec` on the next call.
+ */
+void replay_frames(replay_t *rp, frame_decoder_t *dec,
+                   const uint8_t *data, size_t len);
+
+/**
+ * @brief Map a CSV log and replay it.
+ * @return false if the file cannot be opened
+ */
+bool replay_csv_file(replay_t *rp, const char *path);
+
+/**
+ * @brief Read a binary capture and replay it through `dec`.
+ * @return false if the file cannot be opened
+ */
+bool replay_binary_file(replay_t *rp, frame_decoder_t *dec, const char *path);
+
+/**
+ * @brief Print throughput, pacing and per-stage latency.
+ */
+void replay_print_stats(const replay_t *rp);
+
+#endif /* REPLAY_H */
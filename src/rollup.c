@@ -0,0 +1,328 @@
+/**
+ * @file rollup.c
+ * @brief Multi-tier downsampling implementation
+ *
+ * A raw reading and a closed lower-tier bucket are the same thing to a
+ * tier: a partial summary (count, min, max, sum, last) with a timestamp.
+ * So a single merge routine serves both the feed path and the cascade.
+ *
+ * Buckets close lazily — when a newer timestamp for the same sensor lands
+ * in a later bucket. A reading older than the open bucket (clock glitch,
+ * reordered input) is folded into the open bucket rather than reopening a
+ * bucket that is already on disk.
+ */
+
+#include "rollup.h"
+#include "diag.h"
+#include <stdio.h>
+#include <string.h>
+
+/** `<path>.idx` */
+static void index_path(char *out, const char *path)
+{
+    snprintf(out, ROLLUP_PATH_MAX + 4, "%s.idx", path);
+}
+
+/** Records in an open file, from its size */
+static uint64_t file_entries(FILE *f, size_t size)
+{
+    if (fseek(f, 0, SEEK_END) != 0)
+        return 0;
+    long bytes = ftell(f);
+    return bytes > 0 ? (uint64_t)bytes / size : 0;
+}
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static void tier_merge(rollup_t *r, uint8_t level, uint8_t id,
+                       uint32_t timestamp, const rollup_bucket_t *src);
+
+/**
+ * @brief Account for one more record in the file; a full block gets its
+ * index entry.
+ */
+static void index_note(rollup_tier_t *t, uint32_t bucket_start)
+{
+    if (t->records % ROLLUP_INDEX_STRIDE == 0)
+        t->block = (rollup_index_t){bucket_start, bucket_start};
+    else if (bucket_start < t->block.min_start)
+        t->block.min_start = bucket_start;
+    else if (bucket_start > t->block.max_start)
+        t->block.max_start = bucket_start;
+
+    t->records++;
+    if (t->records % ROLLUP_INDEX_STRIDE == 0 && t->index != NULL)
+        fwrite(&t->block, sizeof(t->block), 1, (FILE *)t->index);
+}
+
+/**
+ * @brief Open `<path>.idx` and index what it is missing.
+ *
+ * Entries beyond the data (a crash between the two files) or a torn
+ * entry mean the index cannot be trusted: it is rebuilt from scratch.
+ * Either way the records after the last entry are read once, to seed
+ * the block still being filled.
+ */
+static void index_open(rollup_tier_t *t)
+{
+    char  ipath[ROLLUP_PATH_MAX + 4];
+    FILE *data = fopen(t->path, "rb");
+    if (data == NULL)
+        return;
+    uint64_t n = file_entries(data, sizeof(rollup_record_t));
+
+    index_path(ipath, t->path);
+    FILE *idx = fopen(ipath, "ab");
+    if (idx == NULL) {
+        DIAG_WARN("ROLLUP", "No index for '%s' - queries will scan it", t->path);
+        fclose(data);
+        return;
+    }
+    uint64_t entries = file_entries(idx, sizeof(rollup_index_t));
+    if (entries > n / ROLLUP_INDEX_STRIDE ||
+        (uint64_t)ftell(idx) != entries * sizeof(rollup_index_t)) {
+        fclose(idx);
+        idx = fopen(ipath, "wb");
+        entries = 0;
+    }
+    t->index   = (void *)idx;
+    t->records = entries * ROLLUP_INDEX_STRIDE;
+
+    rollup_record_t chunk[ROLLUP_INDEX_STRIDE];
+    size_t k;
+    fseek(data, (long)(t->records * sizeof(rollup_record_t)), SEEK_SET);
+    while (t->records < n &&
+           (k = fread(chunk, sizeof(chunk[0]), ROLLUP_INDEX_STRIDE, data)) > 0)
+        for (size_t i = 0; i < k && t->records < n; i++)
+            index_note(t, chunk[i].bucket_start);
+
+    fflush(idx);
+    if (entries < t->records / ROLLUP_INDEX_STRIDE)
+        DIAG_INFO("ROLLUP", "Indexed %llu blocks of '%s'",
+                  (unsigned long long)(t->records / ROLLUP_INDEX_STRIDE - entries),
+                  t->path);
+    fclose(data);
+}
+
+/** Copy the records of `id` in [t0, t1) */
+static void take(const rollup_record_t *chunk, size_t n, uint8_t id,
+                 uint32_t t0, uint32_t t1, rollup_record_t *out,
+                 size_t *found, size_t max)
+{
+    for (size_t i = 0; i < n && *found < max; i++) {
+        if (chunk[i].sensor_id == id &&
+            chunk[i].bucket_start >= t0 &&
+            chunk[i].bucket_start <  t1)
+            out[(*found)++] = chunk[i];
+    }
+}
+
+/**
+ * @brief Write out a tier's open bucket and cascade it one tier up.
+ */
+static void bucket_close(rollup_t *r, uint8_t level, uint8_t id)
+{
+    rollup_tier_t   *t = &r->tiers[level];
+    rollup_bucket_t *b = &t->open[id];
+
+    if (b->count == 0)
+        return;
+
+    /* memset first so struct padding on disk is deterministic */
+    rollup_record_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.bucket_start = b->bucket_start;
+    rec.count        = b->count;
+    rec.min          = b->min;
+    rec.max          = b->max;
+    rec.mean         = (float)(b->sum / (double)b->count);
+    rec.last         = b->last;
+    rec.sensor_id    = id;
+
+    if (t->file != NULL && fwrite(&rec, sizeof(rec), 1, (FILE *)t->file) == 1) {
+        t->records_written++;
+        index_note(t, rec.bucket_start);
+    }
+
+    if (level + 1 < r->count)
+        tier_merge(r, (uint8_t)(level + 1), id, b->bucket_start, b);
+
+    b->count = 0;
+}
+
+/**
+ * @brief Fold a partial summary into a tier's open bucket for `id`.
+ */
+static void tier_merge(rollup_t *r, uint8_t level, uint8_t id,
+                       uint32_t timestamp, const rollup_bucket_t *src)
+{
+    rollup_tier_t   *t     = &r->tiers[level];
+    rollup_bucket_t *b     = &t->open[id];
+    uint32_t         start = timestamp - (timestamp % t->width);
+
+    if (b->count > 0 && start > b->bucket_start)
+        bucket_close(r, level, id);
+
+    if (b->count == 0) {
+        *b = *src;
+        b->bucket_start = start;
+        return;
+    }
+
+    if (src->min < b->min) b->min = src->min;
+    if (src->max > b->max) b->max = src->max;
+    b->sum   += src->sum;
+    b->count += src->count;
+    b->last   = src->last;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void rollup_init(rollup_t *r)
+{
+    if (r == NULL)
+        return;
+
+    memset(r, 0, sizeof(*r));
+}
+
+bool rollup_add_tier(rollup_t *r, uint32_t width, const char *path)
+{
+    if (r == NULL || path == NULL || width == 0)
+        return false;
+    if (r->count >= ROLLUP_MAX_TIERS)
+        return false;
+
+    if (r->count > 0) {
+        uint32_t prev = r->tiers[r->count - 1].width;
+        if (width <= prev || width % prev != 0)
+            return false;           /* buckets must nest exactly */
+    }
+
+    FILE *f = fopen(path, "ab");
+    if (f == NULL) {
+        DIAG_ERROR("ROLLUP", "Could not open file '%s'", path);
+        return false;
+    }
+
+    rollup_tier_t *t = &r->tiers[r->count];
+    memset(t, 0, sizeof(*t));
+    t->width = width;
+    t->file  = (void *)f;
+    strncpy(t->path, path, ROLLUP_PATH_MAX - 1);
+    t->path[ROLLUP_PATH_MAX - 1] = '\0';
+    index_open(t);
+
+    r->count++;
+    return true;
+}
+
+void rollup_feed(rollup_t *r, uint8_t sensor_id, float value,
+                 uint32_t timestamp)
+{
+    if (r == NULL || r->count == 0 || sensor_id >= MAX_SENSORS)
+        return;
+
+    rollup_bucket_t sample = {
+        .count = 1,
+        .min   = value,
+        .max   = value,
+        .last  = value,
+        .sum   = value
+    };
+    tier_merge(r, 0, sensor_id, timestamp, &sample);
+}
+
+void rollup_sync(rollup_t *r)
+{
+    if (r == NULL)
+        return;
+
+    for (uint8_t i = 0; i < r->count; i++) {
+        if (r->tiers[i].file != NULL)
+            fflush((FILE *)r->tiers[i].file);
+        if (r->tiers[i].index != NULL)
+            fflush((FILE *)r->tiers[i].index);
+    }
+}
+
+void rollup_close(rollup_t *r)
+{
+    if (r == NULL)
+        return;
+
+    /* Finest tier first so each close cascades into a still-open tier */
+    for (uint8_t level = 0; level < r->count; level++)
+        for (uint8_t id = 0; id < MAX_SENSORS; id++)
+            bucket_close(r, level, id);
+
+    for (uint8_t level = 0; level < r->count; level++) {
+        rollup_tier_t *t = &r->tiers[level];
+        if (t->file != NULL) {
+            fclose((FILE *)t->file);
+            t->file = NULL;
+        }
+        if (t->index != NULL) {
+            fclose((FILE *)t->index);
+            t->index = NULL;
+        }
+    }
+}
+
+size_t rollup_query(const char *path, uint8_t id, uint32_t t0, uint32_t t1,
+                    rollup_record_t *out, size_t max)
+{
+    if (path == NULL || out == NULL || max == 0)
+        return 0;
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return 0;
+    uint64_t n = file_entries(f, sizeof(rollup_record_t));
+
+    /* An index longer than the data is stale: ignore it */
+    char ipath[ROLLUP_PATH_MAX + 4];
+    index_path(ipath, path);
+    FILE    *idx     = fopen(ipath, "rb");
+    uint64_t entries = idx != NULL ? file_entries(idx, sizeof(rollup_index_t)) : 0;
+    if (entries > n / ROLLUP_INDEX_STRIDE)
+        entries = 0;
+    if (idx != NULL)
+        fseek(idx, 0, SEEK_SET);
+
+    rollup_record_t chunk[ROLLUP_INDEX_STRIDE];
+    size_t   found = 0;
+    uint64_t block = 0;
+    size_t   k;
+
+    /* Indexed blocks: read only those whose range meets [t0, t1) */
+    for (; block < entries && found < max; block++) {
+        rollup_index_t e;
+        if (fread(&e, sizeof(e), 1, idx) != 1)
+            break;
+        if (e.max_start < t0 || e.min_start >= t1)
+            continue;
+        fseek(f, (long)(block * ROLLUP_INDEX_STRIDE * sizeof(rollup_record_t)),
+              SEEK_SET);
+        k = fread(chunk, sizeof(chunk[0]), ROLLUP_INDEX_STRIDE, f);
+        take(chunk, k, id, t0, t1, out, &found, max);
+    }
+
+    /* The tail the index does not cover yet */
+    if (found < max) {
+        fseek(f, (long)(block * ROLLUP_INDEX_STRIDE * sizeof(rollup_record_t)),
+              SEEK_SET);
+        while (found < max &&
+               (k = fread(chunk, sizeof(chunk[0]), ROLLUP_INDEX_STRIDE, f)) > 0)
+            take(chunk, k, id, t0, t1, out, &found, max);
+    }
+
+    if (idx != NULL)
+        fclose(idx);
+    fclose(f);
+    return found;
+}
@@ -0,0 +1,187 @@
+/**
+ * @file rollup.h
+ * @brief Multi-tier downsampling (rollups) for long-horizon storage
+ *
+ * Full-rate data is kept only for a short window. For the long term each
+ * sensor is summarised into fixed-width time buckets, one tier per
+ * resolution, e.g.:
+ *
+ *   tier 0:  1 s buckets   -> data/rollup_1s.bin
+ *   tier 1:  1 min buckets -> data/rollup_1m.bin
+ *   tier 2:  1 h buckets   -> data/rollup_1h.bin
+ *
+ * Tiers cascade: when a tier-0 bucket closes, its summary is folded into
+ * the open tier-1 bucket, and so on. Raw data is never re-read, and every
+ * reading costs O(1) (plus one record write each time a bucket closes).
+ *
+ * Each tier is a flat file of fixed-size rollup_record_t entries, so a
+ * query over months of hourly data reads kilobytes, not gigabytes.
+ *
+ * Next to each tier file sits a sparse index, `<path>.idx`: for every
+ * ROLLUP_INDEX_STRIDE records, the smallest and largest bucket_start in
+ * them. Records are appended roughly in time order but not strictly -
+ * each sensor closes its own buckets, and a quiet sensor closes late -
+ * so the index keeps a range per block rather than assuming sorted data.
+ * rollup_query() reads the index and only the blocks whose range meets
+ * the query, plus the unindexed tail. A missing or stale index is
+ * rebuilt when the tier is next opened.
+ *
+ * Timestamps are uint32 in whatever unit the caller feeds. In
+ * milliseconds (the board's millis()) they wrap after about 49.7 days,
+ * after which new buckets start again near 0 and share a range with the
+ * oldest ones. For more than a month and a half of history per file,
+ * feed seconds (about 136 years) or start a new file per wrap.
+ *
+ * Typical usage:
+ *
+ *   rollup_t r;
+ *   rollup_init(&r);
+ *   rollup_add_tier(&r, 1000,    "data/rollup_1s.bin");
+ *   rollup_add_tier(&r, 60000,   "data/rollup_1m.bin");
+ *   rollup_add_tier(&r, 3600000, "data/rollup_1h.bin");
+ *   manager_attach_rollup(m, &r);
+ *   ...
+ *   rollup_close(&r);
+ */
+
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+#include "buffer.h"     /* MAX_SENSORS */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum number of cascaded tiers */
+#define ROLLUP_MAX_TIERS  4
+
+/** @brief Maximum tier file path length */
+#define ROLLUP_PATH_MAX   256
+
+/** @brief Records per sparse index entry */
+#define ROLLUP_INDEX_STRIDE 256
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief One closed bucket, exactly as stored on disk
+ */
+typedef struct {
+    uint32_t bucket_start;  ///< First timestamp covered by the bucket
+    uint32_t count;         ///< Number of raw readings summarised
+    float    min;           ///< Smallest reading in the bucket
+    float    max;           ///< Largest reading in the bucket
+    float    mean;          ///< Mean of all readings in the bucket
+    float    last;          ///< Most recent reading in the bucket
+    uint8_t  sensor_id;     ///< Sensor the bucket belongs to
+} rollup_record_t;
+
+/**
+ * @brief One sparse index entry: the bucket_start range of a block
+ */
+typedef struct {
+    uint32_t min_start;
+    uint32_t max_start;
+} rollup_index_t;
+
+/**
+ * @brief An open (still accumulating) bucket
+ */
+typedef struct {
+    uint32_t bucket_start;
+    uint32_t count;         ///< 0 = bucket not open
+    float    min;
+    float    max;
+    float    last;
+    double   sum;           ///< double so hour-long sums stay exact enough
+} rollup_bucket_t;
+
+/**
+ * @brief One resolution level
+ */
+typedef struct {
+    uint32_t        width;                  ///< Bucket width in timestamp units
+    char            path[ROLLUP_PATH_MAX];  ///< Output file
+    void           *file;                   ///< FILE* (void* keeps stdio out)
+    void           *index;                  ///< FILE* of `<path>.idx`, may be NULL
+    uint32_t        records_written;        ///< Buckets closed this session
+    uint64_t        records;                ///< Records in the file, all sessions
+    rollup_index_t  block;                  ///< Range of the block being filled
+    rollup_bucket_t open[MAX_SENSORS];      ///< One open bucket per sensor
+} rollup_tier_t;
+
+/**
+ * @brief The whole cascade — caller-allocated, no heap use
+ */
+typedef struct {
+    rollup_tier_t tiers[ROLLUP_MAX_TIERS];
+    uint8_t       count;                    ///< Tiers configured
+} rollup_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Initialise an empty cascade.
+ */
+void rollup_init(rollup_t *r);
+
+/**
+ * @brief Add the next (coarser) tier and open its file for appending.
+ *
+ * Brings the tier's sparse index up to date with records already in
+ * the file (a full rebuild if it is missing).
+ *
+ * Widths must grow and each must be a whole multiple of the previous
+ * tier's width so buckets nest exactly.
+ *
+ * @param r      Cascade
+ * @param width  Bucket width in timestamp units (e.g. ms)
+ * @param path   File that receives this tier's closed buckets
+ * @return true on success
+ */
+bool rollup_add_tier(rollup_t *r, uint32_t width, const char *path);
+
+/**
+ * @brief Fold one reading into the finest tier (O(1)).
+ *
+ * Closes and cascades any bucket the timestamp has moved past.
+ */
+void rollup_feed(rollup_t *r, uint8_t sensor_id, float value,
+                 uint32_t timestamp);
+
+/**
+ * @brief Push buffered records to disk without closing buckets.
+ */
+void rollup_sync(rollup_t *r);
+
+/**
+ * @brief Close every open bucket (writing and cascading it) and the files.
+ */
+void rollup_close(rollup_t *r);
+
+/**
+ * @brief Read one sensor's buckets that start within [t0, t1).
+ *
+ * Uses the sparse index to skip blocks outside the range; without an
+ * index the whole file is scanned. Records come back in file order.
+ *
+ * @param path  Tier file written by rollup_add_tier()
+ * @param id    Sensor ID
+ * @param t0    Range start (inclusive)
+ * @param t1    Range end   (exclusive)
+ * @param out   Destination array
+ * @param max   Capacity of out
+ * @return      Number of records copied to out
+ */
+size_t rollup_query(const char *path, uint8_t id, uint32_t t0, uint32_t t1,
+                    rollup_record_t *out, size_t max);
+
+#endif /* ROLLUP_H */
@@ -0,0 +1,224 @@
+/**
+ * @file sampler.c
+ * @brief Per-sensor acquisition scheduler on a timer wheel
+ *
+ * Each source's timer is the first member of its sampler_source_t, so
+ * the wheel's expiry callback gets the source back with a cast. The
+ * callback reads the source, queues the reading and re-arms the timer
+ * at its previous deadline plus one period.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "sampler.h"
+#include "clock.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static void sleep_ms(uint64_t ms)
+{
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts = {(time_t)(ms / 1000u), (long)(ms % 1000u) * 1000000L};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void flush_batch(sampler_t *s)
+{
+    if (s->pending == 0)
+        return;
+    if (s->sink != NULL)
+        s->sink(s->sink_ctx, s->batch, s->pending);
+    s->samples += s->pending;
+    s->pending = 0;
+}
+
+/** Wheel callback: one source is due */
+static void on_due(void *ctx, tw_timer_t *t)
+{
+    sampler_t        *s   = ctx;
+    sampler_source_t *src = (sampler_source_t *)t;
+    uint64_t          due = t->deadline;
+
+    if (s->now_ms - due > s->max_late_ms)
+        s->max_late_ms = s->now_ms - due;
+
+    float value;
+    if (src->read(src->ctx, src->id, due, &value))
+    {
+        src->samples++;
+        s->batch[s->pending++] = (sensor_reading_t){
+            .timestamp = (uint32_t)due, .sensor_id = src->id, .value = value};
+        if (s->pending == SAMPLER_BATCH)
+            flush_batch(s);
+    }
+    else
+    {
+        src->failed++;
+    }
+
+    /* Next deadline from this one, not from now: no drift. One that is
+     * due exactly now still fires in this advance; if we are more than
+     * a whole period behind, skip to the first one not yet passed. */
+    uint64_t next = due + src->period_ms;
+    if (next < s->now_ms)
+    {
+        uint64_t behind = (s->now_ms - next + src->period_ms - 1) / src->period_ms;
+        src->missed += behind;
+        next += behind * src->period_ms;
+    }
+    tw_schedule(&s->wheel, t, next);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+sampler_t *sampler_create(size_t max_sources, uint64_t start_ms)
+{
+    if (max_sources == 0)
+    {
+        DIAG_ERROR("SAMPLER", "max_sources must be at least 1");
+        return NULL;
+    }
+
+    sampler_t *s = calloc(1, sizeof(*s));
+    if (s == NULL)
+        return NULL;
+
+    s->sources = calloc(max_sources, sizeof(*s->sources));
+    if (s->sources == NULL)
+    {
+        free(s);
+        return NULL;
+    }
+
+    tw_init(&s->wheel, start_ms);
+    s->start_ms = start_ms;
+    s->now_ms   = start_ms;
+    s->capacity = max_sources;
+
+    DIAG_DEBUG("SAMPLER", "Created sampler for %zu sources", max_sources);
+    return s;
+}
+
+void sampler_destroy(sampler_t *s)
+{
+    if (s == NULL)
+        return;
+    free(s->sources);
+    free(s);
+}
+
+void sampler_set_sink(sampler_t *s, sampler_sink_t sink, void *ctx)
+{
+    s->sink     = sink;
+    s->sink_ctx = ctx;
+}
+
+void sampler_manager_sink(void *ctx, const sensor_reading_t *batch, size_t n)
+{
+    manager_log_batch(ctx, batch, n);
+}
+
+sampler_source_t *sampler_add(sampler_t *s, uint8_t id, uint32_t period_ms,
+                              uint32_t phase_ms, sampler_read_fn read,
+                              void *ctx)
+{
+    if (s == NULL || read == NULL || period_ms == 0)
+        return NULL;
+    if (s->count >= s->capacity)
+    {
+        DIAG_ERROR("SAMPLER", "Sampler full (%zu sources)", s->capacity);
+        return NULL;
+    }
+
+    sampler_source_t *src = &s->sources[s->count++];
+    src->read      = read;
+    src->ctx       = ctx;
+    src->period_ms = period_ms;
+    src->id        = id;
+
+    /* First start + phase + k * period that is not already past */
+    uint64_t first = s->start_ms + phase_ms;
+    if (first < s->wheel.now)
+        first += (s->wheel.now - first + period_ms - 1) / period_ms * period_ms;
+    tw_schedule(&s->wheel, &src->timer, first);
+
+    DIAG_DEBUG("SAMPLER", "Source id=%u every %u ms, phase %u ms",
+               id, period_ms, phase_ms);
+    return src;
+}
+
+void sampler_remove(sampler_t *s, sampler_source_t *src)
+{
+    if (s != NULL && src != NULL)
+        tw_cancel(&s->wheel, &src->timer);
+}
+
+size_t sampler_advance(sampler_t *s, uint64_t now_ms)
+{
+    if (now_ms < s->now_ms)
+        return 0;
+
+    s->now_ms = now_ms;
+    size_t fired = tw_advance(&s->wheel, now_ms, on_due, s);
+    flush_batch(s);
+    if (fired > 0)
+        s->wakeups++;
+    return fired;
+}
+
+uint64_t sampler_next_due(const sampler_t *s)
+{
+    return tw_next_expiry(&s->wheel);
+}
+
+void sampler_run(sampler_t *s, uint64_t duration_ms,
+                 const volatile sig_atomic_t *stop)
+{
+    uint64_t base = s->now_ms;
+    uint64_t end  = base + duration_ms;
+    uint64_t t0   = clock_ns();
+
+    while (stop == NULL || !*stop)
+    {
+        uint64_t now = base + (clock_ns() - t0) / 1000000u;
+        sampler_advance(s, now);
+        if (now >= end)
+            break;
+
+        uint64_t next = sampler_next_due(s);
+        if (next > end)
+            next = end;
+        if (next > now)
+            sleep_ms(next - now < SAMPLER_MAX_SLEEP_MS ? next - now
+                                                       : SAMPLER_MAX_SLEEP_MS);
+    }
+}
+
+void sampler_print_stats(const sampler_t *s)
+{
+    printf("\n--- Sampler ---\n");
+    for (size_t i = 0; i < s->count; i++)
+    {
+        const sampler_source_t *src = &s->sources[i];
+        printf("  id=%-3u every %6u ms : %8" PRIu64 " samples, %" PRIu64
+               " failed, %" PRIu64 " missed\n", src->id, src->period_ms,
+               src->samples, src->failed, src->missed);
+    }
+    printf("  Wakeups            : %" PRIu64 "\n", s->wakeups);
+    printf("  Readings delivered : %" PRIu64 "\n", s->samples);
+    printf("  Worst lateness     : %" PRIu64 " ms\n", s->max_late_ms);
+    printf("---------------\n");
+}
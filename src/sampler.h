@@ -0,0 +1,186 @@
+/**
+ * @file sampler.h
+ * @brief Per-sensor acquisition scheduler on a timer wheel
+ *
+ * The sketch samples everything on one delay(READ_INTERVAL_MS) cadence
+ * and the simulation logs in lockstep. Real sensors want their own
+ * rates - a DHT11 no faster than every 2 s, vibration at 100 Hz - and
+ * their own phase, so slow reads do not all land on the same tick.
+ *
+ * A sampler drives any number of polled or simulated sources from one
+ * thread, with no timer per sensor:
+ *
+ *   - each source has a period and a phase (ms); it is due at
+ *     start + phase + k * period for k = 0, 1, 2, ...
+ *   - deadlines are absolute and the next one is computed from the last
+ *     deadline, not from when the read happened, so lateness never
+ *     accumulates into drift
+ *   - a source that falls more than a whole period behind skips the
+ *     missed deadlines (counted) rather than bursting to catch up
+ *   - all sources due at a wakeup are read in that one wakeup and their
+ *     readings reach the sink in batches of up to SAMPLER_BATCH
+ *
+ * Due sources are found with a hierarchical timer wheel (timer_wheel.h):
+ * adding a source and re-arming it after each read are O(1) however
+ * many there are, and the driving thread sleeps straight to the next
+ * deadline.
+ *
+ *   sampler_t *s = sampler_create(8, 0);
+ *   sampler_set_sink(s, sampler_manager_sink, m);       // manager_log_batch()
+ *   sampler_add(s, 0, 2000,   0, read_dht_temp, dev);   // 0.5 Hz
+ *   sampler_add(s, 2, 10,     5, read_mpu, dev);        // 100 Hz, 5 ms in
+ *   sampler_run(s, 60000, &stop);                       // one minute, real time
+ *
+ * sampler_advance() does the same work for a caller-supplied clock, for
+ * simulations and tests. Not thread-safe: one thread owns a sampler.
+ */
+
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "timer_wheel.h"
+#include "sensor_manager.h"
+#include <signal.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Readings handed to the sink at once */
+#define SAMPLER_BATCH       256
+
+/** @brief Longest sleep in sampler_run(), so a stop request is seen */
+#define SAMPLER_MAX_SLEEP_MS 100
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Read one source.
+ * @param ctx     As given to sampler_add()
+ * @param id      The source's sensor ID
+ * @param due_ms  The deadline this read is for
+ * @param value   Where to put the reading
+ * @return false if the source had nothing (e.g. a failed DHT11 read)
+ */
+typedef bool (*sampler_read_fn)(void *ctx, uint8_t id, uint64_t due_ms,
+                                float *value);
+
+/**
+ * @brief Receive a batch of readings, stamped with their deadlines
+ */
+typedef void (*sampler_sink_t)(void *ctx, const sensor_reading_t *batch,
+                               size_t n);
+
+/**
+ * @brief One scheduled source
+ */
+typedef struct {
+    tw_timer_t      timer;      ///< Must stay first (see sampler.c)
+    sampler_read_fn read;
+    void           *ctx;
+    uint32_t        period_ms;
+    uint8_t         id;         ///< sensor_id of its readings
+    uint64_t        samples;    ///< Successful reads
+    uint64_t        failed;     ///< Reads that returned false
+    uint64_t        missed;     ///< Deadlines skipped after falling behind
+} sampler_source_t;
+
+/**
+ * @brief A set of sources sharing one wheel and one thread
+ */
+typedef struct {
+    timer_wheel_t     wheel;        ///< Ticks are milliseconds
+    uint64_t          start_ms;     ///< Time phases are counted from
+    uint64_t          now_ms;       ///< Latest time passed to sampler_advance()
+    sampler_source_t *sources;      ///< Fixed array, so pointers stay valid
+    size_t            count;
+    size_t            capacity;
+    sampler_sink_t    sink;
+    void             *sink_ctx;
+    sensor_reading_t  batch[SAMPLER_BATCH];
+    size_t            pending;      ///< Readings in batch[]
+
+    /* Statistics */
+    uint64_t          wakeups;      ///< Advances that found work
+    uint64_t          samples;      ///< Readings delivered
+    uint64_t          max_late_ms;  ///< Worst (wakeup - deadline) seen
+} sampler_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Create a sampler for up to `max_sources` sources.
+ * @param start_ms  Current time; phases count from here
+ * @return The sampler, or NULL on failure
+ */
+sampler_t *sampler_create(size_t max_sources, uint64_t start_ms);
+
+/**
+ * @brief Free a sampler. Pending readings are not delivered.
+ */
+void sampler_destroy(sampler_t *s);
+
+/**
+ * @brief Set where readings go. Without a sink they are counted and dropped.
+ */
+void sampler_set_sink(sampler_t *s, sampler_sink_t sink, void *ctx);
+
+/**
+ * @brief Ready-made sink: manager_log_batch() into the manager `ctx`.
+ */
+void sampler_manager_sink(void *ctx, const sensor_reading_t *batch, size_t n);
+
+/**
+ * @brief Schedule a source.
+ *
+ * Its first deadline is the earliest start + phase + k * period that
+ * is not in the past, so a source added late still keeps its phase.
+ * @param period_ms  >= 1
+ * @param phase_ms   Offset of its deadlines within the period
+ * @return The source, or NULL if the sampler is full or an argument is bad
+ */
+sampler_source_t *sampler_add(sampler_t *s, uint8_t id, uint32_t period_ms,
+                              uint32_t phase_ms, sampler_read_fn read,
+                              void *ctx);
+
+/**
+ * @brief Stop sampling a source (O(1)). Its slot is not reused.
+ */
+void sampler_remove(sampler_t *s, sampler_source_t *src);
+
+/**
+ * @brief Read every source due by `now_ms` and deliver the readings.
+ * @return Number of sources read
+ */
+size_t sampler_advance(sampler_t *s, uint64_t now_ms);
+
+/**
+ * @brief When the next source is due (UINT64_MAX if none).
+ *
+ * May be a little early, never late: see tw_next_expiry().
+ */
+uint64_t sampler_next_due(const sampler_t *s);
+
+/**
+ * @brief Drive the sampler in real time from the calling thread.
+ *
+ * Sleeps until each next deadline and advances, for `duration_ms` or
+ * until *stop becomes non-zero (may be NULL). Sampler time carries on
+ * from where the last advance left it, paced by the monotonic clock.
+ */
+void sampler_run(sampler_t *s, uint64_t duration_ms,
+                 const volatile sig_atomic_t *stop);
+
+/**
+ * @brief Print per-source and overall counters.
+ */
+void sampler_print_stats(const sampler_t *s);
+
+#endif /* SAMPLER_H */
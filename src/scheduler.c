@@ -0,0 +1,354 @@
+/**
+ * @file scheduler.c
+ * @brief Work-stealing task scheduler implementation
+ *
+ * Worker loop, in priority order:
+ *   1. pop the newest task from my own deque
+ *   2. take a task from the injection queue
+ *   3. steal the oldest task from a random other worker
+ *   4. back off (yield, then sleep) and try again
+ *
+ * Running a task: while it is larger than its grain, push the upper half
+ * back onto my deque and keep the lower half. By the time the leaf runs,
+ * the remaining halves sit on the deque - biggest at the top where the
+ * thieves look first.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "scheduler.h"
+#include "clock.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS - deque
+ * ========================================================================== */
+
+static void deque_init(ws_deque_t *d)
+{
+    d->top    = 0;
+    d->bottom = 0;
+    pthread_mutex_init(&d->lock, NULL);   /* default attrs: cannot fail on Linux */
+}
+
+static bool deque_push(ws_deque_t *d, const ws_task_t *t)
+{
+    pthread_mutex_lock(&d->lock);
+    bool ok = (d->bottom - d->top) < WS_DEQUE_CAPACITY;
+    if (ok)
+    {
+        d->tasks[d->bottom % WS_DEQUE_CAPACITY] = *t;
+        d->bottom++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/** Owner end: newest task */
+static bool deque_pop(ws_deque_t *d, ws_task_t *out)
+{
+    pthread_mutex_lock(&d->lock);
+    bool ok = d->bottom != d->top;
+    if (ok)
+    {
+        d->bottom--;
+        *out = d->tasks[d->bottom % WS_DEQUE_CAPACITY];
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/** Thief end: oldest task */
+static bool deque_steal(ws_deque_t *d, ws_task_t *out)
+{
+    /* Trylock: never queue up behind the owner or another thief */
+    if (pthread_mutex_trylock(&d->lock) != 0)
+        return false;
+    bool ok = d->bottom != d->top;
+    if (ok)
+    {
+        *out = d->tasks[d->top % WS_DEQUE_CAPACITY];
+        d->top++;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
+}
+
+/* ============================================================================
+ * PRIVATE HELPERS - workers
+ * ========================================================================== */
+
+#define IDLE_SPINS     64
+#define IDLE_SLEEP_NS  50000L
+
+static void idle_wait(unsigned *idle)
+{
+    if (++(*idle) < IDLE_SPINS)
+    {
+        sched_yield();
+        return;
+    }
+    struct timespec ts = { 0, IDLE_SLEEP_NS };
+    nanosleep(&ts, NULL);
+}
+
+static uint32_t xorshift(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static bool try_steal(ws_worker_t *w, ws_task_t *out)
+{
+    ws_scheduler_t *ws = w->ws;
+    if (ws->worker_count < 2)
+        return false;
+
+    /* One sweep over the other workers from a random starting point */
+    unsigned start = xorshift(&w->rng) % ws->worker_count;
+    for (unsigned k = 0; k < ws->worker_count; k++)
+    {
+        unsigned v = (start + k) % ws->worker_count;
+        if (v == w->index)
+            continue;
+
+        atomic_fetch_add_explicit(&w->steal_attempts, 1, memory_order_relaxed);
+        if (deque_steal(&ws->workers[v].deque, out))
+        {
+            atomic_fetch_add_explicit(&w->steals, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void run_task(ws_worker_t *w, ws_task_t t)
+{
+    /* Split: keep the lower half, expose the upper half to thieves */
+    while (t.end - t.begin > t.grain)
+    {
+        size_t mid = t.begin + (t.end - t.begin) / 2;
+        ws_task_t upper = t;
+        upper.begin = mid;
+        if (!deque_push(&w->deque, &upper))
+            break;                      /* deque full: run the rest here */
+        t.end = mid;
+        atomic_fetch_add_explicit(&w->splits, 1, memory_order_relaxed);
+    }
+
+    size_t   n  = t.end - t.begin;
+    uint64_t t0 = clock_ns();
+    t.fn(t.ctx, t.begin, t.end, w->index);
+    atomic_fetch_add_explicit(&w->busy_ns, clock_ns() - t0, memory_order_relaxed);
+    atomic_fetch_add_explicit(&w->tasks, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&w->items, n, memory_order_relaxed);
+
+    /* Release: ws_wait() must see everything fn wrote */
+    atomic_fetch_sub_explicit(&w->ws->pending, n, memory_order_release);
+}
+
+static void *worker_main(void *arg)
+{
+    ws_worker_t    *w  = arg;
+    ws_scheduler_t *ws = w->ws;
+    unsigned idle = 0;
+
+    for (;;)
+    {
+        ws_task_t t;
+        if (deque_pop(&w->deque, &t) ||
+            deque_steal(&ws->inject, &t) ||
+            try_steal(w, &t))
+        {
+            idle = 0;
+            run_task(w, t);
+            continue;
+        }
+
+        if (!atomic_load_explicit(&ws->running, memory_order_acquire) &&
+            atomic_load_explicit(&ws->pending, memory_order_acquire) == 0)
+            break;
+        idle_wait(&idle);
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+ws_scheduler_t *ws_create(unsigned workers)
+{
+    if (workers == 0 || workers > WS_MAX_WORKERS)
+    {
+        DIAG_ERROR("SCHED", "workers must be 1..%d, got %u",
+                   WS_MAX_WORKERS, workers);
+        return NULL;
+    }
+
+    ws_scheduler_t *ws = malloc(sizeof(*ws));
+    if (ws == NULL)
+        return NULL;
+
+    ws->workers = cache_alloc(sizeof(ws_worker_t) * workers);
+    if (ws->workers == NULL)
+    {
+        free(ws);
+        return NULL;
+    }
+
+    deque_init(&ws->inject);
+
+    atomic_init(&ws->pending, 0);
+    atomic_init(&ws->running, true);
+
+    /* Every deque must exist before the first thread may try to steal */
+    ws->worker_count = workers;
+    for (unsigned i = 0; i < workers; i++)
+    {
+        ws_worker_t *w = &ws->workers[i];
+        w->ws    = ws;
+        w->index = i;
+        w->rng   = 0x9E3779B9u * (i + 1);
+        atomic_init(&w->start_ns, clock_ns());
+        atomic_init(&w->tasks, 0);
+        atomic_init(&w->items, 0);
+        atomic_init(&w->splits, 0);
+        atomic_init(&w->steals, 0);
+        atomic_init(&w->steal_attempts, 0);
+        atomic_init(&w->busy_ns, 0);
+        deque_init(&w->deque);
+    }
+
+    for (unsigned i = 0; i < workers; i++)
+    {
+        if (pthread_create(&ws->workers[i].thread, NULL, worker_main,
+                           &ws->workers[i]) != 0)
+        {
+            atomic_store(&ws->running, false);
+            for (unsigned j = 0; j < i; j++)
+                pthread_join(ws->workers[j].thread, NULL);
+            for (unsigned j = 0; j < workers; j++)
+                pthread_mutex_destroy(&ws->workers[j].deque.lock);
+            pthread_mutex_destroy(&ws->inject.lock);
+            cache_free(ws->workers);
+            free(ws);
+            return NULL;
+        }
+    }
+
+    return ws;
+}
+
+void ws_destroy(ws_scheduler_t *ws)
+{
+    if (ws == NULL)
+        return;
+
+    atomic_store_explicit(&ws->running, false, memory_order_release);
+    for (unsigned i = 0; i < ws->worker_count; i++)
+        pthread_join(ws->workers[i].thread, NULL);
+    for (unsigned i = 0; i < ws->worker_count; i++)
+        pthread_mutex_destroy(&ws->workers[i].deque.lock);
+
+    pthread_mutex_destroy(&ws->inject.lock);
+    cache_free(ws->workers);
+    free(ws);
+}
+
+bool ws_submit(ws_scheduler_t *ws, ws_fn_t fn, void *ctx,
+               size_t begin, size_t end, size_t grain)
+{
+    if (ws == NULL || fn == NULL || end < begin)
+        return false;
+    if (end == begin)
+        return true;
+
+    ws_task_t t = { .fn = fn, .ctx = ctx, .begin = begin, .end = end,
+                    .grain = (grain == 0) ? 1 : grain };
+
+    /* Count first so a fast worker cannot drive pending below zero */
+    atomic_fetch_add_explicit(&ws->pending, end - begin, memory_order_relaxed);
+    if (!deque_push(&ws->inject, &t))
+    {
+        atomic_fetch_sub_explicit(&ws->pending, end - begin, memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void ws_wait(ws_scheduler_t *ws)
+{
+    if (ws == NULL)
+        return;
+
+    unsigned idle = 0;
+    while (atomic_load_explicit(&ws->pending, memory_order_acquire) != 0)
+        idle_wait(&idle);
+}
+
+bool ws_get_stats(ws_scheduler_t *ws, unsigned worker, ws_worker_stats_t *stats)
+{
+    if (ws == NULL || stats == NULL || worker >= ws->worker_count)
+        return false;
+
+    ws_worker_t *w = &ws->workers[worker];
+    stats->tasks          = atomic_load_explicit(&w->tasks, memory_order_relaxed);
+    stats->items          = atomic_load_explicit(&w->items, memory_order_relaxed);
+    stats->splits         = atomic_load_explicit(&w->splits, memory_order_relaxed);
+    stats->steals         = atomic_load_explicit(&w->steals, memory_order_relaxed);
+    stats->steal_attempts = atomic_load_explicit(&w->steal_attempts, memory_order_relaxed);
+    stats->busy_ns        = atomic_load_explicit(&w->busy_ns, memory_order_relaxed);
+    stats->alive_ns       = clock_ns() - atomic_load_explicit(&w->start_ns,
+                                                              memory_order_relaxed);
+    stats->utilization    = (stats->alive_ns > 0)
+                          ? (double)stats->busy_ns / (double)stats->alive_ns
+                          : 0.0;
+    return true;
+}
+
+void ws_reset_stats(ws_scheduler_t *ws)
+{
+    if (ws == NULL)
+        return;
+
+    uint64_t now = clock_ns();
+    for (unsigned i = 0; i < ws->worker_count; i++)
+    {
+        ws_worker_t *w = &ws->workers[i];
+        atomic_store(&w->tasks, 0);
+        atomic_store(&w->items, 0);
+        atomic_store(&w->splits, 0);
+        atomic_store(&w->steals, 0);
+        atomic_store(&w->steal_attempts, 0);
+        atomic_store(&w->busy_ns, 0);
+        atomic_store(&w->start_ns, now);
+    }
+}
+
+void ws_print_stats(ws_scheduler_t *ws)
+{
+    if (ws == NULL)
+        return;
+
+    printf("\n--- Scheduler Statistics ---\n");
+    printf("  %-6s %7s %10s %8s %8s %10s\n",
+           "worker", "util", "items", "tasks", "steals", "attempts");
+    for (unsigned i = 0; i < ws->worker_count; i++)
+    {
+        ws_worker_stats_t s;
+        ws_get_stats(ws, i, &s);
+        printf("  %-6u %6.1f%% %10" PRIu64 " %8" PRIu64 " %8" PRIu64
+               " %10" PRIu64 "\n", i, s.utilization * 100.0,
+               s.items, s.tasks, s.steals, s.steal_attempts);
+    }
+    printf("----------------------------\n");
+}
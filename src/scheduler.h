@@ -0,0 +1,190 @@
+/**
+ * @file scheduler.h
+ * @brief Work-stealing task scheduler for skewed per-sensor workloads
+ *
+ * The worker pool pins each sensor to one worker, which is ideal when
+ * sensors cost about the same. They rarely do: a 1 kHz vibration channel
+ * running an FFT per window costs thousands of times more than a DHT11
+ * read every 2 s, so static partitioning leaves most cores idle.
+ *
+ * This scheduler runs RANGE tasks - "apply fn to items [begin, end)",
+ * e.g. the analysis windows of one sensor's capture - on N workers:
+ *
+ *   - every worker owns a deque; it pushes and pops at the bottom (LIFO,
+ *     cache-warm), thieves take from the top (the oldest, largest task)
+ *   - a task larger than its grain is split in half; the upper half goes
+ *     onto the worker's deque where an idle worker can steal it, so one
+ *     heavy sensor ends up spread across every core
+ *   - tasks submitted from outside go into a shared injection queue that
+ *     idle workers drain before they try to steal
+ *
+ * Each deque has its own mutex. The owner's operations are uncontended
+ * unless a thief is working on the same deque at that instant, and tasks
+ * are coarse (a window of work, not a reading), so the lock is never the
+ * bottleneck.
+ *
+ *   ws_scheduler_t *ws = ws_create(4);
+ *   ws_submit(ws, analyse_windows, vib_ctx, 0, 1000, 8);  // heavy sensor
+ *   ws_submit(ws, analyse_windows, dht_ctx, 0, 2, 1);     // light sensor
+ *   ws_wait(ws);
+ *   ws_get_stats(ws, 0, &stats);   // utilisation, steals, ...
+ *   ws_destroy(ws);
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "cacheline.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum number of worker threads */
+#define WS_MAX_WORKERS     64
+
+/**
+ * @brief Tasks each deque can hold (splits beyond this run inline).
+ *
+ * The shared injection queue is a deque too, so at most this many
+ * submitted tasks can be waiting for a worker.
+ */
+#define WS_DEQUE_CAPACITY  256
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Work function: process items [begin, end) of `ctx`.
+ *
+ * Called concurrently on disjoint sub-ranges, so it must only write
+ * per-item state. `worker` is the index of the calling worker.
+ */
+typedef void (*ws_fn_t)(void *ctx, size_t begin, size_t end, unsigned worker);
+
+/**
+ * @brief A range of work, split down to `grain` items before it runs
+ */
+typedef struct {
+    ws_fn_t fn;
+    void   *ctx;
+    size_t  begin;
+    size_t  end;
+    size_t  grain;   ///< Largest range run without splitting (>= 1)
+} ws_task_t;
+
+/**
+ * @brief Fixed-size task deque (owner at the bottom, thieves at the top)
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    ws_task_t       tasks[WS_DEQUE_CAPACITY];
+    size_t          top;     ///< Oldest task (steal end)
+    size_t          bottom;  ///< One past the newest task (owner end)
+} ws_deque_t;
+
+/**
+ * @brief Per-worker counters, readable at any time
+ */
+typedef struct {
+    uint64_t tasks;          ///< Leaf tasks run
+    uint64_t items;          ///< Items processed
+    uint64_t splits;         ///< Tasks split in half
+    uint64_t steals;         ///< Tasks stolen from another worker
+    uint64_t steal_attempts; ///< Steal attempts, successful or not
+    uint64_t busy_ns;        ///< Time spent inside work functions
+    uint64_t alive_ns;       ///< Time since the worker started
+    double   utilization;    ///< busy_ns / alive_ns
+} ws_worker_stats_t;
+
+struct ws_scheduler;
+
+/**
+ * @brief One worker thread and its deque
+ */
+typedef struct {
+    _Alignas(CACHE_LINE)
+    ws_deque_t           deque;
+    struct ws_scheduler *ws;
+    pthread_t            thread;
+    unsigned             index;
+    _Atomic uint64_t     start_ns;  ///< For utilisation (reset by ws_reset_stats)
+    uint32_t             rng;       ///< Victim selection (xorshift)
+
+    _Alignas(CACHE_LINE)
+    _Atomic uint64_t     tasks;
+    _Atomic uint64_t     items;
+    _Atomic uint64_t     splits;
+    _Atomic uint64_t     steals;
+    _Atomic uint64_t     steal_attempts;
+    _Atomic uint64_t     busy_ns;
+} ws_worker_t;
+
+/**
+ * @brief The scheduler (allocate with ws_create)
+ */
+typedef struct ws_scheduler {
+    ws_worker_t     *workers;
+    unsigned         worker_count;
+    ws_deque_t       inject;        ///< Tasks submitted from outside
+    _Atomic size_t   pending;       ///< Items submitted but not yet processed
+    _Atomic bool     running;
+} ws_scheduler_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Create a scheduler and start its worker threads.
+ * @param workers  1 .. WS_MAX_WORKERS
+ * @return         New scheduler, NULL on failure
+ */
+ws_scheduler_t *ws_create(unsigned workers);
+
+/**
+ * @brief Finish all queued work, stop and free the workers (NULL is safe).
+ */
+void ws_destroy(ws_scheduler_t *ws);
+
+/**
+ * @brief Queue fn over [begin, end), split down to `grain` items.
+ *
+ * Safe from any thread that is not a worker (workers split instead).
+ *
+ * @return false if the arguments are invalid or the injection queue
+ *         already holds WS_DEQUE_CAPACITY tasks
+ */
+bool ws_submit(ws_scheduler_t *ws, ws_fn_t fn, void *ctx,
+               size_t begin, size_t end, size_t grain);
+
+/**
+ * @brief Block until every submitted item has been processed.
+ */
+void ws_wait(ws_scheduler_t *ws);
+
+/**
+ * @brief Snapshot one worker's counters and utilisation.
+ * @return false if `worker` is out of range
+ */
+bool ws_get_stats(ws_scheduler_t *ws, unsigned worker, ws_worker_stats_t *stats);
+
+/**
+ * @brief Zero every worker's counters and restart utilisation timing.
+ *
+ * Call while the scheduler is idle (after ws_wait).
+ */
+void ws_reset_stats(ws_scheduler_t *ws);
+
+/**
+ * @brief Print per-worker utilisation, items and steal counts.
+ */
+void ws_print_stats(ws_scheduler_t *ws);
+
+#endif /* SCHEDULER_H */
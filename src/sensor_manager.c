@@ -15,9 +15,22 @@
  * 3. The `registered[]` boolean array tracks which slots are in use.
  *    This lets us distinguish "slot 3 is empty" from
  *    "slot 3 has a sensor with value 0.0".
+ *
+ * 4. Thresholds are stored in the sensor's hot cache line, not in a
+ *    parallel array here, so a reading does not pull in an extra line
+ *    just to find its limits.
+ *
+ * 5. Cross-thread threshold updates are quiescent-state RCU with a
+ *    single reader: the logging thread only ever reads limits inside
+ *    manager_log(), so the gap between two readings is a point where it
+ *    holds no references, and that is where a published table is
+ *    copied into the sensors. No reader-side lock or retry loop.
  */
 
 #include "sensor_manager.h"
+#include "stage_timing.h"
+#include "watchdog.h"
+#include "diag.h"
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -66,23 +79,45 @@ static alert_level_t evaluate_threshold(const sensor_threshold_t *t,
     return ALERT_NONE;
 }
 
+/**
+ * @brief Copy a published threshold table into the sensors.
+ *
+ * Runs on the logging thread between two readings. Taking the pointer
+ * with an exchange tells the publisher the slot is in use; bumping
+ * limits_applied afterwards tells it the slot is free again.
+ */
+static void apply_published_limits(manager_t *m)
+{
+    threshold_table_t *t = atomic_exchange_explicit(&m->limits_pending, NULL,
+                                                    memory_order_acquire);
+    if (t == NULL)
+        return;
+
+    for (uint8_t id = 0; id < m->capacity; id++)
+    {
+        if (m->registered[id])
+            m->sensors[id].limits = t->limits[id];
+    }
+    atomic_fetch_add_explicit(&m->limits_applied, 1, memory_order_release);
+}
+
 /**
  * @brief Print a formatted alert message.
  *
  * Kept separate so it's easy to replace with a different
  * output method (e.g. writing to a log file, sending over serial).
+ * `kind` distinguishes threshold alerts from anomaly alerts.
  */
-static void print_alert(const manager_t *m, uint8_t id,
-                        alert_level_t level, float value,
-                        uint32_t timestamp)
+static void print_alert(const manager_t *m, const char *kind,
+                        const alert_event_t *ev)
 {
-    const char *sensor_name = m->sensors[id].name;
-    const char *level_str = (level == ALERT_CRITICAL) ? "CRITICAL" : "WARNING";
-    const char *color_start = (level == ALERT_CRITICAL) ? "!!!" : "!";
+    const char *sensor_name = m->sensors[ev->sensor_id].name;
+    const char *level_str = (ev->level == ALERT_CRITICAL) ? "CRITICAL" : "WARNING";
+    const char *color_start = (ev->level == ALERT_CRITICAL) ? "!!!" : "!";
 
-    printf("\n%s ALERT [%s] Sensor '%s' (id=%u): value=%.2f at t=%u %s\n\n",
-           color_start, level_str, sensor_name, id,
-           value, timestamp, color_start);
+    printf("\n%s %s [%s] Sensor '%s' (id=%u): value=%.2f at t=%u %s\n\n",
+           color_start, kind, level_str, sensor_name, ev->sensor_id,
+           ev->value, ev->timestamp, color_start);
 }
 
 /* ============================================================================
@@ -90,33 +125,46 @@ static void print_alert(const manager_t *m, uint8_t id,
  * ========================================================================== */
 
 manager_t *manager_create(uint8_t capacity)
+{
+    return manager_create_arena(capacity, 0, 0);
+}
+
+manager_t *manager_create_arena(uint8_t capacity, size_t arena_bytes,
+                                unsigned arena_flags)
 {
     /* Validate capacity */
     if (capacity == 0 || capacity > MANAGER_MAX_SENSORS)
     {
-        printf("[MANAGER] ERROR: capacity must be 1..%d, got %u\n",
-               MANAGER_MAX_SENSORS, capacity);
+        DIAG_ERROR("MANAGER", "capacity must be 1..%d, got %u",
+                   MANAGER_MAX_SENSORS, capacity);
         return NULL;
     }
 
-    manager_t *m = malloc(sizeof(manager_t));
-    if (m == NULL)
-        return NULL;
+    if (arena_bytes == 0)
+        arena_bytes = capacity * buffer_footprint(MANAGER_ARENA_RING);
 
     /*
-     * Zero the entire struct first.
-     * This sets all registered[] to false, all counts to 0,
-     * and all pointers inside sensors[] to NULL in one shot.
-     * Safer than initialising each field manually.
+     * One reservation for the manager and every ring it will own.
+     * The arena hands out zeroed blocks, so all registered[] are false,
+     * all counts 0 and all pointers inside sensors[] NULL already.
      */
-    memset(m, 0, sizeof(manager_t));
+    arena_t *arena = arena_create(sizeof(manager_t) + arena_bytes, arena_flags);
+    if (arena == NULL)
+        return NULL;
 
+    manager_t *m = arena_alloc(arena, sizeof(manager_t));
+    m->arena = arena;
     m->capacity = capacity;
     m->count = 0;
     m->total_logs = 0;
     m->total_alerts = 0;
+    m->total_anomalies = 0;
+    atomic_init(&m->limits_pending, NULL);
+    atomic_init(&m->limits_applied, 0);
+    m->limits_published = 0;
 
-    printf("[MANAGER] Created manager (capacity=%u)\n", capacity);
+    DIAG_INFO("MANAGER", "Created manager (capacity=%u, arena=%zu bytes %s)",
+              capacity, arena->size, arena_backing_name(arena));
     return m;
 }
 
@@ -126,9 +174,8 @@ void manager_destroy(manager_t *m)
         return;
 
     /*
-     * Destroy each registered sensor.
-     * sensor_destroy() frees the ring buffer each sensor owns.
-     * Without this loop we'd leak every sensor's buffer memory.
+     * Rings in the arena go with it; sensor_destroy() still frees what
+     * lives outside it (broadcast rings, rings that did not fit).
      */
     for (uint8_t i = 0; i < m->capacity; i++)
     {
@@ -138,8 +185,9 @@ void manager_destroy(manager_t *m)
         }
     }
 
-    free(m);
-    printf("[MANAGER] Destroyed\n");
+    /* The manager itself is in the arena: one release frees everything */
+    arena_destroy(m->arena);
+    DIAG_INFO("MANAGER", "Destroyed");
 }
 
 bool manager_register(manager_t *m, uint8_t id,
@@ -155,23 +203,33 @@ bool manager_register(manager_t *m, uint8_t id,
         return false; /* manager full */
 
     /*
-     * sensor_init allocates the ring buffer for this sensor.
+     * The ring buffer is bump-allocated from the manager's arena, right
+     * after the previous sensor's; a ring too big for what is left
+     * comes from the heap instead.
      * The sensor lives at m->sensors[id] - no extra malloc needed.
      * The ID in the array and the sensor's own ID match intentionally.
      */
-    if (!sensor_init(&m->sensors[id], id, name, buf_size))
+    arena_t *arena = m->arena;
+    size_t   room  = arena_remaining(arena);
+    if (buf_size > room / sizeof(sensor_reading_t) ||
+        buffer_footprint(buf_size) > room)
     {
-        printf("[MANAGER] ERROR: Failed to init sensor id=%u\n", id);
+        DIAG_DEBUG("MANAGER", "Ring of sensor id=%u does not fit the arena, "
+                   "using the heap", id);
+        arena = NULL;
+    }
+    if (!sensor_init_in(&m->sensors[id], id, name, buf_size, arena))
+    {
+        DIAG_ERROR("MANAGER", "Failed to init sensor id=%u", id);
         return false;
     }
 
-    /* Mark slot as in use and set default thresholds (disabled) */
+    /* Mark slot as in use; sensor_init_in() left thresholds disabled */
     m->registered[id] = true;
-    m->thresholds[id].enabled = false;
     m->count++;
 
-    printf("[MANAGER] Registered sensor id=%u name='%s' buf=%zu\n",
-           id, name, buf_size);
+    DIAG_INFO("MANAGER", "Registered sensor id=%u name='%s' buf=%zu",
+              id, name, buf_size);
     return true;
 }
 
@@ -181,14 +239,120 @@ bool manager_set_thresholds(manager_t *m, uint8_t id,
     if (!is_valid(m, id))
         return false;
 
-    m->thresholds[id] = thresholds;
-    m->thresholds[id].enabled = true;
+    m->sensors[id].limits = thresholds;
+    m->sensors[id].limits.enabled = true;
+
+    DIAG_INFO("MANAGER", "Thresholds set for sensor id=%u "
+              "warn=[%.1f, %.1f] critical=[%.1f, %.1f]",
+              id,
+              thresholds.warn_low, thresholds.warn_high,
+              thresholds.critical_low, thresholds.critical_high);
+    return true;
+}
 
-    printf("[MANAGER] Thresholds set for sensor id=%u "
-           "warn=[%.1f, %.1f] critical=[%.1f, %.1f]\n",
-           id,
-           thresholds.warn_low, thresholds.warn_high,
-           thresholds.critical_low, thresholds.critical_high);
+bool manager_publish_thresholds(manager_t *m, const threshold_table_t *table)
+{
+    if (m == NULL || table == NULL)
+        return false;
+
+    /*
+     * Take back a table the logging thread has not picked up yet - the
+     * slot is then ours again. If it was already taken, wait until its
+     * copy has finished before overwriting the slot.
+     */
+    if (atomic_exchange_explicit(&m->limits_pending, NULL,
+                                 memory_order_acquire) != NULL)
+        m->limits_published--;
+    else
+        while (atomic_load_explicit(&m->limits_applied, memory_order_acquire) !=
+               m->limits_published)
+            ;
+
+    m->limits_slot = *table;
+    m->limits_published++;
+    atomic_store_explicit(&m->limits_pending, &m->limits_slot,
+                          memory_order_release);
+
+    DIAG_INFO("MANAGER", "Threshold table %" PRIu32 " published",
+              m->limits_published);
+    return true;
+}
+
+bool manager_set_anomaly(manager_t *m, uint8_t id, anomaly_config_t cfg)
+{
+    if (!is_valid(m, id))
+        return false;
+
+    if (!sensor_set_anomaly(&m->sensors[id], &cfg))
+    {
+        DIAG_ERROR("MANAGER", "Invalid anomaly config for sensor id=%u", id);
+        return false;
+    }
+
+    DIAG_INFO("MANAGER", "Anomaly detection %s for sensor id=%u "
+              "alpha=%.3f z=[%.1f, %.1f] min_sigma=%.3f cusum k=%.2f h=%.2f",
+              cfg.enabled ? "set" : "disabled", id, cfg.alpha,
+              cfg.z_warn, cfg.z_critical, cfg.min_sigma, cfg.cusum_k, cfg.cusum_h);
+    return true;
+}
+
+bool manager_add_filter(manager_t *m, uint8_t id, filter_stage_config_t cfg)
+{
+    if (!is_valid(m, id))
+        return false;
+
+    if (!sensor_add_filter(&m->sensors[id], &cfg))
+    {
+        DIAG_ERROR("MANAGER", "Could not add filter to sensor id=%u", id);
+        return false;
+    }
+
+    DIAG_INFO("MANAGER", "Filter stage %u added to sensor id=%u",
+              m->sensors[id].filter.count, id);
+    return true;
+}
+
+bool manager_set_log_raw(manager_t *m, uint8_t id, bool log_raw)
+{
+    if (!is_valid(m, id))
+        return false;
+
+    sensor_set_log_raw(&m->sensors[id], log_raw);
+    return true;
+}
+
+broadcast_ring_t *manager_enable_broadcast(manager_t *m, uint8_t id,
+                                           size_t capacity)
+{
+    if (!is_valid(m, id))
+        return NULL;
+
+    if (!sensor_enable_broadcast(&m->sensors[id], capacity))
+    {
+        DIAG_ERROR("MANAGER", "Could not enable broadcast for sensor id=%u", id);
+        return NULL;
+    }
+
+    DIAG_INFO("MANAGER", "Broadcast mode on for sensor id=%u ring=%zu",
+              id, capacity);
+    return m->sensors[id].bcast;
+}
+
+bool manager_attach_rollup(manager_t *m, rollup_t *r)
+{
+    if (m == NULL)
+        return false;
+
+    m->rollup = r;
+    return true;
+}
+
+bool manager_attach_watchdog(manager_t *m, struct watchdog *wd)
+{
+    if (m == NULL)
+        return false;
+
+    m->watchdog = wd;
     return true;
 }
 
@@ -198,27 +362,81 @@ bool manager_log(manager_t *m, uint8_t id,
     if (!is_valid(m, id))
         return false;
 
+    /* A control thread published new limits: switch between readings */
+    if (atomic_load_explicit(&m->limits_pending, memory_order_relaxed) != NULL)
+        apply_published_limits(m);
+
+    /* Any reading, good or bad, proves the sensor is alive - and clears a
+     * stale fault first, so this one is recorded */
+    if (m->watchdog != NULL)
+        watchdog_feed(m->watchdog, id);
+
+    sensor_t *s = &m->sensors[id];
+
+    /* Condition first - a single spike must not trip a threshold */
+    float filtered = sensor_condition(s, value);
+
     /* Check thresholds BEFORE logging so alert fires on every bad value */
-    alert_level_t level = evaluate_threshold(&m->thresholds[id], value);
+    uint64_t t = STAGE_BEGIN(STAGE_THRESHOLD);
+    alert_level_t level = evaluate_threshold(&s->limits, filtered);
+    STAGE_END(STAGE_THRESHOLD, t);
     if (level != ALERT_NONE)
     {
-        print_alert(m, id, level, value, timestamp);
+        alert_event_t ev = {.sensor_id = id, .level = level,
+                            .value = filtered, .timestamp = timestamp};
+        print_alert(m, "ALERT", &ev);
         m->total_alerts++;
     }
 
     /* Log the value through the sensor layer */
-    if (!sensor_log(&m->sensors[id], value, timestamp))
+    if (!sensor_record(s, filtered, value, timestamp))
         return false;
 
+    /* The sensor scored the reading against its learned baseline */
+    alert_event_t anomaly;
+    if (s->detecting && sensor_last_anomaly(s, &anomaly) != ALERT_NONE)
+    {
+        print_alert(m, "ANOMALY", &anomaly);
+        m->total_alerts++;
+        m->total_anomalies++;
+    }
+
+    /* Long-horizon summaries see the same conditioned signal */
+    if (m->rollup != NULL)
+        rollup_feed(m->rollup, id, filtered, timestamp);
+
     m->total_logs++;
     return true;
 }
 
+size_t manager_log_batch(manager_t *m, const sensor_reading_t *readings,
+                         size_t n)
+{
+    if (m == NULL || readings == NULL)
+        return 0;
+
+    size_t accepted = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const sensor_reading_t *r = &readings[i];
+        if (manager_log(m, r->sensor_id, r->value, r->timestamp))
+            accepted++;
+    }
+    return accepted;
+}
+
 bool manager_read(manager_t *m, uint8_t id, sensor_reading_t *output)
 {
     if (!is_valid(m, id) || output == NULL)
         return false;
 
+    if (m->sensors[id].bcast != NULL)
+    {
+        DIAG_WARN("MANAGER", "Sensor id=%u is in broadcast mode: "
+                  "read through a subscription", id);
+        return false;
+    }
+
     return sensor_read(&m->sensors[id], output);
 }
 
@@ -238,26 +456,34 @@ bool manager_resume_sensor(manager_t *m, uint8_t id)
     return sensor_resume(&m->sensors[id]);
 }
 
-void manager_flush_sensor(manager_t *m, uint8_t id)
+bool manager_flush_sensor(manager_t *m, uint8_t id)
 {
     if (!is_valid(m, id))
-        return;
+        return false;
 
-    sensor_flush(&m->sensors[id]);
+    if (!sensor_flush(&m->sensors[id]))
+    {
+        DIAG_WARN("MANAGER", "Sensor id=%u is in broadcast mode: not flushed", id);
+        return false;
+    }
+    return true;
 }
 
-void manager_flush_all(manager_t *m)
+bool manager_flush_all(manager_t *m)
 {
     if (m == NULL)
-        return;
+        return false;
 
+    bool all = true;
     for (uint8_t i = 0; i < m->capacity; i++)
     {
-        if (m->registered[i])
-            sensor_flush(&m->sensors[i]);
+        if (m->registered[i] && !manager_flush_sensor(m, i))
+            all = false;
     }
 
-    printf("[MANAGER] All sensors flushed\n");
+    if (all)
+        DIAG_INFO("MANAGER", "All sensors flushed");
+    return all;
 }
 
 alert_level_t manager_check_threshold(const manager_t *m,
@@ -266,7 +492,7 @@ alert_level_t manager_check_threshold(const manager_t *m,
     if (!is_valid(m, id))
         return ALERT_NONE;
 
-    return evaluate_threshold(&m->thresholds[id], value);
+    return evaluate_threshold(&m->sensors[id].limits, value);
 }
 
 void manager_print_all(const manager_t *m)
@@ -307,6 +533,7 @@ void manager_print_stats(const manager_t *m)
     printf("  Sensors registered : %u / %u\n", m->count, m->capacity);
     printf("  Total readings     : %" PRIu32 "\n", m->total_logs);
     printf("  Total alerts fired : %" PRIu32 "\n", m->total_alerts);
+    printf("  Anomalies flagged  : %" PRIu32 "\n", m->total_anomalies);
 
     /* Per-sensor overflow summary */
     printf("  Overflow summary   :\n");
@@ -26,10 +26,15 @@
 #define SENSOR_MANAGER_H
 
 #include "sensors.h" /* sensor_t, sensor_reading_t */
+#include "alert.h"   /* alert_level_t, alert_event_t */
+#include "rollup.h"  /* rollup_t */
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
 
+struct watchdog;    /* watchdog.h */
+
 /* ============================================================================
  * CONFIGURATION
  * ========================================================================== */
@@ -42,55 +47,30 @@
  */
 #define MANAGER_MAX_SENSORS 8
 
+/**
+ * @brief Ring capacity per sensor that manager_create() sizes its arena for.
+ *
+ * A registration that no longer fits in the arena falls back to the heap,
+ * so this is a sizing hint, not a limit.
+ */
+#define MANAGER_ARENA_RING  DEFAULT_BUFFER_SIZE
+
 /* ============================================================================
  * ALERT SYSTEM
  * ========================================================================== */
 
-/**
- * @brief Alert severity levels
- *
- * NONE    - everything normal
- * WARNING - value approaching a threshold (early warning)
- * CRITICAL- threshold crossed, action required
- */
-typedef enum
-{
-    ALERT_NONE = 0,
-    ALERT_WARNING = 1,
-    ALERT_CRITICAL = 2
-} alert_level_t;
+/* sensor_threshold_t is defined in alert.h; each sensor_t holds its own. */
 
 /**
- * @brief Threshold configuration for one sensor
- *
- * Set warn_high / warn_low to 0 to disable warning thresholds.
- * Set critical_high / critical_low to 0 to disable critical thresholds.
+ * @brief Limits for every sensor of a manager, swapped in as one unit
  *
- * Example for a temperature sensor (Celsius):
- *   warn_low     = 0.0f    (below 0 is unusual)
- *   warn_high    = 60.0f   (above 60 is getting hot)
- *   critical_low = -10.0f  (below -10 is a fault)
- *   critical_high= 85.0f   (above 85 is dangerous)
+ * See manager_publish_thresholds(). Entries for IDs that are not
+ * registered are ignored; .enabled is taken as given.
  */
 typedef struct
 {
-    float warn_low;      ///< Warning if value drops below this
-    float warn_high;     ///< Warning if value exceeds this
-    float critical_low;  ///< Critical if value drops below this
-    float critical_high; ///< Critical if value exceeds this
-    bool enabled;        ///< false = ignore thresholds for this sensor
-} sensor_threshold_t;
-
-/**
- * @brief One alert event — what happened and when
- */
-typedef struct
-{
-    uint8_t sensor_id;   ///< Which sensor triggered this
-    alert_level_t level; ///< WARNING or CRITICAL
-    float value;         ///< The value that triggered it
-    uint32_t timestamp;  ///< When it happened
-} alert_event_t;
+    sensor_threshold_t limits[MANAGER_MAX_SENSORS]; ///< Indexed by sensor ID
+} threshold_table_t;
 
 /* ============================================================================
  * MANAGER STRUCTURE
@@ -101,18 +81,34 @@ typedef struct
  *
  * You never need to access these fields directly.
  * Use the public API functions below.
+ *
+ * The scalar fields come first and share one cache line; each sensor
+ * then starts on a line of its own (see sensor_t), so logging a reading
+ * touches this header line, the sensor's hot line and its ring.
  */
 typedef struct
 {
-    sensor_t sensors[MANAGER_MAX_SENSORS];              ///< Sensor array
-    sensor_threshold_t thresholds[MANAGER_MAX_SENSORS]; ///< Per-sensor thresholds
-    bool registered[MANAGER_MAX_SENSORS];               ///< Slot in use?
-    uint8_t count;                                      ///< How many registered
-    uint8_t capacity;                                   ///< Max allowed (<=MANAGER_MAX_SENSORS)
-    uint32_t total_logs;                                ///< Total readings logged
-    uint32_t total_alerts;                              ///< Total alerts triggered
+    bool registered[MANAGER_MAX_SENSORS];  ///< Slot in use?
+    uint8_t count;                         ///< How many registered
+    uint8_t capacity;                      ///< Max allowed (<=MANAGER_MAX_SENSORS)
+    uint32_t total_logs;                   ///< Total readings logged
+    uint32_t total_alerts;                 ///< Total alerts triggered
+    uint32_t total_anomalies;              ///< Alerts raised by anomaly detection
+    rollup_t *rollup;                      ///< Optional downsampling cascade (not owned)
+    arena_t *arena;                        ///< Holds this struct and the rings
+    _Atomic(threshold_table_t *) limits_pending; ///< Published, not yet applied
+    struct watchdog *watchdog;             ///< Optional stale-sensor watchdog (not owned)
+    sensor_t sensors[MANAGER_MAX_SENSORS]; ///< Sensor array, limits included
+
+    /* Threshold hand-over, touched only when a table is published */
+    threshold_table_t limits_slot;         ///< What limits_pending points to
+    uint32_t limits_published;             ///< Tables published (control thread)
+    atomic_uint limits_applied;            ///< Tables applied (logging thread)
 } manager_t;
 
+_Static_assert(offsetof(manager_t, sensors) == CACHE_LINE,
+               "manager_t header fields must fit in the first cache line");
+
 /* ============================================================================
  * PUBLIC API
  * ========================================================================== */
@@ -125,6 +121,24 @@ typedef struct
  */
 manager_t *manager_create(uint8_t capacity);
 
+/**
+ * @brief Create a manager inside an arena of explicit size.
+ *
+ * The manager struct is the arena's first block; each manager_register()
+ * then bump-allocates that sensor's ring header and storage right after
+ * the previous one, cache-line aligned, so the whole working set is one
+ * contiguous region and manager_destroy() releases it in one call.
+ * manager_create() is this with arena_bytes = 0 (room for `capacity`
+ * rings of MANAGER_ARENA_RING readings) and no flags.
+ *
+ * @param capacity     Max number of sensors (1 .. MANAGER_MAX_SENSORS)
+ * @param arena_bytes  Bytes for rings beyond the manager itself, 0 = default
+ * @param arena_flags  0 or ARENA_HUGEPAGES
+ * @return             Pointer to manager, NULL on failure
+ */
+manager_t *manager_create_arena(uint8_t capacity, size_t arena_bytes,
+                                unsigned arena_flags);
+
 /**
  * @brief Free all memory and destroy the manager.
  * @param m  Manager to destroy (NULL is safe)
@@ -149,7 +163,8 @@ bool manager_register(manager_t *m, uint8_t id,
  * @brief Set alert thresholds for a sensor.
  *
  * Optional - sensors work without thresholds.
- * Call after manager_register().
+ * Call after manager_register(), from the thread that calls
+ * manager_log(); other threads use manager_publish_thresholds().
  *
  * @param m          Manager
  * @param id         Sensor ID
@@ -159,10 +174,125 @@ bool manager_register(manager_t *m, uint8_t id,
 bool manager_set_thresholds(manager_t *m, uint8_t id,
                             sensor_threshold_t thresholds);
 
+/**
+ * @brief Replace every sensor's thresholds from another thread.
+ *
+ * For a control thread (config reload, SIGHUP) while another thread is
+ * logging. The table is copied into the manager and handed over; the
+ * logging thread picks it up at the start of its next manager_log()
+ * and applies all limits at once between two readings, so a reading is
+ * always checked against either the old set or the new one, never a
+ * mix. The logging side never blocks: picking up a table is a single
+ * atomic exchange, and when nothing was published manager_log() pays
+ * one relaxed load of a word in a line it reads anyway.
+ *
+ * Publishing again before the last table was picked up replaces it.
+ * If the logging thread is applying a table at that moment, this call
+ * waits for that copy (a few hundred bytes) to finish. Calls from
+ * several control threads must be serialised by the caller.
+ *
+ * @param m      Manager
+ * @param table  New limits for every sensor
+ * @return true on success
+ */
+bool manager_publish_thresholds(manager_t *m, const threshold_table_t *table);
+
+/**
+ * @brief Enable statistical anomaly detection for a sensor.
+ *
+ * Optional - complements the static thresholds by flagging readings
+ * that jump away from, or slowly drift off, the learned baseline.
+ * Call after manager_register(). Pass .enabled = false to turn it off.
+ *
+ * @param m    Manager
+ * @param id   Sensor ID
+ * @param cfg  Detector tuning (alpha must be in (0, 1) when enabled)
+ * @return true on success
+ */
+bool manager_set_anomaly(manager_t *m, uint8_t id, anomaly_config_t cfg);
+
+/**
+ * @brief Append a filter stage to a sensor's conditioning chain.
+ *
+ * Stages run in the order they were added, before thresholds, stats
+ * and anomaly detection. Up to FILTER_MAX_STAGES per sensor.
+ *
+ * Example - knock out DHT11 spikes, then smooth:
+ *   manager_add_filter(m, 0, (filter_stage_config_t){
+ *       .type = FILTER_MEDIAN, .window = 5});
+ *   manager_add_filter(m, 0, (filter_stage_config_t){
+ *       .type = FILTER_MOVING_AVG, .window = 4});
+ *
+ * @param m    Manager
+ * @param id   Sensor ID
+ * @param cfg  Stage configuration
+ * @return true on success, false if invalid or the chain is full
+ */
+bool manager_add_filter(manager_t *m, uint8_t id, filter_stage_config_t cfg);
+
+/**
+ * @brief Choose whether a sensor buffers raw or filtered values.
+ *
+ * Thresholds and stats always use the filtered value; this only changes
+ * what is stored (and therefore what reaches the log). Default: filtered.
+ *
+ * @return true on success
+ */
+bool manager_set_log_raw(manager_t *m, uint8_t id, bool log_raw);
+
+/**
+ * @brief Switch a sensor to broadcast mode.
+ *
+ * Readings are published to a broadcast ring instead of the sensor's
+ * destructive ring buffer, so the logger, alert engine and exporters can
+ * each subscribe and read the whole stream:
+ *
+ *   broadcast_ring_t *ring = manager_enable_broadcast(m, 0, 1024);
+ *   int logger_id = broadcast_subscribe(ring, BROADCAST_GATE);
+ *   int live_id   = broadcast_subscribe(ring, BROADCAST_LAP);
+ *
+ * The ring is owned by the sensor and freed by manager_destroy().
+ * manager_read() and manager_flush_sensor() refuse a broadcast sensor.
+ *
+ * @param m         Manager
+ * @param id        Sensor ID
+ * @param capacity  Ring size (power of two)
+ * @return          The ring to subscribe to, NULL on failure
+ */
+broadcast_ring_t *manager_enable_broadcast(manager_t *m, uint8_t id,
+                                           size_t capacity);
+
+/**
+ * @brief Feed every successfully logged reading into a rollup cascade.
+ *
+ * The manager does not own the cascade - the caller keeps it alive and
+ * calls rollup_close() after the last reading. Pass NULL to detach.
+ *
+ * @param m  Manager
+ * @param r  Initialised cascade with at least one tier, or NULL
+ * @return true on success
+ */
+bool manager_attach_rollup(manager_t *m, rollup_t *r);
+
+/**
+ * @brief Tell a watchdog about every reading manager_log() receives.
+ *
+ * watchdog_init() attaches itself; the manager does not own it. A reading
+ * from a sensor the watchdog faulted clears the fault before it is
+ * recorded. Pass NULL to detach.
+ *
+ * @param m   Manager
+ * @param wd  Initialised watchdog, or NULL
+ * @return true on success
+ */
+bool manager_attach_watchdog(manager_t *m, struct watchdog *wd);
+
 /**
  * @brief Log a reading for a specific sensor.
  *
- * Automatically checks thresholds and prints alerts if configured.
+ * Runs the sensor's filter chain, then automatically checks thresholds
+ * and anomaly detection on the filtered value and prints alerts if
+ * configured.
  *
  * @param m          Manager
  * @param id         Sensor ID
@@ -173,12 +303,28 @@ bool manager_set_thresholds(manager_t *m, uint8_t id,
 bool manager_log(manager_t *m, uint8_t id,
                  float value, uint32_t timestamp);
 
+/**
+ * @brief Log a batch of readings, each routed by its sensor_id.
+ *
+ * Equivalent to calling manager_log() for every entry in order; intended
+ * for ingestion paths (serial daemon, replay) that parse many readings
+ * per read() and want one call per batch instead of one per reading.
+ *
+ * @param m         Manager
+ * @param readings  Array of readings
+ * @param n         Number of readings
+ * @return          Number of readings accepted (rejected ones are skipped)
+ */
+size_t manager_log_batch(manager_t *m, const sensor_reading_t *readings,
+                         size_t n);
+
 /**
  * @brief Read the oldest entry from a specific sensor.
  * @param m       Manager
  * @param id      Sensor ID
  * @param output  Destination for the reading
- * @return true on success, false if empty or not registered
+ * @return true on success, false if empty, not registered or in
+ *         broadcast mode (read through a subscription instead)
  */
 bool manager_read(manager_t *m, uint8_t id, sensor_reading_t *output);
 
@@ -196,13 +342,17 @@ bool manager_resume_sensor(manager_t *m, uint8_t id);
 
 /**
  * @brief Flush one sensor's buffer and reset its statistics.
+ * @return true on success, false if not registered or in broadcast mode
  */
-void manager_flush_sensor(manager_t *m, uint8_t id);
+bool manager_flush_sensor(manager_t *m, uint8_t id);
 
 /**
  * @brief Flush ALL sensors at once.
+ *
+ * Sensors in broadcast mode are skipped with a warning.
+ * @return true if every registered sensor was flushed
  */
-void manager_flush_all(manager_t *m);
+bool manager_flush_all(manager_t *m);
 
 /**
  * @brief Check the current alert level for a sensor.
@@ -4,6 +4,7 @@
  */
 
 #include "sensors.h"
+#include "stage_timing.h"
 #include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
@@ -34,6 +35,12 @@ static void stats_reset(sensor_stats_t *stats)
  * ========================================================================== */
 
 bool sensor_init(sensor_t *sensor, uint8_t id, const char *name, size_t capacity)
+{
+    return sensor_init_in(sensor, id, name, capacity, NULL);
+}
+
+bool sensor_init_in(sensor_t *sensor, uint8_t id, const char *name,
+                    size_t capacity, arena_t *arena)
 {
     if (sensor == NULL || name == NULL || capacity == 0)
         return false;
@@ -44,11 +51,22 @@ bool sensor_init(sensor_t *sensor, uint8_t id, const char *name, size_t capacity
     strncpy(sensor->name, name, SENSOR_NAME_MAX - 1);
     sensor->name[SENSOR_NAME_MAX - 1] = '\0';
 
-    sensor->buf = buffer_create(capacity);
+    /* Ring header + storage from the arena when one is given */
+    sensor->bcast = NULL;
+    sensor->buf   = arena != NULL ? buffer_create_in(arena, capacity)
+                                  : buffer_create(capacity);
     if (sensor->buf == NULL)
         return false;
 
     stats_reset(&sensor->stats);
+    memset(&sensor->limits, 0, sizeof(sensor->limits));
+    filter_chain_init(&sensor->filter);
+    sensor->log_raw    = false;
+    sensor->filtering  = false;
+    sensor->detecting  = false;
+    sensor->last_value = 0.0f;
+    anomaly_init(&sensor->anomaly, NULL);
+    memset(&sensor->last_anomaly, 0, sizeof(sensor->last_anomaly));
     sensor->state = SENSOR_STATE_ACTIVE;
     return true;
 }
@@ -59,11 +77,38 @@ void sensor_destroy(sensor_t *sensor)
         return;
 
     buffer_destroy(sensor->buf);
+    broadcast_destroy(sensor->bcast);
     sensor->buf   = NULL;
+    sensor->bcast = NULL;
     sensor->state = SENSOR_STATE_UNINIT;
 }
 
 bool sensor_log(sensor_t *sensor, float value, uint32_t timestamp)
+{
+    if (sensor == NULL || sensor->buf == NULL)
+        return false;
+
+    if (sensor->state != SENSOR_STATE_ACTIVE)
+        return false;
+
+    return sensor_record(sensor, sensor_condition(sensor, value),
+                         value, timestamp);
+}
+
+float sensor_condition(sensor_t *sensor, float raw)
+{
+    /* Paused / faulted sensors must not advance their filter history */
+    if (sensor == NULL || sensor->state != SENSOR_STATE_ACTIVE)
+        return raw;
+
+    /* No stages: leave the filter chain's cold lines alone */
+    sensor->last_value = sensor->filtering
+                       ? filter_chain_process(&sensor->filter, raw) : raw;
+    return sensor->last_value;
+}
+
+bool sensor_record(sensor_t *sensor, float filtered, float raw,
+                   uint32_t timestamp)
 {
     if (sensor == NULL || sensor->buf == NULL)
         return false;
@@ -74,19 +119,75 @@ bool sensor_log(sensor_t *sensor, float value, uint32_t timestamp)
     sensor_reading_t r = {
         .timestamp = timestamp,
         .sensor_id = sensor->id,
-        .value     = value
+        .value     = sensor->log_raw ? raw : filtered
     };
 
-    if (!buffer_write(sensor->buf, &r))
+    /* Broadcast mode: publish for every subscriber instead of buffering */
+    uint64_t t = STAGE_BEGIN(STAGE_BUFFER_WRITE);
+    bool stored = (sensor->bcast != NULL)
+                ? broadcast_publish(sensor->bcast, &r)
+                : buffer_write(sensor->buf, &r);
+    STAGE_END(STAGE_BUFFER_WRITE, t);
+    if (!stored)
+        return false;
+
+    t = STAGE_BEGIN(STAGE_STATS);
+    stats_update(&sensor->stats, filtered);
+    STAGE_END(STAGE_STATS, t);
+
+    /* last_anomaly stays at ALERT_NONE while detection is off */
+    if (sensor->detecting)
+    {
+        sensor->last_anomaly.sensor_id = sensor->id;
+        sensor->last_anomaly.level     = anomaly_update(&sensor->anomaly, filtered);
+        sensor->last_anomaly.value     = filtered;
+        sensor->last_anomaly.timestamp = timestamp;
+    }
+    return true;
+}
+
+bool sensor_add_filter(sensor_t *sensor, const filter_stage_config_t *cfg)
+{
+    if (sensor == NULL)
+        return false;
+
+    if (!filter_chain_add(&sensor->filter, cfg))
         return false;
 
-    stats_update(&sensor->stats, value);
+    sensor->filtering = true;
     return true;
 }
 
+void sensor_clear_filters(sensor_t *sensor)
+{
+    if (sensor == NULL)
+        return;
+
+    filter_chain_init(&sensor->filter);
+    sensor->filtering = false;
+}
+
+void sensor_set_log_raw(sensor_t *sensor, bool log_raw)
+{
+    if (sensor == NULL)
+        return;
+
+    sensor->log_raw = log_raw;
+}
+
+bool sensor_enable_broadcast(sensor_t *sensor, size_t capacity)
+{
+    if (sensor == NULL || sensor->buf == NULL || sensor->bcast != NULL)
+        return false;
+
+    sensor->bcast = broadcast_create(capacity);
+    return sensor->bcast != NULL;
+}
+
+/* In broadcast mode the ring buffer is unused: read through a subscription */
 bool sensor_read(sensor_t *sensor, sensor_reading_t *output)
 {
-    if (sensor == NULL || output == NULL)
+    if (sensor == NULL || output == NULL || sensor->bcast != NULL)
         return false;
 
     return buffer_read(sensor->buf, output);
@@ -94,7 +195,7 @@ bool sensor_read(sensor_t *sensor, sensor_reading_t *output)
 
 bool sensor_peek(const sensor_t *sensor, sensor_reading_t *output)
 {
-    if (sensor == NULL || output == NULL)
+    if (sensor == NULL || output == NULL || sensor->bcast != NULL)
         return false;
 
     return buffer_peek(sensor->buf, output);
@@ -120,6 +221,32 @@ bool sensor_get_mean(const sensor_t *sensor, float *mean)
     return true;
 }
 
+bool sensor_set_anomaly(sensor_t *sensor, const anomaly_config_t *cfg)
+{
+    if (sensor == NULL || cfg == NULL)
+        return false;
+
+    if (cfg->enabled && (cfg->alpha <= 0.0f || cfg->alpha >= 1.0f ||
+                         cfg->min_sigma < 0.0f))
+        return false;
+
+    anomaly_init(&sensor->anomaly, cfg);
+    sensor->detecting          = cfg->enabled;
+    sensor->last_anomaly.level = ALERT_NONE;
+    return true;
+}
+
+alert_level_t sensor_last_anomaly(const sensor_t *sensor, alert_event_t *event)
+{
+    if (sensor == NULL)
+        return ALERT_NONE;
+
+    if (event != NULL)
+        *event = sensor->last_anomaly;
+
+    return sensor->last_anomaly.level;
+}
+
 bool sensor_pause(sensor_t *sensor)
 {
     if (sensor == NULL || sensor->state != SENSOR_STATE_ACTIVE)
@@ -138,13 +265,37 @@ bool sensor_resume(sensor_t *sensor)
     return true;
 }
 
-void sensor_flush(sensor_t *sensor)
+/* A fault rejects readings like a pause; only an active sensor can fault */
+bool sensor_fault(sensor_t *sensor)
 {
-    if (sensor == NULL)
-        return;
+    if (sensor == NULL || sensor->state != SENSOR_STATE_ACTIVE)
+        return false;
+
+    sensor->state = SENSOR_STATE_ERROR;
+    return true;
+}
+
+bool sensor_clear_fault(sensor_t *sensor)
+{
+    if (sensor == NULL || sensor->state != SENSOR_STATE_ERROR)
+        return false;
+
+    sensor->state = SENSOR_STATE_ACTIVE;
+    return true;
+}
+
+/* A broadcast ring cannot be cleared: each subscriber owns its cursor */
+bool sensor_flush(sensor_t *sensor)
+{
+    if (sensor == NULL || sensor->bcast != NULL)
+        return false;
 
     buffer_clear(sensor->buf);
     stats_reset(&sensor->stats);
+    filter_chain_reset(&sensor->filter);
+    anomaly_reset(&sensor->anomaly);
+    sensor->last_anomaly.level = ALERT_NONE;
+    return true;
 }
 
 void sensor_print_info(const sensor_t *sensor)
@@ -4,15 +4,40 @@
  *
  * Sits on top of the ring buffer. Each logical sensor has an ID, a human
  * readable name, and its own dedicated ring buffer. The layer handles
- * timestamping, min/max tracking, and formatted reporting.
+ * timestamping, signal conditioning, min/max tracking, anomaly detection,
+ * and formatted reporting.
+ *
+ * Every reading flows through the same pipeline:
+ *
+ *   raw -> filter chain -> ring buffer -> stats -> anomaly detector
+ *
+ * In broadcast mode (sensor_enable_broadcast) the ring buffer stage is
+ * replaced by a broadcast_ring_t, so several consumers can each read the
+ * full stream non-destructively instead of competing for buffer_read().
+ * sensor_read(), sensor_peek() and sensor_flush() then return false.
+ *
+ * sensor_log() runs the whole pipeline. Callers that need to act on the
+ * conditioned value before it is stored (e.g. threshold checks in the
+ * manager) call sensor_condition() and sensor_record() separately.
+ *
+ * sensor_t is split hot/cold. Its first cache line holds everything one
+ * reading needs when no filter or detector is configured (ring pointers,
+ * stats, threshold limits, state); the name, the filter chain and the
+ * anomaly detector follow and are only touched when in use. The ring's
+ * own indices live in its header, on the line just before its storage.
  */
 
 #ifndef SENSORS_H
 #define SENSORS_H
 
+#include "cacheline.h"
 #include "buffer.h"
+#include "anomaly.h"
+#include "filter.h"
+#include "broadcast.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 /* ============================================================================
  * CONFIGURATION
@@ -35,7 +60,7 @@ typedef enum {
     SENSOR_STATE_UNINIT = 0,    ///< Not yet initialised
     SENSOR_STATE_ACTIVE,        ///< Logging readings normally
     SENSOR_STATE_PAUSED,        ///< Temporarily stopped (buffer kept)
-    SENSOR_STATE_ERROR          ///< Fault condition
+    SENSOR_STATE_ERROR          ///< Fault condition (e.g. gone silent)
 } sensor_state_t;
 
 /**
@@ -52,27 +77,55 @@ typedef struct {
  * @brief A logical sensor with its own ring buffer and metadata
  */
 typedef struct {
-    uint8_t         id;                     ///< Unique sensor index
-    char            name[SENSOR_NAME_MAX];  ///< Human-readable label
-    sensor_state_t  state;                  ///< Current operational state
+    /* Hot: one cache line, read or written by every reading */
+    _Alignas(CACHE_LINE)
     ring_buffer_t  *buf;                    ///< Dedicated ring buffer
+    broadcast_ring_t *bcast;                ///< Broadcast ring (NULL = normal mode)
     sensor_stats_t  stats;                  ///< Running statistics
+    sensor_threshold_t limits;              ///< Alert thresholds (checked by the manager)
+    float           last_value;             ///< Conditioned value of the latest reading
+    sensor_state_t  state;                  ///< Current operational state
+    uint8_t         id;                     ///< Unique sensor index
+    bool            log_raw;                ///< Buffer raw instead of filtered values
+    bool            filtering;              ///< Filter chain has stages
+    bool            detecting;              ///< Anomaly detector enabled
+
+    /* Cold: metadata and optional stages, untouched unless configured */
+    char            name[SENSOR_NAME_MAX];  ///< Human-readable label
+    filter_chain_t  filter;                 ///< Conditioning applied to raw input
+    anomaly_detector_t anomaly;             ///< Baseline drift / jump detector
+    alert_event_t   last_anomaly;           ///< Verdict for the latest reading
 } sensor_t;
 
+_Static_assert(offsetof(sensor_t, name) == CACHE_LINE,
+               "sensor_t hot fields must fill exactly one cache line");
+
 /* ============================================================================
  * PUBLIC API
  * ========================================================================== */
 
 bool sensor_init(sensor_t *sensor, uint8_t id, const char *name, size_t capacity);
+bool sensor_init_in(sensor_t *sensor, uint8_t id, const char *name,
+                    size_t capacity, arena_t *arena);
 void sensor_destroy(sensor_t *sensor);
 bool sensor_log(sensor_t *sensor, float value, uint32_t timestamp);
+float sensor_condition(sensor_t *sensor, float raw);
+bool sensor_record(sensor_t *sensor, float filtered, float raw, uint32_t timestamp);
+bool sensor_add_filter(sensor_t *sensor, const filter_stage_config_t *cfg);
+void sensor_clear_filters(sensor_t *sensor);
+void sensor_set_log_raw(sensor_t *sensor, bool log_raw);
+bool sensor_enable_broadcast(sensor_t *sensor, size_t capacity);
 bool sensor_read(sensor_t *sensor, sensor_reading_t *output);
 bool sensor_peek(const sensor_t *sensor, sensor_reading_t *output);
 bool sensor_get_stats(const sensor_t *sensor, sensor_stats_t *stats);
 bool sensor_get_mean(const sensor_t *sensor, float *mean);
+bool sensor_set_anomaly(sensor_t *sensor, const anomaly_config_t *cfg);
+alert_level_t sensor_last_anomaly(const sensor_t *sensor, alert_event_t *event);
 bool sensor_pause(sensor_t *sensor);
 bool sensor_resume(sensor_t *sensor);
-void sensor_flush(sensor_t *sensor);
+bool sensor_fault(sensor_t *sensor);
+bool sensor_clear_fault(sensor_t *sensor);
+bool sensor_flush(sensor_t *sensor);
 void sensor_print_info(const sensor_t *sensor);
 
 #endif /* SENSORS_H */
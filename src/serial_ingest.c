@@ -0,0 +1,313 @@
+/**
+ * @file serial_ingest.c
+ * @brief Multi-device serial ingestion implementation (Linux, epoll)
+ *
+ * Reads are edge-triggered: on every event a device is read until
+ * read() reports EAGAIN, so no data is left behind waiting for an event
+ * that will never come.
+ */
+
+#define _DEFAULT_SOURCE     /* cfmakeraw, B-rates beyond POSIX */
+
+#include "serial_ingest.h"
+#include "diag.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+static speed_t baud_constant(uint32_t baud)
+{
+    switch (baud)
+    {
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    default:     return 0;
+    }
+}
+
+/** Raw 8N1, no echo, no line discipline. Non-terminals are left alone. */
+static bool configure_tty(int fd, uint32_t baud)
+{
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0)
+        return errno == ENOTTY;          /* pipe / file: nothing to set */
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    /* VMIN 1: an empty non-blocking read gives EAGAIN, not a 0 (= EOF) */
+    tio.c_cc[VMIN]  = 1;
+    tio.c_cc[VTIME] = 0;
+
+    if (baud != 0)
+    {
+        speed_t sp = baud_constant(baud);
+        if (sp == 0)
+            return false;
+        cfsetispeed(&tio, sp);
+        cfsetospeed(&tio, sp);
+    }
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+static void remove_device(serial_ingest_t *in, int idx)
+{
+    ingest_device_t *d = &in->devices[idx];
+    epoll_ctl(in->epfd, EPOLL_CTL_DEL, d->fd, NULL);
+    close(d->fd);
+    d->fd = -1;
+    in->open_count--;
+    if (d->binary)
+        DIAG_INFO("INGEST", "Device %d closed (%" PRIu64 " readings, %" PRIu64
+                  " CRC errors, %" PRIu64 " bytes skipped)", idx,
+                  d->frames.samples, d->frames.crc_errors, d->frames.skipped);
+    else
+        DIAG_INFO("INGEST", "Device %d closed (%" PRIu64 " readings, %" PRIu64
+                  " bad lines)", idx, d->parser.rows, d->parser.bad);
+}
+
+static void flush_batch(serial_ingest_t *in)
+{
+    if (in->batch_len == 0)
+        return;
+
+    /* Keep only what the manager accepted, as the manager saw it */
+    size_t ok = 0;
+    for (size_t i = 0; i < in->batch_len; i++)
+    {
+        sensor_reading_t r = in->batch[i];
+        if (!manager_log(in->m, r.sensor_id, r.value, r.timestamp))
+            continue;
+        r.value         = in->m->sensors[r.sensor_id].last_value;
+        in->alerts[ok]  = manager_check_threshold(in->m, r.sensor_id, r.value);
+        in->batch[ok++] = r;
+    }
+    in->accepted += ok;
+    in->rejected += in->batch_len - ok;
+
+    if (in->sink != NULL)
+        in->sink(in->m, in->batch, in->alerts, ok, in->sink_ctx);
+    in->batch_len = 0;
+}
+
+/**
+ * @brief Read a device dry and parse every complete line.
+ * @return false if the device hung up or failed
+ */
+static bool drain_device(serial_ingest_t *in, ingest_device_t *d)
+{
+    char buf[INGEST_READ_SIZE];
+
+    for (;;)
+    {
+        ssize_t n = read(d->fd, buf, sizeof(buf));
+        if (n < 0)
+            return errno == EAGAIN || errno == EINTR;
+        if (n == 0)
+            return false;                   /* EOF */
+
+        d->bytes += (uint64_t)n;
+
+        /* The decoder keeps any partial tail; loop only when the batch
+         * fills. A frame needs room for all its samples at once. */
+        size_t used = 0;
+        while (used < (size_t)n)
+        {
+            if (INGEST_BATCH - in->batch_len < FRAME_MAX_SAMPLES)
+                flush_batch(in);
+
+            size_t consumed;
+            sensor_reading_t *dst = in->batch + in->batch_len;
+            size_t room = INGEST_BATCH - in->batch_len;
+
+            if (d->binary)
+                in->batch_len += frame_decode(&d->frames,
+                                              (const uint8_t *)buf + used,
+                                              (size_t)n - used, dst, room,
+                                              &consumed);
+            else
+                in->batch_len += csv_parse_chunk(&d->parser, buf + used,
+                                                 (size_t)n - used, dst, room,
+                                                 &consumed);
+            used += consumed;
+        }
+    }
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+bool ingest_init(serial_ingest_t *in, manager_t *m)
+{
+    if (in == NULL || m == NULL)
+        return false;
+
+    memset(in, 0, sizeof(*in));
+    for (int i = 0; i < INGEST_MAX_DEVICES; i++)
+        in->devices[i].fd = -1;
+
+    in->m    = m;
+    in->epfd = epoll_create1(EPOLL_CLOEXEC);
+    return in->epfd >= 0;
+}
+
+void ingest_close(serial_ingest_t *in)
+{
+    if (in == NULL || in->epfd < 0)
+        return;
+
+    flush_batch(in);
+    for (int i = 0; i < INGEST_MAX_DEVICES; i++)
+    {
+        if (in->devices[i].fd >= 0)
+            remove_device(in, i);
+    }
+    close(in->epfd);
+    in->epfd = -1;
+}
+
+int ingest_add_fd(serial_ingest_t *in, int fd)
+{
+    if (in == NULL || fd < 0)
+        return -1;
+
+    int idx = -1;
+    for (int i = 0; i < INGEST_MAX_DEVICES; i++)
+    {
+        if (in->devices[i].fd < 0)
+        {
+            idx = i;
+            break;
+        }
+    }
+    if (idx < 0)
+        return -1;
+
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+        return -1;
+
+    struct epoll_event ev = { .events = EPOLLIN | EPOLLET | EPOLLRDHUP,
+                              .data.u32 = (uint32_t)idx };
+    if (epoll_ctl(in->epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+        return -1;
+
+    ingest_device_t *d = &in->devices[idx];
+    memset(d, 0, sizeof(*d));
+    d->fd = fd;
+    csv_parser_init(&d->parser, in->dict);
+    in->open_count++;
+    return idx;
+}
+
+int ingest_add_device(serial_ingest_t *in, const char *path, uint32_t baud)
+{
+    if (in == NULL || path == NULL)
+        return -1;
+
+    int fd = open(path, O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        DIAG_ERROR("INGEST", "Cannot open %s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    if (!configure_tty(fd, baud))
+    {
+        DIAG_ERROR("INGEST", "Cannot configure %s at %u baud", path, baud);
+        close(fd);
+        return -1;
+    }
+
+    int idx = ingest_add_fd(in, fd);
+    if (idx < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    DIAG_INFO("INGEST", "Device %d: %s", idx, path);
+    return idx;
+}
+
+void ingest_set_sink(serial_ingest_t *in, ingest_sink_t sink, void *ctx)
+{
+    if (in == NULL)
+        return;
+
+    in->sink     = sink;
+    in->sink_ctx = ctx;
+}
+
+frame_decoder_t *ingest_set_binary(serial_ingest_t *in, int idx)
+{
+    if (in == NULL || idx < 0 || idx >= INGEST_MAX_DEVICES ||
+        in->devices[idx].fd < 0)
+        return NULL;
+
+    ingest_device_t *d = &in->devices[idx];
+    d->binary = true;
+    frame_decoder_init(&d->frames);
+    return &d->frames;
+}
+
+void ingest_set_dict(serial_ingest_t *in, const csv_dict_t *dict)
+{
+    if (in == NULL)
+        return;
+
+    in->dict = dict;
+    for (int i = 0; i < INGEST_MAX_DEVICES; i++)
+        in->devices[i].parser.dict = dict;
+}
+
+int ingest_poll(serial_ingest_t *in, int timeout_ms)
+{
+    if (in == NULL || in->epfd < 0)
+        return -1;
+
+    struct epoll_event events[INGEST_MAX_DEVICES];
+    int n = epoll_wait(in->epfd, events, INGEST_MAX_DEVICES, timeout_ms);
+    if (n < 0)
+        return (errno == EINTR) ? 0 : -1;
+
+    uint64_t before = in->accepted;
+    for (int i = 0; i < n; i++)
+    {
+        int idx = (int)events[i].data.u32;
+        ingest_device_t *d = &in->devices[idx];
+        if (d->fd < 0)
+            continue;
+
+        /* Read first: a board may send its last lines and then hang up */
+        bool alive = drain_device(in, d);
+        if (!alive || (events[i].events & (EPOLLHUP | EPOLLERR | EPOLLRDHUP)))
+            remove_device(in, idx);
+    }
+
+    flush_batch(in);
+    return (int)(in->accepted - before);
+}
+
+bool ingest_parse_line(const char *line, sensor_reading_t *out)
+{
+    if (line == NULL || out == NULL)
+        return false;
+
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    return csv_parse_line(&p, line, strlen(line), out);
+}
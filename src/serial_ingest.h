@@ -0,0 +1,184 @@
+/**
+ * @file serial_ingest.h
+ * @brief Multi-device serial ingestion (Linux, epoll)
+ *
+ * Reads the Arduino's CSV stream straight from serial ports (or any
+ * character device, e.g. a pseudo-terminal in tests) into a manager.
+ * Every device is non-blocking and registered with one epoll instance,
+ * so a single thread serves any number of boards:
+ *
+ *   serial_ingest_t in;
+ *   ingest_init(&in, m);
+ *   ingest_add_device(&in, "/dev/ttyACM0", 9600);
+ *   ingest_add_device(&in, "/dev/ttyACM1", 9600);
+ *   while (running)
+ *       ingest_poll(&in, 1000);
+ *   ingest_close(&in);
+ *
+ * Lines look like send_csv_row() output:
+ *
+ *   timestamp,sensor_id,sensor_name,value,alert_level
+ *   88,0,Temperature (C),23.6000,NONE
+ *
+ * Each device owns a csv_parser_t, so a line split across reads is
+ * completed on the next one. Complete lines are parsed straight out of
+ * the read buffer and collected into a batch that goes to
+ * manager_log_batch() once per poll round. Header and '#' comment lines
+ * are skipped; anything else that does not parse is counted as a bad
+ * line. With ingest_set_dict() the sensor_name column, not the board's
+ * sensor_id, decides which sensor a row is logged to.
+ *
+ * Boards running the binary protocol (frame.h) are switched over per
+ * device with ingest_set_binary(); both kinds can share one ingester.
+ *
+ * The alert_level column is ignored - the manager re-evaluates every
+ * reading against its own thresholds.
+ */
+
+#ifndef SERIAL_INGEST_H
+#define SERIAL_INGEST_H
+
+#include "sensor_manager.h"
+#include "csv_parser.h"
+#include "frame.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum devices multiplexed by one ingester */
+#define INGEST_MAX_DEVICES  16
+
+/** @brief Bytes requested per read() */
+#define INGEST_READ_SIZE    1024
+
+/** @brief Readings collected before a manager_log_batch() call */
+#define INGEST_BATCH        256
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Called with every batch after the manager has logged it
+ *
+ * Lets the caller write the readings to CSV, forward them, etc. Only the
+ * readings the manager accepted are passed, each carrying the conditioned
+ * value the manager checked; alerts[i] is its threshold verdict for
+ * batch[i].
+ */
+typedef void (*ingest_sink_t)(manager_t *m, const sensor_reading_t *batch,
+                              const alert_level_t *alerts, size_t n,
+                              void *ctx);
+
+/**
+ * @brief Per-device state
+ */
+typedef struct {
+    int          fd;                    ///< -1 when the slot is closed
+    bool         binary;                ///< Framed protocol instead of CSV
+    csv_parser_t parser;                ///< Partial line + rows/bad counters
+    frame_decoder_t frames;             ///< Partial frame + CRC/resync counters
+    uint64_t     bytes;                 ///< Bytes read
+} ingest_device_t;
+
+/**
+ * @brief The ingester (caller-allocated, see ingest_init)
+ */
+typedef struct {
+    int              epfd;                          ///< epoll instance
+    manager_t       *m;                             ///< Destination manager
+    const csv_dict_t *dict;                         ///< Name -> ID map (optional)
+    ingest_device_t  devices[INGEST_MAX_DEVICES];
+    uint8_t          open_count;                    ///< Devices still open
+    sensor_reading_t batch[INGEST_BATCH];
+    alert_level_t    alerts[INGEST_BATCH];              ///< Verdicts for the sink
+    size_t           batch_len;
+    ingest_sink_t    sink;
+    void            *sink_ctx;
+    uint64_t         accepted;                      ///< Logged by the manager
+    uint64_t         rejected;                      ///< Parsed but refused
+} serial_ingest_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Initialise an ingester that feeds manager `m`.
+ * @return true on success (false if epoll could not be created)
+ */
+bool ingest_init(serial_ingest_t *in, manager_t *m);
+
+/**
+ * @brief Close every device and the epoll instance.
+ */
+void ingest_close(serial_ingest_t *in);
+
+/**
+ * @brief Open a serial device (or pty) and add it to the poll set.
+ *
+ * Terminals are switched to raw 8N1 at `baud`; pass 0 to keep the
+ * current line settings (e.g. for pipes or pre-configured ports).
+ *
+ * @return Device index, or -1 on failure
+ */
+int ingest_add_device(serial_ingest_t *in, const char *path, uint32_t baud);
+
+/**
+ * @brief Add an already-open descriptor (made non-blocking; owned after).
+ * @return Device index, or -1 on failure
+ */
+int ingest_add_fd(serial_ingest_t *in, int fd);
+
+/**
+ * @brief Install a callback that sees every logged batch (see ingest_sink_t).
+ */
+void ingest_set_sink(serial_ingest_t *in, ingest_sink_t sink, void *ctx);
+
+/**
+ * @brief Decode device `idx` as binary frames (see frame.h) instead of CSV.
+ *
+ * Returns the device's decoder so the caller can set per-sensor scales
+ * with frame_set_scale(). The dictionary does not apply to binary
+ * devices - frames carry the sensor ID.
+ *
+ * @return The decoder, or NULL if idx is not an open device
+ */
+frame_decoder_t *ingest_set_binary(serial_ingest_t *in, int idx);
+
+/**
+ * @brief Resolve sensor IDs from the sensor_name column.
+ *
+ * Applies to devices already open and to those added later. Rows whose
+ * name is not in `dict` are dropped (counted in parser.unknown_names).
+ * The dictionary must outlive the ingester; NULL restores the default of
+ * trusting the sensor_id column.
+ */
+void ingest_set_dict(serial_ingest_t *in, const csv_dict_t *dict);
+
+/**
+ * @brief Wait up to `timeout_ms` for data, read every ready device dry,
+ *        and log what was parsed.
+ *
+ * Devices that hang up (board unplugged, pty closed) are removed.
+ *
+ * @return Readings accepted by the manager this round, -1 on epoll error
+ */
+int ingest_poll(serial_ingest_t *in, int timeout_ms);
+
+/**
+ * @brief Parse one NUL-terminated line (a trailing '\r' is allowed).
+ *
+ * Convenience wrapper around csv_parse_line() without a dictionary.
+ *
+ * @param line  Line text without the newline
+ * @param out   Destination (sensor_id, timestamp, value)
+ * @return true for a data row, false for header/comment/malformed lines
+ */
+bool ingest_parse_line(const char *line, sensor_reading_t *out);
+
+#endif /* SERIAL_INGEST_H */
@@ -0,0 +1,261 @@
+/**
+ * @file sharded_manager.c
+ * @brief Multi-producer ingestion implementation
+ *
+ * The combiner (stats, totals, reads, reports) locks one shard at a time
+ * and never holds two locks at once, so it can neither deadlock with a
+ * producer nor stall more than one producer for longer than a single
+ * shard snapshot takes.
+ */
+
+#include "sharded_manager.h"
+#include "cacheline.h"
+#include "diag.h"
+#include <float.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+sharded_manager_t *sharded_create(uint8_t shards, uint8_t capacity)
+{
+    if (shards == 0 || shards > SHARDED_MAX_SHARDS)
+    {
+        DIAG_ERROR("SHARDED", "shards must be 1..%d, got %u",
+                   SHARDED_MAX_SHARDS, shards);
+        return NULL;
+    }
+
+    sharded_manager_t *sm = malloc(sizeof(*sm));
+    if (sm == NULL)
+        return NULL;
+
+    sm->shards = cache_alloc(sizeof(manager_shard_t) * shards);
+    if (sm->shards == NULL)
+    {
+        free(sm);
+        return NULL;
+    }
+
+    sm->shard_count = 0;
+    sm->capacity    = capacity;
+
+    for (uint8_t i = 0; i < shards; i++)
+    {
+        manager_shard_t *sh = &sm->shards[i];
+        sh->m = manager_create(capacity);
+        if (sh->m == NULL || pthread_mutex_init(&sh->lock, NULL) != 0)
+        {
+            manager_destroy(sh->m);
+            sharded_destroy(sm);
+            return NULL;
+        }
+        sm->shard_count++;
+    }
+
+    return sm;
+}
+
+void sharded_destroy(sharded_manager_t *sm)
+{
+    if (sm == NULL)
+        return;
+
+    for (uint8_t i = 0; i < sm->shard_count; i++)
+    {
+        pthread_mutex_destroy(&sm->shards[i].lock);
+        manager_destroy(sm->shards[i].m);
+    }
+
+    cache_free(sm->shards);
+    free(sm);
+}
+
+bool sharded_register(sharded_manager_t *sm, uint8_t id,
+                      const char *name, size_t buf_size)
+{
+    if (sm == NULL)
+        return false;
+
+    for (uint8_t i = 0; i < sm->shard_count; i++)
+    {
+        if (!manager_register(sm->shards[i].m, id, name, buf_size))
+            return false;
+    }
+    return true;
+}
+
+bool sharded_set_thresholds(sharded_manager_t *sm, uint8_t id,
+                            sensor_threshold_t thresholds)
+{
+    if (sm == NULL)
+        return false;
+
+    for (uint8_t i = 0; i < sm->shard_count; i++)
+    {
+        if (!manager_set_thresholds(sm->shards[i].m, id, thresholds))
+            return false;
+    }
+    return true;
+}
+
+manager_t *sharded_shard(sharded_manager_t *sm, uint8_t shard)
+{
+    if (sm == NULL || shard >= sm->shard_count)
+        return NULL;
+
+    return sm->shards[shard].m;
+}
+
+bool sharded_log(sharded_manager_t *sm, uint8_t shard, uint8_t id,
+                 float value, uint32_t timestamp)
+{
+    if (sm == NULL || shard >= sm->shard_count)
+        return false;
+
+    manager_shard_t *sh = &sm->shards[shard];
+
+    pthread_mutex_lock(&sh->lock);
+    bool ok = manager_log(sh->m, id, value, timestamp);
+    pthread_mutex_unlock(&sh->lock);
+    return ok;
+}
+
+bool sharded_read(sharded_manager_t *sm, uint8_t id, sensor_reading_t *output)
+{
+    if (sm == NULL || output == NULL || id >= sm->capacity)
+        return false;
+
+    /*
+     * Two passes: find the shard holding the oldest head, then consume
+     * from it. If its producer was flushed in between, retry the scan.
+     */
+    for (;;)
+    {
+        int      best    = -1;
+        uint32_t best_ts = 0;
+
+        for (uint8_t i = 0; i < sm->shard_count; i++)
+        {
+            manager_shard_t *sh = &sm->shards[i];
+            sensor_reading_t head;
+
+            pthread_mutex_lock(&sh->lock);
+            bool have = sh->m->registered[id] &&
+                        sensor_peek(&sh->m->sensors[id], &head);
+            pthread_mutex_unlock(&sh->lock);
+
+            if (have && (best < 0 || head.timestamp < best_ts))
+            {
+                best    = i;
+                best_ts = head.timestamp;
+            }
+        }
+
+        if (best < 0)
+            return false;
+
+        manager_shard_t *sh = &sm->shards[best];
+        pthread_mutex_lock(&sh->lock);
+        bool ok = manager_read(sh->m, id, output);
+        pthread_mutex_unlock(&sh->lock);
+
+        if (ok)
+            return true;
+    }
+}
+
+bool sharded_get_stats(sharded_manager_t *sm, uint8_t id, sensor_stats_t *stats)
+{
+    if (sm == NULL || stats == NULL || id >= sm->capacity)
+        return false;
+
+    sensor_stats_t merged = { .min = FLT_MAX, .max = -FLT_MAX,
+                              .sum = 0.0f, .sample_count = 0 };
+    bool found = false;
+
+    for (uint8_t i = 0; i < sm->shard_count; i++)
+    {
+        manager_shard_t *sh = &sm->shards[i];
+        sensor_stats_t part;
+
+        pthread_mutex_lock(&sh->lock);
+        bool ok = sh->m->registered[id] &&
+                  sensor_get_stats(&sh->m->sensors[id], &part);
+        pthread_mutex_unlock(&sh->lock);
+
+        if (!ok)
+            continue;
+
+        found = true;
+        if (part.sample_count == 0)
+            continue;
+
+        if (part.min < merged.min) merged.min = part.min;
+        if (part.max > merged.max) merged.max = part.max;
+        merged.sum          += part.sum;
+        merged.sample_count += part.sample_count;
+    }
+
+    if (!found)
+        return false;
+
+    *stats = merged;
+    return true;
+}
+
+void sharded_get_totals(sharded_manager_t *sm, sharded_totals_t *totals)
+{
+    if (totals == NULL)
+        return;
+
+    totals->logs = totals->alerts = totals->anomalies = totals->overflows = 0;
+    if (sm == NULL)
+        return;
+
+    for (uint8_t i = 0; i < sm->shard_count; i++)
+    {
+        manager_shard_t *sh = &sm->shards[i];
+
+        pthread_mutex_lock(&sh->lock);
+        totals->logs      += sh->m->total_logs;
+        totals->alerts    += sh->m->total_alerts;
+        totals->anomalies += sh->m->total_anomalies;
+        for (uint8_t id = 0; id < sh->m->capacity; id++)
+        {
+            if (sh->m->registered[id])
+                totals->overflows += buffer_overflow_count(sh->m->sensors[id].buf);
+        }
+        pthread_mutex_unlock(&sh->lock);
+    }
+}
+
+void sharded_print_stats(sharded_manager_t *sm)
+{
+    if (sm == NULL)
+        return;
+
+    sharded_totals_t t;
+    sharded_get_totals(sm, &t);
+
+    printf("\n--- Sharded Manager Statistics ---\n");
+    printf("  Producer shards    : %u\n", sm->shard_count);
+    printf("  Total readings     : %" PRIu64 "\n", t.logs);
+    printf("  Total alerts fired : %" PRIu64 "\n", t.alerts);
+    printf("  Anomalies flagged  : %" PRIu64 "\n", t.anomalies);
+    printf("  Buffer overflows   : %" PRIu64 "\n", t.overflows);
+
+    for (uint8_t id = 0; id < sm->capacity; id++)
+    {
+        sensor_stats_t st;
+        if (!sharded_get_stats(sm, id, &st) || st.sample_count == 0)
+            continue;
+        printf("    Sensor id=%u: n=%" PRIu32 " min=%.2f max=%.2f mean=%.2f\n",
+               id, st.sample_count, st.min, st.max,
+               st.sum / (float)st.sample_count);
+    }
+    printf("----------------------------------\n");
+}
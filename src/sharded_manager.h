@@ -0,0 +1,158 @@
+/**
+ * @file sharded_manager.h
+ * @brief Multi-producer ingestion on top of the sensor manager
+ *
+ * manager_t is single-threaded: its counters, stats and ring indices are
+ * plain fields. Rather than putting a lock (or an atomic) on every one of
+ * them, the sharded manager gives each producer thread its OWN manager_t
+ * - its own rings, filters, stats and counters - and merges the shards
+ * only when somebody asks for a combined view.
+ *
+ *   sharded_manager_t *sm = sharded_create(4, 3);  // 4 producers, 3 sensors
+ *   sharded_register(sm, 0, "Temperature", 256);   // registered in every shard
+ *
+ *   // producer thread k only ever touches shard k
+ *   sharded_log(sm, k, 0, 21.5f, now());
+ *
+ *   // any thread: combined stats / reads / report
+ *   sharded_get_stats(sm, 0, &stats);
+ *   sharded_read(sm, 0, &reading);                 // oldest across shards
+ *   sharded_print_stats(sm);
+ *
+ * Each shard carries a mutex that its producer takes around every log.
+ * No two producers ever share one, so on the hot path the lock is always
+ * uncontended; it only exists so the combiner can take a consistent
+ * snapshot of a shard while that producer is running.
+ *
+ * Per-sensor state (filter history, anomaly baseline) is per shard, so
+ * each sensor should be fed by one producer at a time - the common case
+ * where every thread owns a device or a set of channels.
+ */
+
+#ifndef SHARDED_MANAGER_H
+#define SHARDED_MANAGER_H
+
+#include "sensor_manager.h"
+#include "cacheline.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Maximum number of producer shards */
+#define SHARDED_MAX_SHARDS  64
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief One producer's private manager plus the lock the combiner uses
+ *
+ * Aligned to a cache line so two producers never false-share a lock word.
+ */
+typedef struct {
+    _Alignas(CACHE_LINE) pthread_mutex_t lock;  ///< Held by the producer while logging
+    manager_t      *m;                  ///< This producer's manager
+} manager_shard_t;
+
+/**
+ * @brief Combined counters across all shards
+ */
+typedef struct {
+    uint64_t logs;       ///< Sum of total_logs
+    uint64_t alerts;     ///< Sum of total_alerts
+    uint64_t anomalies;  ///< Sum of total_anomalies
+    uint64_t overflows;  ///< Sum of ring buffer overflow counts
+} sharded_totals_t;
+
+/**
+ * @brief A set of per-producer manager shards
+ */
+typedef struct {
+    manager_shard_t *shards;    ///< Array of shard_count shards
+    uint8_t          shard_count;
+    uint8_t          capacity;  ///< Sensors per shard
+} sharded_manager_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Create one manager per producer.
+ *
+ * @param shards    Number of producer threads (1 .. SHARDED_MAX_SHARDS)
+ * @param capacity  Sensors per manager (1 .. MANAGER_MAX_SENSORS)
+ * @return          New sharded manager, NULL on failure
+ */
+sharded_manager_t *sharded_create(uint8_t shards, uint8_t capacity);
+
+/**
+ * @brief Destroy every shard. Producers must have stopped.
+ * @param sm  Sharded manager (NULL is safe)
+ */
+void sharded_destroy(sharded_manager_t *sm);
+
+/**
+ * @brief Register a sensor in every shard (setup time, single-threaded).
+ * @return true if every shard accepted it
+ */
+bool sharded_register(sharded_manager_t *sm, uint8_t id,
+                      const char *name, size_t buf_size);
+
+/**
+ * @brief Apply the same thresholds to a sensor in every shard.
+ * @return true if every shard accepted them
+ */
+bool sharded_set_thresholds(sharded_manager_t *sm, uint8_t id,
+                            sensor_threshold_t thresholds);
+
+/**
+ * @brief Access one shard's manager for any other per-sensor setup
+ *        (filters, anomaly detection, ...). Setup time only.
+ * @return The shard's manager, NULL if out of range
+ */
+manager_t *sharded_shard(sharded_manager_t *sm, uint8_t shard);
+
+/**
+ * @brief Log a reading from producer `shard`.
+ *
+ * Only the thread that owns `shard` may call this for that shard.
+ *
+ * @return Same as manager_log()
+ */
+bool sharded_log(sharded_manager_t *sm, uint8_t shard, uint8_t id,
+                 float value, uint32_t timestamp);
+
+/**
+ * @brief Read the oldest buffered reading for a sensor across all shards.
+ *
+ * Peeks each shard and consumes the one with the smallest timestamp, so
+ * repeated calls return the merged stream in time order.
+ *
+ * @return true if a reading was returned, false if all shards are empty
+ */
+bool sharded_read(sharded_manager_t *sm, uint8_t id, sensor_reading_t *output);
+
+/**
+ * @brief Merge one sensor's running statistics across all shards.
+ * @return true on success, false if the sensor is not registered
+ */
+bool sharded_get_stats(sharded_manager_t *sm, uint8_t id, sensor_stats_t *stats);
+
+/**
+ * @brief Sum the manager counters of every shard.
+ */
+void sharded_get_totals(sharded_manager_t *sm, sharded_totals_t *totals);
+
+/**
+ * @brief Print the combined manager statistics.
+ */
+void sharded_print_stats(sharded_manager_t *sm);
+
+#endif /* SHARDED_MANAGER_H */
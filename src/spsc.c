@@ -0,0 +1,90 @@
+/**
+ * @file spsc.c
+ * @brief Lock-free single-producer / single-consumer queue implementation
+ *
+ * head and tail are free-running counters; slot = counter & mask. The
+ * producer writes the slot, then stores tail with release. The consumer
+ * loads tail with acquire before reading slots, then stores head with
+ * release so the producer (acquire) may reuse them.
+ */
+
+#include "spsc.h"
+
+spsc_queue_t *spsc_create(size_t capacity)
+{
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return NULL;
+
+    spsc_queue_t *q = cache_alloc(sizeof(spsc_queue_t));
+    if (q == NULL)
+        return NULL;
+
+    q->slots = cache_alloc(capacity * sizeof(sensor_reading_t));
+    if (q->slots == NULL)
+    {
+        cache_free(q);
+        return NULL;
+    }
+
+    q->mask       = capacity - 1;
+    q->tail_cache = 0;
+    q->head_cache = 0;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    return q;
+}
+
+void spsc_destroy(spsc_queue_t *q)
+{
+    if (q == NULL)
+        return;
+
+    cache_free(q->slots);
+    cache_free(q);
+}
+
+bool spsc_push(spsc_queue_t *q, const sensor_reading_t *r)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+
+    if (tail - q->head_cache > q->mask)
+    {
+        q->head_cache = atomic_load_explicit(&q->head, memory_order_acquire);
+        if (tail - q->head_cache > q->mask)
+            return false;
+    }
+
+    q->slots[tail & q->mask] = *r;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+size_t spsc_pop_batch(spsc_queue_t *q, sensor_reading_t *out, size_t max)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    /* Refresh only when the cached view cannot fill the whole batch */
+    if (q->tail_cache - head < max)
+    {
+        q->tail_cache = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (q->tail_cache == head)
+            return 0;
+    }
+
+    size_t n = q->tail_cache - head;
+    if (n > max)
+        n = max;
+
+    for (size_t i = 0; i < n; i++)
+        out[i] = q->slots[(head + i) & q->mask];
+
+    atomic_store_explicit(&q->head, head + n, memory_order_release);
+    return n;
+}
+
+size_t spsc_size(spsc_queue_t *q)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    return tail - head;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file spsc.h
+ * @brief Lock-free single-producer / single-consumer reading queue
+ *
+ * The hand-off between an ingestion thread and one worker. Exactly one
+ * thread may push and exactly one (other) thread may pop; with that
+ * restriction neither side ever takes a lock or a CAS - each just
+ * publishes its own index with a release store.
+ *
+ * Each side keeps a private copy of the other side's index and only
+ * reloads the shared one when its copy says the queue is full (producer)
+ * or empty (consumer), so in steady state a push or pop touches only
+ * cache lines its own thread owns.
+ */
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include "buffer.h"     /* sensor_reading_t */
+#include "cacheline.h"  /* CACHE_LINE */
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief SPSC queue of readings (allocate with spsc_create)
+ */
+typedef struct {
+    sensor_reading_t *slots;    ///< capacity entries
+    size_t            mask;     ///< capacity - 1 (capacity is a power of two)
+
+    _Alignas(CACHE_LINE)
+    _Atomic size_t    head;     ///< Next slot to pop (written by consumer)
+    size_t            tail_cache; ///< Consumer's copy of tail
+
+    _Alignas(CACHE_LINE)
+    _Atomic size_t    tail;     ///< Next slot to push (written by producer)
+    size_t            head_cache; ///< Producer's copy of head
+} spsc_queue_t;
+
+/**
+ * @brief Allocate a queue.
+ * @param capacity  Number of slots, must be a power of two
+ * @return          New queue, NULL on failure or bad capacity
+ */
+spsc_queue_t *spsc_create(size_t capacity);
+
+/** @brief Free a queue (NULL is safe). Both sides must have stopped. */
+void spsc_destroy(spsc_queue_t *q);
+
+/**
+ * @brief Enqueue one reading (producer thread only).
+ * @return false if the queue is full
+ */
+bool spsc_push(spsc_queue_t *q, const sensor_reading_t *r);
+
+/**
+ * @brief Dequeue up to `max` readings in FIFO order (consumer thread only).
+ * @return Number of readings copied to `out` (0 if empty)
+ */
+size_t spsc_pop_batch(spsc_queue_t *q, sensor_reading_t *out, size_t max);
+
+/**
+ * @brief Approximate number of queued readings (exact when quiescent).
+ */
+size_t spsc_size(spsc_queue_t *q);
+
+#endif /* SPSC_H */
@@ -0,0 +1,131 @@
+/**
+ * @file stage_timing.h
+ * @brief Optional per-stage latency hooks on the logging hot path
+ *
+ * The totals kept by the manager and logger say how much work was done,
+ * not where the time went. Built with -DSTAGE_TIMING (make STAGE_TIMING=1)
+ * the pipeline times four stages into per-thread histograms:
+ *
+ *   STAGE_THRESHOLD     evaluate_threshold() in manager_log()
+ *   STAGE_BUFFER_WRITE  buffer_write() / broadcast_publish() in sensor_record()
+ *   STAGE_STATS         stats_update() in sensor_record()
+ *   STAGE_LOGGER        logger_write(), formatting and flush
+ *
+ * Without the flag the hooks expand to nothing and the pipeline compiles
+ * exactly as before.
+ *
+ * With it, one call in 2^STAGE_SAMPLE_SHIFT per stage and thread is timed
+ * (two clock reads, ~30 ns each); the others pay a thread-local counter
+ * increment and a branch. Each thread gets its own set of histograms on
+ * its first timed call and records into them without locks, so
+ * producers on different cores never share a cache line. Reporting
+ * merges every thread's set:
+ *
+ *   uint64_t t = STAGE_BEGIN(STAGE_STATS);
+ *   stats_update(&sensor->stats, filtered);
+ *   STAGE_END(STAGE_STATS, t);
+ *   ...
+ *   stage_timing_print();
+ *
+ * A thread's histograms stay registered after it exits so its samples
+ * still count in the totals.
+ */
+
+#ifndef STAGE_TIMING_H
+#define STAGE_TIMING_H
+
+#include "histogram.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief Time one call in 2^STAGE_SAMPLE_SHIFT (0 = every call) */
+#ifndef STAGE_SAMPLE_SHIFT
+#define STAGE_SAMPLE_SHIFT  6
+#endif
+
+#define STAGE_SAMPLE_MASK   ((1u << STAGE_SAMPLE_SHIFT) - 1u)
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+typedef enum {
+    STAGE_THRESHOLD = 0,
+    STAGE_BUFFER_WRITE,
+    STAGE_STATS,
+    STAGE_LOGGER,
+    STAGE_COUNT
+} stage_id_t;
+
+/* ============================================================================
+ * HOOKS
+ * ========================================================================== */
+
+/** Per-thread call counters behind the sampling decision */
+extern _Thread_local uint32_t stage_calls[STAGE_COUNT];
+
+/** @brief Clock read for a sampled call (never returns 0) */
+uint64_t stage_clock(void);
+
+/** @brief Record a sampled call that began at `t0` */
+void stage_record(stage_id_t stage, uint64_t t0);
+
+/**
+ * @brief Start timing `stage` on this thread.
+ * @return Start time, or 0 if this call is not sampled
+ */
+static inline uint64_t stage_begin(stage_id_t stage)
+{
+    if ((stage_calls[stage]++ & STAGE_SAMPLE_MASK) != 0)
+        return 0;
+    return stage_clock();
+}
+
+/** @brief Finish timing a call started with stage_begin() */
+static inline void stage_end(stage_id_t stage, uint64_t t0)
+{
+    if (t0 != 0)
+        stage_record(stage, t0);
+}
+
+#ifdef STAGE_TIMING
+#define STAGE_BEGIN(stage)      stage_begin(stage)
+#define STAGE_END(stage, t0)    stage_end((stage), (t0))
+#else
+#define STAGE_BEGIN(stage)      0
+#define STAGE_END(stage, t0)    ((void)(t0))
+#endif
+
+/* ============================================================================
+ * REPORTING
+ * ========================================================================== */
+
+/** @brief Short name of a stage ("threshold", "buffer_write", ...) */
+const char *stage_name(stage_id_t stage);
+
+/** @brief true when the hooks were compiled in (-DSTAGE_TIMING) */
+bool stage_timing_enabled(void);
+
+/**
+ * @brief Add every thread's samples of `stage` into `out`.
+ * @return Number of threads that had recorded anything
+ */
+unsigned stage_timing_merge(stage_id_t stage, hist_t *out);
+
+/**
+ * @brief Empty every thread's histograms.
+ *
+ * Only while no thread is inside a timed stage.
+ */
+void stage_timing_reset(void);
+
+/**
+ * @brief Print one percentile row (ns) per stage.
+ */
+void stage_timing_print(void);
+
+#endif /* STAGE_TIMING_H */
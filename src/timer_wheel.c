@@ -0,0 +1,184 @@
+/**
+ * @file timer_wheel.c
+ * @brief Hierarchical timer wheel
+ *
+ * A timer at level L sits in the slot of its deadline's "block"
+ * (deadline >> (L * TW_BITS)). When the wheel reaches the first tick of
+ * that block the slot is emptied and its timers are placed again, which
+ * puts them one or more levels lower - the cascade. Level 0 slots hold
+ * timers due within TW_SLOTS ticks and fire when their tick is reached.
+ *
+ * Placement keeps every level-L timer within the next TW_SLOTS blocks of
+ * that level, so no two blocks share a slot at the same time and a slot
+ * is cascaded exactly when its block starts.
+ */
+
+#include "timer_wheel.h"
+#include <string.h>
+
+#define TW_MASK     (TW_SLOTS - 1u)
+
+/** Rotate right so that bit `by` becomes bit 0 */
+static inline uint64_t rotr64(uint64_t x, unsigned by)
+{
+    by &= 63u;
+    return by ? (x >> by) | (x << (64u - by)) : x;
+}
+
+static void link_slot(timer_wheel_t *w, unsigned level, unsigned slot,
+                      tw_timer_t *t)
+{
+    tw_timer_t **head = &w->slots[level][slot];
+    t->next = *head;
+    if (*head != NULL)
+        (*head)->pprev = &t->next;
+    *head = t;
+    t->pprev = head;
+    w->occupied[level] |= (uint64_t)1 << slot;
+}
+
+static void unlink_timer(tw_timer_t *t)
+{
+    *t->pprev = t->next;
+    if (t->next != NULL)
+        t->next->pprev = t->pprev;
+    t->next = NULL;
+    t->pprev = NULL;
+}
+
+/** Put `t` in the slot its distance from w->now calls for */
+static void place(timer_wheel_t *w, tw_timer_t *t)
+{
+    uint64_t d = t->deadline < w->now ? w->now : t->deadline;
+    uint64_t delta = d - w->now;
+    if (delta >= TW_RANGE)
+    {
+        /* Park at the far edge; it is placed again when that slot cascades */
+        delta = TW_RANGE - 1;
+        d = w->now + delta;
+    }
+
+    unsigned level = 0;
+    while (delta >= ((uint64_t)1 << (TW_BITS * (level + 1))))
+        level++;
+
+    link_slot(w, level, (unsigned)(d >> (TW_BITS * level)) & TW_MASK, t);
+}
+
+/** Take a whole slot's list off the wheel, with its head in `*list` */
+static void detach_slot(timer_wheel_t *w, unsigned level, unsigned slot,
+                        tw_timer_t **list)
+{
+    *list = w->slots[level][slot];
+    if (*list != NULL)
+        (*list)->pprev = list;
+    w->slots[level][slot] = NULL;
+    w->occupied[level] &= ~((uint64_t)1 << slot);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void tw_init(timer_wheel_t *w, uint64_t now)
+{
+    memset(w, 0, sizeof(*w));
+    w->now = now;
+}
+
+void tw_schedule(timer_wheel_t *w, tw_timer_t *t, uint64_t deadline)
+{
+    if (tw_pending(t))
+        unlink_timer(t);
+    else
+        w->count++;
+
+    t->deadline = deadline;
+    place(w, t);
+}
+
+void tw_cancel(timer_wheel_t *w, tw_timer_t *t)
+{
+    if (!tw_pending(t))
+        return;
+    unlink_timer(t);
+    w->count--;
+}
+
+uint64_t tw_next_expiry(const timer_wheel_t *w)
+{
+    if (w->count == 0)
+        return UINT64_MAX;
+
+    uint64_t best = UINT64_MAX;
+    for (unsigned level = 0; level < TW_LEVELS; level++)
+    {
+        if (w->occupied[level] == 0)
+            continue;
+
+        /* Blocks still to come at this level: the one starting at or
+         * after now, and the TW_SLOTS - 1 after it */
+        unsigned shift = TW_BITS * level;
+        uint64_t first = (w->now + (((uint64_t)1 << shift) - 1)) >> shift;
+        uint64_t bits  = rotr64(w->occupied[level], (unsigned)(first & TW_MASK));
+        uint64_t when  = (first + (uint64_t)__builtin_ctzll(bits)) << shift;
+        if (when < best)
+            best = when;
+    }
+    return best;
+}
+
+size_t tw_advance(timer_wheel_t *w, uint64_t now, tw_expire_fn fn, void *ctx)
+{
+    size_t fired = 0;
+
+    while (w->now <= now)
+    {
+        /* Jump over ticks with nothing to fire or cascade */
+        uint64_t next = tw_next_expiry(w);
+        if (next > now)
+        {
+            w->now = now + 1;
+            break;
+        }
+        if (next > w->now)
+            w->now = next;
+
+        uint64_t tick = w->now;
+
+        /* At the start of a block, move that block's timers down */
+        for (unsigned level = 1; level < TW_LEVELS; level++)
+        {
+            unsigned shift = TW_BITS * level;
+            if (tick & (((uint64_t)1 << shift) - 1))
+                break;
+
+            tw_timer_t *list;
+            detach_slot(w, level, (unsigned)(tick >> shift) & TW_MASK, &list);
+            while (list != NULL)
+            {
+                tw_timer_t *t = list;
+                unlink_timer(t);
+                place(w, t);
+            }
+        }
+
+        /*
+         * Fire this tick's slot. Popping from a detached list keeps it
+         * safe for the callback to re-arm or cancel any timer, and
+         * anything it schedules for "now" lands on the next tick.
+         */
+        tw_timer_t *list;
+        detach_slot(w, 0, (unsigned)tick & TW_MASK, &list);
+        w->now = tick + 1;
+        while (list != NULL)
+        {
+            tw_timer_t *t = list;
+            unlink_timer(t);
+            w->count--;
+            fired++;
+            fn(ctx, t);
+        }
+    }
+    return fired;
+}
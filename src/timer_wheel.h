@@ -0,0 +1,143 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timer wheel - O(1) timers for thousands of sensors
+ *
+ * A wheel of TW_LEVELS levels with TW_SLOTS slots each. Level 0 has one
+ * slot per tick, level 1 one slot per 64 ticks, level 2 per 4096, level
+ * 3 per 262144, so four levels cover 2^24 ticks (4.6 hours at 1 ms)
+ * ahead of the current tick. Deadlines further out wait in the top level
+ * and are placed again when they come into range.
+ *
+ *   level 3  |....|....|....|   262144 ticks per slot
+ *   level 2  |....|....|....|     4096
+ *   level 1  |....|....|....|       64
+ *   level 0  |....|....|....|        1   <- fires from here
+ *
+ * Timers are intrusive (tw_timer_t lives inside the caller's struct)
+ * and each slot is a doubly linked list, so:
+ *
+ *   tw_schedule()  O(1)   pick the level from the distance, link in
+ *   tw_cancel()    O(1)   unlink
+ *   tw_advance()   O(1) per tick plus O(1) per timer fired or moved
+ *                         down a level - a timer moves at most
+ *                         TW_LEVELS - 1 times in its life
+ *
+ * Nothing is allocated after tw_init(). Deadlines are absolute ticks;
+ * the unit is the caller's (the sampler uses milliseconds). One bitmap
+ * per level marks the non-empty slots, so tw_next_expiry() answers
+ * "when must I wake up?" with a few bit operations instead of a scan,
+ * and tw_advance() jumps straight over empty stretches.
+ *
+ * Not thread-safe: one thread owns a wheel.
+ *
+ *   timer_wheel_t w;
+ *   tw_init(&w, 0);
+ *   tw_schedule(&w, &src->timer, 250);
+ *   tw_advance(&w, now, on_expire, ctx);   // calls on_expire for each due timer
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief log2 of the slots per level */
+#define TW_BITS     6
+
+/** @brief Slots per level (one bit each in a 64-bit occupancy map) */
+#define TW_SLOTS    (1u << TW_BITS)
+
+/** @brief Number of levels */
+#define TW_LEVELS   4
+
+/** @brief Furthest deadline placed exactly, in ticks from now */
+#define TW_RANGE    ((uint64_t)1 << (TW_BITS * TW_LEVELS))
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief One timer, embedded in the caller's struct
+ *
+ * Zero-initialised it is idle. Recover the outer struct in the expiry
+ * callback with offsetof(), or keep the timer as its first member.
+ */
+typedef struct tw_timer {
+    struct tw_timer  *next;
+    struct tw_timer **pprev;    ///< &previous->next or &slot head; NULL when idle
+    uint64_t          deadline; ///< Absolute tick it fires at
+} tw_timer_t;
+
+/**
+ * @brief Called once for each expired timer.
+ *
+ * The timer is already unlinked; the callback may schedule it again
+ * (typically at deadline + period) or schedule and cancel others.
+ */
+typedef void (*tw_expire_fn)(void *ctx, tw_timer_t *t);
+
+/**
+ * @brief The wheel
+ */
+typedef struct {
+    tw_timer_t *slots[TW_LEVELS][TW_SLOTS]; ///< List heads
+    uint64_t    occupied[TW_LEVELS];        ///< Bit s set = slots[l][s] non-empty
+    uint64_t    now;                        ///< Next tick to be processed
+    size_t      count;                      ///< Timers scheduled
+} timer_wheel_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Empty the wheel and start it at tick `now`.
+ */
+void tw_init(timer_wheel_t *w, uint64_t now);
+
+/**
+ * @brief Arm `t` to fire at absolute tick `deadline`.
+ *
+ * Re-arming a scheduled timer moves it. A deadline already in the past
+ * fires on the next tw_advance(); t->deadline keeps the value given, so
+ * a periodic caller can compute the next one from it without drift.
+ */
+void tw_schedule(timer_wheel_t *w, tw_timer_t *t, uint64_t deadline);
+
+/**
+ * @brief Disarm `t`. No effect if it is not scheduled.
+ */
+void tw_cancel(timer_wheel_t *w, tw_timer_t *t);
+
+/** @brief true while `t` is scheduled */
+static inline bool tw_pending(const tw_timer_t *t)
+{
+    return t->pprev != NULL;
+}
+
+/**
+ * @brief Process every tick up to and including `now`.
+ *
+ * Timers due by `now` fire in deadline order (ties in no particular
+ * order), all in this one call - one wakeup however many are due.
+ * @return Number of timers fired
+ */
+size_t tw_advance(timer_wheel_t *w, uint64_t now, tw_expire_fn fn, void *ctx);
+
+/**
+ * @brief Earliest tick at which tw_advance() has work to do.
+ *
+ * Exact for timers within TW_SLOTS ticks; for later ones it is the tick
+ * at which they move down a level, which is never after their deadline.
+ * @return The tick, or UINT64_MAX if nothing is scheduled
+ */
+uint64_t tw_next_expiry(const timer_wheel_t *w);
+
+#endif /* TIMER_WHEEL_H */
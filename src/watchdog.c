@@ -0,0 +1,158 @@
+/**
+ * @file watchdog.c
+ * @brief Stale-sensor watchdog
+ *
+ * Each entry's timer is the first member of its watchdog_entry_t, so the
+ * wheel's expiry callback gets the entry back with a cast. Feeding never
+ * touches the wheel; the callback decides whether the timer expired on a
+ * sensor that has since reported (re-arm) or one that is silent (fault).
+ */
+
+#include "watchdog.h"
+#include "diag.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/** First time the entry will have been silent for more than its timeout */
+static uint64_t deadline(const watchdog_entry_t *e)
+{
+    return e->last_seen + e->timeout_ms + 1;
+}
+
+/** Same shape as the manager's threshold and anomaly alerts */
+static void print_stale(const watchdog_t *wd, uint8_t id, bool stale,
+                        uint64_t silent_ms)
+{
+    const char *name = wd->m->sensors[id].name;
+
+    if (stale)
+        printf("\n!!! STALE [CRITICAL] Sensor '%s' (id=%u): no reading for %"
+               PRIu64 " ms !!!\n\n", name, id, silent_ms);
+    else
+        printf("\n! RECOVERED Sensor '%s' (id=%u): reporting again after %"
+               PRIu64 " ms !\n\n", name, id, silent_ms);
+}
+
+/** Wheel callback: a sensor's deadline passed */
+static void on_expiry(void *ctx, tw_timer_t *t)
+{
+    watchdog_t       *wd = ctx;
+    watchdog_entry_t *e  = (watchdog_entry_t *)t;
+
+    /* Heard from since this timer was armed: push it back */
+    if (deadline(e) > wd->now_ms)
+    {
+        tw_schedule(&wd->wheel, t, deadline(e));
+        return;
+    }
+
+    /* Paused (or already faulted elsewhere): look again a timeout later */
+    if (!sensor_fault(&wd->m->sensors[e->id]))
+    {
+        tw_schedule(&wd->wheel, t, wd->now_ms + e->timeout_ms);
+        return;
+    }
+
+    /* Silent. Stays disarmed until watchdog_feed() hears from it. */
+    uint64_t silent = wd->now_ms - e->last_seen;
+    e->stale = true;
+    wd->stale_events++;
+    wd->m->total_alerts++;
+    print_stale(wd, e->id, true, silent);
+    if (wd->alert != NULL)
+        wd->alert(wd->alert_ctx, e->id, true, silent);
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+void watchdog_init(watchdog_t *wd, manager_t *m, uint64_t now_ms)
+{
+    memset(wd, 0, sizeof(*wd));
+    tw_init(&wd->wheel, now_ms);
+    wd->m      = m;
+    wd->now_ms = now_ms;
+    manager_attach_watchdog(m, wd);
+}
+
+bool watchdog_watch(watchdog_t *wd, uint8_t id, uint32_t period_ms,
+                    uint32_t misses)
+{
+    if (wd == NULL || id >= MANAGER_MAX_SENSORS || !wd->m->registered[id])
+        return false;
+    if (period_ms == 0 || misses == 0 || (uint64_t)period_ms * misses > UINT32_MAX)
+    {
+        DIAG_ERROR("WATCHDOG", "Bad budget for sensor id=%u: %u x %u ms",
+                   id, misses, period_ms);
+        return false;
+    }
+
+    watchdog_entry_t *e = &wd->entries[id];
+    e->id         = id;
+    e->timeout_ms = period_ms * misses;
+    e->last_seen  = wd->now_ms;
+    e->watched    = true;
+    if (!e->stale)
+        tw_schedule(&wd->wheel, &e->timer, deadline(e));
+
+    DIAG_DEBUG("WATCHDOG", "Watching id=%u: stale after %u ms",
+               id, e->timeout_ms);
+    return true;
+}
+
+void watchdog_unwatch(watchdog_t *wd, uint8_t id)
+{
+    if (wd == NULL || id >= MANAGER_MAX_SENSORS)
+        return;
+
+    watchdog_entry_t *e = &wd->entries[id];
+    tw_cancel(&wd->wheel, &e->timer);
+    e->watched = false;
+}
+
+void watchdog_feed(watchdog_t *wd, uint8_t id)
+{
+    watchdog_entry_t *e = &wd->entries[id];
+    if (!e->stale)
+    {
+        e->last_seen = wd->now_ms;
+        return;
+    }
+
+    /* It came back */
+    uint64_t silent = wd->now_ms - e->last_seen;
+    sensor_clear_fault(&wd->m->sensors[id]);
+    e->stale     = false;
+    e->last_seen = wd->now_ms;
+    wd->recoveries++;
+    if (e->watched)
+        tw_schedule(&wd->wheel, &e->timer, deadline(e));
+
+    print_stale(wd, id, false, silent);
+    if (wd->alert != NULL)
+        wd->alert(wd->alert_ctx, id, false, silent);
+}
+
+size_t watchdog_poll(watchdog_t *wd, uint64_t now_ms)
+{
+    if (now_ms < wd->now_ms)
+        return 0;
+
+    uint64_t before = wd->stale_events;
+    wd->now_ms = now_ms;
+    tw_advance(&wd->wheel, now_ms, on_expiry, wd);
+    return (size_t)(wd->stale_events - before);
+}
+
+uint64_t watchdog_next_due(const watchdog_t *wd)
+{
+    return tw_next_expiry(&wd->wheel);
+}
+
+void watchdog_set_alert(watchdog_t *wd, watchdog_alert_fn fn, void *ctx)
+{
+    wd->alert     = fn;
+    wd->alert_ctx = ctx;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file watchdog.h
+ * @brief Stale-sensor watchdog
+ *
+ * A sensor that stops reporting does not fail loudly: when the DHT11
+ * read fails the sketch prints a comment line and the host just stops
+ * seeing data. The watchdog notices. Each watched sensor has a period
+ * and a budget of K missed samples; if more than K * period passes
+ * without a reading the sensor is moved to SENSOR_STATE_ERROR and a STALE alert
+ * is raised. Its next reading clears the fault and logs as normal.
+ *
+ *   watchdog_t wd;
+ *   watchdog_init(&wd, m, now_ms());           // attaches to the manager
+ *   watchdog_watch(&wd, 0, 2000, 3);           // DHT11: 2 s, 3 misses
+ *   for (;;) {
+ *       ... manager_log(m, ...) ...             // each reading feeds it
+ *       watchdog_poll(&wd, now_ms());           // faults the silent ones
+ *   }
+ *
+ * Cost does not grow with the number of sensors:
+ *
+ *   - a reading (manager_log()) stores the time of the last poll in its
+ *     sensor's entry - one store, no wheel operation
+ *   - each watched sensor has one timer in a timer wheel (timer_wheel.h)
+ *     at its last known deadline. When it fires, a sensor that has been
+ *     heard from since is simply re-armed from its last reading; only
+ *     a sensor that really went silent is faulted
+ *   - watchdog_poll() therefore touches only timers that are due, never
+ *     the full list of sensors
+ *
+ * Time is the caller's clock in milliseconds (host time, not the board's
+ * timestamps - a silent board sends none). Readings are stamped with
+ * the time of the latest poll, so detection is accurate to the polling
+ * interval. Poll from the thread that calls manager_log().
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include "timer_wheel.h"
+#include "sensor_manager.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Told about every sensor that goes stale or comes back.
+ * @param stale      true: went silent; false: reporting again
+ * @param silent_ms  How long it had been silent
+ */
+typedef void (*watchdog_alert_fn)(void *ctx, uint8_t id, bool stale,
+                                  uint64_t silent_ms);
+
+/**
+ * @brief One watched sensor
+ */
+typedef struct {
+    tw_timer_t timer;       ///< Must stay first (see watchdog.c)
+    uint64_t   last_seen;   ///< Poll time of its latest reading
+    uint32_t   timeout_ms;  ///< period * misses
+    uint8_t    id;
+    bool       watched;
+    bool       stale;       ///< Faulted by the watchdog, waiting for a reading
+} watchdog_entry_t;
+
+/**
+ * @brief Watchdog for one manager's sensors
+ */
+typedef struct watchdog {
+    timer_wheel_t     wheel;        ///< Ticks are milliseconds
+    manager_t        *m;
+    uint64_t          now_ms;       ///< Time of the latest poll
+    watchdog_entry_t  entries[MANAGER_MAX_SENSORS];
+    watchdog_alert_fn alert;
+    void             *alert_ctx;
+
+    /* Statistics */
+    uint64_t          stale_events; ///< Sensors faulted
+    uint64_t          recoveries;   ///< Faulted sensors that reported again
+} watchdog_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Start an empty watchdog at `now_ms` and attach it to `m`.
+ *
+ * `wd` must stay valid until it is detached with
+ * manager_attach_watchdog(m, NULL) or the manager is destroyed.
+ */
+void watchdog_init(watchdog_t *wd, manager_t *m, uint64_t now_ms);
+
+/**
+ * @brief Watch a registered sensor.
+ *
+ * It is counted as heard from now, and faulted once more than `misses`
+ * periods pass without a reading. Calling again changes the budget.
+ * @param period_ms  Expected time between its readings
+ * @param misses     Readings it may miss before it is faulted (>= 1)
+ * @return true on success
+ */
+bool watchdog_watch(watchdog_t *wd, uint8_t id, uint32_t period_ms,
+                    uint32_t misses);
+
+/**
+ * @brief Stop watching a sensor. A fault it set stays until a reading.
+ */
+void watchdog_unwatch(watchdog_t *wd, uint8_t id);
+
+/**
+ * @brief Record a reading from `id`. Called by manager_log().
+ *
+ * O(1). If the watchdog had faulted the sensor, the fault is cleared so
+ * this reading is logged, and a recovery is reported.
+ */
+void watchdog_feed(watchdog_t *wd, uint8_t id);
+
+/**
+ * @brief Advance to `now_ms` and fault every sensor that has gone silent.
+ * @return Number of sensors faulted by this call
+ */
+size_t watchdog_poll(watchdog_t *wd, uint64_t now_ms);
+
+/**
+ * @brief When the next poll could find something (UINT64_MAX if never).
+ *
+ * For sizing a poll or sleep timeout; may be early, never late.
+ */
+uint64_t watchdog_next_due(const watchdog_t *wd);
+
+/**
+ * @brief Be told about stale sensors and recoveries (NULL to stop).
+ *
+ * Alerts are printed and counted in the manager's total_alerts either way.
+ */
+void watchdog_set_alert(watchdog_t *wd, watchdog_alert_fn fn, void *ctx);
+
+#endif /* WATCHDOG_H */
@@ -0,0 +1,284 @@
+/**
+ * @file worker_pool.c
+ * @brief Sensor-sharded worker pool implementation
+ *
+ * Completion tracking: the ingestion thread counts what it submitted to
+ * each worker, the worker publishes what it finished with a release
+ * store. pool_drain() waits for processed == submitted with acquire, so
+ * once it returns every manager update made by the workers is visible
+ * to the caller.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "worker_pool.h"
+#include "diag.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ============================================================================
+ * PRIVATE HELPERS
+ * ========================================================================== */
+
+/** Empty polls before an idle worker starts sleeping instead of yielding */
+#define IDLE_SPINS     64
+#define IDLE_SLEEP_NS  20000L
+
+static void idle_wait(unsigned *idle)
+{
+    if (++(*idle) < IDLE_SPINS)
+    {
+        sched_yield();
+        return;
+    }
+    struct timespec ts = { 0, IDLE_SLEEP_NS };
+    nanosleep(&ts, NULL);
+}
+
+static pool_worker_t *owner_of(worker_pool_t *pool, uint8_t id)
+{
+    if (pool == NULL || id >= pool->capacity)
+        return NULL;
+
+    return &pool->workers[id % pool->worker_count];
+}
+
+static void *worker_main(void *arg)
+{
+    pool_worker_t *w    = arg;
+    worker_pool_t *pool = w->pool;
+    sensor_reading_t batch[POOL_BATCH];
+    unsigned idle = 0;
+
+    for (;;)
+    {
+        size_t n = spsc_pop_batch(w->queue, batch, POOL_BATCH);
+        if (n == 0)
+        {
+            /* Stop only once the queue is empty after the flag dropped */
+            if (!atomic_load_explicit(&pool->running, memory_order_acquire) &&
+                spsc_size(w->queue) == 0)
+                break;
+            idle_wait(&idle);
+            continue;
+        }
+
+        idle = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const sensor_reading_t *r = &batch[i];
+            manager_log(w->m, r->sensor_id, r->value, r->timestamp);
+            if (pool->hook != NULL)
+                pool->hook(&w->m->sensors[r->sensor_id], r, pool->hook_ctx);
+        }
+
+        atomic_fetch_add_explicit(&w->processed, n, memory_order_release);
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+worker_pool_t *pool_create(uint8_t workers, uint8_t capacity,
+                           size_t queue_capacity)
+{
+    if (workers == 0 || workers > POOL_MAX_WORKERS)
+    {
+        DIAG_ERROR("POOL", "workers must be 1..%d, got %u",
+                   POOL_MAX_WORKERS, workers);
+        return NULL;
+    }
+
+    worker_pool_t *pool = malloc(sizeof(*pool));
+    if (pool == NULL)
+        return NULL;
+
+    pool->workers = cache_alloc(sizeof(pool_worker_t) * workers);
+    if (pool->workers == NULL)
+    {
+        free(pool);
+        return NULL;
+    }
+
+    pool->worker_count = 0;
+    pool->capacity     = capacity;
+    pool->hook         = NULL;
+    pool->hook_ctx     = NULL;
+    pool->started      = false;
+    atomic_init(&pool->running, false);
+
+    for (uint8_t i = 0; i < workers; i++)
+    {
+        pool_worker_t *w = &pool->workers[i];
+        w->pool      = pool;
+        w->submitted = 0;
+        w->dropped   = 0;
+        atomic_init(&w->processed, 0);
+        w->queue = spsc_create(queue_capacity);
+        w->m     = manager_create(capacity);
+        if (w->queue == NULL || w->m == NULL)
+        {
+            spsc_destroy(w->queue);
+            manager_destroy(w->m);
+            pool_destroy(pool);
+            return NULL;
+        }
+        pool->worker_count++;
+    }
+
+    return pool;
+}
+
+void pool_destroy(worker_pool_t *pool)
+{
+    if (pool == NULL)
+        return;
+
+    pool_stop(pool);
+
+    for (uint8_t i = 0; i < pool->worker_count; i++)
+    {
+        spsc_destroy(pool->workers[i].queue);
+        manager_destroy(pool->workers[i].m);
+    }
+
+    cache_free(pool->workers);
+    free(pool);
+}
+
+bool pool_register(worker_pool_t *pool, uint8_t id,
+                   const char *name, size_t buf_size)
+{
+    pool_worker_t *w = owner_of(pool, id);
+    if (w == NULL || pool->started)
+        return false;
+
+    return manager_register(w->m, id, name, buf_size);
+}
+
+manager_t *pool_manager(worker_pool_t *pool, uint8_t id)
+{
+    pool_worker_t *w = owner_of(pool, id);
+    return (w != NULL) ? w->m : NULL;
+}
+
+void pool_set_hook(worker_pool_t *pool, pool_hook_t hook, void *ctx)
+{
+    if (pool == NULL || pool->started)
+        return;
+
+    pool->hook     = hook;
+    pool->hook_ctx = ctx;
+}
+
+bool pool_start(worker_pool_t *pool)
+{
+    if (pool == NULL || pool->started)
+        return false;
+
+    atomic_store(&pool->running, true);
+    for (uint8_t i = 0; i < pool->worker_count; i++)
+    {
+        if (pthread_create(&pool->workers[i].thread, NULL,
+                           worker_main, &pool->workers[i]) != 0)
+        {
+            /* Let the threads that did start exit cleanly */
+            atomic_store(&pool->running, false);
+            for (uint8_t j = 0; j < i; j++)
+                pthread_join(pool->workers[j].thread, NULL);
+            return false;
+        }
+    }
+
+    pool->started = true;
+    DIAG_INFO("POOL", "Started %u workers", pool->worker_count);
+    return true;
+}
+
+bool pool_submit(worker_pool_t *pool, uint8_t id,
+                 float value, uint32_t timestamp)
+{
+    pool_worker_t *w = owner_of(pool, id);
+    if (w == NULL || !w->m->registered[id])
+        return false;
+
+    sensor_reading_t r = { .timestamp = timestamp, .sensor_id = id,
+                           .value = value };
+    if (!spsc_push(w->queue, &r))
+    {
+        w->dropped++;
+        return false;
+    }
+
+    w->submitted++;
+    return true;
+}
+
+void pool_drain(worker_pool_t *pool)
+{
+    if (pool == NULL || !pool->started)
+        return;
+
+    for (uint8_t i = 0; i < pool->worker_count; i++)
+    {
+        pool_worker_t *w = &pool->workers[i];
+        unsigned idle = 0;
+        while (atomic_load_explicit(&w->processed, memory_order_acquire)
+               != w->submitted)
+            idle_wait(&idle);
+    }
+}
+
+void pool_stop(worker_pool_t *pool)
+{
+    if (pool == NULL || !pool->started)
+        return;
+
+    atomic_store_explicit(&pool->running, false, memory_order_release);
+    for (uint8_t i = 0; i < pool->worker_count; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+
+    pool->started = false;
+}
+
+bool pool_read(worker_pool_t *pool, uint8_t id, sensor_reading_t *output)
+{
+    manager_t *m = pool_manager(pool, id);
+    return m != NULL && manager_read(m, id, output);
+}
+
+bool pool_get_stats(worker_pool_t *pool, uint8_t id, sensor_stats_t *stats)
+{
+    manager_t *m = pool_manager(pool, id);
+    if (m == NULL || !m->registered[id])
+        return false;
+
+    return sensor_get_stats(&m->sensors[id], stats);
+}
+
+void pool_get_totals(worker_pool_t *pool, pool_totals_t *totals)
+{
+    if (totals == NULL)
+        return;
+
+    *totals = (pool_totals_t){ 0 };
+    if (pool == NULL)
+        return;
+
+    for (uint8_t i = 0; i < pool->worker_count; i++)
+    {
+        pool_worker_t *w = &pool->workers[i];
+        totals->submitted += w->submitted;
+        totals->dropped   += w->dropped;
+        totals->processed += atomic_load_explicit(&w->processed,
+                                                  memory_order_acquire);
+        totals->logs      += w->m->total_logs;
+        totals->alerts    += w->m->total_alerts;
+        totals->anomalies += w->m->total_anomalies;
+    }
+}
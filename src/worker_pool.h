@@ -0,0 +1,200 @@
+/**
+ * @file worker_pool.h
+ * @brief Sensor-sharded worker pool - run the per-sensor pipeline in parallel
+ *
+ * manager_log() does all of a reading's work (filtering, stats, threshold
+ * and anomaly checks, rollups) inline on the caller's thread. The worker
+ * pool moves that work onto N worker threads:
+ *
+ *   - sensors are partitioned by ID: sensor `id` belongs to worker
+ *     `id % N`, which owns it exclusively (its own manager_t)
+ *   - the ingestion thread hands readings over through one lock-free
+ *     SPSC queue per worker, so the hot path takes no locks at all
+ *   - an optional hook runs on the owning worker right after
+ *     manager_log(), for heavier per-sensor work (FFT windows, quantile
+ *     sketches, ...) that can keep private per-sensor state without locks
+ *
+ * Typical usage:
+ *
+ *   worker_pool_t *pool = pool_create(4, 8, 4096);
+ *   pool_register(pool, 0, "Vibration", 256);
+ *   manager_set_thresholds(pool_manager(pool, 0), 0, t);   // setup
+ *   pool_start(pool);
+ *
+ *   pool_submit(pool, 0, value, now());    // ingestion thread
+ *
+ *   pool_drain(pool);                      // wait for workers to catch up
+ *   pool_get_stats(pool, 0, &stats);
+ *   pool_destroy(pool);
+ *
+ * Only one thread may call pool_submit() (each queue has one producer).
+ * Reads, stats and totals are only consistent after pool_drain() or
+ * pool_stop(), because the workers update their managers lock-free.
+ */
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "sensor_manager.h"
+#include "spsc.h"
+#include "cacheline.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ============================================================================
+ * CONFIGURATION
+ * ========================================================================== */
+
+/** @brief More workers than sensor IDs would leave workers with nothing */
+#define POOL_MAX_WORKERS  MANAGER_MAX_SENSORS
+
+/** @brief Readings a worker pops from its queue per batch */
+#define POOL_BATCH        64
+
+/* ============================================================================
+ * DATA TYPES
+ * ========================================================================== */
+
+/**
+ * @brief Per-reading work run on the owning worker after manager_log()
+ *
+ * @param sensor   The sensor (sensor->last_value is the filtered value)
+ * @param reading  The reading as submitted (raw value)
+ * @param ctx      User context from pool_set_hook()
+ */
+typedef void (*pool_hook_t)(const sensor_t *sensor,
+                            const sensor_reading_t *reading, void *ctx);
+
+struct worker_pool;
+
+/**
+ * @brief One worker: its queue, its sensors, its thread
+ *
+ * Producer-side and worker-side counters live on separate cache lines.
+ */
+typedef struct {
+    spsc_queue_t        *queue;     ///< Hand-off from the ingestion thread
+    manager_t           *m;         ///< Sensors owned by this worker
+    struct worker_pool  *pool;      ///< Back pointer for the thread
+    pthread_t            thread;
+
+    _Alignas(CACHE_LINE)
+    uint64_t             submitted; ///< Accepted by pool_submit (producer)
+    uint64_t             dropped;   ///< Rejected, queue full (producer)
+
+    _Alignas(CACHE_LINE)
+    _Atomic uint64_t     processed; ///< Run through the pipeline (worker)
+} pool_worker_t;
+
+/**
+ * @brief Combined counters across all workers
+ */
+typedef struct {
+    uint64_t submitted;  ///< Readings handed to a worker
+    uint64_t processed;  ///< Readings a worker has finished
+    uint64_t dropped;    ///< Readings rejected because a queue was full
+    uint64_t logs;       ///< Sum of manager total_logs
+    uint64_t alerts;     ///< Sum of manager total_alerts
+    uint64_t anomalies;  ///< Sum of manager total_anomalies
+} pool_totals_t;
+
+/**
+ * @brief The worker pool (allocate with pool_create)
+ */
+typedef struct worker_pool {
+    pool_worker_t *workers;         ///< worker_count workers
+    uint8_t        worker_count;
+    uint8_t        capacity;        ///< Sensor IDs 0 .. capacity-1
+    pool_hook_t    hook;            ///< Optional per-reading work
+    void          *hook_ctx;
+    _Atomic bool   running;         ///< Cleared by pool_stop
+    bool           started;         ///< Threads have been created
+} worker_pool_t;
+
+/* ============================================================================
+ * PUBLIC API
+ * ========================================================================== */
+
+/**
+ * @brief Create a pool (threads are not started yet).
+ *
+ * @param workers         Number of worker threads (1 .. POOL_MAX_WORKERS)
+ * @param capacity        Sensor IDs per pool (1 .. MANAGER_MAX_SENSORS)
+ * @param queue_capacity  Slots per worker queue (power of two)
+ * @return                New pool, NULL on failure
+ */
+worker_pool_t *pool_create(uint8_t workers, uint8_t capacity,
+                           size_t queue_capacity);
+
+/**
+ * @brief Stop the workers if running and free everything (NULL is safe).
+ */
+void pool_destroy(worker_pool_t *pool);
+
+/**
+ * @brief Register a sensor with the worker that owns its ID.
+ * @return Same as manager_register()
+ */
+bool pool_register(worker_pool_t *pool, uint8_t id,
+                   const char *name, size_t buf_size);
+
+/**
+ * @brief The manager that owns sensor `id`, for setup or quiescent reads.
+ * @return Owning manager, NULL if the pool or ID is invalid
+ */
+manager_t *pool_manager(worker_pool_t *pool, uint8_t id);
+
+/**
+ * @brief Install a per-reading hook (before pool_start only).
+ */
+void pool_set_hook(worker_pool_t *pool, pool_hook_t hook, void *ctx);
+
+/**
+ * @brief Start the worker threads.
+ * @return true on success
+ */
+bool pool_start(worker_pool_t *pool);
+
+/**
+ * @brief Hand a reading to the worker that owns sensor `id`.
+ *
+ * Never blocks. Call from a single ingestion thread.
+ *
+ * @return true if queued, false if the ID is not registered or the
+ *         worker's queue is full (counted in pool_totals_t.dropped)
+ */
+bool pool_submit(worker_pool_t *pool, uint8_t id,
+                 float value, uint32_t timestamp);
+
+/**
+ * @brief Wait until every submitted reading has been processed.
+ *
+ * Call from the ingestion thread. Afterwards the workers' managers may be
+ * read safely until the next pool_submit().
+ */
+void pool_drain(worker_pool_t *pool);
+
+/**
+ * @brief Process everything still queued, then join the workers.
+ */
+void pool_stop(worker_pool_t *pool);
+
+/**
+ * @brief Read the oldest buffered reading of a sensor (quiescent only).
+ */
+bool pool_read(worker_pool_t *pool, uint8_t id, sensor_reading_t *output);
+
+/**
+ * @brief Running stats of a sensor (quiescent only).
+ */
+bool pool_get_stats(worker_pool_t *pool, uint8_t id, sensor_stats_t *stats);
+
+/**
+ * @brief Sum the counters of every worker (manager sums: quiescent only).
+ */
+void pool_get_totals(worker_pool_t *pool, pool_totals_t *totals);
+
+#endif /* WORKER_POOL_H */
@@ -0,0 +1,373 @@
+/**
+ * @file test_broadcast.c
+ * @brief Unit tests for the single-producer / multi-consumer broadcast ring
+ *
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/broadcast.c tests/test_broadcast.c -o build/test_broadcast.exe -pthread
+ * Run:    ./build/test_broadcast.exe
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/broadcast.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+static sensor_reading_t make_reading(uint32_t ts, uint8_t id, float val)
+{
+    sensor_reading_t r;
+    r.timestamp = ts;
+    r.sensor_id = id;
+    r.value     = val;
+    return r;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_create(void)
+{
+    test_header("broadcast_create — capacity rules");
+    broadcast_ring_t *ring = broadcast_create(8);
+    ASSERT_TRUE(ring != NULL,                 "power of two accepted");
+    ASSERT_EQ(broadcast_published(ring), 0,   "nothing published yet");
+    broadcast_destroy(ring);
+
+    ASSERT_FALSE(broadcast_create(0),         "capacity 0 rejected");
+    ASSERT_FALSE(broadcast_create(6),         "non power of two rejected");
+    broadcast_destroy(NULL);
+    ASSERT_TRUE(1,                            "destroy(NULL) is safe");
+}
+
+static void test_every_consumer_sees_everything(void)
+{
+    test_header("broadcast — each consumer reads the full stream");
+    broadcast_ring_t *ring = broadcast_create(8);
+    int a = broadcast_subscribe(ring, BROADCAST_GATE);
+    int b = broadcast_subscribe(ring, BROADCAST_LAP);
+    ASSERT_TRUE(a >= 0 && b >= 0 && a != b,   "two consumers subscribed");
+
+    for (uint32_t i = 0; i < 5; i++) {
+        sensor_reading_t r = make_reading(i, 3, (float)i);
+        broadcast_publish(ring, &r);
+    }
+    ASSERT_EQ(broadcast_lag(ring, a), 5,      "consumer a lags by 5");
+
+    sensor_reading_t out;
+    int got_a = 0, got_b = 0;
+    uint32_t last_b = 0;
+    while (broadcast_consume(ring, a, &out)) got_a++;
+    while (broadcast_consume(ring, b, &out)) { got_b++; last_b = out.timestamp; }
+
+    ASSERT_EQ(got_a, 5,                       "consumer a got all 5");
+    ASSERT_EQ(got_b, 5,                       "consumer b also got all 5");
+    ASSERT_EQ(last_b, 4,                      "in publish order");
+    ASSERT_EQ(out.sensor_id, 3,               "sensor id round-trips");
+    ASSERT_EQ(broadcast_lag(ring, a), 0,      "caught up");
+
+    broadcast_destroy(ring);
+}
+
+static void test_gate_policy(void)
+{
+    test_header("BROADCAST_GATE — slow consumer holds the producer");
+    broadcast_ring_t *ring = broadcast_create(4);
+    int slow = broadcast_subscribe(ring, BROADCAST_GATE);
+    sensor_reading_t r = make_reading(0, 0, 0.0f), out;
+
+    for (int i = 0; i < 4; i++)
+        broadcast_publish(ring, &r);
+    ASSERT_FALSE(broadcast_publish(ring, &r),       "5th publish refused");
+    ASSERT_EQ(broadcast_overflow_count(ring), 1,    "overflow counted");
+
+    broadcast_consume(ring, slow, &out);
+    ASSERT_TRUE(broadcast_publish(ring, &r),        "space freed by consumer");
+
+    broadcast_unsubscribe(ring, slow);
+    for (int i = 0; i < 10; i++)
+        broadcast_publish(ring, &r);
+    ASSERT_EQ(broadcast_overflow_count(ring), 1,    "no gating once unsubscribed");
+
+    broadcast_destroy(ring);
+}
+
+static void test_lap_policy(void)
+{
+    test_header("BROADCAST_LAP — producer laps a slow consumer");
+    broadcast_ring_t *ring = broadcast_create(4);
+    int slow = broadcast_subscribe(ring, BROADCAST_LAP);
+
+    for (uint32_t i = 0; i < 10; i++) {
+        sensor_reading_t r = make_reading(i, 0, 0.0f);
+        broadcast_publish(ring, &r);
+    }
+    ASSERT_EQ(broadcast_overflow_count(ring), 0,    "producer never refused");
+
+    sensor_reading_t out;
+    ASSERT_TRUE(broadcast_consume(ring, slow, &out), "consume after lap");
+    ASSERT_EQ(out.timestamp, 6,                      "skipped to oldest available");
+    ASSERT_EQ(broadcast_lapped(ring, slow), 6,       "6 entries reported lost");
+
+    broadcast_destroy(ring);
+}
+
+static void test_late_subscribe(void)
+{
+    test_header("broadcast_subscribe — late consumer starts at the next publish");
+    broadcast_ring_t *ring = broadcast_create(4);
+    int early = broadcast_subscribe(ring, BROADCAST_GATE);
+    sensor_reading_t out;
+
+    for (uint32_t i = 0; i < 3; i++) {
+        sensor_reading_t r = make_reading(i, 0, 0.0f);
+        broadcast_publish(ring, &r);
+    }
+    int late = broadcast_subscribe(ring, BROADCAST_GATE);
+    ASSERT_FALSE(broadcast_consume(ring, late, &out), "nothing before the next publish");
+    ASSERT_EQ(broadcast_lag(ring, late), 0,           "and no lag");
+
+    sensor_reading_t r = make_reading(3, 0, 0.0f);
+    ASSERT_TRUE(broadcast_publish(ring, &r),          "fourth entry fits");
+    ASSERT_TRUE(broadcast_consume(ring, late, &out),  "late consumer reads");
+    ASSERT_EQ(out.timestamp, 3,                       "starting at the next entry");
+    ASSERT_EQ(broadcast_lag(ring, early), 4,          "early consumer still has all four");
+
+    broadcast_destroy(ring);
+}
+
+/* ---- Threaded: one producer, one gated + one lapped consumer ---- */
+
+#define STRESS_COUNT 200000u
+
+typedef struct {
+    broadcast_ring_t *ring;
+    int               id;
+    uint64_t          received;
+    bool              ordered;
+} consumer_arg_t;
+
+static void *consumer_thread(void *p)
+{
+    consumer_arg_t *arg = p;
+    sensor_reading_t out;
+    uint32_t prev = 0;
+    bool first = true;
+
+    /* The final entry can never be lapped, so both policies end on it. */
+    while (first || prev < STRESS_COUNT - 1) {
+        if (!broadcast_consume(arg->ring, arg->id, &out))
+            continue;
+        if (!first && out.timestamp <= prev)
+            arg->ordered = false;
+        if (out.value != (float)out.timestamp)
+            arg->ordered = false;       /* torn read would show up here */
+        prev  = out.timestamp;
+        first = false;
+        arg->received++;
+    }
+    return NULL;
+}
+
+static void test_threaded(void)
+{
+    test_header("broadcast — concurrent producer and consumers");
+    broadcast_ring_t *ring = broadcast_create(1024);
+    consumer_arg_t gate = { ring, broadcast_subscribe(ring, BROADCAST_GATE), 0, true };
+    consumer_arg_t lap  = { ring, broadcast_subscribe(ring, BROADCAST_LAP),  0, true };
+
+    pthread_t tg, tl;
+    pthread_create(&tg, NULL, consumer_thread, &gate);
+    pthread_create(&tl, NULL, consumer_thread, &lap);
+
+    for (uint32_t i = 0; i < STRESS_COUNT; i++) {
+        sensor_reading_t r = make_reading(i, 1, (float)i);
+        while (!broadcast_publish(ring, &r))
+            ;                           /* gated: retry */
+    }
+
+    pthread_join(tg, NULL);
+    pthread_join(tl, NULL);
+
+    ASSERT_EQ(gate.received, STRESS_COUNT,  "gated consumer lost nothing");
+    ASSERT_TRUE(gate.ordered,               "gated consumer saw ordered, intact data");
+    ASSERT_TRUE(lap.ordered,                "lapped consumer saw ordered, intact data");
+    ASSERT_EQ(lap.received + broadcast_lapped(ring, lap.id), STRESS_COUNT,
+              "lapped consumer: received + lost == published");
+
+    broadcast_destroy(ring);
+}
+
+/* ---- Threaded: GATE consumers subscribing while the producer runs ---- */
+
+#define JOIN_ROUNDS  500
+#define JOIN_READS   64
+
+typedef struct {
+    broadcast_ring_t *ring;
+    atomic_bool       stop;
+} producer_arg_t;
+
+static void *producer_thread(void *p)
+{
+    producer_arg_t *arg = p;
+    for (uint32_t i = 0; !atomic_load(&arg->stop); ) {
+        sensor_reading_t r = make_reading(i, 1, (float)i);
+        if (broadcast_publish(arg->ring, &r))
+            i++;
+        else
+            sched_yield();              /* gated: let the consumer run */
+    }
+    return NULL;
+}
+
+static void test_subscribe_while_running(void)
+{
+    test_header("broadcast — GATE consumer joining a running producer is never lapped");
+    producer_arg_t prod = { .ring = broadcast_create(16) };
+    atomic_init(&prod.stop, false);
+
+    pthread_t tp;
+    pthread_create(&tp, NULL, producer_thread, &prod);
+
+    int      gaps = 0, torn = 0;
+    uint64_t lapped = 0;
+    for (int round = 0; round < JOIN_ROUNDS; round++) {
+        int id = broadcast_subscribe(prod.ring, BROADCAST_GATE);
+        sensor_reading_t out;
+        uint32_t prev = 0;
+
+        for (int got = 0; got < JOIN_READS; ) {
+            if (!broadcast_consume(prod.ring, id, &out)) {
+                sched_yield();
+                continue;
+            }
+            if (got > 0 && out.timestamp != prev + 1)
+                gaps++;
+            if (out.value != (float)out.timestamp)
+                torn++;
+            prev = out.timestamp;
+            got++;
+        }
+        lapped += broadcast_lapped(prod.ring, id);
+        broadcast_unsubscribe(prod.ring, id);
+    }
+
+    atomic_store(&prod.stop, true);
+    pthread_join(tp, NULL);
+
+    ASSERT_EQ(lapped, 0u, "no entries lost to the producer");
+    ASSERT_EQ(gaps, 0,    "every round read a gap-free run");
+    ASSERT_EQ(torn, 0,    "and intact data");
+
+    broadcast_destroy(prod.ring);
+}
+
+/* ---- Threaded: several consumers subscribing at the same moment ---- */
+
+#define RACE_THREADS  BROADCAST_MAX_CONSUMERS
+#define RACE_ROUNDS   200
+
+typedef struct {
+    broadcast_ring_t *ring;
+    atomic_int       *ready;        ///< Threads waiting at the start line
+    int               id;
+} subscriber_arg_t;
+
+static void *subscriber_thread(void *p)
+{
+    subscriber_arg_t *arg = p;
+    atomic_fetch_add(arg->ready, 1);
+    while (atomic_load(arg->ready) < RACE_THREADS)
+        sched_yield();
+    arg->id = broadcast_subscribe(arg->ring, BROADCAST_GATE);
+    return NULL;
+}
+
+static void test_subscribe_race(void)
+{
+    test_header("broadcast_subscribe — concurrent subscribers get distinct ids");
+
+    int duplicates = 0, failed = 0;
+    for (int round = 0; round < RACE_ROUNDS; round++) {
+        broadcast_ring_t *ring = broadcast_create(16);
+        atomic_int ready;
+        atomic_init(&ready, 0);
+
+        pthread_t        tid[RACE_THREADS];
+        subscriber_arg_t arg[RACE_THREADS];
+        for (int i = 0; i < RACE_THREADS; i++) {
+            arg[i] = (subscriber_arg_t){ ring, &ready, -1 };
+            pthread_create(&tid[i], NULL, subscriber_thread, &arg[i]);
+        }
+
+        bool seen[BROADCAST_MAX_CONSUMERS] = { false };
+        for (int i = 0; i < RACE_THREADS; i++) {
+            pthread_join(tid[i], NULL);
+            if (arg[i].id < 0)
+                failed++;
+            else if (seen[arg[i].id])
+                duplicates++;
+            else
+                seen[arg[i].id] = true;
+        }
+        broadcast_destroy(ring);
+    }
+
+    ASSERT_EQ(failed, 0,     "every subscriber got a slot");
+    ASSERT_EQ(duplicates, 0, "no slot handed out twice");
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Broadcast Ring Test Suite\n");
+    printf("==============================\n");
+
+    test_create();
+    test_every_consumer_sees_everything();
+    test_gate_policy();
+    test_lap_policy();
+    test_late_subscribe();
+    test_threaded();
+    test_subscribe_while_running();
+    test_subscribe_race();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
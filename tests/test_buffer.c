@@ -2,7 +2,7 @@
  * @file test_buffer.c
  * @brief Unit tests for the ring buffer
  *
- * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/buffer.c tests/test_buffer.c -o build/test_buffer.exe
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/diag.c src/arena.c src/buffer.c tests/test_buffer.c -o build/test_buffer.exe
  * Run:    ./build/test_buffer.exe
  */
 
@@ -247,6 +247,127 @@ static void test_capacity_one(void)
     buffer_destroy(buf);
 }
 
+static void test_find_from(void)
+{
+    test_header("buffer_find_from — binary search across the wrap point");
+    ring_buffer_t *buf = buffer_create(8);
+
+    /* Write 6, consume 4, write 5 more: live data wraps (ts 50..100) */
+    for (uint32_t i = 0; i < 6; i++) {
+        sensor_reading_t r = make_reading(i * 10, 0, 0.0f);
+        buffer_write(buf, &r);
+    }
+    sensor_reading_t out;
+    for (int i = 0; i < 4; i++)
+        buffer_read(buf, &out);
+    for (uint32_t i = 6; i < 11; i++) {
+        sensor_reading_t r = make_reading(i * 10, 0, 0.0f);
+        buffer_write(buf, &r);
+    }
+    ASSERT_TRUE(buf->head < buf->tail,            "live data wraps");
+
+    ASSERT_EQ(buffer_find_from(buf, 0),   0,      "before oldest -> 0");
+    ASSERT_EQ(buffer_find_from(buf, 40),  0,      "exact oldest -> 0");
+    ASSERT_EQ(buffer_find_from(buf, 55),  2,      "between in first run");
+    ASSERT_EQ(buffer_find_from(buf, 80),  4,      "exact in second run");
+    ASSERT_EQ(buffer_find_from(buf, 101), 7,      "after newest -> count");
+    ASSERT_EQ(buffer_find_from(NULL, 5),  0,      "NULL -> 0");
+
+    buffer_destroy(buf);
+}
+
+static void test_range_spans(void)
+{
+    test_header("buffer_range — zero-copy spans for [t0, t1)");
+    ring_buffer_t *buf = buffer_create(8);
+
+    for (uint32_t i = 0; i < 6; i++) {
+        sensor_reading_t r = make_reading(i * 10, 0, (float)i);
+        buffer_write(buf, &r);
+    }
+    sensor_reading_t out;
+    for (int i = 0; i < 4; i++)
+        buffer_read(buf, &out);
+    for (uint32_t i = 6; i < 11; i++) {
+        sensor_reading_t r = make_reading(i * 10, 0, (float)i);
+        buffer_write(buf, &r);
+    }
+
+    buffer_range_iter_t it;
+    buffer_span_t span;
+    ASSERT_EQ(buffer_range_begin(buf, 50, 90, &it), 4, "4 readings in [50, 90)");
+
+    ASSERT_TRUE(buffer_range_next(&it, &span),        "first span");
+    ASSERT_TRUE(span.data >= buf->buffer &&
+                span.data <  buf->buffer + buf->capacity, "span points into storage");
+    ASSERT_EQ(span.data[0].timestamp, 50,              "first span starts at t0");
+    size_t total = span.count;
+    ASSERT_TRUE(buffer_range_next(&it, &span),        "second span after wrap");
+    ASSERT_EQ(span.data, buf->buffer,                  "second span starts at array base");
+    ASSERT_EQ(span.data[span.count - 1].timestamp, 80, "last reading before t1");
+    total += span.count;
+    ASSERT_EQ(total, 4,                                "spans cover the range");
+    ASSERT_FALSE(buffer_range_next(&it, &span),       "iterator exhausted");
+
+    ASSERT_EQ(buffer_range_begin(buf, 200, 300, &it), 0, "range past newest is empty");
+    ASSERT_FALSE(buffer_range_next(&it, &span),          "no spans for empty range");
+    ASSERT_EQ(buffer_count(buf), 7,                      "iteration is non-destructive");
+
+    buffer_destroy(buf);
+}
+
+static void test_arena(void)
+{
+    test_header("arena_alloc — bump allocation, alignment, exhaustion");
+
+    ASSERT_TRUE(arena_create(0, 0) == NULL, "zero-size arena rejected");
+
+    arena_t *a = arena_create(4 * CACHE_LINE, 0);
+    ASSERT_TRUE(a != NULL, "arena created");
+    ASSERT_EQ(arena_remaining(a), (size_t)(4 * CACHE_LINE), "whole size available");
+
+    unsigned char *p = arena_alloc(a, 1);
+    unsigned char *q = arena_alloc(a, CACHE_LINE + 1);
+    ASSERT_TRUE(((uintptr_t)p % CACHE_LINE) == 0, "first block aligned");
+    ASSERT_TRUE(q == p + CACHE_LINE, "blocks adjacent, rounded to a line");
+    ASSERT_EQ(arena_remaining(a), (size_t)CACHE_LINE, "three lines used");
+    ASSERT_TRUE(q[CACHE_LINE] == 0, "blocks zero-filled");
+    ASSERT_TRUE(arena_contains(a, q) && !arena_contains(a, &q), "contains");
+
+    ASSERT_TRUE(arena_alloc(a, CACHE_LINE + 1) == NULL, "too big refused");
+    ASSERT_TRUE(arena_alloc(a, CACHE_LINE) != NULL, "exact fit accepted");
+    ASSERT_TRUE(arena_alloc(a, 0) == NULL, "full arena refuses even 0 bytes");
+    arena_destroy(a);
+    arena_destroy(NULL);
+
+    arena_t *h = arena_create(1000, ARENA_HUGEPAGES);
+    ASSERT_TRUE(h != NULL && arena_alloc(h, 1000) != NULL,
+                "huge-page arena usable (or fell back)");
+    printf("  info  huge-page request backed by: %s\n", arena_backing_name(h));
+    arena_destroy(h);
+}
+
+static void test_create_in_arena(void)
+{
+    test_header("buffer_create_in — header and storage in one block");
+
+    arena_t *a = arena_create(2 * buffer_footprint(8), 0);
+    ring_buffer_t *b = buffer_create_in(a, 8);
+    ASSERT_TRUE(b != NULL, "ring placed in the arena");
+    ASSERT_TRUE(buffer_get_status(b).in_arena, "marked in_arena");
+    ASSERT_TRUE((unsigned char *)b->buffer == (unsigned char *)b + CACHE_LINE,
+                "storage on the line after the header");
+    ASSERT_TRUE(buffer_create_in(a, 10000) == NULL, "oversized ring refused");
+    ASSERT_TRUE(buffer_create_in(NULL, 8) == NULL, "NULL arena refused");
+
+    sensor_reading_t r = make_reading(1, 0, 2.5f), out;
+    ASSERT_TRUE(buffer_write(b, &r) && buffer_read(b, &out), "write/read work");
+    ASSERT_TRUE(out.value == 2.5f, "value round-trips");
+
+    buffer_destroy(b);      /* no free: the arena owns it */
+    arena_destroy(a);
+}
+
 /* ============================================================================
  * MAIN
  * ========================================================================== */
@@ -269,6 +390,10 @@ int main(void)
     test_peek();
     test_clear();
     test_capacity_one();
+    test_find_from();
+    test_range_spans();
+    test_arena();
+    test_create_in_arena();
 
     printf("\n==============================\n");
     printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
@@ -0,0 +1,257 @@
+/**
+ * @file test_config.c
+ * @brief Unit tests for the configuration loader
+ *
+ * Build:  make test
+ * Run:    ./build/test_config
+ */
+
+#include "../src/config.h"
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+static const char k_example[] =
+    "# two sensors, one gap\n"
+    "[logger]\n"
+    "path        = out/test.csv\n"
+    "flush_every = 8\n"
+    "\n"
+    "[manager]\n"
+    "hugepages = false\n"
+    "\n"
+    "[watchdog]\n"
+    "misses = 3\n"
+    "\n"
+    "[sensor.0]\n"
+    "name          = Temperature (C)\n"
+    "buffer        = 32\n"
+    "warn_high     = 70\n"
+    "critical_high = 85\n"
+    "filter        = median 5\n"
+    "filter        = moving_avg 4\n"
+    "period        = 250\n"
+    "phase         = 40\n"
+    "\n"
+    "[sensor.2]\n"
+    "  name = \"Vibration (g)\"   \n"
+    "  filter = biquad 0.5 0.5 0 0 0\n"
+    "  log_raw = true\n";
+
+/** Parse `text`, expecting failure on `line` */
+static bool fails_at(const char *text, unsigned line)
+{
+    config_t cfg;
+    config_error_t err = {0};
+    return !config_parse(&cfg, text, &err) && err.line == line;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_parse(void)
+{
+    test_header("config_parse — sections, keys and defaults");
+
+    config_t cfg;
+    config_error_t err;
+    ASSERT_TRUE(config_parse(&cfg, k_example, &err), "example parses");
+    ASSERT_EQ(cfg.capacity, 3, "capacity = highest id + 1");
+    ASSERT_TRUE(strcmp(cfg.log_path, "out/test.csv") == 0, "logger path");
+    ASSERT_EQ(cfg.flush_every, 8u, "flush_every");
+    ASSERT_EQ(cfg.watchdog_misses, 3u, "watchdog misses");
+
+    const config_sensor_t *t = &cfg.sensors[0];
+    ASSERT_TRUE(t->present && strcmp(t->name, "Temperature (C)") == 0,
+                "sensor 0 named");
+    ASSERT_EQ(t->buffer, 32u, "buffer size");
+    ASSERT_TRUE(t->thresholds.enabled && t->thresholds.warn_high == 70.0f &&
+                t->thresholds.critical_high == 85.0f, "limits given");
+    ASSERT_TRUE(t->thresholds.warn_low == -FLT_MAX &&
+                t->thresholds.critical_low == -FLT_MAX,
+                "limits left out never fire");
+    ASSERT_EQ(t->n_filters, 2, "two filter stages");
+    ASSERT_TRUE(t->filters[0].type == FILTER_MEDIAN && t->filters[0].window == 5 &&
+                t->filters[1].type == FILTER_MOVING_AVG && t->filters[1].window == 4,
+                "stages in file order");
+
+    ASSERT_TRUE(t->period_ms == 250 && t->phase_ms == 40, "period and phase");
+
+    ASSERT_FALSE(cfg.sensors[1].present, "gap stays undeclared");
+
+    const config_sensor_t *v = &cfg.sensors[2];
+    ASSERT_TRUE(strcmp(v->name, "Vibration (g)") == 0, "quotes stripped");
+    ASSERT_EQ(v->buffer, (uint32_t)SENSOR_BUFFER_CAPACITY, "default buffer");
+    ASSERT_FALSE(v->thresholds.enabled, "no limits = thresholds off");
+    ASSERT_TRUE(v->filters[0].type == FILTER_BIQUAD &&
+                v->filters[0].biquad.b1 == 0.5f, "biquad coefficients");
+    ASSERT_TRUE(v->log_raw, "log_raw");
+    ASSERT_TRUE(v->period_ms == CONFIG_DEFAULT_PERIOD_MS && v->phase_ms == 0,
+                "default period, no phase");
+}
+
+static void test_errors(void)
+{
+    test_header("config_parse — errors name the line");
+
+    ASSERT_TRUE(fails_at("[sensor.0]\nbufer = 4\n", 2), "unknown key");
+    ASSERT_TRUE(fails_at("[sensor.0]\nwarn_high = hot\n", 2), "not a number");
+    ASSERT_TRUE(fails_at("[sensor.0]\nbuffer = -4\n", 2), "negative count");
+    ASSERT_TRUE(fails_at("name = x\n", 1), "key outside a section");
+    ASSERT_TRUE(fails_at("[sensor.0]\n[sensor.0]\n", 2), "sensor declared twice");
+    ASSERT_TRUE(fails_at("[sensor.8]\n", 1), "id out of range");
+    ASSERT_TRUE(fails_at("[sensors]\n", 1), "unknown section");
+    ASSERT_TRUE(fails_at("[logger\n", 1), "unterminated header");
+    ASSERT_TRUE(fails_at("[sensor.0]\nfilter = median 32\n", 2), "window too long");
+    ASSERT_TRUE(fails_at("[sensor.0]\nfilter = biquad 1 2\n", 2),
+                "biquad needs five coefficients");
+    ASSERT_TRUE(fails_at("[sensor.0]\nfilter = median 3\nfilter = median 3\n"
+                         "filter = median 3\nfilter = median 3\n"
+                         "filter = median 3\n", 6), "too many stages");
+    ASSERT_TRUE(fails_at("[logger]\nflush_every = 0\n", 2), "flush_every >= 1");
+    ASSERT_TRUE(fails_at("[watchdog]\nmisses = some\n", 2), "misses not a count");
+
+    char big[CONFIG_LINE_MAX + 16];
+    memset(big, '#', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    ASSERT_TRUE(fails_at(big, 1), "overlong line");
+
+    /* Whole-file problems have no line */
+    ASSERT_TRUE(fails_at("# nothing\n", 0), "no sensors");
+    ASSERT_TRUE(fails_at("[sensor.0]\nbuffer = 0\n", 0), "empty ring");
+    ASSERT_TRUE(fails_at("[sensor.0]\nperiod = 0\n", 0), "zero period");
+    ASSERT_TRUE(fails_at("[sensor.0]\nwarn_high = 90\ncritical_high = 80\n", 0),
+                "limits out of order");
+}
+
+static void test_build(void)
+{
+    test_header("config_build — one manager, every ring in its arena");
+
+    config_t cfg;
+    config_error_t err;
+    config_parse(&cfg, k_example, &err);
+    manager_t *m = config_build(&cfg, &err);
+    ASSERT_TRUE(m != NULL, "manager built");
+    ASSERT_EQ(m->count, 2, "two sensors registered");
+    ASSERT_TRUE(m->registered[0] && !m->registered[1] && m->registered[2],
+                "at their declared ids");
+    ASSERT_TRUE(arena_contains(m->arena, m->sensors[0].buf) &&
+                arena_contains(m->arena, m->sensors[2].buf),
+                "rings preallocated in the arena");
+    ASSERT_EQ(arena_remaining(m->arena), (size_t)0, "arena sized exactly");
+
+    ASSERT_TRUE(strcmp(m->sensors[0].name, "Temperature (C)") == 0, "name applied");
+    ASSERT_EQ(m->sensors[0].buf->capacity, (size_t)32, "buffer applied");
+    ASSERT_EQ(manager_check_threshold(m, 0, 75.0f), ALERT_WARNING, "thresholds applied");
+    ASSERT_EQ(manager_check_threshold(m, 0, -500.0f), ALERT_NONE, "no low limit");
+    ASSERT_EQ(m->sensors[0].filter.count, 2, "filters applied");
+    ASSERT_TRUE(m->sensors[2].log_raw, "log_raw applied");
+    ASSERT_TRUE(manager_log(m, 2, 1.0f, 1), "sensors accept readings");
+
+    threshold_table_t table;
+    config_thresholds(&cfg, &table);
+    ASSERT_TRUE(table.limits[0].enabled && table.limits[0].warn_high == 70.0f &&
+                !table.limits[2].enabled, "config_thresholds mirrors the file");
+
+    watchdog_t wd;
+    watchdog_init(&wd, m, 0);
+    ASSERT_TRUE(config_watchdog(&cfg, &wd), "config_watchdog");
+    ASSERT_TRUE(wd.entries[0].watched && wd.entries[0].timeout_ms == 750 &&
+                wd.entries[2].timeout_ms == 3 * CONFIG_DEFAULT_PERIOD_MS &&
+                !wd.entries[1].watched, "declared sensors watched at misses x period");
+    manager_attach_watchdog(m, NULL);
+
+    manager_destroy(m);
+}
+
+static void test_load(void)
+{
+    test_header("config_load / config_open_logger — file and flush policy");
+
+    const char *path = "test_config.ini";
+    const char *out  = "test_config_out.csv";
+    remove(out);
+
+    FILE *f = fopen(path, "w");
+    fprintf(f, "[logger]\npath = %s\nflush_every = 2\n\n"
+               "[sensor.0]\nname = T\nbuffer = 4\n\n[sensor.1]\nfilter = bogus\n",
+            out);
+    fclose(f);
+
+    config_t cfg;
+    config_error_t err;
+    ASSERT_FALSE(config_load(&cfg, path, &err), "bad file rejected");
+    ASSERT_EQ(err.line, 10u, "at the file's line number");
+
+    f = fopen(path, "w");
+    fprintf(f, "[logger]\npath = %s\nflush_every = 2\n\n[sensor.0]\nname = T\n", out);
+    fclose(f);
+    ASSERT_TRUE(config_load(&cfg, path, &err), "good file loads");
+
+    csv_logger_t logger;
+    ASSERT_TRUE(config_open_logger(&cfg, &logger), "logger opened at its path");
+    ASSERT_EQ(logger.flush_every, 2u, "flush policy applied");
+    sensor_reading_t r = {.timestamp = 1, .sensor_id = 0, .value = 1.0f};
+    logger_write(&logger, &r, "T", ALERT_NONE);
+    ASSERT_EQ(logger.unflushed, 1u, "first row held back");
+    logger_write(&logger, &r, "T", ALERT_NONE);
+    ASSERT_EQ(logger.unflushed, 0u, "second row flushes both");
+    logger_close(&logger);
+
+    ASSERT_FALSE(config_load(&cfg, "no/such/file.ini", &err), "missing file");
+    ASSERT_EQ(err.line, 0u, "reported without a line");
+
+    remove(path);
+    remove(out);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Config Loader Test Suite\n");
+    printf("==============================\n");
+
+    test_parse();
+    test_errors();
+    test_build();
+    test_load();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
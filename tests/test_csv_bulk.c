@@ -0,0 +1,276 @@
+/**
+ * @file test_csv_bulk.c
+ * @brief Unit tests for the bulk (mmap, columnar) CSV reader
+ *
+ * Build:  make test  (or: gcc -Wall -Wextra -std=c11 src/csv_parser.c src/csv_bulk.c tests/test_csv_bulk.c -o test_csv_bulk)
+ * Run:    ./build/test_csv_bulk
+ */
+
+#include "../src/csv_bulk.h"
+#include "../src/csv_parser.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+static const char k_log[] =
+    "timestamp,sensor_id,sensor_name,value,alert_level\n"
+    "1000,0,Temperature (C),42.0000,NONE\n"
+    "2000,1,Vibration (g),0.1200,WARNING\r\n"
+    "# comment\n"
+    "\n"
+    "3000,0,Temperature (C),-71.5000,CRITICAL\n"
+    "4000,0,Temperature (C),abc,NONE\n"         /* bad value */
+    "5000,0,Temperature (C),1.0\n"              /* missing alert */
+    "6000,2,Humidity (%),55.2500,NONE";         /* no final newline */
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_columns(void)
+{
+    test_header("csv_bulk_read — columns from memory");
+
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    ASSERT_TRUE(csv_columns_init(&cols, 16),            "columns allocated");
+    csv_columns_t none;
+    ASSERT_FALSE(csv_columns_init(&none, 0),            "zero capacity rejected");
+
+    csv_bulk_open_mem(r, k_log, sizeof(k_log) - 1);
+    size_t n = csv_bulk_read(r, &cols);
+
+    ASSERT_EQ(n, 4,                                     "four good rows");
+    ASSERT_EQ(cols.timestamp[0], 1000,                  "timestamp column");
+    ASSERT_EQ(cols.sensor_id[1], 1,                     "sensor_id column");
+    ASSERT_EQ(cols.value[2], -71.5f,                    "value column");
+    ASSERT_EQ(cols.alert[1], ALERT_WARNING,             "alert column (CRLF row)");
+    ASSERT_EQ(cols.alert[2], ALERT_CRITICAL,            "critical alert");
+    ASSERT_EQ(cols.value[3], 55.25f,                    "last line without newline");
+    ASSERT_EQ(r->skipped, 3,                            "header, comment, blank skipped");
+    ASSERT_EQ(r->bad, 2,                                "bad value and short row counted");
+    ASSERT_EQ(csv_bulk_read(r, &cols), 0,               "end of data");
+
+    csv_bulk_rewind(r);
+    ASSERT_EQ(csv_bulk_read(r, &cols), 4,               "rewind reads again");
+
+    csv_columns_free(&cols);
+    free(r);
+}
+
+static void test_small_batches(void)
+{
+    test_header("csv_bulk_read — batch smaller than the file");
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    csv_columns_init(&cols, 1);
+
+    csv_bulk_open_mem(r, k_log, sizeof(k_log) - 1);
+    uint32_t ts[8];
+    size_t total = 0, calls = 0;
+    while (csv_bulk_read(r, &cols) > 0)
+    {
+        ts[total++] = cols.timestamp[0];
+        calls++;
+    }
+    ASSERT_EQ(total, 4,                                 "every row, one per call");
+    ASSERT_TRUE(ts[0] == 1000 && ts[1] == 2000 && ts[2] == 3000 && ts[3] == 6000,
+                                                        "in file order, none repeated");
+    csv_columns_free(&cols);
+    free(r);
+}
+
+static void test_windows(void)
+{
+    test_header("csv_bulk_read — many rows, odd batches, a very long line");
+    /* ~12 KB of rows with varying lengths, so rows straddle the 64-byte
+     * mask blocks at every offset, read in batches that split them at
+     * every possible point */
+    enum { BODY = 12288, LONG_LINE = 5000 };
+    size_t cap = BODY + LONG_LINE + 256;
+    char *buf = malloc(cap);
+    size_t len = 0, rows = 0;
+    while (len + 64 < BODY)
+    {
+        len += (size_t)snprintf(buf + len, cap - len, "%zu,%zu,%.*s,%zu.%04zu,NONE\n",
+                                rows, rows % 7, (int)(rows % 23) + 1,
+                                "Sensor name of many sizes", rows, rows % 10000);
+        rows++;
+    }
+    /* and one line far longer than any real row */
+    memset(buf + len, 'x', LONG_LINE);
+    len += LONG_LINE;
+    buf[len++] = '\n';
+    len += (size_t)snprintf(buf + len, cap - len, "1,0,A,1.0,NONE\n");
+
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    csv_columns_init(&cols, 97);            /* odd batch size */
+    csv_bulk_open_mem(r, buf, len);
+
+    size_t got = 0, ordered = 1;
+    while (csv_bulk_read(r, &cols) > 0)
+    {
+        for (size_t i = 0; i < cols.count; i++, got++)
+        {
+            if (got < rows && (cols.timestamp[i] != got ||
+                               cols.value[i] != (float)got + (float)(got % 10000) / 10000.0f))
+                ordered = 0;
+        }
+    }
+    ASSERT_EQ(got, rows + 1,                            "every row plus the one after the long line");
+    ASSERT_TRUE(ordered,                                "timestamps and values match");
+    ASSERT_EQ(r->bad, 1,                                "long garbage line counted once");
+
+    csv_columns_free(&cols);
+    free(r);
+    free(buf);
+}
+
+static void test_fast_path_fallbacks(void)
+{
+    test_header("csv_bulk_read — rows outside the SWAR fast path");
+    static const char k_odd[] =
+        "4294967295,3,Long timestamp,1.5e2,WARNING\n"
+        "12,255,Plus sign,+2.25,CRITICAL\n"
+        "13,256,Id too big,1.0,NONE\n"
+        "14,1,Fixed fraction,-0.0625,NONE\n"
+        "15,1,Extra,field,3.5,NONE\n"
+        "16,1,No fraction,7,NONE";
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    csv_columns_init(&cols, 8);
+    csv_bulk_open_mem(r, k_odd, sizeof(k_odd) - 1);
+
+    ASSERT_EQ(csv_bulk_read(r, &cols), 4,               "four good rows");
+    ASSERT_EQ(cols.timestamp[0], 4294967295u,           "ten-digit timestamp");
+    ASSERT_EQ(cols.value[0], 150.0f,                    "exponent");
+    ASSERT_EQ(cols.sensor_id[1], 255,                   "largest sensor id");
+    ASSERT_EQ(cols.value[1], 2.25f,                     "leading plus");
+    ASSERT_EQ(cols.value[2], -0.0625f,                  "negative fixed fraction");
+    ASSERT_EQ(cols.value[3], 7.0f,                      "integer value, no newline");
+    ASSERT_EQ(r->bad, 2,                                "id 256 and comma in name are bad");
+    csv_columns_free(&cols);
+    free(r);
+}
+
+static void test_block_end(void)
+{
+    test_header("csv_bulk_read — data ending exactly on a 64-byte block");
+    char buf[128];
+    /* 36 + 28 bytes: the unterminated second row ends the first block */
+    memcpy(buf, "1000,0,Temperature (C),23.6000,NONE\n", 36);
+    memcpy(buf + 36, "2000,1,Humidity (%),41.2,NO", 28);
+
+    csv_bulk_t *r = malloc(sizeof(*r));
+    csv_columns_t cols;
+    csv_columns_init(&cols, 8);
+    csv_bulk_open_mem(r, buf, 64);
+    ASSERT_EQ(csv_bulk_read(r, &cols), 2,               "both rows");
+    ASSERT_EQ(cols.value[1], 41.2f,                     "last row read to the end of data");
+    ASSERT_EQ(r->bad + r->skipped, 0,                   "no phantom line");
+    csv_columns_free(&cols);
+    free(r);
+}
+
+static void test_mmap_vs_stream(void)
+{
+    test_header("csv_bulk_open — mmap data/serial_log.csv vs streaming parser");
+    csv_bulk_t *r = malloc(sizeof(*r));
+    ASSERT_FALSE(csv_bulk_open(r, "/nonexistent/log.csv"), "missing file rejected");
+
+    if (!csv_bulk_open(r, "data/serial_log.csv"))
+    {
+        printf("  SKIP  data/serial_log.csv not found (run from the repo root)\n");
+        free(r);
+        return;
+    }
+
+    csv_columns_t cols;
+    csv_columns_init(&cols, 1000);
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+
+    size_t rows = 0, mismatches = 0, used = 0;
+    sensor_reading_t ref[1000];
+    while (csv_bulk_read(r, &cols) > 0)
+    {
+        /* Reference rows from the same bytes via csv_parse_chunk */
+        size_t n = 0;
+        while (n < cols.count && used < r->size)
+        {
+            size_t consumed;
+            n += csv_parse_chunk(&p, r->data + used, r->size - used, ref + n,
+                                 cols.count - n, &consumed);
+            used += consumed;
+        }
+        for (size_t i = 0; i < cols.count; i++)
+        {
+            if (i >= n || ref[i].timestamp != cols.timestamp[i] ||
+                ref[i].sensor_id != cols.sensor_id[i] || ref[i].value != cols.value[i])
+                mismatches++;
+        }
+        rows += cols.count;
+    }
+    ASSERT_TRUE(rows > 2000,                            "whole log read");
+    ASSERT_EQ(mismatches, 0,                            "identical to the streaming parser");
+    ASSERT_EQ(r->bad, 0,                                "no bad rows");
+
+    csv_bulk_close(r);
+    ASSERT_TRUE(r->data == NULL,                        "closed");
+    csv_columns_free(&cols);
+    free(r);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Bulk CSV Reader Test Suite\n");
+    printf("  SIMD path: %s\n", csv_bulk_isa());
+    printf("==============================\n");
+
+    test_columns();
+    test_small_batches();
+    test_windows();
+    test_fast_path_fallbacks();
+    test_block_end();
+    test_mmap_vs_stream();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
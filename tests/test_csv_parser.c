@@ -0,0 +1,302 @@
+/**
+ * @file test_csv_parser.c
+ * @brief Unit tests for the streaming CSV parser
+ *
+ * Build:  make test  (or: gcc -Wall -Wextra -std=c11 src/csv_parser.c tests/test_csv_parser.c -o test_csv_parser)
+ * Run:    ./build/test_csv_parser
+ */
+
+#include "../src/csv_parser.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) <= (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* Arduino output as the board sends it: CRLF, banner, resent header */
+static const char k_stream[] =
+    "timestamp,sensor_id,sensor_name,value,alert_level\r\n"
+    "# Predictive Maintenance Monitor - Arduino\r\n"
+    "# Sensors: DHT11 (temp/humidity) + MPU6050 (vibration)\r\n"
+    "88,0,Temperature (C),23.6000,NONE\r\n"
+    "88,1,Humidity (%),14.2000,WARNING\r\n"
+    "# WARNING: DHT11 read failed\r\n"
+    "88,2,Vibration (g),-0.0674,NONE\r\n"
+    "\r\n"
+    "timestamp,sensor_id,sensor_name,value,alert_level\r\n"
+    "1090,2,Vibration (g),1.2500,CRITICAL\r\n";
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_lines(void)
+{
+    test_header("csv_parse_line — fields and rejects");
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    sensor_reading_t r;
+
+    const char *row = "2190,2,Vibration (g),-0.0674,CRITICAL\r";
+    ASSERT_TRUE(csv_parse_line(&p, row, strlen(row), &r),  "CRLF row parses");
+    ASSERT_EQ(r.timestamp, 2190,                            "timestamp");
+    ASSERT_EQ(r.sensor_id, 2,                               "sensor_id");
+    ASSERT_EQ(r.value, -0.0674f,                            "value exact");
+
+    const char *no_alert = "5,0,T,7";
+    ASSERT_TRUE(csv_parse_line(&p, no_alert, strlen(no_alert), &r), "alert column optional");
+    ASSERT_EQ(r.value, 7.0f,                                "integer value");
+
+    const char *bad[] = {
+        "88,0,Temperature (C)",         /* no value */
+        "88,0,Temp,abc,NONE",           /* not a number */
+        "88,300,Temp,1.0,NONE",         /* id > 255 */
+        "88,0,Temp,1.0x,NONE",          /* junk after the number */
+        "99999999999,0,Temp,1.0,NONE",  /* timestamp overflow */
+        "garbage",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+        csv_parse_line(&p, bad[i], strlen(bad[i]), &r);
+    ASSERT_EQ(p.bad, sizeof(bad) / sizeof(bad[0]),         "malformed lines counted as bad");
+
+    const char *skip[] = { "", "\r", "# comment", "timestamp,sensor_id" };
+    for (size_t i = 0; i < sizeof(skip) / sizeof(skip[0]); i++)
+        csv_parse_line(&p, skip[i], strlen(skip[i]), &r);
+    ASSERT_EQ(p.skipped, 4,                                 "blank, comment, header skipped");
+    ASSERT_EQ(p.rows, 2,                                    "rows counted");
+}
+
+static void test_decimals(void)
+{
+    test_header("decimal parsing matches strtof");
+    const char *vals[] = {
+        "0", "-0.0001", "23.6000", "14.2000", "-0.0674", "1e3", "2.5E-2",
+        "+12.75", "123456.789", "0.000001", "3.4028235e38", "1.17549435e-38",
+        "12345678901234567890123", ".5", "5.",
+    };
+    int exact = 0;
+    size_t count = sizeof(vals) / sizeof(vals[0]);
+
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    for (size_t i = 0; i < count; i++)
+    {
+        char line[96];
+        snprintf(line, sizeof(line), "1,0,X,%s,NONE", vals[i]);
+        sensor_reading_t r;
+        if (csv_parse_line(&p, line, strlen(line), &r) && r.value == strtof(vals[i], NULL))
+            exact++;
+        else
+            printf("        mismatch on %s\n", vals[i]);
+    }
+    ASSERT_EQ(exact, (int)count,                            "every sample bit-exact");
+}
+
+static void test_every_split(void)
+{
+    test_header("csv_parse_chunk — every two-chunk split");
+    size_t len = sizeof(k_stream) - 1;
+    int good = 0;
+
+    for (size_t cut = 0; cut <= len; cut++)
+    {
+        csv_parser_t p;
+        csv_parser_init(&p, NULL);
+        sensor_reading_t out[8];
+        size_t consumed, n = 0;
+
+        n += csv_parse_chunk(&p, k_stream, cut, out, 8, &consumed);
+        n += csv_parse_chunk(&p, k_stream + cut, len - cut, out + n, 8 - n, &consumed);
+
+        if (n == 4 && p.skipped == 6 && p.bad == 0 &&
+            out[1].sensor_id == 1 && out[1].value == 14.2f &&
+            out[3].timestamp == 1090)
+            good++;
+    }
+    ASSERT_EQ(good, (int)len + 1,                           "same 4 rows for every split point");
+
+    /* One byte at a time */
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    sensor_reading_t out[8];
+    size_t consumed, n = 0;
+    for (size_t i = 0; i < len; i++)
+        n += csv_parse_chunk(&p, k_stream + i, 1, out + n, 8 - n, &consumed);
+    ASSERT_EQ(n, 4,                                         "byte-by-byte stream");
+    ASSERT_EQ(out[2].value, -0.0674f,                       "byte-by-byte value");
+}
+
+static void test_output_full(void)
+{
+    test_header("csv_parse_chunk — output array fills up");
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    sensor_reading_t out[1];
+    size_t len = sizeof(k_stream) - 1, used = 0, total = 0, calls = 0;
+
+    while (used < len)
+    {
+        size_t consumed;
+        total += csv_parse_chunk(&p, k_stream + used, len - used, out, 1, &consumed);
+        used += consumed;
+        calls++;
+    }
+    ASSERT_EQ(total, 4,                                     "all rows via resumed calls");
+    ASSERT_TRUE(calls >= 4,                                 "stopped when out was full");
+    ASSERT_EQ(p.rows, 4,                                    "no row parsed twice");
+}
+
+static void test_overlong(void)
+{
+    test_header("csv_parse_chunk — overlong line resync");
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    sensor_reading_t out[4];
+    size_t consumed, n = 0;
+
+    char noise[CSV_LINE_MAX + 40];
+    memset(noise, 'x', sizeof(noise));
+    n += csv_parse_chunk(&p, "1,0,A,1.0\n", 10, out, 4, &consumed);
+    n += csv_parse_chunk(&p, noise, 60, out + n, 4 - n, &consumed);
+    n += csv_parse_chunk(&p, noise, sizeof(noise), out + n, 4 - n, &consumed);
+    n += csv_parse_chunk(&p, "xx\n2,0,A,2.0\n", 13, out + n, 4 - n, &consumed);
+
+    ASSERT_EQ(n, 2,                                         "rows on both sides kept");
+    ASSERT_EQ(p.bad, 1,                                     "overlong line counted once");
+    ASSERT_EQ(out[1].value, 2.0f,                           "parser resynced at newline");
+}
+
+static void test_dict(void)
+{
+    test_header("csv_dict — name to ID");
+    csv_dict_t d;
+    csv_dict_init(&d);
+
+    ASSERT_TRUE(csv_dict_add(&d, "Temperature (C)", 0),     "add temperature");
+    ASSERT_TRUE(csv_dict_add(&d, "Humidity (%)", 1),        "add humidity");
+    ASSERT_TRUE(csv_dict_add(&d, "Vibration (g)", 7),       "add vibration");
+    ASSERT_FALSE(csv_dict_add(&d, "Humidity (%)", 3),       "duplicate rejected");
+    ASSERT_FALSE(csv_dict_add(&d, "A name that is far too long for the table", 4),
+                                                            "overlong name rejected");
+
+    uint8_t id = 0xFF;
+    ASSERT_TRUE(csv_dict_lookup(&d, "Vibration (g),0.1", 13, &id), "lookup by byte range");
+    ASSERT_EQ(id, 7,                                        "mapped ID");
+    ASSERT_FALSE(csv_dict_lookup(&d, "Vibration", 9, &id),  "prefix is not a match");
+
+    char name[8];
+    int added = 0;
+    for (int i = 0; i < CSV_DICT_SLOTS; i++)
+    {
+        snprintf(name, sizeof(name), "s%d", i);
+        added += csv_dict_add(&d, name, (uint8_t)i);
+    }
+    ASSERT_EQ(d.count, CSV_DICT_SLOTS / 2,                  "load factor capped at 1/2");
+    ASSERT_EQ(added, CSV_DICT_SLOTS / 2 - 3,                "extra names refused");
+
+    csv_parser_t p;
+    csv_parser_init(&p, &d);
+    sensor_reading_t out[8];
+    size_t consumed;
+    size_t n = csv_parse_chunk(&p, k_stream, sizeof(k_stream) - 1, out, 8, &consumed);
+    ASSERT_EQ(n, 4,                                         "rows with known names");
+    ASSERT_EQ(out[2].sensor_id, 7,                          "ID taken from the name");
+    ASSERT_EQ(p.unknown_names, 0,                           "no unknown names");
+}
+
+static void test_log_file(void)
+{
+    test_header("csv_parse_chunk — data/serial_log.csv vs strtof");
+    FILE *f = fopen("data/serial_log.csv", "rb");
+    if (f == NULL)
+    {
+        printf("  SKIP  data/serial_log.csv not found (run from the repo root)\n");
+        return;
+    }
+
+    static char data[1 << 20];
+    size_t len = fread(data, 1, sizeof(data), f);
+    fclose(f);
+
+    csv_parser_t p;
+    csv_parser_init(&p, NULL);
+    static sensor_reading_t out[1 << 14];
+    size_t consumed, used = 0, n = 0;
+    while (used < len)
+    {
+        size_t step = (len - used < 4096) ? len - used : 4096;
+        n += csv_parse_chunk(&p, data + used, step, out + n,
+                             sizeof(out) / sizeof(out[0]) - n, &consumed);
+        used += consumed;
+    }
+
+    /* Reference: the same file through sscanf/strtof */
+    size_t i = 0, mismatches = 0;
+    for (char *line = strtok(data, "\n"); line != NULL; line = strtok(NULL, "\n"))
+    {
+        unsigned ts, id;
+        int off;
+        if (sscanf(line, "%u,%u,%*[^,],%n", &ts, &id, &off) < 2)
+            continue;
+        float v = strtof(line + off, NULL);
+        if (i >= n || out[i].timestamp != ts || out[i].sensor_id != id || out[i].value != v)
+            mismatches++;
+        i++;
+    }
+    ASSERT_EQ(n, i,                                         "same row count as the reference");
+    ASSERT_TRUE(n > 0,                                      "log has rows");
+    ASSERT_EQ(mismatches, 0,                                "every row identical");
+    ASSERT_EQ(p.bad, 0,                                     "no bad lines");
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  CSV Parser Test Suite\n");
+    printf("==============================\n");
+
+    test_lines();
+    test_decimals();
+    test_every_split();
+    test_output_full();
+    test_overlong();
+    test_dict();
+    test_log_file();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
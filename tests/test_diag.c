@@ -0,0 +1,211 @@
+/**
+ * @file test_diag.c
+ * @brief Unit tests for the leveled diagnostics facility
+ *
+ * Build:  make test  (links src/diag.c src/arena.c src/buffer.c)
+ * Run:    ./build/test_diag
+ */
+
+/* The library may be built with DIAG_MIN_LEVEL raised; the tests' own
+ * calls are compiled at every level regardless. */
+#if defined(DIAG_MIN_LEVEL) && DIAG_MIN_LEVEL > 0
+#define LIBRARY_DEBUG_COMPILED  0
+#else
+#define LIBRARY_DEBUG_COMPILED  1
+#endif
+#undef  DIAG_MIN_LEVEL
+#define DIAG_MIN_LEVEL  0
+
+#include "../src/diag.h"
+#include "../src/buffer.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * CAPTURING SINK
+ * ========================================================================== */
+
+typedef struct {
+    int  calls;
+    int  level;
+    char module[16];
+    char msg[DIAG_LINE_MAX];
+} capture_t;
+
+static void capture_sink(void *ctx, int level, const char *module, const char *msg)
+{
+    capture_t *c = ctx;
+    c->calls++;
+    c->level = level;
+    snprintf(c->module, sizeof(c->module), "%s", module);
+    snprintf(c->msg, sizeof(c->msg), "%s", msg);
+}
+
+static int g_evaluated = 0;
+
+static int side_effect(void)
+{
+    return ++g_evaluated;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_defaults(void)
+{
+    test_header("Defaults — warnings and errors only");
+
+    ASSERT_EQ(diag_get_level(), DIAG_LEVEL_WARN, "runtime level starts at WARN");
+    ASSERT_FALSE(DIAG_ENABLED(DIAG_LEVEL_INFO), "INFO filtered by default");
+    ASSERT_TRUE(DIAG_ENABLED(DIAG_LEVEL_ERROR), "ERROR passes by default");
+    ASSERT_TRUE(strcmp(diag_level_name(DIAG_LEVEL_WARN), "WARN") == 0,
+                "level name WARN");
+    ASSERT_TRUE(strcmp(diag_level_name(42), "?") == 0, "unknown level name");
+}
+
+static void test_filtering(void)
+{
+    test_header("diag_set_level — runtime filter");
+
+    capture_t c = {0};
+    diag_set_sink(capture_sink, &c);
+
+    DIAG_INFO("TEST", "hidden %d", 1);
+    ASSERT_EQ(c.calls, 0, "INFO below WARN not delivered");
+
+    DIAG_WARN("TEST", "shown %d", 2);
+    ASSERT_EQ(c.calls, 1, "WARN delivered");
+    ASSERT_EQ(c.level, DIAG_LEVEL_WARN, "sink gets the level");
+    ASSERT_TRUE(strcmp(c.module, "TEST") == 0, "sink gets the module");
+    ASSERT_TRUE(strcmp(c.msg, "shown 2") == 0, "message formatted, no newline");
+
+    diag_set_level(DIAG_LEVEL_DEBUG);
+    DIAG_DEBUG("TEST", "debug");
+    ASSERT_EQ(c.calls, 2, "DEBUG delivered at level DEBUG");
+
+    diag_set_level(DIAG_LEVEL_OFF);
+    DIAG_ERROR("TEST", "silenced");
+    ASSERT_EQ(c.calls, 2, "nothing delivered at level OFF");
+
+    diag_set_level(-5);
+    ASSERT_EQ(diag_get_level(), DIAG_LEVEL_DEBUG, "level clamped to DEBUG");
+    diag_set_level(99);
+    ASSERT_EQ(diag_get_level(), DIAG_LEVEL_OFF, "level clamped to OFF");
+
+    diag_set_sink(NULL, NULL);
+    diag_set_level(DIAG_LEVEL_WARN);
+}
+
+static void test_lazy_arguments(void)
+{
+    test_header("Filtered calls do not evaluate their arguments");
+
+    capture_t c = {0};
+    diag_set_sink(capture_sink, &c);
+    g_evaluated = 0;
+
+    DIAG_INFO("TEST", "%d", side_effect());
+    ASSERT_EQ(g_evaluated, 0, "argument skipped when filtered");
+
+    DIAG_ERROR("TEST", "%d", side_effect());
+    ASSERT_EQ(g_evaluated, 1, "argument evaluated once when delivered");
+    ASSERT_TRUE(strcmp(c.msg, "1") == 0, "value formatted");
+
+    diag_set_sink(NULL, NULL);
+}
+
+static void test_truncation(void)
+{
+    test_header("Long messages are truncated to DIAG_LINE_MAX");
+
+    capture_t c = {0};
+    diag_set_sink(capture_sink, &c);
+
+    char big[DIAG_LINE_MAX * 2];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    DIAG_ERROR("TEST", "%s", big);
+    ASSERT_EQ(strlen(c.msg), (size_t)DIAG_LINE_MAX - 1, "message truncated");
+
+    diag_set_sink(NULL, NULL);
+}
+
+static void test_library_quiet(void)
+{
+    test_header("buffer_create/destroy — quiet unless DEBUG");
+
+    capture_t c = {0};
+    diag_set_sink(capture_sink, &c);
+
+    ring_buffer_t *buf = buffer_create(8);
+    buffer_destroy(buf);
+    ASSERT_EQ(c.calls, 0, "no output at the default level");
+
+    diag_set_level(DIAG_LEVEL_DEBUG);
+    buf = buffer_create(8);
+    buffer_destroy(buf);
+    if (LIBRARY_DEBUG_COMPILED)
+    {
+        ASSERT_EQ(c.calls, 2, "create and destroy reported at DEBUG");
+        ASSERT_TRUE(strcmp(c.module, "BUFFER") == 0, "tagged BUFFER");
+        ASSERT_EQ(c.level, DIAG_LEVEL_DEBUG, "at level DEBUG");
+    }
+    else
+    {
+        ASSERT_EQ(c.calls, 0, "compiled out by DIAG_MIN_LEVEL");
+    }
+
+    diag_set_level(DIAG_LEVEL_WARN);
+    diag_set_sink(NULL, NULL);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Diagnostics Test Suite\n");
+    printf("==============================\n");
+
+    test_defaults();
+    test_filtering();
+    test_lazy_arguments();
+    test_truncation();
+    test_library_quiet();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
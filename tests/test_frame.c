@@ -0,0 +1,279 @@
+/**
+ * @file test_frame.c
+ * @brief Unit tests for the binary serial framing
+ *
+ * The pty loopback (frames through a real tty into the ingester) lives in
+ * test_ingest.c, which is Linux-only; this suite runs everywhere.
+ *
+ * Build:  make test  (or: gcc -Wall -Wextra -std=c11 src/frame.c tests/test_frame.c -o test_frame)
+ * Run:    ./build/test_frame
+ */
+
+#include "../src/frame.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) <= (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* Deterministic xorshift so failures reproduce */
+static uint32_t g_rng = 0x12345678u;
+static uint32_t rnd(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+/** Decode a whole buffer, resuming whenever out fills */
+static size_t decode_all(frame_decoder_t *d, const uint8_t *data, size_t len,
+                         sensor_reading_t *out, size_t max_out)
+{
+    size_t used = 0, n = 0;
+    while (used < len)
+    {
+        size_t consumed;
+        size_t got = frame_decode(d, data + used, len - used, out + n, max_out - n, &consumed);
+        if (got == 0 && consumed == 0)
+            break;                          /* out is full */
+        n    += got;
+        used += consumed;
+    }
+    return n;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_encode(void)
+{
+    test_header("frame_encode — layout and CRC");
+    ASSERT_EQ(frame_crc16((const uint8_t *)"123456789", 9), 0x29B1, "CRC-16/CCITT-FALSE check value");
+
+    uint8_t f[FRAME_MAX_BYTES];
+    int16_t counts[2] = { 2360, -1 };
+    size_t len = frame_encode(f, sizeof(f), 0, 1000, 10, counts, 2);
+    ASSERT_EQ(len, 12,                                      "8 bytes overhead + 2 per sample");
+    ASSERT_EQ(f[0], FRAME_SYNC,                             "sync byte");
+    ASSERT_EQ(f[1], 8,                                      "length covers ID..counts");
+    ASSERT_EQ(f[3] | (f[4] << 8), 1000,                     "delta timestamp little-endian");
+    ASSERT_EQ(f[8] | (f[9] << 8), 0xFFFF,                   "negative count two's complement");
+
+    ASSERT_EQ(frame_encode(f, sizeof(f), 0, 0, 0, counts, 0), 0,     "zero samples rejected");
+    ASSERT_EQ(frame_encode(f, 10, 0, 0, 0, counts, 2), 0,            "short buffer rejected");
+    ASSERT_EQ(frame_encode(f, sizeof(f), FRAME_ID_TIME, 0, 0, counts, 1), 0, "reserved ID rejected");
+    ASSERT_EQ(frame_encode_time(f, sizeof(f), 0x12345678u), 12,      "time-base frame");
+
+    /* 16 samples per frame vs a ~40-byte CSV row per reading */
+    int16_t batch[16] = { 0 };
+    size_t bytes = frame_encode(f, sizeof(f), 2, 0, 10, batch, 16);
+    ASSERT_TRUE(40.0 / ((double)bytes / 16.0) > 10.0,       "over 10x fewer bytes per reading than CSV");
+}
+
+static void test_roundtrip(void)
+{
+    test_header("frame_decode — timestamps, scales, time base");
+    uint8_t stream[256];
+    size_t len = 0;
+    int16_t temp = 2360, vib[4] = { 100, 200, -300, 400 };
+
+    len += frame_encode_time(stream + len, sizeof(stream) - len, 100000);
+    len += frame_encode(stream + len, sizeof(stream) - len, 0, 500, 0, &temp, 1);
+    len += frame_encode(stream + len, sizeof(stream) - len, 2, -200, 10, vib, 4);
+
+    frame_decoder_t d;
+    frame_decoder_init(&d);
+    frame_set_scale(&d, 0, 0.01f);
+    ASSERT_FALSE(frame_set_scale(&d, FRAME_MAX_SENSORS, 1.0f), "scale ID out of range");
+
+    sensor_reading_t out[8];
+    size_t consumed;
+    size_t n = frame_decode(&d, stream, len, out, 8, &consumed);
+
+    ASSERT_EQ(n, 5,                                         "1 + 4 readings");
+    ASSERT_EQ(consumed, len,                                "whole stream consumed");
+    ASSERT_EQ(out[0].timestamp, 100500,                     "time base + delta");
+    ASSERT_NEAR(out[0].value, 23.6f, 0.0001f,               "scaled temperature");
+    ASSERT_EQ(out[1].timestamp, 100300,                     "negative delta");
+    ASSERT_EQ(out[4].timestamp, 100330,                     "sample i at + i * period");
+    ASSERT_EQ(out[3].value, -300.0f,                        "unscaled counts pass through");
+    ASSERT_EQ(d.time_frames, 1,                             "time-base frame counted");
+    ASSERT_EQ(d.frames, 2,                                  "sensor frames counted");
+}
+
+static void test_splits(void)
+{
+    test_header("frame_decode — every split point, output limits");
+    uint8_t stream[256];
+    size_t len = 0;
+    int16_t c[3] = { 1, 2, 3 };
+    for (uint8_t id = 0; id < 4; id++)
+        len += frame_encode(stream + len, sizeof(stream) - len, id, 10, 1, c, 3);
+
+    int good = 0;
+    for (size_t cut = 0; cut <= len; cut++)
+    {
+        frame_decoder_t d;
+        frame_decoder_init(&d);
+        sensor_reading_t out[16];
+        size_t consumed, n = 0;
+        n += frame_decode(&d, stream, cut, out, 16, &consumed);
+        n += frame_decode(&d, stream + cut, len - cut, out + n, 16 - n, &consumed);
+        if (n == 12 && out[11].sensor_id == 3 && out[11].timestamp == 42 &&
+            d.crc_errors == 0 && d.skipped == 0)
+            good++;
+    }
+    ASSERT_EQ(good, (int)len + 1,                           "identical for every split");
+
+    /* Room for one frame at a time: stops before the next, then resumes */
+    frame_decoder_t d;
+    frame_decoder_init(&d);
+    sensor_reading_t out[4];
+    size_t consumed, total = 0, used = 0, calls = 0;
+    while (used < len)
+    {
+        total += frame_decode(&d, stream + used, len - used, out, 4, &consumed);
+        used += consumed;
+        calls++;
+    }
+    ASSERT_EQ(total, 12,                                    "all readings across calls");
+    ASSERT_EQ(calls, 4,                                     "one frame per call");
+}
+
+static void test_resync(void)
+{
+    test_header("frame_decode — corruption and resync");
+    uint8_t stream[512];
+    size_t len = 0;
+    int16_t c = 7;
+
+    /* Garbage containing SYNC bytes and a bogus length */
+    const uint8_t junk[] = { 0x00, FRAME_SYNC, 0xFF, 0x13, FRAME_SYNC, 0x07 };
+    memcpy(stream, junk, sizeof(junk));
+    len += sizeof(junk);
+
+    size_t a = len;
+    len += frame_encode(stream + len, sizeof(stream) - len, 0, 0, 0, &c, 1);
+    size_t b = len;
+    len += frame_encode(stream + len, sizeof(stream) - len, 1, 0, 0, &c, 1);
+    len += frame_encode(stream + len, sizeof(stream) - len, 2, 0, 0, &c, 1);
+    stream[b + 6] ^= 0x40;                  /* corrupt frame 1's count */
+
+    /* A frame truncated mid-way, followed by a good one: the good frame
+     * starts inside the bytes the decoder took for the truncated one */
+    size_t t = frame_encode(stream + len, sizeof(stream) - len, 3, 0, 0, &c, 1);
+    len += t / 2;
+    len += frame_encode(stream + len, sizeof(stream) - len, 4, 0, 0, &c, 1);
+    (void)a;
+
+    frame_decoder_t d;
+    frame_decoder_init(&d);
+    sensor_reading_t out[16];
+    size_t n = decode_all(&d, stream, len, out, 16);
+
+    ASSERT_EQ(n, 3,                                         "good frames recovered");
+    ASSERT_EQ(out[0].sensor_id, 0,                          "frame after junk");
+    ASSERT_EQ(out[1].sensor_id, 2,                          "frame after a CRC error");
+    ASSERT_EQ(out[2].sensor_id, 4,                          "frame inside a truncated one");
+    ASSERT_TRUE(d.crc_errors >= 2,                          "CRC errors counted");
+    ASSERT_TRUE(d.length_errors >= 1,                       "bad length counted");
+}
+
+static void test_fuzz(void)
+{
+    test_header("frame_decode — random corruption, random chunking");
+    enum { FRAMES = 2000 };
+    static uint8_t stream[FRAMES * FRAME_MAX_BYTES];
+    static bool    damaged[FRAMES];
+    size_t len = 0, intact = 0, intact_samples = 0;
+
+    for (int f = 0; f < FRAMES; f++)
+    {
+        int16_t counts[FRAME_MAX_SAMPLES];
+        uint8_t n = (uint8_t)(1 + rnd() % FRAME_MAX_SAMPLES);
+        for (uint8_t i = 0; i < n; i++)
+            counts[i] = (int16_t)rnd();
+
+        size_t fl = frame_encode(stream + len, sizeof(stream) - len,
+                                 (uint8_t)(f % 8), 5, 1, counts, n);
+        damaged[f] = (rnd() % 10 == 0);
+        if (damaged[f])
+            stream[len + rnd() % fl] ^= (uint8_t)(1u << (rnd() % 8));
+        else
+        {
+            intact++;
+            intact_samples += n;
+        }
+        len += fl;
+    }
+
+    frame_decoder_t d;
+    frame_decoder_init(&d);
+    static sensor_reading_t out[FRAMES * FRAME_MAX_SAMPLES];
+    size_t used = 0, n = 0;
+    while (used < len)
+    {
+        size_t chunk = 1 + rnd() % 300, consumed;
+        if (chunk > len - used)
+            chunk = len - used;
+        n += frame_decode(&d, stream + used, chunk, out + n,
+                          sizeof(out) / sizeof(out[0]) - n, &consumed);
+        used += consumed;
+    }
+
+    ASSERT_EQ(d.frames, intact,                             "every intact frame recovered");
+    ASSERT_EQ(n, intact_samples,                            "every intact sample recovered");
+    ASSERT_TRUE(d.crc_errors + d.length_errors > 0,         "damaged frames rejected");
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Frame Protocol Test Suite\n");
+    printf("==============================\n");
+
+    test_encode();
+    test_roundtrip();
+    test_splits();
+    test_resync();
+    test_fuzz();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
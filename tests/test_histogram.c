@@ -0,0 +1,237 @@
+/**
+ * @file test_histogram.c
+ * @brief Unit tests for the latency histogram and the stage timing hooks
+ *
+ * Build:  make test  (links src/histogram.c src/stage_timing.c)
+ * Run:    ./build/test_histogram
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/histogram.h"
+#include "../src/stage_timing.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/** |got - want| within `frac` of want */
+static bool within(uint64_t got, uint64_t want, double frac)
+{
+    double d = (double)got - (double)want;
+    if (d < 0.0)
+        d = -d;
+    return d <= frac * (double)want;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_empty(void)
+{
+    test_header("hist_create — empty histogram");
+
+    hist_t *h = hist_create();
+    ASSERT_TRUE(h != NULL, "created");
+    ASSERT_EQ(hist_count(h), 0u, "count 0");
+    ASSERT_EQ(hist_min(h), 0u, "min 0 when empty");
+    ASSERT_EQ(hist_max(h), 0u, "max 0 when empty");
+    ASSERT_EQ(hist_percentile(h, 50.0), 0u, "p50 0 when empty");
+    ASSERT_TRUE(hist_mean(h) == 0.0, "mean 0 when empty");
+    hist_destroy(h);
+    hist_destroy(NULL);
+    ASSERT_TRUE(true, "destroy(NULL) is safe");
+}
+
+static void test_exact_range(void)
+{
+    test_header("hist_record — small values are exact");
+
+    hist_t *h = hist_create();
+    for (uint64_t v = 1; v <= 100; v++)
+        hist_record(h, v);
+
+    ASSERT_EQ(hist_count(h), 100u, "100 recorded");
+    ASSERT_EQ(hist_min(h), 1u, "min 1");
+    ASSERT_EQ(hist_max(h), 100u, "max 100");
+    ASSERT_EQ(hist_percentile(h, 50.0), 50u, "p50 = 50");
+    ASSERT_EQ(hist_percentile(h, 90.0), 90u, "p90 = 90");
+    ASSERT_EQ(hist_percentile(h, 99.0), 99u, "p99 = 99");
+    ASSERT_EQ(hist_percentile(h, 100.0), 100u, "p100 = max");
+    ASSERT_EQ(hist_percentile(h, 0.0), 1u, "p0 = min");
+    ASSERT_TRUE(hist_mean(h) == 50.5, "mean 50.5");
+    hist_destroy(h);
+}
+
+static void test_relative_error(void)
+{
+    test_header("hist_percentile — bounded relative error");
+
+    hist_t *h = hist_create();
+    /* 1 .. 1,000,000 ns in steps of 10 */
+    for (uint64_t v = 10; v <= 1000000; v += 10)
+        hist_record(h, v);
+
+    ASSERT_EQ(hist_count(h), 100000u, "100000 recorded");
+    ASSERT_TRUE(within(hist_percentile(h, 50.0), 500000, 0.016), "p50 within 1.6%");
+    ASSERT_TRUE(within(hist_percentile(h, 99.0), 990000, 0.016), "p99 within 1.6%");
+    ASSERT_TRUE(hist_percentile(h, 50.0) >= 500000, "p50 never under-reported");
+    ASSERT_EQ(hist_percentile(h, 100.0), 1000000u, "p100 capped at max");
+
+    /* Huge values still land in a bucket */
+    hist_record(h, UINT64_MAX);
+    hist_record(h, (uint64_t)1 << 40);
+    ASSERT_EQ(hist_max(h), UINT64_MAX, "UINT64_MAX recorded");
+    ASSERT_EQ(hist_percentile(h, 100.0), UINT64_MAX, "top bucket reachable");
+    hist_destroy(h);
+}
+
+static void test_tail(void)
+{
+    test_header("hist_percentile — tail separated from the body");
+
+    hist_t *h = hist_create();
+    for (int i = 0; i < 9990; i++)
+        hist_record(h, 30);            /* fast path */
+    for (int i = 0; i < 10; i++)
+        hist_record(h, 250000);        /* 0.1% stalls */
+
+    ASSERT_EQ(hist_percentile(h, 99.0), 30u, "p99 is the fast path");
+    ASSERT_TRUE(within(hist_percentile(h, 99.95), 250000, 0.016),
+                "p99.95 sees the stalls");
+    ASSERT_EQ(hist_max(h), 250000u, "max exact");
+    hist_destroy(h);
+}
+
+static void test_merge_reset(void)
+{
+    test_header("hist_merge / hist_reset");
+
+    hist_t *a = hist_create();
+    hist_t *b = hist_create();
+    hist_t *m = hist_create();
+    for (uint64_t v = 1; v <= 50; v++)
+        hist_record(a, v);
+    for (uint64_t v = 51; v <= 100; v++)
+        hist_record(b, v);
+
+    hist_merge(m, a);
+    hist_merge(m, b);
+    ASSERT_EQ(hist_count(m), 100u, "merged count");
+    ASSERT_EQ(hist_min(m), 1u, "merged min from a");
+    ASSERT_EQ(hist_max(m), 100u, "merged max from b");
+    ASSERT_EQ(hist_percentile(m, 50.0), 50u, "merged p50");
+    ASSERT_EQ(hist_count(a), 50u, "source untouched");
+
+    hist_reset(m);
+    ASSERT_EQ(hist_count(m), 0u, "reset empties");
+    ASSERT_EQ(hist_percentile(m, 50.0), 0u, "reset clears buckets");
+    hist_record(m, 7);
+    ASSERT_EQ(hist_min(m), 7u, "min re-armed after reset");
+
+    hist_destroy(a);
+    hist_destroy(b);
+    hist_destroy(m);
+}
+
+#define CALLS   (64 * 100)
+
+static void *timed_calls(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < CALLS; i++)
+    {
+        uint64_t t = stage_begin(STAGE_STATS);
+        stage_end(STAGE_STATS, t);
+    }
+    return NULL;
+}
+
+static void test_stage_timing(void)
+{
+    test_header("stage_timing — per-thread sampling and merge");
+
+    ASSERT_EQ(strcmp(stage_name(STAGE_BUFFER_WRITE), "buffer_write"), 0,
+              "stage names");
+
+    pthread_t t[2];
+    for (int i = 0; i < 2; i++)
+        pthread_create(&t[i], NULL, timed_calls, NULL);
+    for (int i = 0; i < 2; i++)
+        pthread_join(t[i], NULL);
+
+    hist_t *h = hist_create();
+    unsigned threads = stage_timing_merge(STAGE_STATS, h);
+    ASSERT_EQ(threads, 2u, "one histogram per thread");
+    ASSERT_EQ(hist_count(h), (uint64_t)(2 * CALLS >> STAGE_SAMPLE_SHIFT),
+              "1 in 2^STAGE_SAMPLE_SHIFT calls sampled");
+    ASSERT_TRUE(hist_max(h) < 1000000000u, "durations are sane");
+
+    hist_reset(h);
+    ASSERT_EQ(stage_timing_merge(STAGE_LOGGER, h), 0u, "untouched stage empty");
+
+    stage_timing_reset();
+    hist_reset(h);
+    stage_timing_merge(STAGE_STATS, h);
+    ASSERT_EQ(hist_count(h), 0u, "reset clears every thread");
+
+    /* A thread's samples outlive it and new threads add to the list */
+    timed_calls(NULL);
+    hist_reset(h);
+    ASSERT_EQ(stage_timing_merge(STAGE_STATS, h), 1u, "main thread registered");
+    ASSERT_EQ(hist_count(h), (uint64_t)(CALLS >> STAGE_SAMPLE_SHIFT),
+              "main thread sampled");
+    hist_destroy(h);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Histogram Test Suite\n");
+    printf("==============================\n");
+
+    test_empty();
+    test_exact_range();
+    test_relative_error();
+    test_tail();
+    test_merge_reset();
+    test_stage_timing();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
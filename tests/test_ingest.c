@@ -0,0 +1,396 @@
+/**
+ * @file test_ingest.c
+ * @brief Unit tests for the epoll serial ingester, driven through ptys
+ *
+ * Each "Arduino" is the master side of a pseudo-terminal; the ingester
+ * opens the slave side exactly as it would open /dev/ttyACM0.
+ *
+ * Build:  make test  (links $(CORE) with src/serial_ingest.c, Linux only)
+ * Run:    ./build/test_ingest
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include "../src/serial_ingest.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) <= (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * PTY HELPERS
+ * ========================================================================== */
+
+/** Open a pty pair; returns the master fd and the slave path */
+static int open_pty(char *slave_path, size_t size)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        return -1;
+
+    const char *name = ptsname(master);
+    if (name == NULL)
+        return -1;
+    snprintf(slave_path, size, "%s", name);
+    return master;
+}
+
+static void send(int fd, const char *text)
+{
+    ssize_t n = write(fd, text, strlen(text));
+    (void)n;
+}
+
+/** Poll until `want` readings were accepted or a few rounds pass */
+static uint64_t poll_for(serial_ingest_t *in, uint64_t want)
+{
+    for (int i = 0; i < 50 && in->accepted < want; i++)
+        ingest_poll(in, 20);
+    return in->accepted;
+}
+
+static manager_t *make_manager(void)
+{
+    manager_t *m = manager_create(3);
+    manager_register(m, 0, "Temperature (C)", 1024);
+    manager_register(m, 1, "Humidity (%)", 1024);
+    manager_register(m, 2, "Vibration (g)", 1024);
+    return m;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_parse_line(void)
+{
+    test_header("ingest_parse_line — Arduino rows");
+    sensor_reading_t r;
+
+    ASSERT_TRUE(ingest_parse_line("88,0,Temperature (C),23.6000,NONE", &r), "data row parses");
+    ASSERT_EQ(r.timestamp, 88,                          "timestamp");
+    ASSERT_EQ(r.sensor_id, 0,                           "sensor id");
+    ASSERT_NEAR(r.value, 23.6f, 0.0001f,                "value");
+
+    ASSERT_TRUE(ingest_parse_line("2190,2,Vibration (g),-0.0674,CRITICAL\r", &r), "CRLF row parses");
+    ASSERT_NEAR(r.value, -0.0674f, 0.0001f,             "negative value");
+
+    ASSERT_FALSE(ingest_parse_line("timestamp,sensor_id,sensor_name,value,alert_level", &r), "header skipped");
+    ASSERT_FALSE(ingest_parse_line("# Predictive Maintenance Monitor", &r), "comment skipped");
+    ASSERT_FALSE(ingest_parse_line("88,0,Temperature (C)", &r),    "missing value rejected");
+    ASSERT_FALSE(ingest_parse_line("88,0,Temp,abc,NONE", &r),      "non-numeric value rejected");
+    ASSERT_FALSE(ingest_parse_line("88,300,Temp,1.0,NONE", &r),    "id out of range rejected");
+}
+
+static void test_single_pty(void)
+{
+    test_header("ingest_poll — one pty, split lines, noise");
+    manager_t *m = make_manager();
+    serial_ingest_t in;
+    ASSERT_TRUE(ingest_init(&in, m),                    "init");
+
+    char path[64];
+    int master = open_pty(path, sizeof(path));
+    ASSERT_TRUE(master >= 0,                            "pty opened");
+    ASSERT_TRUE(ingest_add_device(&in, path, 9600) >= 0, "slave added at 9600 baud");
+    ASSERT_EQ(ingest_add_device(&in, "/nonexistent/tty", 9600), -1, "missing device rejected");
+
+    send(master, "# Predictive Maintenance Monitor - Arduino\n");
+    send(master, "timestamp,sensor_id,sensor_name,value,alert_level\n");
+    send(master, "88,0,Temperature (C),23.6000,NONE\n88,1,Humid");
+    ingest_poll(&in, 100);
+    ASSERT_EQ(in.accepted, 1,                           "complete line logged, partial held");
+
+    send(master, "ity (%),14.2000,WARNING\n");
+    send(master, "garbage line\n88,2,Vibration (g),0.0674,NONE\n");
+    poll_for(&in, 3);
+    ASSERT_EQ(in.accepted, 3,                           "split line completed");
+    ASSERT_EQ(in.devices[0].parser.bad, 1,               "garbage counted, header/comment not");
+    ASSERT_NEAR(m->sensors[1].stats.max, 14.2f, 0.001f, "reassembled value correct");
+
+    close(master);
+    for (int i = 0; i < 10 && in.open_count > 0; i++)
+        ingest_poll(&in, 20);
+    ASSERT_EQ(in.open_count, 0,                         "hang-up removes the device");
+
+    ingest_close(&in);
+    manager_destroy(m);
+}
+
+typedef struct {
+    size_t calls;
+    size_t readings;
+} sink_log_t;
+
+static void count_sink(manager_t *m, const sensor_reading_t *batch,
+                       const alert_level_t *alerts, size_t n, void *ctx)
+{
+    sink_log_t *log = ctx;
+    (void)m;
+    (void)batch;
+    (void)alerts;
+    log->calls++;
+    log->readings += n;
+}
+
+static void test_many_ptys(void)
+{
+    test_header("ingest_poll — several devices on one thread");
+    manager_t *m = make_manager();
+    serial_ingest_t in;
+    ingest_init(&in, m);
+
+    sink_log_t log = { 0, 0 };
+    ingest_set_sink(&in, count_sink, &log);
+
+    enum { BOARDS = 4, ROWS = 200 };
+    int masters[BOARDS];
+    for (int b = 0; b < BOARDS; b++)
+    {
+        char path[64];
+        masters[b] = open_pty(path, sizeof(path));
+        ingest_add_device(&in, path, 115200);
+    }
+    ASSERT_EQ(in.open_count, BOARDS,                    "all boards open");
+
+    for (int row = 0; row < ROWS; row++)
+    {
+        for (int b = 0; b < BOARDS; b++)
+        {
+            char line[64];
+            snprintf(line, sizeof(line), "%d,%d,Sensor,%d.5,NONE\n",
+                     row, b % 3, row);
+            send(masters[b], line);
+        }
+        if (row % 50 == 0)
+            ingest_poll(&in, 0);
+    }
+
+    poll_for(&in, BOARDS * ROWS);
+    ASSERT_EQ(in.accepted, BOARDS * ROWS,               "every row from every board logged");
+    ASSERT_EQ(log.readings, BOARDS * ROWS,              "sink saw every reading");
+    ASSERT_TRUE(log.calls < BOARDS * ROWS,              "readings delivered in batches");
+    ASSERT_EQ(m->total_logs, BOARDS * ROWS,             "manager total matches");
+
+    for (int b = 0; b < BOARDS; b++)
+        close(masters[b]);
+    ingest_close(&in);
+    manager_destroy(m);
+}
+
+typedef struct {
+    sensor_reading_t readings[16];
+    alert_level_t    alerts[16];
+    size_t           n;
+} sink_copy_t;
+
+static void copy_sink(manager_t *m, const sensor_reading_t *batch,
+                      const alert_level_t *alerts, size_t n, void *ctx)
+{
+    sink_copy_t *copy = ctx;
+    (void)m;
+    for (size_t i = 0; i < n && copy->n < 16; i++, copy->n++)
+    {
+        copy->readings[copy->n] = batch[i];
+        copy->alerts[copy->n]   = alerts[i];
+    }
+}
+
+static void test_sink_sees_manager_verdict(void)
+{
+    test_header("ingest sink — accepted readings only, as the manager saw them");
+    manager_t *m = make_manager();
+    manager_set_thresholds(m, 0, (sensor_threshold_t){.warn_low = -100.0f,
+                                                      .warn_high = 30.0f,
+                                                      .critical_low = -100.0f,
+                                                      .critical_high = 100.0f,
+                                                      .enabled = true});
+    manager_add_filter(m, 0, (filter_stage_config_t){.type = FILTER_MEDIAN,
+                                                     .window = 3});
+    manager_pause_sensor(m, 1);
+
+    serial_ingest_t in;
+    ingest_init(&in, m);
+    sink_copy_t copy = { .n = 0 };
+    ingest_set_sink(&in, copy_sink, &copy);
+
+    char path[64];
+    int master = open_pty(path, sizeof(path));
+    ingest_add_device(&in, path, 9600);
+
+    /* A spike the median removes, a paused sensor, an unknown id,
+     * then a real rise */
+    send(master, "1,0,T,20.0,NONE\n2,0,T,20.0,NONE\n3,0,T,90.0,WARNING\n"
+                 "4,1,H,50.0,NONE\n5,7,X,1.0,NONE\n6,0,T,40.0,WARNING\n");
+    for (int i = 0; i < 50 && in.accepted + in.rejected < 6; i++)
+        ingest_poll(&in, 20);
+
+    ASSERT_EQ(in.rejected, 2,                           "paused and unknown rows rejected");
+    ASSERT_EQ(copy.n, 4,                                "sink got only the accepted rows");
+    ASSERT_EQ(copy.readings[2].timestamp, 3,            "spike row kept");
+    ASSERT_NEAR(copy.readings[2].value, 20.0f, 0.001f,  "with the filtered value");
+    ASSERT_EQ(copy.alerts[2], ALERT_NONE,               "and the manager's verdict, not the raw one");
+    ASSERT_EQ(copy.readings[3].timestamp, 6,            "rows after the rejects follow");
+    ASSERT_NEAR(copy.readings[3].value, 40.0f, 0.001f,  "real rise passes the filter");
+    ASSERT_EQ(copy.alerts[3], ALERT_WARNING,            "and is flagged");
+
+    close(master);
+    ingest_close(&in);
+    manager_destroy(m);
+}
+
+static void test_dict_routing(void)
+{
+    test_header("ingest_set_dict — rows routed by sensor_name");
+    manager_t *m = make_manager();
+    serial_ingest_t in;
+    ingest_init(&in, m);
+
+    char path[64];
+    int master = open_pty(path, sizeof(path));
+    ingest_add_device(&in, path, 9600);
+
+    csv_dict_t dict;
+    csv_dict_init(&dict);
+    csv_dict_add(&dict, "Temperature (C)", 0);
+    csv_dict_add(&dict, "Vibration (g)", 2);
+    ingest_set_dict(&in, &dict);
+
+    /* A board that numbers its sensors the other way round */
+    send(master, "10,2,Temperature (C),21.5000,NONE\n");
+    send(master, "10,0,Vibration (g),0.2500,NONE\n");
+    send(master, "10,1,Pressure (kPa),101.3000,NONE\n");
+    poll_for(&in, 2);
+
+    ASSERT_EQ(in.accepted, 2,                           "known names logged");
+    ASSERT_NEAR(m->sensors[0].stats.max, 21.5f, 0.001f, "temperature routed to sensor 0");
+    ASSERT_NEAR(m->sensors[2].stats.max, 0.25f, 0.001f, "vibration routed to sensor 2");
+    ASSERT_EQ(in.devices[0].parser.unknown_names, 1,    "unknown name dropped and counted");
+
+    close(master);
+    ingest_close(&in);
+    manager_destroy(m);
+}
+
+/** Write raw bytes to the "board" side of a pty */
+static void send_bytes(int master, const uint8_t *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(master, data, len);
+        if (n <= 0)
+            return;
+        data += n;
+        len  -= (size_t)n;
+    }
+}
+
+static void test_binary_pty(void)
+{
+    test_header("ingest_set_binary — framed protocol through a pty");
+    manager_t *m = make_manager();
+    serial_ingest_t in;
+    ingest_init(&in, m);
+
+    char path[64];
+    int master = open_pty(path, sizeof(path));
+    int idx = ingest_add_device(&in, path, 9600);
+    ASSERT_EQ(ingest_set_binary(&in, 5), NULL,          "closed slot rejected");
+
+    frame_decoder_t *dec = ingest_set_binary(&in, idx);
+    ASSERT_TRUE(dec != NULL,                            "device switched to frames");
+    frame_set_scale(dec, 0, 0.01f);
+    frame_set_scale(dec, 2, 1.0f / 16384.0f);
+
+    /* As the WIRE_BINARY sketch sends it: time base, a DHT11 reading,
+     * then batches of 16 vibration samples 10 ms apart */
+    enum { BATCHES = 20 };
+    static uint8_t stream[BATCHES * FRAME_MAX_BYTES + 64];
+    size_t len = frame_encode_time(stream, sizeof(stream), 5000);
+    int16_t temp = 2360;
+    len += frame_encode(stream + len, sizeof(stream) - len, 0, 0, 0, &temp, 1);
+
+    size_t corrupt_at = 0;
+    for (int b = 0; b < BATCHES; b++)
+    {
+        int16_t vib[16];
+        for (int i = 0; i < 16; i++)
+            vib[i] = (int16_t)(b * 100 + i);
+        if (b == BATCHES / 2)
+            corrupt_at = len + 9;
+        len += frame_encode(stream + len, sizeof(stream) - len, 2, 160, 10, vib, 16);
+    }
+    stream[corrupt_at] ^= 0x10;             /* one damaged batch on the wire */
+
+    /* Dribble it out in odd-sized writes, like a UART would */
+    for (size_t off = 0; off < len; off += 37)
+    {
+        send_bytes(master, stream + off, (len - off < 37) ? len - off : 37);
+        ingest_poll(&in, 0);
+    }
+    poll_for(&in, 1 + (BATCHES - 1) * 16);
+
+    ASSERT_EQ(in.accepted, 1 + (BATCHES - 1) * 16,      "all intact readings logged");
+    ASSERT_EQ(in.devices[idx].frames.crc_errors, 1,     "damaged batch dropped");
+    ASSERT_NEAR(m->sensors[0].stats.max, 23.6f, 0.001f, "temperature scaled from centi-degrees");
+    ASSERT_NEAR(m->sensors[2].stats.max, (float)((BATCHES - 1) * 100 + 15) / 16384.0f, 1e-6f,
+                                                        "vibration scaled from raw counts");
+
+    close(master);
+    ingest_close(&in);
+    manager_destroy(m);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Serial Ingest Test Suite\n");
+    printf("==============================\n");
+
+    test_parse_line();
+    test_single_pty();
+    test_many_ptys();
+    test_sink_sees_manager_verdict();
+    test_dict_routing();
+    test_binary_pty();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
@@ -3,11 +3,15 @@
  * @brief Unit tests for the sensor manager
  *
  * Build:
- *   gcc src/buffer.c src/sensors.c src/sensor_manager.c tests/test_manager.c
- *       -o build/test_manager.exe -Wall -Wextra -Werror -std=c11 -g -lm
+ *   gcc src/arena.c src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c src/rollup.c src/sensor_manager.c tests/test_manager.c
+ *       -o build/test_manager.exe -Wall -Wextra -Werror -std=c11 -g -lm -pthread
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "../src/sensor_manager.h"
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <math.h>
 
@@ -192,9 +196,16 @@ static void test_flush(void)
     ASSERT_TRUE(buffer_is_empty(m->sensors[0].buf), "sensor 0 empty after flush");
     ASSERT_FALSE(buffer_is_empty(m->sensors[1].buf), "sensor 1 unaffected");
 
-    manager_flush_all(m);
+    ASSERT_TRUE(manager_flush_all(m), "flush_all reports success");
     ASSERT_TRUE(buffer_is_empty(m->sensors[1].buf), "sensor 1 empty after flush_all");
 
+    sensor_reading_t out;
+    manager_enable_broadcast(m, 1, 8);
+    manager_log(m, 1, 5.5f, 300);
+    ASSERT_FALSE(manager_read(m, 1, &out),         "broadcast sensor: read refused");
+    ASSERT_FALSE(manager_flush_sensor(m, 1),       "broadcast sensor: flush refused");
+    ASSERT_FALSE(manager_flush_all(m),             "flush_all reports the skipped sensor");
+
     manager_destroy(m);
 }
 
@@ -228,6 +239,298 @@ static void test_multiple_sensors(void)
     manager_destroy(m);
 }
 
+static void test_anomaly_alerts(void)
+{
+    test_header("anomaly alerts");
+
+    manager_t *m = manager_create(1);
+    manager_register(m, 0, "Current", 64);
+
+    anomaly_config_t cfg = {.alpha = 0.1f,
+                            .z_warn = 3.0f,
+                            .z_critical = 6.0f,
+                            .warmup = 10,
+                            .enabled = true};
+    ASSERT_TRUE(manager_set_anomaly(m, 0, cfg), "set_anomaly ok");
+    ASSERT_FALSE(manager_set_anomaly(m, 3, cfg), "unregistered id rejected");
+
+    for (int i = 0; i < 20; i++)
+        manager_log(m, 0, (i % 2) ? 5.1f : 4.9f, (uint32_t)(i * 100));
+    ASSERT_EQ(m->total_anomalies, 0, "no anomalies on steady input");
+
+    /* Well inside any static threshold, but far off the baseline */
+    manager_log(m, 0, 7.0f, 5000);
+    ASSERT_EQ(m->total_anomalies, 1, "jump flagged as anomaly");
+    ASSERT_EQ(m->total_alerts, 1, "anomaly counted as an alert");
+
+    manager_destroy(m);
+}
+
+static void test_filtered_thresholds(void)
+{
+    test_header("filters run before thresholds");
+
+    manager_t *m = manager_create(1);
+    manager_register(m, 0, "Vibration", 16);
+    manager_set_thresholds(m, 0, (sensor_threshold_t){.warn_low = -1.0f,
+                                                      .warn_high = 0.5f,
+                                                      .critical_low = -1.0f,
+                                                      .critical_high = 1.0f,
+                                                      .enabled = true});
+    ASSERT_TRUE(manager_add_filter(m, 0, (filter_stage_config_t){
+                    .type = FILTER_MEDIAN, .window = 3}),
+                "median filter added");
+    ASSERT_FALSE(manager_add_filter(m, 4, (filter_stage_config_t){
+                     .type = FILTER_MEDIAN, .window = 3}),
+                 "unregistered id rejected");
+
+    manager_log(m, 0, 0.1f, 100);
+    manager_log(m, 0, 0.1f, 200);
+    manager_log(m, 0, 1.5f, 300); /* one-sample spike */
+    manager_log(m, 0, 0.1f, 400);
+    ASSERT_EQ(m->total_alerts, 0, "single spike does not alert");
+
+    manager_log(m, 0, 1.5f, 500);
+    manager_log(m, 0, 1.5f, 600); /* sustained */
+    ASSERT_EQ(m->total_alerts, 2, "sustained excursion alerts");
+
+    manager_destroy(m);
+}
+
+static void test_rollup_feed(void)
+{
+    test_header("manager feeds attached rollup cascade");
+
+    manager_t *m = manager_create(1);
+    manager_register(m, 0, "Temp", 16);
+
+    rollup_t r;
+    rollup_init(&r);
+    rollup_add_tier(&r, 1000, "test_manager_rollup.bin");
+    ASSERT_TRUE(manager_attach_rollup(m, &r), "attach ok");
+
+    manager_log(m, 0, 20.0f, 100);
+    manager_log(m, 0, 22.0f, 500);
+    manager_log(m, 0, 30.0f, 1500);
+    ASSERT_EQ(r.tiers[0].records_written, 1, "one bucket closed");
+    ASSERT_EQ(r.tiers[0].open[0].count, 1, "newest reading in open bucket");
+
+    rollup_close(&r);
+    remove("test_manager_rollup.bin");
+    remove("test_manager_rollup.bin.idx");
+    manager_destroy(m);
+}
+
+static void test_log_batch(void)
+{
+    test_header("manager_log_batch routes by sensor_id");
+
+    manager_t *m = manager_create(2);
+    manager_register(m, 0, "Temp", 16);
+    manager_register(m, 1, "Vib", 16);
+
+    sensor_reading_t batch[] = {
+        {.timestamp = 1, .sensor_id = 0, .value = 20.0f},
+        {.timestamp = 1, .sensor_id = 1, .value = 0.1f},
+        {.timestamp = 2, .sensor_id = 7, .value = 9.9f},   /* unknown */
+        {.timestamp = 2, .sensor_id = 0, .value = 21.0f},
+    };
+
+    ASSERT_EQ(manager_log_batch(m, batch, 4), 3, "3 of 4 accepted");
+    ASSERT_EQ(m->total_logs, 3, "total_logs counts accepted only");
+    ASSERT_EQ(m->sensors[0].stats.sample_count, 2, "sensor 0 got both");
+    ASSERT_EQ(manager_log_batch(NULL, batch, 4), 0, "NULL manager -> 0");
+
+    manager_destroy(m);
+}
+
+static void test_arena_layout(void)
+{
+    test_header("manager arena — contiguous, aligned rings");
+
+    manager_t *m = manager_create(3);
+    ASSERT(m->arena != NULL, "manager_create reserves an arena");
+    ASSERT(arena_contains(m->arena, m), "manager lives in its arena");
+
+    manager_register(m, 0, "Temp", 16);
+    manager_register(m, 1, "Vib", 32);
+    ring_buffer_t *a = m->sensors[0].buf, *b = m->sensors[1].buf;
+
+    ASSERT(arena_contains(m->arena, a) && arena_contains(m->arena, b),
+           "rings bump-allocated from the arena");
+    ASSERT(((uintptr_t)a % CACHE_LINE) == 0 && ((uintptr_t)b % CACHE_LINE) == 0,
+           "ring headers cache-line aligned");
+    ASSERT(((uintptr_t)a->buffer % CACHE_LINE) == 0,
+           "storage starts on a cache line");
+    ASSERT((unsigned char *)a->buffer - (unsigned char *)a == CACHE_LINE,
+           "storage directly after its header");
+    ASSERT((unsigned char *)b == (unsigned char *)a + buffer_footprint(16),
+           "next sensor's ring follows the previous one");
+
+    /* Too big for what is left: heap, still usable, still freed */
+    manager_register(m, 2, "Big", 100000);
+    ASSERT(m->registered[2] && !arena_contains(m->arena, m->sensors[2].buf),
+           "oversized ring falls back to the heap");
+    ASSERT(manager_log(m, 2, 1.0f, 1), "heap ring accepts readings");
+
+    manager_destroy(m);
+
+    manager_t *h = manager_create_arena(1, 4096, ARENA_HUGEPAGES);
+    ASSERT(h != NULL, "huge-page request succeeds (or falls back)");
+    ASSERT(manager_register(h, 0, "Temp", 64) &&
+           arena_contains(h->arena, h->sensors[0].buf),
+           "explicit arena holds the ring");
+    manager_destroy(h);
+}
+
+static void test_hot_cold_layout(void)
+{
+    test_header("sensor hot line — limits and flags beside the stats");
+
+    manager_t *m = manager_create(2);
+    manager_register(m, 0, "Temp", 16);
+    manager_register(m, 1, "Vib", 16);
+    sensor_t *s = &m->sensors[0];
+
+    ASSERT(((uintptr_t)m->sensors % CACHE_LINE) == 0 &&
+           ((uintptr_t)&m->sensors[1] % CACHE_LINE) == 0,
+           "every sensor starts on its own cache line");
+    ASSERT((unsigned char *)s->name - (unsigned char *)s == CACHE_LINE,
+           "name is past the hot line");
+    ASSERT(!s->limits.enabled, "thresholds disabled after register");
+
+    manager_set_thresholds(m, 0, (sensor_threshold_t){.warn_low = -10.0f,
+        .warn_high = 50.0f, .critical_low = -20.0f, .critical_high = 90.0f});
+    ASSERT(s->limits.enabled && s->limits.warn_high == 50.0f,
+           "manager_set_thresholds writes the sensor's limits");
+    ASSERT_EQ(manager_check_threshold(m, 0, 60.0f), ALERT_WARNING,
+              "limits read back from the sensor");
+    ASSERT_EQ(manager_check_threshold(m, 1, 60.0f), ALERT_NONE,
+              "other sensor unaffected");
+
+    ASSERT(!s->filtering && !s->detecting, "no optional stages by default");
+    manager_add_filter(m, 0, (filter_stage_config_t){
+        .type = FILTER_MOVING_AVG, .window = 2});
+    ASSERT(s->filtering, "adding a stage turns filtering on");
+    manager_log(m, 0, 10.0f, 1);
+    manager_log(m, 0, 20.0f, 2);
+    ASSERT_NEAR(s->last_value, 15.0f, 0.001f, "chain still applied");
+
+    manager_set_anomaly(m, 0, (anomaly_config_t){.alpha = 0.1f,
+        .z_warn = 3.0f, .z_critical = 5.0f, .enabled = true});
+    ASSERT(s->detecting, "enabling the detector sets the flag");
+    manager_set_anomaly(m, 0, (anomaly_config_t){.enabled = false});
+    ASSERT(!s->detecting, "disabling clears it");
+    ASSERT_EQ(sensor_last_anomaly(s, NULL), ALERT_NONE,
+              "no verdict while detection is off");
+
+    manager_destroy(m);
+}
+
+/** Table number k: every limit of every sensor derived from k */
+static void make_table(threshold_table_t *t, uint32_t k)
+{
+    for (uint8_t id = 0; id < MANAGER_MAX_SENSORS; id++)
+        t->limits[id] = (sensor_threshold_t){
+            .warn_low = -(float)k, .warn_high = (float)k,
+            .critical_low = -(float)k - 1000.0f,
+            .critical_high = (float)k + 1000.0f, .enabled = true};
+}
+
+static void test_publish_thresholds(void)
+{
+    test_header("manager_publish_thresholds — applied between readings");
+
+    manager_t *m = manager_create(2);
+    manager_register(m, 0, "Temp", 16);
+    manager_register(m, 1, "Vib", 16);
+    sensor_reading_t out;
+
+    threshold_table_t t;
+    make_table(&t, 10);
+    ASSERT_FALSE(manager_publish_thresholds(NULL, &t), "NULL manager rejected");
+    ASSERT_TRUE(manager_publish_thresholds(m, &t), "table published");
+    ASSERT_FALSE(m->sensors[0].limits.enabled, "nothing applied before a reading");
+
+    manager_log(m, 1, 5.0f, 1);
+    ASSERT_TRUE(m->sensors[0].limits.warn_high == 10.0f &&
+                m->sensors[1].limits.warn_high == 10.0f,
+                "next reading applies it to every sensor");
+    ASSERT_EQ(manager_check_threshold(m, 0, 11.0f), ALERT_WARNING,
+              "new limits in effect");
+
+    /* Two publications before a reading: only the last one lands */
+    make_table(&t, 20);
+    manager_publish_thresholds(m, &t);
+    make_table(&t, 30);
+    manager_publish_thresholds(m, &t);
+    manager_log(m, 0, 5.0f, 2);
+    ASSERT_TRUE(m->sensors[0].limits.warn_high == 30.0f, "latest table wins");
+    ASSERT_EQ(atomic_load(&m->limits_applied), m->limits_published,
+              "every handed-over table accounted for");
+
+    manager_read(m, 0, &out);
+    manager_read(m, 1, &out);
+    manager_destroy(m);
+}
+
+#define SWAP_TABLES 2000
+
+static void *publisher(void *arg)
+{
+    manager_t *m = arg;
+    threshold_table_t t;
+    for (uint32_t k = 1; k <= SWAP_TABLES; k++)
+    {
+        make_table(&t, k);
+        manager_publish_thresholds(m, &t);
+    }
+    return NULL;
+}
+
+static void test_publish_concurrent(void)
+{
+    test_header("manager_publish_thresholds — consistent under a live swap");
+
+    manager_t *m = manager_create(2);
+    manager_register(m, 0, "Temp", 16);
+    manager_register(m, 1, "Vib", 16);
+
+    pthread_t tid;
+    pthread_create(&tid, NULL, publisher, m);
+
+    /* Log until the last table shows up, checking every set we see */
+    sensor_reading_t out;
+    uint32_t seen = 0, torn = 0, backwards = 0, readings = 0;
+    while (seen < SWAP_TABLES)
+    {
+        manager_log(m, readings & 1, 0.0f, readings);
+        manager_read(m, readings & 1, &out);
+        readings++;
+
+        const sensor_threshold_t *a = &m->sensors[0].limits;
+        const sensor_threshold_t *b = &m->sensors[1].limits;
+        if (!a->enabled)
+            continue;
+        uint32_t k = (uint32_t)a->warn_high;
+        if (a->warn_low != -(float)k || a->critical_high != (float)k + 1000.0f ||
+            b->warn_high != a->warn_high || b->critical_low != a->critical_low)
+            torn++;
+        if (k < seen)
+            backwards++;
+        seen = k;
+    }
+    pthread_join(tid, NULL);
+
+    ASSERT_EQ(torn, 0u, "no reading saw a mix of two tables");
+    ASSERT_EQ(backwards, 0u, "tables never go backwards");
+    ASSERT_EQ(m->total_alerts, 0u, "no spurious alerts during the swap");
+    ASSERT_EQ(atomic_load(&m->limits_applied), m->limits_published,
+              "publisher and logger agree at the end");
+
+    manager_destroy(m);
+}
+
 /* ============================================================================
  * MAIN
  * ========================================================================== */
@@ -245,6 +548,14 @@ int main(void)
     test_pause_resume();
     test_flush();
     test_multiple_sensors();
+    test_anomaly_alerts();
+    test_filtered_thresholds();
+    test_rollup_feed();
+    test_log_batch();
+    test_arena_layout();
+    test_hot_cold_layout();
+    test_publish_thresholds();
+    test_publish_concurrent();
 
     printf("\n==============================\n");
     printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
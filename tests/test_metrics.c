@@ -0,0 +1,336 @@
+/**
+ * @file test_metrics.c
+ * @brief Unit tests for the metrics registry, pipeline metrics and the
+ *        scrape endpoint
+ *
+ * Build:  make test  (Linux: links $(CORE) with metrics, pipeline_metrics
+ *         and metrics_server)
+ * Run:    ./build/test_metrics
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/pipeline_metrics.h"
+#include "../src/metrics_server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/** true if `text` contains the line `line` */
+static bool has_line(const char *text, const char *line)
+{
+    size_t n = strlen(line);
+    for (const char *p = text; (p = strstr(p, line)) != NULL; p++)
+    {
+        if ((p == text || p[-1] == '\n') && (p[n] == '\n' || p[n] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_register(void)
+{
+    test_header("metrics_counter / gauge — registration");
+
+    metrics_t *reg = metrics_create();
+    ASSERT_TRUE(reg != NULL, "registry created");
+
+    int c = metrics_counter(reg, "ingest_readings_total", "Readings", NULL);
+    int g = metrics_gauge(reg, "queue_depth", "Depth", "queue=\"a\"");
+    ASSERT_EQ(c, 0, "first id 0");
+    ASSERT_EQ(g, 1, "second id 1");
+    ASSERT_EQ(metrics_counter(reg, "9bad", "", NULL), -1, "leading digit refused");
+    ASSERT_EQ(metrics_counter(reg, "bad-name", "", NULL), -1, "dash refused");
+
+    metrics_add(reg, c, 5);
+    metrics_add(reg, c, 2);
+    ASSERT_TRUE(metrics_value(reg, c) == 7.0, "counter adds");
+    metrics_set_total(reg, c, 100);
+    ASSERT_TRUE(metrics_value(reg, c) == 107.0, "absolute total plus slot adds");
+
+    metrics_set(reg, g, 0.25);
+    ASSERT_TRUE(metrics_value(reg, g) == 0.25, "gauge set");
+    metrics_add(reg, g, 1);
+    ASSERT_TRUE(metrics_value(reg, g) == 0.25, "add on a gauge ignored");
+    metrics_add(reg, 99, 1);
+    ASSERT_TRUE(true, "unknown id ignored");
+
+    metrics_destroy(reg);
+}
+
+#define ADDS 100000
+
+typedef struct {
+    metrics_t *reg;
+    int        id, hist;
+} adder_t;
+
+static void *adder(void *arg)
+{
+    adder_t *a = arg;
+    for (int i = 0; i < ADDS; i++)
+    {
+        metrics_add(a->reg, a->id, 1);
+        if ((i & 1023) == 0)
+            metrics_observe(a->reg, a->hist, 2000);
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    test_header("metrics_add — per-thread slots, summed at scrape");
+
+    metrics_t *reg = metrics_create();
+    adder_t a = {.reg = reg,
+                 .id   = metrics_counter(reg, "adds_total", "", NULL),
+                 .hist = metrics_histogram(reg, "op_seconds", "", NULL)};
+
+    pthread_t t[4];
+    for (int i = 0; i < 4; i++)
+        pthread_create(&t[i], NULL, adder, &a);
+
+    /* Scrape while the threads run: never more than the final total */
+    double mid = metrics_value(reg, a.id);
+    ASSERT_TRUE(mid <= 4.0 * ADDS, "concurrent read is a lower bound");
+
+    for (int i = 0; i < 4; i++)
+        pthread_join(t[i], NULL);
+
+    ASSERT_TRUE(metrics_value(reg, a.id) == 4.0 * ADDS, "no increment lost");
+    ASSERT_EQ(reg->slots_used, 4u, "one slot per thread");
+
+    size_t len;
+    char *text = metrics_render(reg, &len);
+    char line[96];
+    snprintf(line, sizeof(line), "op_seconds_count %d", 4 * ((ADDS + 1023) / 1024));
+    ASSERT_TRUE(has_line(text, line), "histogram samples merged across threads");
+    free(text);
+    metrics_destroy(reg);
+}
+
+static void test_render(void)
+{
+    test_header("metrics_render — Prometheus text format");
+
+    metrics_t *reg = metrics_create();
+    char esc[64], labels[96];
+    metrics_escape(esc, sizeof(esc), "Say \"hi\"\\");
+    ASSERT_EQ(strcmp(esc, "Say \\\"hi\\\"\\\\"), 0, "quotes and backslash escaped");
+
+    snprintf(labels, sizeof(labels), "sensor=\"%s\"", "a");
+    int a = metrics_gauge(reg, "fill_ratio", "Fill", labels);
+    int x = metrics_counter(reg, "other_total", "Other", NULL);
+    int b = metrics_gauge(reg, "fill_ratio", "Fill", "sensor=\"b\"");
+    int h = metrics_histogram(reg, "flush_seconds", "Flush", NULL);
+    metrics_set(reg, a, 0.5);
+    metrics_set(reg, b, 1.0);
+    metrics_add(reg, x, 3);
+    metrics_observe(reg, h, 3000);          /* 3 us */
+    metrics_observe(reg, h, 2000000);       /* 2 ms */
+
+    size_t len = 0;
+    char *text = metrics_render(reg, &len);
+    ASSERT_TRUE(text != NULL && len == strlen(text), "rendered with length");
+    ASSERT_TRUE(has_line(text, "# TYPE fill_ratio gauge"), "TYPE line");
+    ASSERT_TRUE(has_line(text, "# HELP fill_ratio Fill"), "HELP line");
+    ASSERT_TRUE(has_line(text, "fill_ratio{sensor=\"a\"} 0.5"), "labelled gauge a");
+    ASSERT_TRUE(has_line(text, "other_total 3"), "unlabelled counter");
+
+    /* Family contiguous: both fill_ratio series before other_total */
+    char *pa = strstr(text, "fill_ratio{sensor=\"b\"} 1");
+    char *po = strstr(text, "other_total 3");
+    ASSERT_TRUE(pa != NULL && po != NULL && pa < po, "families kept together");
+
+    ASSERT_TRUE(has_line(text, "flush_seconds_bucket{le=\"1e-06\"} 0"), "1 us bucket");
+    ASSERT_TRUE(has_line(text, "flush_seconds_bucket{le=\"5e-06\"} 1"), "5 us bucket");
+    ASSERT_TRUE(has_line(text, "flush_seconds_bucket{le=\"0.005\"} 2"), "5 ms bucket");
+    ASSERT_TRUE(has_line(text, "flush_seconds_bucket{le=\"+Inf\"} 2"), "+Inf bucket");
+    ASSERT_TRUE(has_line(text, "flush_seconds_count 2"), "count");
+    ASSERT_TRUE(has_line(text, "flush_seconds_sum 0.002003"), "sum in seconds");
+    free(text);
+    metrics_destroy(reg);
+}
+
+static void test_pipeline(void)
+{
+    test_header("pipeline_metrics — manager and logger published");
+
+    const char *path = "test_metrics_log.csv";
+    remove(path);
+
+    manager_t *m = manager_create(2);
+    manager_register(m, 0, "Temperature (C)", 4);
+    manager_register(m, 1, "Humidity (%)", 4);
+    manager_set_thresholds(m, 0, (sensor_threshold_t){
+        .warn_low = 0.0f, .warn_high = 30.0f,
+        .critical_low = -10.0f, .critical_high = 50.0f, .enabled = true});
+    csv_logger_t logger;
+    logger_open(&logger, path);
+
+    metrics_t *reg = metrics_create();
+    pipeline_metrics_t pm;
+    ASSERT_TRUE(pipeline_metrics_init(&pm, reg, m, &logger), "registered");
+    ASSERT_TRUE(logger.flush_ns == pm.flush_ns, "logger flushes timed");
+
+    for (uint32_t t = 0; t < 6; t++)      /* 4-slot ring: 2 refused */
+        manager_log(m, 0, t == 0 ? 40.0f : 20.0f, t);
+    sensor_reading_t r = {.timestamp = 1, .sensor_id = 0, .value = 20.0f};
+    logger_write(&logger, &r, "Temperature (C)", ALERT_NONE);
+    pipeline_metrics_publish(&pm, m, &logger);
+
+    ASSERT_TRUE(metrics_value(reg, pm.fill[0]) == 1.0, "full ring: fill 1.0");
+    ASSERT_TRUE(metrics_value(reg, pm.fill[1]) == 0.0, "empty ring: fill 0");
+    ASSERT_TRUE(metrics_value(reg, pm.overflows[0]) == 2.0, "overflows exported");
+    ASSERT_TRUE(metrics_value(reg, pm.samples[0]) == 4.0, "samples exported");
+    ASSERT_TRUE(metrics_value(reg, pm.alerts) >= 1.0, "alert counted");
+    ASSERT_TRUE(metrics_value(reg, pm.rows) == 1.0, "logger rows");
+    ASSERT_TRUE(metrics_value(reg, pm.bytes) == (double)logger.bytes_written &&
+                logger.bytes_written > 20, "logger bytes");
+    ASSERT_EQ(pm.fill[2], -1, "unregistered slot not exported");
+
+    char *text = metrics_render(reg, NULL);
+    ASSERT_TRUE(strstr(text, "sensor_buffer_fill_ratio{id=\"1\",sensor=\"Humidity (%)\"} 0")
+                != NULL, "per-sensor labels");
+    ASSERT_TRUE(has_line(text, "logger_flush_seconds_count 1"), "flush latency histogram");
+    free(text);
+
+    pipeline_metrics_free(&pm, &logger);
+    ASSERT_TRUE(logger.flush_ns == NULL, "flush timing detached");
+    metrics_destroy(reg);
+    logger_close(&logger);
+    manager_destroy(m);
+    remove(path);
+}
+
+/** GET `target` over a connected socket, response into buf */
+static size_t http_get(int fd, const char *target, char *buf, size_t cap)
+{
+    char req[128];
+    int n = snprintf(req, sizeof(req), "GET %s HTTP/1.0\r\nHost: x\r\n\r\n", target);
+    if (write(fd, req, (size_t)n) != n)
+        return 0;
+
+    size_t len = 0;
+    ssize_t r;
+    while (len + 1 < cap && (r = read(fd, buf + len, cap - 1 - len)) > 0)
+        len += (size_t)r;
+    buf[len] = '\0';
+    close(fd);
+    return len;
+}
+
+static int connect_tcp(uint16_t port)
+{
+    struct sockaddr_in sa = {.sin_family = AF_INET, .sin_port = htons(port)};
+    inet_pton(AF_INET, "127.0.0.1", &sa.sin_addr);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void test_server(void)
+{
+    test_header("metrics_server — HTTP over TCP and a Unix socket");
+
+    metrics_t *reg = metrics_create();
+    int c = metrics_counter(reg, "scrape_test_total", "Test", NULL);
+    metrics_add(reg, c, 42);
+
+    ASSERT_TRUE(metrics_server_start(reg, "not-a-port") == NULL, "bad address refused");
+
+    metrics_server_t *srv = metrics_server_start(reg, "127.0.0.1:0");
+    ASSERT_TRUE(srv != NULL, "TCP server started");
+    ASSERT_TRUE(metrics_server_port(srv) != 0, "ephemeral port bound");
+
+    static char buf[8192];
+    int fd = connect_tcp(metrics_server_port(srv));
+    ASSERT_TRUE(fd >= 0, "connected");
+    http_get(fd, "/metrics", buf, sizeof(buf));
+    ASSERT_TRUE(strncmp(buf, "HTTP/1.0 200 OK", 15) == 0, "200 OK");
+    ASSERT_TRUE(strstr(buf, "version=0.0.4") != NULL, "exposition content type");
+    ASSERT_TRUE(strstr(buf, "\nscrape_test_total 42\n") != NULL, "body has the counter");
+
+    http_get(connect_tcp(metrics_server_port(srv)), "/nope", buf, sizeof(buf));
+    ASSERT_TRUE(strncmp(buf, "HTTP/1.0 404", 12) == 0, "unknown path 404");
+    ASSERT_EQ(metrics_server_scrapes(srv), 1u, "one scrape counted");
+    metrics_server_stop(srv);
+
+    const char *path = "/tmp/test_metrics.sock";
+    srv = metrics_server_start(reg, path);
+    ASSERT_TRUE(srv != NULL, "Unix socket server started");
+    struct sockaddr_un sa = {.sun_family = AF_UNIX};
+    strcpy(sa.sun_path, path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_TRUE(connect(fd, (struct sockaddr *)&sa, sizeof(sa)) == 0, "connected");
+    http_get(fd, "/metrics", buf, sizeof(buf));
+    ASSERT_TRUE(strstr(buf, "\nscrape_test_total 42\n") != NULL, "scraped over unix socket");
+    metrics_server_stop(srv);
+    ASSERT_TRUE(access(path, F_OK) != 0, "socket file removed on stop");
+
+    metrics_destroy(reg);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Metrics Test Suite\n");
+    printf("==============================\n");
+
+    test_register();
+    test_threads();
+    test_render();
+    test_pipeline();
+    test_server();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+/**
+ * @file test_pool.c
+ * @brief Unit tests for the SPSC hand-off queue and the sensor worker pool
+ *
+ * Build:  make test  (links $(CORE) with tests/test_pool.c -lm -pthread)
+ * Run:    ./build/test_pool.exe
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/worker_pool.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <math.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) <= (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+static sensor_reading_t make_reading(uint32_t ts, uint8_t id, float val)
+{
+    sensor_reading_t r;
+    r.timestamp = ts;
+    r.sensor_id = id;
+    r.value     = val;
+    return r;
+}
+
+/* ============================================================================
+ * SPSC QUEUE TESTS
+ * ========================================================================== */
+
+static void test_spsc_basic(void)
+{
+    test_header("spsc — FIFO, full and empty");
+    ASSERT_FALSE(spsc_create(3),                      "non power of two rejected");
+
+    spsc_queue_t *q = spsc_create(4);
+    sensor_reading_t out[8];
+    ASSERT_EQ(spsc_pop_batch(q, out, 8), 0,           "new queue is empty");
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        sensor_reading_t r = make_reading(i, 0, 0.0f);
+        spsc_push(q, &r);
+    }
+    sensor_reading_t extra = make_reading(9, 0, 0.0f);
+    ASSERT_FALSE(spsc_push(q, &extra),                "push into full queue fails");
+    ASSERT_EQ(spsc_size(q), 4,                        "size is 4");
+
+    ASSERT_EQ(spsc_pop_batch(q, out, 3), 3,           "batch limited by max");
+    ASSERT_TRUE(out[0].timestamp == 0 && out[2].timestamp == 2, "FIFO order");
+    ASSERT_TRUE(spsc_push(q, &extra),                 "space after pop (wraps)");
+    ASSERT_EQ(spsc_pop_batch(q, out, 8), 2,           "rest drained");
+    ASSERT_EQ(out[1].timestamp, 9,                    "wrapped entry intact");
+    spsc_destroy(q);
+}
+
+#define SPSC_STRESS 500000u
+
+static void *spsc_consumer(void *p)
+{
+    spsc_queue_t *q = p;
+    sensor_reading_t out[32];
+    uint32_t expect = 0;
+    bool ok = true;
+
+    while (expect < SPSC_STRESS)
+    {
+        size_t n = spsc_pop_batch(q, out, 32);
+        for (size_t i = 0; i < n; i++, expect++)
+        {
+            if (out[i].timestamp != expect || out[i].value != (float)expect)
+                ok = false;
+        }
+    }
+    return ok ? p : NULL;
+}
+
+static void test_spsc_threaded(void)
+{
+    test_header("spsc — producer and consumer threads");
+    spsc_queue_t *q = spsc_create(256);
+    pthread_t th;
+    pthread_create(&th, NULL, spsc_consumer, q);
+
+    for (uint32_t i = 0; i < SPSC_STRESS; i++)
+    {
+        sensor_reading_t r = make_reading(i, 0, (float)i);
+        while (!spsc_push(q, &r))
+            ;
+    }
+
+    void *result;
+    pthread_join(th, &result);
+    ASSERT_TRUE(result != NULL,                       "every reading arrived in order, intact");
+    spsc_destroy(q);
+}
+
+/* ============================================================================
+ * WORKER POOL TESTS
+ * ========================================================================== */
+
+static void test_pool_partition(void)
+{
+    test_header("pool_create / pool_register — sensors partitioned by ID");
+    ASSERT_FALSE(pool_create(0, 4, 16),               "0 workers rejected");
+
+    worker_pool_t *pool = pool_create(2, 4, 16);
+    ASSERT_TRUE(pool != NULL,                         "pool created");
+    for (uint8_t id = 0; id < 4; id++)
+        pool_register(pool, id, "S", 32);
+
+    ASSERT_TRUE(pool_manager(pool, 0) == pool_manager(pool, 2), "0 and 2 share a worker");
+    ASSERT_TRUE(pool_manager(pool, 0) != pool_manager(pool, 1), "0 and 1 do not");
+    ASSERT_TRUE(pool_manager(pool, 1)->registered[3], "3 lives with 1");
+    ASSERT_FALSE(pool_manager(pool, 1)->registered[2], "2 is not on worker 1");
+    ASSERT_FALSE(pool_submit(pool, 4, 1.0f, 1),       "unknown ID rejected");
+
+    /* Not started: the queue fills and further readings are dropped */
+    for (uint32_t i = 0; i < 16; i++)
+        pool_submit(pool, 0, 1.0f, i);
+    ASSERT_FALSE(pool_submit(pool, 0, 1.0f, 99),      "full queue drops");
+
+    pool_totals_t t;
+    pool_get_totals(pool, &t);
+    ASSERT_EQ(t.dropped, 1,                           "drop counted");
+    ASSERT_EQ(t.submitted, 16,                        "accepted counted");
+
+    ASSERT_TRUE(pool_start(pool),                     "workers start");
+    pool_drain(pool);
+    pool_get_totals(pool, &t);
+    ASSERT_EQ(t.processed, 16,                        "queued readings processed");
+    pool_destroy(pool);
+}
+
+typedef struct {
+    pthread_t owner[4];
+    bool      seen[4];
+    bool      exclusive;
+    uint32_t  calls[4];
+} hook_log_t;
+
+static void record_hook(const sensor_t *s, const sensor_reading_t *r, void *ctx)
+{
+    hook_log_t *log = ctx;
+    uint8_t id = r->sensor_id;
+
+    if (!log->seen[id])
+    {
+        log->owner[id] = pthread_self();
+        log->seen[id]  = true;
+    }
+    else if (!pthread_equal(log->owner[id], pthread_self()))
+    {
+        log->exclusive = false;
+    }
+    if (s->id != id)
+        log->exclusive = false;
+    log->calls[id]++;
+}
+
+static void test_pool_pipeline(void)
+{
+    test_header("pool — readings run the full pipeline on the owner");
+    worker_pool_t *pool = pool_create(2, 4, 1024);
+    for (uint8_t id = 0; id < 4; id++)
+        pool_register(pool, id, "S", 4096);
+
+    sensor_threshold_t th = { .warn_low = -1000.0f, .warn_high = 90.0f,
+                              .critical_low = -2000.0f, .critical_high = 200.0f };
+    manager_set_thresholds(pool_manager(pool, 3), 3, th);
+
+    hook_log_t log = { .exclusive = true };
+    pool_set_hook(pool, record_hook, &log);
+    pool_start(pool);
+
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < 4000; i++)
+    {
+        uint8_t id = (uint8_t)(i % 4);
+        float   v  = (id == 3 && i == 3) ? 95.0f : (float)id;
+        while (!pool_submit(pool, id, v, i))
+            ;                       /* queue full: retry */
+        accepted++;
+    }
+    pool_drain(pool);
+
+    pool_totals_t t;
+    pool_get_totals(pool, &t);
+    ASSERT_EQ(t.processed, accepted,                  "all readings processed");
+    ASSERT_EQ(t.logs, accepted,                       "all readings logged");
+    ASSERT_EQ(t.alerts, 1,                            "threshold alert on worker");
+    ASSERT_TRUE(log.exclusive,                        "each sensor ran on one thread only");
+    ASSERT_TRUE(!pthread_equal(log.owner[0], log.owner[1]), "sensors 0 and 1 on different workers");
+    ASSERT_EQ(log.calls[2], 1000,                     "hook ran for every reading");
+
+    sensor_stats_t st;
+    ASSERT_TRUE(pool_get_stats(pool, 2, &st),         "stats readable after drain");
+    ASSERT_EQ(st.sample_count, 1000,                  "sensor 2 count");
+    ASSERT_NEAR(st.max, 2.0f, 0.001f,                 "sensor 2 value");
+
+    sensor_reading_t r;
+    ASSERT_TRUE(pool_read(pool, 1, &r),               "buffer readable after drain");
+    ASSERT_EQ(r.timestamp, 1,                         "oldest reading of sensor 1");
+
+    pool_stop(pool);
+    pool_destroy(pool);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Worker Pool Test Suite\n");
+    printf("==============================\n");
+
+    test_spsc_basic();
+    test_spsc_threaded();
+    test_pool_partition();
+    test_pool_pipeline();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
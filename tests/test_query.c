@@ -0,0 +1,151 @@
+/**
+ * @file test_query.c
+ * @brief Unit tests for LTTB downsampling and the dashboard query API
+ *
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/lttb.c src/query.c tests/test_query.c -o build/test_query.exe -lm
+ * Run:    ./build/test_query.exe
+ */
+
+#include "../src/lttb.h"
+#include "../src/query.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)        ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)         ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)        ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a)-(b)) < (eps), msg)
+
+#define CSV_PATH "test_query.csv"
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_lttb_small_input(void)
+{
+    test_header("lttb_select — input already small enough");
+    uint32_t x[4] = {0, 1, 2, 3};
+    float    y[4] = {1, 2, 3, 4};
+    size_t   idx[8];
+
+    ASSERT_EQ(lttb_select(x, y, 4, 8, idx), 4,   "all points kept");
+    ASSERT_EQ(idx[3], 3,                         "indices in order");
+    ASSERT_EQ(lttb_select(x, y, 4, 2, idx), 2,   "threshold 2 keeps ends");
+    ASSERT_EQ(idx[1], 3,                         "last point kept");
+    ASSERT_EQ(lttb_select(x, y, 0, 8, idx), 0,   "empty input");
+}
+
+static void test_lttb_keeps_spike(void)
+{
+    test_header("lttb_select — spike survives 1000 -> 20 reduction");
+    static uint32_t x[1000];
+    static float    y[1000];
+    for (int i = 0; i < 1000; i++) {
+        x[i] = (uint32_t)(i * 10);
+        y[i] = 1.0f;
+    }
+    y[637] = 50.0f;
+
+    size_t idx[20];
+    size_t n = lttb_select(x, y, 1000, 20, idx);
+    ASSERT_EQ(n, 20,                "exactly threshold points");
+    ASSERT_EQ(idx[0], 0,            "first point kept");
+    ASSERT_EQ(idx[19], 999,         "last point kept");
+
+    bool spike = false, ascending = true;
+    for (size_t i = 0; i < n; i++) {
+        if (idx[i] == 637) spike = true;
+        if (i > 0 && idx[i] <= idx[i - 1]) ascending = false;
+    }
+    ASSERT_TRUE(spike,              "spike index selected");
+    ASSERT_TRUE(ascending,          "indices strictly ascending");
+}
+
+static void test_query_csv(void)
+{
+    test_header("query_lttb / query_count — CSV source");
+    FILE *f = fopen(CSV_PATH, "w");
+    fprintf(f, "timestamp,sensor_id,sensor_name,value,alert_level\n");
+    fprintf(f, "# comment line from the Arduino\n");
+    for (int i = 0; i < 500; i++) {
+        fprintf(f, "%d,0,Temperature (C),%.4f,%s\n", i * 100,
+                (i == 250) ? 90.0 : 40.0, (i == 250) ? "CRITICAL" : "NONE");
+        fprintf(f, "%d,1,Vibration (g),0.1000,NONE\n", i * 100);
+    }
+    /* Out of range: must not wrap to sensor 2 / timestamp 100 */
+    fprintf(f, "300,258,Bogus,1.0000,NONE\n");
+    fprintf(f, "4294967396,0,Temperature (C),40.0000,NONE\n");
+    fprintf(f, "400,-254,Bogus,1.0000,NONE\n");
+    fclose(f);
+
+    ASSERT_EQ(query_count(CSV_PATH, 0, 0, UINT32_MAX), 500,   "count sensor 0");
+    ASSERT_EQ(query_count(CSV_PATH, 1, 0, 10000), 100,        "count in range");
+    ASSERT_EQ(query_count("missing.csv", 0, 0, 10), 0,        "missing file = 0");
+    ASSERT_EQ(query_count(CSV_PATH, 2, 0, UINT32_MAX), 0,     "sensor_id 258 / -254 rejected");
+    ASSERT_EQ(query_count(CSV_PATH, 0, 0, 200), 2,            "timestamp past UINT32_MAX rejected");
+
+    uint32_t ts[50];
+    float    vals[50];
+    uint8_t  alerts[50];
+    uint32_t n = query_lttb(CSV_PATH, 0, 0, UINT32_MAX, 50, ts, vals, alerts);
+    ASSERT_EQ(n, 50,                                          "reduced to 50 points");
+
+    bool found = false;
+    for (uint32_t i = 0; i < n; i++)
+        if (ts[i] == 25000 && vals[i] > 89.0f && alerts[i] == 2)
+            found = true;
+    ASSERT_TRUE(found,                       "critical spike kept with its alert level");
+
+    n = query_lttb(CSV_PATH, 1, 1000, 2000, 50, ts, vals, NULL);
+    ASSERT_EQ(n, 10,                         "range smaller than K returned whole");
+    ASSERT_EQ(ts[0], 1000,                   "range start honoured");
+
+    remove(CSV_PATH);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Query / LTTB Test Suite\n");
+    printf("==============================\n");
+
+    test_lttb_small_input();
+    test_lttb_keeps_spike();
+    test_query_csv();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
@@ -0,0 +1,261 @@
+/**
+ * @file test_replay.c
+ * @brief Unit tests for the log replay engine
+ *
+ * Build:  make test  (links $(CORE) with csv_parser, csv_bulk, frame, replay)
+ * Run:    ./build/test_replay
+ */
+
+#include "../src/replay.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) < (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/** Three board sensors, 8-entry rings, no thresholds */
+static manager_t *make_manager(void)
+{
+    manager_t *m = manager_create(3);
+    manager_register(m, 0, "Temperature (C)", 8);
+    manager_register(m, 1, "Humidity (%)",    8);
+    manager_register(m, 2, "Vibration (g)",   8);
+    return m;
+}
+
+static const char k_log[] =
+    "timestamp,sensor_id,sensor_name,value,alert_level\n"
+    "0,0,Temperature (C),20.0000,NONE\n"
+    "0,1,Humidity (%),50.0000,NONE\n"
+    "20,2,Vibration (g),0.1000,NONE\n"
+    "40,7,Unknown,1.0000,NONE\n"              /* not registered */
+    "60,0,Temperature (C),22.0000,NONE\n";
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_csv_fast(void)
+{
+    test_header("replay_csv — as fast as possible, manager only");
+
+    manager_t *m = make_manager();
+    replay_t *rp = malloc(sizeof(*rp));
+    replay_init(rp, m, NULL);
+    ASSERT_TRUE(replay_set_speed(rp, REPLAY_FAST), "speed 0 accepted");
+    ASSERT_FALSE(replay_set_speed(rp, -1.0), "negative speed refused");
+    ASSERT_TRUE(rp->speed == REPLAY_FAST, "speed unchanged after refusal");
+
+    csv_bulk_t r;
+    csv_bulk_open_mem(&r, k_log, sizeof(k_log) - 1);
+    ASSERT_TRUE(replay_csv(rp, &r), "replay_csv succeeds");
+
+    ASSERT_EQ(rp->readings, 4u, "4 readings logged");
+    ASSERT_EQ(rp->rejected, 1u, "unregistered sensor rejected");
+    ASSERT_EQ(rp->bytes, sizeof(k_log) - 1, "every byte consumed");
+    ASSERT_EQ(rp->wait_ns, 0u, "no sleeping when unpaced");
+    ASSERT_EQ(m->sensors[0].stats.sample_count, 2u, "temperature saw 2");
+    ASSERT_NEAR(m->sensors[0].stats.max, 22.0f, 1e-4f, "temperature max 22");
+    ASSERT_EQ(m->sensors[2].stats.sample_count, 1u, "vibration saw 1");
+    ASSERT_TRUE(rp->manage.total_ns > 0, "manager stage timed");
+
+    free(rp);
+    manager_destroy(m);
+}
+
+static void test_longer_than_ring(void)
+{
+    test_header("replay_csv — log longer than the sensor ring");
+
+    /* 100 rows into an 8-entry ring: the replay drains as it goes */
+    char  *log = malloc(4096);
+    size_t len = 0;
+    for (int i = 0; i < 100; i++)
+        len += (size_t)snprintf(log + len, 4096 - len,
+                                "%d,0,Temperature (C),%d.5000,NONE\n",
+                                i * 10, i);
+
+    manager_t *m = make_manager();
+    replay_t *rp = malloc(sizeof(*rp));
+    replay_init(rp, m, NULL);
+    replay_set_speed(rp, REPLAY_FAST);
+
+    csv_bulk_t r;
+    csv_bulk_open_mem(&r, log, len);
+    replay_csv(rp, &r);
+
+    ASSERT_EQ(rp->readings, 100u, "all 100 logged");
+    ASSERT_EQ(rp->rejected, 0u, "none rejected for a full ring");
+    ASSERT_NEAR(m->sensors[0].stats.max, 99.5f, 1e-4f, "last value reached");
+
+    free(rp);
+    manager_destroy(m);
+    free(log);
+}
+
+static void test_logger_output(void)
+{
+    test_header("replay_csv — rows written to the logger");
+
+    const char *path = "test_replay_out.csv";
+    remove(path);
+
+    csv_logger_t logger;
+    ASSERT_TRUE(logger_open(&logger, path), "logger opened");
+
+    manager_t *m = make_manager();
+    manager_set_thresholds(m, 0, (sensor_threshold_t){
+        .warn_low = 0.0f, .warn_high = 21.0f,
+        .critical_low = -10.0f, .critical_high = 30.0f, .enabled = true});
+
+    replay_t *rp = malloc(sizeof(*rp));
+    replay_init(rp, m, &logger);
+    replay_set_speed(rp, REPLAY_FAST);
+
+    csv_bulk_t r;
+    csv_bulk_open_mem(&r, k_log, sizeof(k_log) - 1);
+    replay_csv(rp, &r);
+    ASSERT_EQ(logger_rows_written(&logger), 4u, "one row per logged reading");
+    logger_close(&logger);
+
+    /* Read it back: the output is itself a replayable log */
+    csv_bulk_t back;
+    csv_columns_t cols;
+    ASSERT_TRUE(csv_bulk_open(&back, path), "output reopened");
+    csv_columns_init(&cols, 16);
+    size_t n = csv_bulk_read(&back, &cols);
+    ASSERT_EQ(n, 4u, "4 rows read back");
+    ASSERT_EQ(cols.timestamp[3], 60u, "timestamps preserved");
+    ASSERT_EQ(cols.alert[0], ALERT_NONE, "20.0 under the warning line");
+    ASSERT_EQ(cols.alert[3], ALERT_WARNING, "22.0 over the warning line");
+    csv_columns_free(&cols);
+    csv_bulk_close(&back);
+    remove(path);
+
+    free(rp);
+    manager_destroy(m);
+}
+
+static void test_pacing(void)
+{
+    test_header("replay_csv — paced by recorded timestamps");
+
+    manager_t *m = make_manager();
+    replay_t *rp = malloc(sizeof(*rp));
+    replay_init(rp, m, NULL);
+
+    /* 60 ms of recording at 2x: at least 30 ms of wall time */
+    replay_set_speed(rp, 2.0);
+    csv_bulk_t r;
+    csv_bulk_open_mem(&r, k_log, sizeof(k_log) - 1);
+    replay_csv(rp, &r);
+    ASSERT_TRUE(rp->elapsed_ns >= 29000000u, "2x replay takes >= 30 ms");
+    ASSERT_TRUE(rp->wait_ns > 0, "time spent waiting");
+    ASSERT_EQ(rp->readings, 4u, "all readings delivered");
+
+    /* Restart mid-log: 0, 1500, then 10, 1510 at 10x. Re-anchoring
+     * replays the second session in full (~300 ms in total) instead of
+     * treating it as already overdue (~150 ms) */
+    static const char restart[] =
+        "0,0,Temperature (C),1.0,NONE\n"
+        "1500,0,Temperature (C),2.0,NONE\n"
+        "10,0,Temperature (C),3.0,NONE\n"
+        "1510,0,Temperature (C),4.0,NONE\n";
+    replay_init(rp, m, NULL);
+    replay_set_speed(rp, 10.0);
+    csv_bulk_open_mem(&r, restart, sizeof(restart) - 1);
+    replay_csv(rp, &r);
+    ASSERT_EQ(rp->readings, 4u, "restart: all readings delivered");
+    ASSERT_TRUE(rp->elapsed_ns >= 290000000u, "restart re-anchors the clock");
+
+    free(rp);
+    manager_destroy(m);
+}
+
+static void test_binary(void)
+{
+    test_header("replay_frames — binary capture in small chunks");
+
+    uint8_t cap[256];
+    size_t  len = 0;
+    int16_t temp[2] = {2150, 2160};              /* centi-degrees */
+    int16_t vib[4]  = {16384, -8192, 0, 4096};   /* 16384 per g */
+
+    len += frame_encode_time(cap + len, sizeof(cap) - len, 5000);
+    len += frame_encode(cap + len, sizeof(cap) - len, 0, 0, 100, temp, 2);
+    cap[len++] = 0x00;                           /* line noise */
+    len += frame_encode(cap + len, sizeof(cap) - len, 2, 10, 10, vib, 4);
+
+    frame_decoder_t dec;
+    frame_decoder_init(&dec);
+    frame_set_scale(&dec, 0, 0.01f);
+    frame_set_scale(&dec, 2, 1.0f / 16384.0f);
+
+    manager_t *m = make_manager();
+    replay_t *rp = malloc(sizeof(*rp));
+    replay_init(rp, m, NULL);
+    replay_set_speed(rp, REPLAY_FAST);
+
+    for (size_t off = 0; off < len; off += 3)
+        replay_frames(rp, &dec, cap + off, (len - off < 3) ? len - off : 3);
+
+    ASSERT_EQ(rp->readings, 6u, "2 + 4 readings logged");
+    ASSERT_EQ(rp->bytes, len, "every byte consumed");
+    ASSERT_EQ(dec.frames, 2u, "2 sensor frames decoded");
+    ASSERT_NEAR(m->sensors[0].stats.max, 21.6f, 1e-3f, "temperature scaled");
+    ASSERT_NEAR(m->sensors[2].stats.min, -0.5f, 1e-4f, "vibration scaled");
+    ASSERT_EQ(m->sensors[2].stats.sample_count, 4u, "vibration saw 4");
+
+    free(rp);
+    manager_destroy(m);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Replay Engine Test Suite\n");
+    printf("==============================\n");
+
+    test_csv_fast();
+    test_longer_than_ring();
+    test_logger_output();
+    test_pacing();
+    test_binary();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
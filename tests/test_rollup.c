@@ -0,0 +1,219 @@
+/**
+ * @file test_rollup.c
+ * @brief Unit tests for the rollup (downsampling) cascade
+ *
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/rollup.c tests/test_rollup.c -o build/test_rollup.exe -lm
+ * Run:    ./build/test_rollup.exe
+ */
+
+#include "../src/rollup.h"
+#include <stdio.h>
+#include <math.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)        ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)         ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)        ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a)-(b)) < (eps), msg)
+
+#define TIER0_PATH "test_rollup_t0.bin"
+#define TIER1_PATH "test_rollup_t1.bin"
+#define INDEX_PATH "test_rollup_t0.bin.idx"
+#define INDEX1_PATH "test_rollup_t1.bin.idx"
+
+static long file_size(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_add_tier(void)
+{
+    test_header("rollup_add_tier — widths must nest");
+    rollup_t r;
+    rollup_init(&r);
+
+    ASSERT_TRUE(rollup_add_tier(&r, 1000, TIER0_PATH),   "first tier ok");
+    ASSERT_FALSE(rollup_add_tier(&r, 1500, TIER1_PATH),  "non-multiple width rejected");
+    ASSERT_FALSE(rollup_add_tier(&r, 1000, TIER1_PATH),  "equal width rejected");
+    ASSERT_FALSE(rollup_add_tier(&r, 0, TIER1_PATH),     "zero width rejected");
+    ASSERT_TRUE(rollup_add_tier(&r, 60000, TIER1_PATH),  "multiple width ok");
+    ASSERT_EQ(r.count, 2,                                "two tiers configured");
+
+    rollup_close(&r);
+    remove(TIER0_PATH);
+    remove(INDEX_PATH);
+    remove(TIER1_PATH);
+    remove(INDEX1_PATH);
+}
+
+static void test_bucket_summary(void)
+{
+    test_header("rollup_feed — min/max/mean/count/last per bucket");
+    rollup_t r;
+    rollup_init(&r);
+    rollup_add_tier(&r, 1000, TIER0_PATH);
+
+    /* Bucket [0, 1000): 1, 5, 3   Bucket [1000, 2000): 10 */
+    rollup_feed(&r, 2, 1.0f, 100);
+    rollup_feed(&r, 2, 5.0f, 400);
+    rollup_feed(&r, 2, 3.0f, 900);
+    rollup_feed(&r, 2, 10.0f, 1200);
+    ASSERT_EQ(r.tiers[0].records_written, 1, "first bucket closed by later reading");
+
+    rollup_close(&r);
+
+    rollup_record_t out[4];
+    size_t n = rollup_query(TIER0_PATH, 2, 0, 5000, out, 4);
+    ASSERT_EQ(n, 2,                           "two buckets on disk");
+    ASSERT_EQ(out[0].bucket_start, 0,         "bucket aligned to width");
+    ASSERT_EQ(out[0].count, 3,                "count");
+    ASSERT_NEAR(out[0].min, 1.0f, 0.001f,     "min");
+    ASSERT_NEAR(out[0].max, 5.0f, 0.001f,     "max");
+    ASSERT_NEAR(out[0].mean, 3.0f, 0.001f,    "mean");
+    ASSERT_NEAR(out[0].last, 3.0f, 0.001f,    "last");
+    ASSERT_EQ(out[1].bucket_start, 1000,      "second bucket start");
+
+    ASSERT_EQ(rollup_query(TIER0_PATH, 3, 0, 5000, out, 4), 0, "other sensor has no buckets");
+    ASSERT_EQ(rollup_query(TIER0_PATH, 2, 1000, 2000, out, 4), 1, "range filter applied");
+
+    remove(TIER0_PATH);
+    remove(INDEX_PATH);
+}
+
+static void test_cascade(void)
+{
+    test_header("cascade — 1 s buckets roll into 1 min buckets");
+    rollup_t r;
+    rollup_init(&r);
+    rollup_add_tier(&r, 1000, TIER0_PATH);
+    rollup_add_tier(&r, 60000, TIER1_PATH);
+
+    /* Two minutes of 10 Hz data: value = minute index */
+    for (uint32_t t = 0; t < 120000; t += 100)
+        rollup_feed(&r, 0, (float)(t / 60000), t);
+
+    ASSERT_EQ(r.tiers[0].records_written, 119, "119 closed 1 s buckets while running");
+    ASSERT_EQ(r.tiers[1].records_written, 1,   "first minute closed by cascade");
+
+    rollup_close(&r);
+
+    rollup_record_t out[4];
+    size_t n = rollup_query(TIER1_PATH, 0, 0, 200000, out, 4);
+    ASSERT_EQ(n, 2,                           "two minute buckets");
+    ASSERT_EQ(out[0].count, 600,              "minute 0 counts every raw reading");
+    ASSERT_NEAR(out[0].mean, 0.0f, 0.001f,    "minute 0 mean");
+    ASSERT_EQ(out[1].bucket_start, 60000,     "minute 1 start");
+    ASSERT_NEAR(out[1].mean, 1.0f, 0.001f,    "minute 1 mean");
+
+    remove(TIER0_PATH);
+    remove(INDEX_PATH);
+    remove(TIER1_PATH);
+    remove(INDEX1_PATH);
+}
+
+static void test_index(void)
+{
+    test_header("sparse index — queries read only the blocks in range");
+    remove(TIER0_PATH);
+    remove(INDEX_PATH);
+
+    /* 1000 one-reading buckets: 3 indexed blocks and a 232-record tail */
+    rollup_t r;
+    rollup_init(&r);
+    rollup_add_tier(&r, 10, TIER0_PATH);
+    for (uint32_t i = 0; i <= 1000; i++)
+        rollup_feed(&r, 0, (float)i, i * 10);
+    rollup_sync(&r);
+    ASSERT_EQ(file_size(INDEX_PATH), 3 * (long)sizeof(rollup_index_t),
+              "one entry per full block");
+
+    rollup_record_t out[300];
+    size_t n = rollup_query(TIER0_PATH, 0, 3000, 3100, out, 300);
+    ASSERT_TRUE(n == 10 && out[0].bucket_start == 3000 &&
+                out[9].bucket_start == 3090, "range in an indexed block");
+    n = rollup_query(TIER0_PATH, 0, 9000, 20000, out, 300);
+    ASSERT_TRUE(n == 100 && out[99].bucket_start == 9990, "range in the tail");
+    ASSERT_EQ(rollup_query(TIER0_PATH, 0, 0, 20000, out, 300), (size_t)300,
+              "capped at max");
+
+    /* Plant a matching record in block 0: a query for block 2 must not see it */
+    FILE *f = fopen(TIER0_PATH, "r+b");
+    rollup_record_t planted = {.bucket_start = 6000, .count = 99, .sensor_id = 0};
+    fwrite(&planted, sizeof(planted), 1, f);
+    fclose(f);
+    n = rollup_query(TIER0_PATH, 0, 6000, 6010, out, 300);
+    ASSERT_TRUE(n == 1 && out[0].count == 1, "blocks out of range not read");
+    rollup_close(&r);
+
+    /* Index lost: rebuilt when the tier is opened again, then extended */
+    remove(INDEX_PATH);
+    rollup_init(&r);
+    rollup_add_tier(&r, 10, TIER0_PATH);
+    ASSERT_EQ(file_size(INDEX_PATH), 3 * (long)sizeof(rollup_index_t),
+              "missing index rebuilt");
+    ASSERT_EQ(r.tiers[0].records, (uint64_t)1001, "existing records counted");
+    for (uint32_t i = 1001; i < 1100; i++)
+        rollup_feed(&r, 0, (float)i, i * 10);
+    rollup_close(&r);
+    ASSERT_EQ(file_size(INDEX_PATH), 4 * (long)sizeof(rollup_index_t),
+              "index continues across sessions");
+    n = rollup_query(TIER0_PATH, 0, 10200, 10300, out, 300);
+    ASSERT_TRUE(n == 10 && out[0].bucket_start == 10200, "new block queryable");
+
+    remove(TIER0_PATH);
+    remove(INDEX_PATH);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Rollup Test Suite\n");
+    printf("==============================\n");
+
+    test_add_tier();
+    test_bucket_summary();
+    test_cascade();
+    test_index();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
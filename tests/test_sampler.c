@@ -0,0 +1,420 @@
+/**
+ * @file test_sampler.c
+ * @brief Unit tests for the timer wheel and the acquisition scheduler
+ *
+ * Build:  make test
+ * Run:    ./build/test_sampler
+ */
+
+#include "../src/sampler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * TIMER WHEEL
+ * ========================================================================== */
+
+typedef struct {
+    tw_timer_t timer;
+    uint64_t   fired_at;    ///< Wheel tick it fired on, UINT64_MAX if not
+    int        fires;
+} probe_t;
+
+typedef struct {
+    timer_wheel_t *w;
+    uint64_t       last;    ///< Previous fire tick, for ordering
+    bool           ordered;
+} fire_log_t;
+
+static void on_probe(void *ctx, tw_timer_t *t)
+{
+    fire_log_t *log = ctx;
+    probe_t    *p   = (probe_t *)t;
+    p->fired_at = log->w->now - 1;      /* the tick being processed */
+    p->fires++;
+    if (p->fired_at < log->last)
+        log->ordered = false;
+    log->last = p->fired_at;
+}
+
+static void test_wheel_levels(void)
+{
+    test_header("tw_schedule / tw_advance — fires on the deadline at every level");
+
+    static const uint64_t deadlines[] = {
+        0, 1, 63, 64, 65, 127, 4095, 4096, 4097, 262143, 262144,
+        300001, TW_RANGE - 1, TW_RANGE + 12345, 3 * TW_RANGE + 7};
+    enum { N = sizeof(deadlines) / sizeof(deadlines[0]) };
+    probe_t p[N];
+    timer_wheel_t w;
+    fire_log_t log = {.w = &w, .ordered = true};
+
+    memset(p, 0, sizeof(p));
+    tw_init(&w, 0);
+    for (int i = 0; i < N; i++)
+        tw_schedule(&w, &p[i].timer, deadlines[i]);
+    ASSERT_EQ(w.count, (size_t)N, "all scheduled");
+    ASSERT_EQ(tw_next_expiry(&w), 0u, "first one due now");
+
+    /* Uneven steps, so cascades happen mid-step and at step edges */
+    uint64_t now = 0, step = 1;
+    size_t fired = 0;
+    while (w.count > 0)
+    {
+        fired += tw_advance(&w, now, on_probe, &log);
+        now += step;
+        step = step * 3 % 100003 + 1;
+    }
+    ASSERT_EQ(fired, (size_t)N, "every timer fired once");
+
+    bool exact = true;
+    for (int i = 0; i < N; i++)
+        exact = exact && p[i].fires == 1 && p[i].fired_at == deadlines[i];
+    ASSERT_TRUE(exact, "each on its own deadline tick, beyond TW_RANGE too");
+    ASSERT_TRUE(log.ordered, "in deadline order");
+    ASSERT_EQ(tw_next_expiry(&w), UINT64_MAX, "empty wheel has no expiry");
+}
+
+static void test_wheel_random(void)
+{
+    test_header("tw_advance — 20000 random timers, cancels, random steps");
+
+    enum { N = 20000 };
+    probe_t *p = calloc(N, sizeof(*p));
+    timer_wheel_t w;
+    fire_log_t log = {.w = &w, .ordered = true};
+    tw_init(&w, 1000);
+
+    uint32_t s = 12345;
+    for (int i = 0; i < N; i++)
+    {
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        tw_schedule(&w, &p[i].timer, 1000 + s % (1u << 20));
+        p[i].fired_at = UINT64_MAX;
+    }
+    for (int i = 0; i < N; i += 4)
+        tw_cancel(&w, &p[i].timer);
+    tw_cancel(&w, &p[0].timer);     /* twice is harmless */
+    ASSERT_EQ(w.count, (size_t)N * 3 / 4, "cancelled timers left the wheel");
+
+    /* next_expiry never later than the earliest deadline */
+    bool bound = true;
+    uint64_t now = 1000;
+    while (w.count > 0)
+    {
+        uint64_t earliest = UINT64_MAX;
+        for (int i = 0; i < N; i++)
+            if (tw_pending(&p[i].timer) && p[i].timer.deadline < earliest)
+                earliest = p[i].timer.deadline;
+        if (tw_next_expiry(&w) > earliest)
+            bound = false;
+
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        now += s % 20000;
+        tw_advance(&w, now, on_probe, &log);
+    }
+    ASSERT_TRUE(bound, "tw_next_expiry is never late");
+
+    bool ok = true;
+    for (int i = 0; i < N; i++)
+    {
+        if (i % 4 == 0)
+            ok = ok && p[i].fires == 0;
+        else
+            ok = ok && p[i].fires == 1 && p[i].fired_at == p[i].timer.deadline;
+    }
+    ASSERT_TRUE(ok, "live timers fired once on time, cancelled ones never");
+    ASSERT_TRUE(log.ordered, "in deadline order across big steps");
+    free(p);
+}
+
+static void rearm_in_past(void *ctx, tw_timer_t *t)
+{
+    probe_t *p = (probe_t *)t;
+    p->fires++;
+    if (p->fires < 3)
+        tw_schedule(ctx, t, 0);     /* long past */
+}
+
+static void test_wheel_rearm(void)
+{
+    test_header("tw_schedule from the callback — past deadline waits a tick");
+
+    timer_wheel_t w;
+    probe_t p = {0};
+    tw_init(&w, 50);
+    tw_schedule(&w, &p.timer, 10);
+    ASSERT_EQ(tw_next_expiry(&w), 50u, "past deadline is due now");
+    ASSERT_EQ(p.timer.deadline, 10u, "deadline kept as given");
+
+    ASSERT_EQ(tw_advance(&w, 50, rearm_in_past, &w), (size_t)1,
+              "re-armed timer does not fire again in the same tick");
+    ASSERT_EQ(tw_next_expiry(&w), 51u, "due on the next tick");
+    ASSERT_EQ(tw_advance(&w, 60, rearm_in_past, &w), (size_t)2,
+              "a later advance sees both re-arms");
+    ASSERT_FALSE(tw_pending(&p.timer), "then stays idle");
+
+    tw_schedule(&w, &p.timer, 200);
+    tw_schedule(&w, &p.timer, 100);
+    ASSERT_EQ(w.count, (size_t)1, "re-arming moves, not duplicates");
+    ASSERT_EQ(tw_next_expiry(&w), 100u, "at the new deadline");
+}
+
+/* ============================================================================
+ * SAMPLER
+ * ========================================================================== */
+
+typedef struct {
+    sensor_reading_t got[4096];
+    size_t           n;
+    int              batches;
+} collect_t;
+
+static void collect(void *ctx, const sensor_reading_t *batch, size_t n)
+{
+    collect_t *c = ctx;
+    for (size_t i = 0; i < n && c->n < 4096; i++)
+        c->got[c->n++] = batch[i];
+    c->batches++;
+}
+
+/** Value = the deadline, so the test can check what was read when */
+static bool read_due(void *ctx, uint8_t id, uint64_t due_ms, float *value)
+{
+    (void)ctx;
+    (void)id;
+    *value = (float)due_ms;
+    return true;
+}
+
+static bool read_flaky(void *ctx, uint8_t id, uint64_t due_ms, float *value)
+{
+    (void)ctx;
+    (void)id;
+    *value = 1.0f;
+    return (due_ms / 100) % 2 == 0;     /* every other read fails */
+}
+
+static size_t count_id(const collect_t *c, uint8_t id)
+{
+    size_t k = 0;
+    for (size_t i = 0; i < c->n; i++)
+        k += c->got[i].sensor_id == id;
+    return k;
+}
+
+static void test_sampler_periods(void)
+{
+    test_header("sampler — own period and phase per source");
+
+    static collect_t c;
+    memset(&c, 0, sizeof(c));
+    sampler_t *s = sampler_create(4, 0);
+    sampler_set_sink(s, collect, &c);
+    ASSERT_TRUE(sampler_add(s, 0, 1000, 0, read_due, NULL) != NULL, "1 Hz source");
+    ASSERT_TRUE(sampler_add(s, 1, 250, 100, read_due, NULL) != NULL, "4 Hz, 100 ms in");
+    ASSERT_TRUE(sampler_add(s, 2, 0, 0, read_due, NULL) == NULL, "period 0 rejected");
+
+    for (uint64_t t = 0; t <= 1999; t++)
+        sampler_advance(s, t);
+
+    ASSERT_EQ(count_id(&c, 0), (size_t)2, "1 Hz: t=0, 1000");
+    ASSERT_EQ(count_id(&c, 1), (size_t)8, "4 Hz: t=100 .. 1850");
+    bool stamped = true;
+    for (size_t i = 0; i < c.n; i++)
+        stamped = stamped && c.got[i].timestamp == (uint32_t)c.got[i].value &&
+                  (c.got[i].sensor_id == 0 ? c.got[i].timestamp % 1000 == 0
+                                           : c.got[i].timestamp % 250 == 100);
+    ASSERT_TRUE(stamped, "readings stamped with their deadlines");
+    ASSERT_EQ(s->wakeups, (uint64_t)10, "one wakeup per distinct deadline");
+    ASSERT_EQ(s->max_late_ms, 0u, "never late when advanced every ms");
+    sampler_destroy(s);
+}
+
+static void test_sampler_drift(void)
+{
+    test_header("sampler — late wakeups do not drift; far behind skips");
+
+    static collect_t c;
+    memset(&c, 0, sizeof(c));
+    sampler_t *s = sampler_create(1, 0);
+    sampler_set_sink(s, collect, &c);
+    sampler_source_t *src = sampler_add(s, 0, 100, 0, read_due, NULL);
+
+    /* Always wake 37 ms late */
+    for (uint64_t t = 37; t < 10000; t += 100)
+        sampler_advance(s, t);
+    ASSERT_EQ(src->samples, (uint64_t)100, "one sample per period");
+    ASSERT_EQ(c.got[99].timestamp, 9900u, "100th still on the 100 ms grid");
+    ASSERT_EQ(s->max_late_ms, 37u, "lateness recorded");
+    ASSERT_EQ(src->missed, 0u, "nothing missed");
+
+    /* Stall 350 ms: one catch-up read, three deadlines skipped */
+    sampler_advance(s, 10350);
+    ASSERT_EQ(src->samples, (uint64_t)101, "one read for the stall");
+    ASSERT_EQ(src->missed, 3u, "skipped deadlines counted");
+    ASSERT_EQ(src->timer.deadline, 10400u, "back on the grid");
+    ASSERT_TRUE(sampler_next_due(s) <= 10400u, "next wakeup not after it");
+    sampler_destroy(s);
+}
+
+static void test_sampler_exact_steps(void)
+{
+    test_header("sampler — advancing exactly one period at a time misses nothing");
+
+    static collect_t c;
+    memset(&c, 0, sizeof(c));
+    sampler_t *s = sampler_create(1, 0);
+    sampler_set_sink(s, collect, &c);
+    sampler_source_t *src = sampler_add(s, 0, 10, 0, read_due, NULL);
+
+    ASSERT_EQ(sampler_advance(s, 10), (size_t)2, "deadlines 0 and 10 both read");
+    ASSERT_TRUE(c.n == 2 && c.got[1].timestamp == 10u, "the one due now included");
+    ASSERT_EQ(src->missed, 0u, "nothing counted as missed");
+
+    for (uint64_t t = 20; t <= 1000; t += 10)
+        sampler_advance(s, t);
+    ASSERT_EQ(src->samples, (uint64_t)101, "one read per step");
+    ASSERT_EQ(c.got[100].timestamp, 1000u, "last read on the final step");
+    ASSERT_EQ(src->missed, 0u, "still nothing missed");
+
+    /* Three periods in one step: only the deadline passed without a
+     * read (1020) is skipped; 1030 is due now and read */
+    sampler_advance(s, 1030);
+    ASSERT_EQ(src->samples, (uint64_t)103, "1010 and 1030 read");
+    ASSERT_EQ(src->missed, 1u, "1020 skipped");
+    ASSERT_EQ(c.got[102].timestamp, 1030u, "on the grid");
+    sampler_destroy(s);
+}
+
+static void test_sampler_batch(void)
+{
+    test_header("sampler — 1000 sources due together, one wakeup");
+
+    static collect_t c;
+    memset(&c, 0, sizeof(c));
+    sampler_t *s = sampler_create(1000, 0);
+    sampler_set_sink(s, collect, &c);
+    for (int i = 0; i < 1000; i++)
+        sampler_add(s, (uint8_t)i, 500, 0, read_due, NULL);
+
+    ASSERT_EQ(sampler_advance(s, 0), (size_t)1000, "all read");
+    ASSERT_EQ(s->wakeups, (uint64_t)1, "in one wakeup");
+    ASSERT_EQ(c.batches, (1000 + SAMPLER_BATCH - 1) / SAMPLER_BATCH,
+              "delivered in SAMPLER_BATCH runs");
+    ASSERT_TRUE(sampler_next_due(s) <= 500u, "woken again by the next round");
+    ASSERT_EQ(sampler_advance(s, 499), (size_t)0, "nothing early");
+
+    ASSERT_TRUE(sampler_add(s, 0, 1, 0, read_due, NULL) == NULL, "full sampler");
+    sampler_destroy(s);
+}
+
+static void test_sampler_sources(void)
+{
+    test_header("sampler — failed reads, late add, remove, manager sink");
+
+    manager_t *m = manager_create(3);
+    manager_register(m, 0, "Temp", 64);
+    manager_register(m, 1, "Hum", 64);
+    sampler_t *s = sampler_create(3, 0);
+    sampler_set_sink(s, sampler_manager_sink, m);
+
+    sampler_source_t *a = sampler_add(s, 0, 100, 0, read_flaky, NULL);
+    for (uint64_t t = 0; t < 1000; t++)
+        sampler_advance(s, t);
+    ASSERT_EQ(a->samples, (uint64_t)5, "good reads delivered");
+    ASSERT_EQ(a->failed, (uint64_t)5, "failed reads counted");
+    ASSERT_EQ(m->sensors[0].buf->count, (size_t)5, "landed in the manager");
+
+    /* Added at t=1000 with phase 30: first due 1030, not 1000 */
+    sampler_source_t *b = sampler_add(s, 1, 200, 30, read_due, NULL);
+    ASSERT_EQ(b->timer.deadline, 1030u, "late add keeps its phase");
+    sampler_remove(s, a);
+    for (uint64_t t = 1000; t < 1500; t++)
+        sampler_advance(s, t);
+    ASSERT_EQ(a->samples + a->failed, (uint64_t)10, "removed source not read");
+    ASSERT_EQ(b->samples, (uint64_t)3, "others carry on");
+
+    sampler_destroy(s);
+    manager_destroy(m);
+}
+
+static void test_sampler_run(void)
+{
+    test_header("sampler_run — real time, one thread");
+
+    static collect_t c;
+    memset(&c, 0, sizeof(c));
+    sampler_t *s = sampler_create(2, 0);
+    sampler_set_sink(s, collect, &c);
+    sampler_source_t *fast = sampler_add(s, 0, 10, 0, read_due, NULL);
+    sampler_source_t *slow = sampler_add(s, 1, 40, 5, read_due, NULL);
+
+    sampler_run(s, 100, NULL);
+    ASSERT_TRUE(s->now_ms >= 100, "ran for the duration");
+    ASSERT_EQ(fast->samples + fast->missed, s->now_ms / 10 + 1,
+              "10 ms source: every deadline up to now");
+    ASSERT_EQ(slow->samples + slow->missed, (s->now_ms - 5) / 40 + 1,
+              "40 ms source, 5 ms phase: likewise");
+
+    volatile sig_atomic_t stop = 1;
+    uint64_t before = s->now_ms;
+    sampler_run(s, 10000, &stop);
+    ASSERT_TRUE(s->now_ms - before < 1000, "stop flag honoured");
+    sampler_destroy(s);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Sampler Test Suite\n");
+    printf("==============================\n");
+
+    test_wheel_levels();
+    test_wheel_random();
+    test_wheel_rearm();
+    test_sampler_periods();
+    test_sampler_drift();
+    test_sampler_exact_steps();
+    test_sampler_batch();
+    test_sampler_sources();
+    test_sampler_run();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
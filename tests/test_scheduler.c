@@ -0,0 +1,194 @@
+/**
+ * @file test_scheduler.c
+ * @brief Unit tests for the work-stealing scheduler
+ *
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/scheduler.c tests/test_scheduler.c -o build/test_scheduler.exe -pthread
+ * Run:    ./build/test_scheduler.exe
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/scheduler.h"
+#include "../src/clock.h"
+#include <stdio.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * WORK FUNCTIONS
+ * ========================================================================== */
+
+#define ITEMS 4096
+
+typedef struct {
+    int      hits[ITEMS];       ///< Times each item was processed
+    size_t   largest_leaf[WS_MAX_WORKERS];
+    uint64_t spin_ns;           ///< Simulated cost per item
+} job_t;
+
+static void count_items(void *ctx, size_t begin, size_t end, unsigned worker)
+{
+    job_t *job = ctx;
+
+    if (end - begin > job->largest_leaf[worker])
+        job->largest_leaf[worker] = end - begin;
+
+    for (size_t i = begin; i < end; i++)
+    {
+        uint64_t until = clock_ns() + job->spin_ns;
+        while (job->spin_ns && clock_ns() < until)
+            ;
+        job->hits[i]++;
+    }
+}
+
+static bool all_hit_once(const job_t *job, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        if (job->hits[i] != 1)
+            return false;
+    return true;
+}
+
+static size_t largest_leaf(const job_t *job)
+{
+    size_t m = 0;
+    for (int i = 0; i < WS_MAX_WORKERS; i++)
+        if (job->largest_leaf[i] > m)
+            m = job->largest_leaf[i];
+    return m;
+}
+
+static job_t g_job;
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_create_submit(void)
+{
+    test_header("ws_create / ws_submit — argument checks");
+    ASSERT_FALSE(ws_create(0),                        "0 workers rejected");
+
+    ws_scheduler_t *ws = ws_create(2);
+    ASSERT_TRUE(ws != NULL,                           "2 workers created");
+    ASSERT_FALSE(ws_submit(ws, NULL, NULL, 0, 1, 1),  "NULL fn rejected");
+    ASSERT_FALSE(ws_submit(ws, count_items, &g_job, 5, 1, 1), "end < begin rejected");
+    ASSERT_TRUE(ws_submit(ws, count_items, &g_job, 3, 3, 1),  "empty range is a no-op");
+    ws_wait(ws);
+
+    ws_worker_stats_t st;
+    ASSERT_FALSE(ws_get_stats(ws, 2, &st),            "stats for bad worker rejected");
+    ws_destroy(ws);
+    ws_destroy(NULL);
+}
+
+static void test_every_item_once(void)
+{
+    test_header("ws_submit — every item processed exactly once, grain respected");
+    memset(&g_job, 0, sizeof(g_job));
+
+    ws_scheduler_t *ws = ws_create(4);
+    ASSERT_TRUE(ws_submit(ws, count_items, &g_job, 0, 3000, 16), "heavy range queued");
+    ASSERT_TRUE(ws_submit(ws, count_items, &g_job, 3000, 3001, 1), "single item queued");
+    ASSERT_TRUE(ws_submit(ws, count_items, &g_job, 3001, ITEMS, 64), "third range queued");
+    ws_wait(ws);
+
+    ASSERT_TRUE(all_hit_once(&g_job, ITEMS),          "no item skipped or repeated");
+    ASSERT_TRUE(largest_leaf(&g_job) <= 64,           "no leaf larger than its grain");
+
+    uint64_t items = 0, splits = 0;
+    for (unsigned i = 0; i < 4; i++)
+    {
+        ws_worker_stats_t st;
+        ws_get_stats(ws, i, &st);
+        items  += st.items;
+        splits += st.splits;
+    }
+    ASSERT_EQ(items, ITEMS,                           "stats account for every item");
+    ASSERT_TRUE(splits > 0,                           "heavy range was split");
+    ws_destroy(ws);
+}
+
+static void test_stealing(void)
+{
+    test_header("ws — one heavy task spreads over idle workers");
+    memset(&g_job, 0, sizeof(g_job));
+    g_job.spin_ns = 100000;                 /* 100 us per item */
+
+    ws_scheduler_t *ws = ws_create(4);
+    ws_submit(ws, count_items, &g_job, 0, 256, 1);
+    ws_wait(ws);
+
+    uint64_t steals = 0, busy = 0;
+    unsigned workers_used = 0;
+    for (unsigned i = 0; i < 4; i++)
+    {
+        ws_worker_stats_t st;
+        ws_get_stats(ws, i, &st);
+        steals += st.steals;
+        busy   += st.busy_ns;
+        if (st.items > 0)
+            workers_used++;
+        ASSERT_TRUE(st.utilization >= 0.0 && st.utilization <= 1.0,
+                    "utilisation is a fraction");
+    }
+
+    ASSERT_TRUE(all_hit_once(&g_job, 256),            "stolen work done exactly once");
+    ASSERT_TRUE(steals > 0,                           "idle workers stole work");
+    ASSERT_TRUE(workers_used > 1,                     "work ran on more than one worker");
+    ASSERT_TRUE(busy > 0,                             "busy time recorded");
+
+    ws_reset_stats(ws);
+    ws_worker_stats_t st;
+    ws_get_stats(ws, 0, &st);
+    ASSERT_EQ(st.items, 0,                            "reset clears counters");
+    ws_destroy(ws);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Scheduler Test Suite\n");
+    printf("==============================\n");
+
+    test_create_submit();
+    test_every_item_once();
+    test_stealing();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
@@ -2,7 +2,7 @@
  * @file test_sensor.c
  * @brief Unit tests for the sensor abstraction layer
  *
- * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/buffer.c src/sensors.c tests/test_sensor.c -o build/test_sensor.exe -lm
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c tests/test_sensor.c -o build/test_sensor.exe -lm
  * Run:    ./build/test_sensor.exe
  */
 
@@ -131,6 +131,27 @@ static void test_pause_resume(void)
     sensor_destroy(&s);
 }
 
+static void test_fault(void)
+{
+    test_header("sensor_fault / sensor_clear_fault");
+    sensor_t s;
+    sensor_init(&s, 0, "DHT11", 8);
+
+    ASSERT_TRUE(sensor_fault(&s),             "fault returns true");
+    ASSERT_EQ(s.state, SENSOR_STATE_ERROR,   "state is ERROR");
+    ASSERT_FALSE(sensor_log(&s, 5.0f, 100),  "log rejected while faulted");
+    ASSERT_FALSE(sensor_resume(&s),           "resume does not clear a fault");
+
+    ASSERT_TRUE(sensor_clear_fault(&s),       "clear returns true");
+    ASSERT_EQ(s.state, SENSOR_STATE_ACTIVE,  "state back to ACTIVE");
+    ASSERT_FALSE(sensor_clear_fault(&s),      "clearing twice returns false");
+
+    sensor_pause(&s);
+    ASSERT_FALSE(sensor_fault(&s),            "paused sensor does not fault");
+
+    sensor_destroy(&s);
+}
+
 static void test_flush(void)
 {
     test_header("sensor_flush — clears buffer and stats");
@@ -179,6 +200,261 @@ static void test_peek_sensor(void)
     sensor_destroy(&s);
 }
 
+static void test_anomaly_zscore(void)
+{
+    test_header("anomaly detection — EWMA z-score");
+    sensor_t s;
+    sensor_init(&s, 7, "Temp", 64);
+
+    anomaly_config_t cfg = {
+        .alpha = 0.1f, .z_warn = 3.0f, .z_critical = 6.0f,
+        .warmup = 10, .enabled = true
+    };
+    ASSERT_TRUE(sensor_set_anomaly(&s, &cfg), "set_anomaly ok");
+
+    /* Baseline: 40 +/- 0.5 */
+    int flagged = 0;
+    for (int i = 0; i < 30; i++) {
+        sensor_log(&s, (i % 2) ? 40.5f : 39.5f, (uint32_t)i);
+        if (sensor_last_anomaly(&s, NULL) != ALERT_NONE)
+            flagged++;
+    }
+    ASSERT_EQ(flagged, 0, "steady baseline never flagged");
+
+    alert_event_t ev;
+    sensor_log(&s, 60.0f, 100);
+    ASSERT_EQ(sensor_last_anomaly(&s, &ev), ALERT_CRITICAL, "spike = CRITICAL");
+    ASSERT_EQ(ev.sensor_id, 7,                             "event carries sensor id");
+    ASSERT_EQ(ev.timestamp, 100,                           "event carries timestamp");
+    ASSERT_NEAR(ev.value, 60.0f, 0.001f,                   "event carries value");
+
+    sensor_flush(&s);
+    sensor_log(&s, 60.0f, 200);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_NONE,   "flush restarts learning");
+
+    anomaly_config_t bad = { .alpha = 1.5f, .enabled = true };
+    ASSERT_FALSE(sensor_set_anomaly(&s, &bad),             "alpha outside (0,1) rejected");
+    ASSERT_FALSE(sensor_set_anomaly(NULL, &cfg),           "NULL sensor rejected");
+
+    sensor_destroy(&s);
+}
+
+static void test_anomaly_min_sigma(void)
+{
+    test_header("anomaly detection — variance floor after a flat warm-up");
+    sensor_t s;
+    sensor_init(&s, 0, "DHT11", 64);
+
+    /* Quantised to 1 C: warm-up on one value leaves var == 0 */
+    anomaly_config_t cfg = {
+        .alpha = 0.1f, .z_warn = 3.0f, .z_critical = 6.0f,
+        .min_sigma = 1.0f, .warmup = 10, .enabled = true
+    };
+    ASSERT_TRUE(sensor_set_anomaly(&s, &cfg), "set_anomaly ok");
+    for (int i = 0; i < 20; i++)
+        sensor_log(&s, 23.0f, (uint32_t)i);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_NONE, "constant baseline");
+
+    sensor_log(&s, 24.0f, 20);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_NONE,
+              "one-step change is not an anomaly");
+
+    sensor_log(&s, 33.0f, 21);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_CRITICAL,
+              "a real jump still is");
+
+    /* Without the floor the same step is CRITICAL */
+    cfg.min_sigma = 0.0f;
+    sensor_set_anomaly(&s, &cfg);
+    for (int i = 0; i < 20; i++)
+        sensor_log(&s, 23.0f, (uint32_t)(30 + i));
+    sensor_log(&s, 24.0f, 50);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_CRITICAL,
+              "min_sigma = 0: no floor");
+
+    cfg.min_sigma = -1.0f;
+    ASSERT_FALSE(sensor_set_anomaly(&s, &cfg), "negative min_sigma rejected");
+
+    sensor_destroy(&s);
+}
+
+static void test_anomaly_cusum(void)
+{
+    test_header("anomaly detection — CUSUM catches slow drift");
+    sensor_t s;
+    sensor_init(&s, 0, "Vibration", 256);
+
+    anomaly_config_t cfg = {
+        .alpha = 0.05f, .cusum_k = 0.05f, .cusum_h = 2.0f,
+        .warmup = 10, .enabled = true
+    };
+    sensor_set_anomaly(&s, &cfg);
+
+    for (int i = 0; i < 20; i++)
+        sensor_log(&s, 1.0f, (uint32_t)i);
+    ASSERT_EQ(sensor_last_anomaly(&s, NULL), ALERT_NONE, "flat signal not flagged");
+
+    /* Ramp of 0.02 per sample — far too gentle for a z-score check */
+    bool drift_seen = false;
+    for (int i = 0; i < 200 && !drift_seen; i++) {
+        sensor_log(&s, 1.0f + 0.02f * (float)i, (uint32_t)(20 + i));
+        drift_seen = (sensor_last_anomaly(&s, NULL) == ALERT_WARNING);
+    }
+    ASSERT_TRUE(drift_seen, "drift raises WARNING");
+
+    sensor_destroy(&s);
+}
+
+/** Brute-force median of the last `w` values of `x` ending at index i */
+static float reference_median(const float *x, int i, int w)
+{
+    float tmp[FILTER_MAX_WINDOW];
+    int n = (i + 1 < w) ? i + 1 : w;
+    for (int k = 0; k < n; k++)
+        tmp[k] = x[i - k];
+    for (int a = 1; a < n; a++)             /* insertion sort */
+        for (int b = a; b > 0 && tmp[b - 1] > tmp[b]; b--) {
+            float t = tmp[b]; tmp[b] = tmp[b - 1]; tmp[b - 1] = t;
+        }
+    return (n % 2) ? tmp[n / 2] : 0.5f * (tmp[n / 2 - 1] + tmp[n / 2]);
+}
+
+static void test_filter_median(void)
+{
+    test_header("filter chain — sliding median");
+    filter_chain_t chain;
+    filter_chain_init(&chain);
+
+    filter_stage_config_t med = { .type = FILTER_MEDIAN, .window = 5 };
+    ASSERT_TRUE(filter_chain_add(&chain, &med), "median stage added");
+
+    /* Pseudo-random stream checked against a brute-force median */
+    float x[200];
+    uint32_t seed = 12345;
+    bool all_match = true;
+    for (int i = 0; i < 200; i++) {
+        seed = seed * 1103515245u + 12345u;
+        x[i] = (float)((seed >> 16) % 1000) / 10.0f;
+        float got = filter_chain_process(&chain, x[i]);
+        if (fabsf(got - reference_median(x, i, 5)) > 1e-4f)
+            all_match = false;
+    }
+    ASSERT_TRUE(all_match, "matches brute-force median on 200 samples");
+
+    filter_chain_reset(&chain);
+    filter_chain_process(&chain, 20.0f);
+    filter_chain_process(&chain, 20.0f);
+    float out = filter_chain_process(&chain, 99.0f);   /* single spike */
+    ASSERT_NEAR(out, 20.0f, 0.001f, "single spike removed after reset");
+
+    filter_stage_config_t too_big = { .type = FILTER_MEDIAN, .window = FILTER_MAX_WINDOW + 1 };
+    ASSERT_FALSE(filter_chain_add(&chain, &too_big), "oversized window rejected");
+}
+
+static void test_filter_avg_biquad(void)
+{
+    test_header("filter chain — moving average and biquad");
+    filter_chain_t chain;
+    filter_chain_init(&chain);
+
+    filter_stage_config_t avg = { .type = FILTER_MOVING_AVG, .window = 4 };
+    filter_chain_add(&chain, &avg);
+    filter_chain_process(&chain, 1.0f);
+    filter_chain_process(&chain, 2.0f);
+    filter_chain_process(&chain, 3.0f);
+    ASSERT_NEAR(filter_chain_process(&chain, 4.0f), 2.5f, 0.001f, "mean of 1..4");
+    ASSERT_NEAR(filter_chain_process(&chain, 5.0f), 3.5f, 0.001f, "window slides");
+
+    filter_chain_init(&chain);
+    filter_stage_config_t lp = {
+        .type   = FILTER_BIQUAD,
+        .biquad = filter_biquad_lowpass(100.0f, 5.0f, 0.707f)
+    };
+    filter_chain_add(&chain, &lp);
+    float y = 0.0f;
+    for (int i = 0; i < 500; i++)
+        y = filter_chain_process(&chain, 10.0f);
+    ASSERT_NEAR(y, 10.0f, 0.01f, "low-pass has unity DC gain");
+
+    /* Nyquist-rate alternation should be almost entirely removed */
+    float peak = 0.0f;
+    for (int i = 0; i < 200; i++) {
+        y = filter_chain_process(&chain, (i % 2) ? 11.0f : 9.0f);
+        if (i > 100 && fabsf(y - 10.0f) > peak)
+            peak = fabsf(y - 10.0f);
+    }
+    ASSERT_TRUE(peak < 0.05f, "low-pass attenuates high-frequency noise");
+
+    for (int i = 0; i < FILTER_MAX_STAGES - 1; i++)
+        filter_chain_add(&chain, &avg);
+    ASSERT_FALSE(filter_chain_add(&chain, &avg), "chain rejects stage past FILTER_MAX_STAGES");
+}
+
+static void test_sensor_filtering(void)
+{
+    test_header("sensor_log — filtered vs raw logging");
+    sensor_t s;
+    sensor_init(&s, 1, "Humidity", 16);
+
+    filter_stage_config_t med = { .type = FILTER_MEDIAN, .window = 3 };
+    ASSERT_TRUE(sensor_add_filter(&s, &med), "sensor_add_filter ok");
+
+    sensor_log(&s, 50.0f, 1);
+    sensor_log(&s, 50.0f, 2);
+    sensor_log(&s, 95.0f, 3);                           /* spike */
+
+    sensor_stats_t st;
+    sensor_get_stats(&s, &st);
+    ASSERT_NEAR(st.max, 50.0f, 0.001f, "stats never see the spike");
+    ASSERT_NEAR(s.last_value, 50.0f, 0.001f, "last_value is filtered");
+
+    sensor_flush(&s);
+    sensor_set_log_raw(&s, true);
+    sensor_log(&s, 50.0f, 4);
+    sensor_log(&s, 50.0f, 5);
+    sensor_log(&s, 95.0f, 6);
+
+    sensor_reading_t out;
+    sensor_read(&s, &out);
+    sensor_read(&s, &out);
+    sensor_read(&s, &out);
+    ASSERT_NEAR(out.value, 95.0f, 0.001f, "log_raw buffers the raw value");
+    sensor_get_stats(&s, &st);
+    ASSERT_NEAR(st.max, 50.0f, 0.001f, "stats still use filtered value");
+
+    sensor_destroy(&s);
+}
+
+static void test_sensor_broadcast(void)
+{
+    test_header("sensor_enable_broadcast — readings fan out to consumers");
+    sensor_t s;
+    sensor_init(&s, 4, "bcast", 8);
+    ASSERT_FALSE(sensor_enable_broadcast(&s, 6),  "non power-of-two rejected");
+    ASSERT_TRUE(sensor_enable_broadcast(&s, 8),   "broadcast enabled");
+
+    int logger = broadcast_subscribe(s.bcast, BROADCAST_GATE);
+    int live   = broadcast_subscribe(s.bcast, BROADCAST_LAP);
+    sensor_log(&s, 10.0f, 1);
+    sensor_log(&s, 20.0f, 2);
+
+    sensor_reading_t a, b;
+    ASSERT_TRUE(broadcast_consume(s.bcast, logger, &a), "logger reads first");
+    ASSERT_TRUE(broadcast_consume(s.bcast, live, &b),   "live view reads first");
+    ASSERT_NEAR(a.value, b.value, 0.001f,               "both see the same reading");
+    ASSERT_EQ(a.sensor_id, 4,                           "sensor id stamped");
+    ASSERT_EQ(buffer_count(s.buf), 0,                   "ring buffer bypassed");
+    ASSERT_FALSE(sensor_read(&s, &a),                   "read refused in broadcast mode");
+    ASSERT_FALSE(sensor_peek(&s, &a),                   "peek refused in broadcast mode");
+    ASSERT_FALSE(sensor_flush(&s),                      "flush refused in broadcast mode");
+
+    sensor_stats_t st;
+    sensor_get_stats(&s, &st);
+    ASSERT_EQ(st.sample_count, 2,                             "stats still updated");
+
+    sensor_destroy(&s);
+}
+
 /* ============================================================================
  * MAIN
  * ========================================================================== */
@@ -194,9 +470,17 @@ int main(void)
     test_log_and_read();
     test_stats();
     test_pause_resume();
+    test_fault();
     test_flush();
     test_name_truncation();
     test_peek_sensor();
+    test_anomaly_zscore();
+    test_anomaly_min_sigma();
+    test_anomaly_cusum();
+    test_filter_median();
+    test_filter_avg_biquad();
+    test_sensor_filtering();
+    test_sensor_broadcast();
 
     printf("\n==============================\n");
     printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
@@ -0,0 +1,202 @@
+/**
+ * @file test_sharded.c
+ * @brief Unit tests for multi-producer ingestion (sharded manager)
+ *
+ * Build:  gcc -Wall -Wextra -Werror -std=c11 -g src/buffer.c src/anomaly.c src/filter.c src/broadcast.c src/sensors.c src/rollup.c src/sensor_manager.c src/sharded_manager.c tests/test_sharded.c -o build/test_sharded.exe -lm -pthread
+ * Run:    ./build/test_sharded.exe
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/sharded_manager.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <math.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+#define ASSERT_NEAR(a, b, eps, msg) ASSERT(fabsf((a) - (b)) <= (eps), msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_create_register(void)
+{
+    test_header("sharded_create / sharded_register");
+    ASSERT_FALSE(sharded_create(0, 2),                 "0 shards rejected");
+
+    sharded_manager_t *sm = sharded_create(3, 2);
+    ASSERT_TRUE(sm != NULL,                            "3 shards created");
+    ASSERT_TRUE(sharded_register(sm, 0, "Temp", 8),    "register in all shards");
+    ASSERT_TRUE(sharded_shard(sm, 2)->registered[0],   "last shard has sensor");
+    ASSERT_FALSE(sharded_shard(sm, 3),                 "shard out of range -> NULL");
+    ASSERT_FALSE(sharded_log(sm, 3, 0, 1.0f, 1),       "log to bad shard rejected");
+    ASSERT_FALSE(sharded_log(sm, 0, 1, 1.0f, 1),       "unregistered sensor rejected");
+    sharded_destroy(sm);
+    sharded_destroy(NULL);
+}
+
+static void test_merged_read_order(void)
+{
+    test_header("sharded_read — merged stream is time ordered");
+    sharded_manager_t *sm = sharded_create(2, 1);
+    sharded_register(sm, 0, "Temp", 8);
+
+    sharded_log(sm, 0, 0, 1.0f, 10);
+    sharded_log(sm, 1, 0, 2.0f, 5);
+    sharded_log(sm, 0, 0, 3.0f, 20);
+    sharded_log(sm, 1, 0, 4.0f, 15);
+
+    sensor_reading_t r;
+    uint32_t order[4];
+    int n = 0;
+    while (n < 4 && sharded_read(sm, 0, &r))
+        order[n++] = r.timestamp;
+
+    ASSERT_EQ(n, 4,                                   "all four readings returned");
+    ASSERT_TRUE(order[0] == 5 && order[1] == 10 &&
+                order[2] == 15 && order[3] == 20,     "oldest first across shards");
+    ASSERT_FALSE(sharded_read(sm, 0, &r),             "empty afterwards");
+    sharded_destroy(sm);
+}
+
+static void test_merged_stats_and_alerts(void)
+{
+    test_header("sharded_get_stats / totals — combiner merges shards");
+    sharded_manager_t *sm = sharded_create(2, 1);
+    sharded_register(sm, 0, "Temp", 8);
+    sensor_threshold_t t = { .warn_low = -100.0f, .warn_high = 50.0f,
+                             .critical_low = -200.0f, .critical_high = 90.0f };
+    sharded_set_thresholds(sm, 0, t);
+
+    sharded_log(sm, 0, 0, 10.0f, 1);
+    sharded_log(sm, 0, 0, 60.0f, 2);                  /* warning */
+    sharded_log(sm, 1, 0, -5.0f, 3);
+
+    sensor_stats_t st;
+    ASSERT_TRUE(sharded_get_stats(sm, 0, &st),        "stats merged");
+    ASSERT_EQ(st.sample_count, 3,                     "count summed");
+    ASSERT_NEAR(st.min, -5.0f, 0.001f,                "min across shards");
+    ASSERT_NEAR(st.max, 60.0f, 0.001f,                "max across shards");
+    ASSERT_NEAR(st.sum, 65.0f, 0.001f,                "sum across shards");
+
+    sharded_totals_t tot;
+    sharded_get_totals(sm, &tot);
+    ASSERT_EQ(tot.logs, 3,                            "total logs summed");
+    ASSERT_EQ(tot.alerts, 1,                          "alert counted once");
+    sharded_destroy(sm);
+}
+
+/* ---- Threaded: N producers, one combiner polling concurrently ---- */
+
+#define PRODUCERS   4
+#define PER_THREAD  20000
+
+typedef struct {
+    sharded_manager_t *sm;
+    uint8_t            shard;
+    uint32_t           logged;
+} producer_arg_t;
+
+static void *producer(void *p)
+{
+    producer_arg_t *arg = p;
+    for (uint32_t i = 0; i < PER_THREAD; i++)
+    {
+        if (sharded_log(arg->sm, arg->shard, 0, (float)arg->shard, i))
+            arg->logged++;
+    }
+    return NULL;
+}
+
+static void test_concurrent_producers(void)
+{
+    test_header("sharded_log — concurrent producers, live combiner");
+    sharded_manager_t *sm = sharded_create(PRODUCERS, 1);
+    sharded_register(sm, 0, "Temp", PER_THREAD);
+
+    pthread_t th[PRODUCERS];
+    producer_arg_t args[PRODUCERS];
+    for (uint8_t i = 0; i < PRODUCERS; i++)
+    {
+        args[i] = (producer_arg_t){ sm, i, 0 };
+        pthread_create(&th[i], NULL, producer, &args[i]);
+    }
+
+    /* The combiner may take snapshots while producers run */
+    bool monotonic = true;
+    uint64_t prev = 0;
+    for (int k = 0; k < 1000; k++)
+    {
+        sharded_totals_t t;
+        sharded_get_totals(sm, &t);
+        if (t.logs < prev)
+            monotonic = false;
+        prev = t.logs;
+    }
+
+    uint32_t expected = 0;
+    for (int i = 0; i < PRODUCERS; i++)
+    {
+        pthread_join(th[i], NULL);
+        expected += args[i].logged;
+    }
+
+    sharded_totals_t t;
+    sharded_get_totals(sm, &t);
+    ASSERT_TRUE(monotonic,                            "live totals never go backwards");
+    ASSERT_EQ(expected, PRODUCERS * PER_THREAD,       "no producer was rejected");
+    ASSERT_EQ(t.logs, expected,                       "no reading lost or double counted");
+
+    sensor_stats_t st;
+    sharded_get_stats(sm, 0, &st);
+    ASSERT_NEAR(st.max, (float)(PRODUCERS - 1), 0.001f, "each shard kept its own values");
+    sharded_destroy(sm);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Sharded Manager Test Suite\n");
+    printf("==============================\n");
+
+    test_create_register();
+    test_merged_read_order();
+    test_merged_stats_and_alerts();
+    test_concurrent_producers();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}
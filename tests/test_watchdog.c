@@ -0,0 +1,242 @@
+/**
+ * @file test_watchdog.c
+ * @brief Unit tests for the stale-sensor watchdog
+ *
+ * Build:  make test
+ * Run:    ./build/test_watchdog
+ */
+
+#include "../src/watchdog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * MINIMAL TEST FRAMEWORK
+ * ========================================================================== */
+
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define ASSERT(cond, msg)                                                   \
+    do {                                                                    \
+        if (cond) {                                                         \
+            printf("  PASS  %s\n", msg);                                   \
+            g_pass++;                                                       \
+        } else {                                                            \
+            printf("  FAIL  %s  [line %d]\n", msg, __LINE__);              \
+            g_fail++;                                                       \
+        }                                                                   \
+    } while (0)
+
+#define ASSERT_EQ(a, b, msg)   ASSERT((a) == (b), msg)
+#define ASSERT_TRUE(x, msg)    ASSERT((x),         msg)
+#define ASSERT_FALSE(x, msg)   ASSERT(!(x),        msg)
+
+static void test_header(const char *name)
+{
+    printf("\n[TEST] %s\n", name);
+}
+
+/* ============================================================================
+ * HELPERS
+ * ========================================================================== */
+
+/** Records what the alert callback was told */
+typedef struct {
+    int      stale;
+    int      recovered;
+    uint8_t  last_id;
+    uint64_t last_silent;
+} alerts_t;
+
+static void on_alert(void *ctx, uint8_t id, bool stale, uint64_t silent_ms)
+{
+    alerts_t *a = ctx;
+    if (stale)
+        a->stale++;
+    else
+        a->recovered++;
+    a->last_id     = id;
+    a->last_silent = silent_ms;
+}
+
+/** Manager with `n` registered sensors */
+static manager_t *make_manager(uint8_t n)
+{
+    manager_t *m = manager_create(n);
+    for (uint8_t id = 0; id < n; id++)
+        manager_register(m, id, "S", 16);
+    return m;
+}
+
+/** Poll at `now`, then log one reading from `id` */
+static bool tick(watchdog_t *wd, manager_t *m, uint8_t id, uint64_t now)
+{
+    watchdog_poll(wd, now);
+    return manager_log(m, id, 1.0f, (uint32_t)now);
+}
+
+/* ============================================================================
+ * TESTS
+ * ========================================================================== */
+
+static void test_regular(void)
+{
+    test_header("watchdog — a sensor reporting on time never goes stale");
+
+    manager_t *m = make_manager(1);
+    watchdog_t wd;
+    watchdog_init(&wd, m, 0);
+    ASSERT_TRUE(m->watchdog == &wd, "init attaches to the manager");
+    ASSERT_TRUE(watchdog_watch(&wd, 0, 100, 3), "watch");
+
+    for (uint64_t t = 0; t <= 10000; t += 100)
+        tick(&wd, m, 0, t);
+    ASSERT_EQ(wd.stale_events, 0u, "no stale events");
+    ASSERT_EQ(m->sensors[0].state, SENSOR_STATE_ACTIVE, "still active");
+    ASSERT_TRUE(tw_pending(&wd.entries[0].timer), "still armed");
+    ASSERT_TRUE(wd.entries[0].timer.deadline > 10000, "deadline follows the readings");
+    ASSERT_EQ(m->total_alerts, 0u, "no alerts");
+
+    manager_destroy(m);
+}
+
+static void test_boundary(void)
+{
+    test_header("watchdog — K-1 misses tolerated, more than K periods is not");
+
+    manager_t *m = make_manager(1);
+    watchdog_t wd;
+    watchdog_init(&wd, m, 0);
+    watchdog_watch(&wd, 0, 100, 3);
+
+    /* Readings at 0 and 100, nothing at 200 or 300, back at 400 */
+    tick(&wd, m, 0, 0);
+    tick(&wd, m, 0, 100);
+    ASSERT_EQ(watchdog_poll(&wd, 300), (size_t)0, "two misses: fine");
+    ASSERT_TRUE(tick(&wd, m, 0, 400), "third reading arrives on its deadline");
+    ASSERT_EQ(wd.stale_events, 0u, "not faulted");
+
+    /* Now silent from 400: exactly 3 periods is still within budget */
+    ASSERT_EQ(watchdog_poll(&wd, 700), (size_t)0, "silent for exactly K periods");
+    ASSERT_EQ(watchdog_poll(&wd, 701), (size_t)1, "silent for longer: faulted");
+
+    manager_destroy(m);
+}
+
+static void test_stale_and_recover(void)
+{
+    test_header("watchdog — silent sensor faulted once, recovers on its next reading");
+
+    manager_t *m = make_manager(2);
+    watchdog_t wd;
+    alerts_t   a = {0};
+    watchdog_init(&wd, m, 0);
+    watchdog_set_alert(&wd, on_alert, &a);
+    watchdog_watch(&wd, 0, 100, 3);
+    watchdog_watch(&wd, 1, 100, 3);
+
+    /* Sensor 1 keeps reporting, sensor 0 goes quiet after t=0 */
+    tick(&wd, m, 0, 0);
+    for (uint64_t t = 0; t <= 1000; t += 100)
+        tick(&wd, m, 1, t);
+
+    ASSERT_EQ(wd.stale_events, 1u, "one sensor went stale");
+    ASSERT_EQ(m->sensors[0].state, SENSOR_STATE_ERROR, "silent sensor in ERROR");
+    ASSERT_EQ(m->sensors[1].state, SENSOR_STATE_ACTIVE, "reporting sensor untouched");
+    ASSERT_EQ(m->total_alerts, 1u, "counted as an alert");
+    ASSERT_TRUE(a.stale == 1 && a.last_id == 0 && a.last_silent == 400,
+                "callback told once, on the first poll past the deadline");
+    ASSERT_FALSE(tw_pending(&wd.entries[0].timer), "disarmed while stale");
+
+    watchdog_unwatch(&wd, 1);
+    ASSERT_EQ(watchdog_poll(&wd, 100000), (size_t)0, "no repeat alerts");
+    ASSERT_EQ(a.stale, 1, "callback not called again");
+
+    ASSERT_TRUE(manager_log(m, 0, 1.0f, 100000), "next reading accepted");
+    ASSERT_EQ(m->sensors[0].state, SENSOR_STATE_ACTIVE, "fault cleared");
+    ASSERT_EQ(m->sensors[0].buf->count, (size_t)2, "and the reading recorded");
+    ASSERT_TRUE(wd.recoveries == 1 && a.recovered == 1 && a.last_silent == 100000,
+                "recovery reported with the silent time");
+    ASSERT_TRUE(tw_pending(&wd.entries[0].timer), "watched again");
+
+    ASSERT_EQ(watchdog_poll(&wd, 100301), (size_t)1, "and can go stale again");
+
+    manager_destroy(m);
+}
+
+static void test_paused(void)
+{
+    test_header("watchdog — paused sensors are not faulted");
+
+    manager_t *m = make_manager(1);
+    watchdog_t wd;
+    watchdog_init(&wd, m, 0);
+    watchdog_watch(&wd, 0, 100, 2);
+
+    manager_pause_sensor(m, 0);
+    ASSERT_EQ(watchdog_poll(&wd, 5000), (size_t)0, "paused: no fault");
+    ASSERT_EQ(m->sensors[0].state, SENSOR_STATE_PAUSED, "still paused");
+    ASSERT_TRUE(tw_pending(&wd.entries[0].timer), "checked again later");
+
+    manager_resume_sensor(m, 0);
+    ASSERT_EQ(watchdog_poll(&wd, 5200), (size_t)1, "resumed and silent: faulted");
+
+    manager_destroy(m);
+}
+
+static void test_watch_args(void)
+{
+    test_header("watchdog_watch / watchdog_unwatch / detach");
+
+    manager_t *m = make_manager(2);
+    watchdog_t wd;
+    watchdog_init(&wd, m, 1000);
+
+    ASSERT_FALSE(watchdog_watch(&wd, 5, 100, 3), "unregistered id rejected");
+    ASSERT_FALSE(watchdog_watch(&wd, 0, 0, 3), "zero period rejected");
+    ASSERT_FALSE(watchdog_watch(&wd, 0, 100, 0), "zero misses rejected");
+    ASSERT_FALSE(watchdog_watch(&wd, 0, UINT32_MAX, 2), "budget overflow rejected");
+    ASSERT_EQ(watchdog_next_due(&wd), UINT64_MAX, "nothing watched: never due");
+
+    ASSERT_TRUE(watchdog_watch(&wd, 0, 100, 3), "watch");
+    ASSERT_TRUE(watchdog_watch(&wd, 0, 100, 5), "watch again changes the budget");
+    ASSERT_EQ(wd.entries[0].timeout_ms, 500u, "new budget");
+    ASSERT_EQ(wd.wheel.count, (size_t)1, "still one timer");
+    ASSERT_EQ(watchdog_poll(&wd, 1400), (size_t)0, "old budget no longer applies");
+
+    watchdog_unwatch(&wd, 0);
+    ASSERT_EQ(watchdog_poll(&wd, 100000), (size_t)0, "unwatched: never faulted");
+    ASSERT_EQ(wd.wheel.count, (size_t)0, "timer gone");
+
+    watchdog_watch(&wd, 1, 100, 1);
+    manager_attach_watchdog(m, NULL);
+    manager_log(m, 1, 1.0f, 1);
+    ASSERT_EQ(watchdog_poll(&wd, 100101), (size_t)1, "detached: readings not seen");
+
+    manager_destroy(m);
+}
+
+/* ============================================================================
+ * MAIN
+ * ========================================================================== */
+
+int main(void)
+{
+    printf("==============================\n");
+    printf("  Watchdog Test Suite\n");
+    printf("==============================\n");
+
+    test_regular();
+    test_boundary();
+    test_stale_and_recover();
+    test_paused();
+    test_watch_args();
+
+    printf("\n==============================\n");
+    printf("  Results: %d passed, %d failed\n", g_pass, g_fail);
+    printf("==============================\n");
+
+    return (g_fail == 0) ? 0 : 1;
+}